@@ -0,0 +1,203 @@
+// Compares continuous self-collision checking against uniform sampling of the same motions.
+//
+// The IRB 120 links are approximated by capsules along their DH offsets. Random motions between collision free
+// configurations are validated both ways; the table reports the time per motion and how many colliding motions
+// each uniform sampling resolution fails to detect.
+
+#include "robots/abb_irb_120.hpp"
+
+#include "serial.hpp"
+#include "collision/capsule.hpp"
+#include "collision/continuous.hpp"
+#include "collision/self_collision.hpp"
+#include "collision/self_distance.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/transform.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace rbt;
+using namespace rbt::collision;
+
+namespace {
+
+typedef std::pair<Angles, Angles> Motion;
+
+const Real LINK_RADIUS = 40;
+
+// A gripper extending past the flange along its Z axis
+const Real TOOL_LENGTH = 150;
+
+// A capsule in each link frame from the previous link frame's origin to its own.
+std::vector<Capsule> dhCapsules(const Serial& robot) {
+  std::vector<Capsule> capsules = { Capsule(Vector3({0, 0, 0}), Vector3({0, 0, 150}), 100) };
+
+  for(const auto& joint : robot.joints()) {
+    // The previous origin seen from this frame does not depend on the joint angle
+    const auto previous = inverse(RigidMatrix(joint.transform().dual))(Vector3());
+    capsules.push_back(Capsule(previous, Vector3(), LINK_RADIUS));
+  }
+
+  capsules.back().b = Vector3({0, 0, TOOL_LENGTH});
+
+  return capsules;
+}
+
+// Links two apart always meet at the wrist, so only pairs three or more links apart are checked.
+AllowedCollisionMatrix wristAllowed(std::size_t links) {
+  auto allowed = AllowedCollisionMatrix(links);
+  for(std::size_t i = 0; i + 2 < links; ++i) {
+    allowed.allow(i, i + 2);
+  }
+  return allowed;
+}
+
+Angles lerp(const Angles& a, const Angles& b, const Real& s) {
+  Angles result(a.size());
+  for(std::size_t j = 0; j < a.size(); ++j) {
+    result[j] = a[j] + s * (b[j] - a[j]);
+  }
+  return result;
+}
+
+// Sample n + 1 evenly spaced configurations including both endpoints.
+bool sampledCollision(const SelfDistance& proxies, const Motion& motion, std::size_t n) {
+  for(std::size_t i = 0; i <= n; ++i) {
+    if(proxies.distance(lerp(motion.first, motion.second, static_cast<Real>(i) / n)) <= 0) return true;
+  }
+  return false;
+}
+
+Angles randomConfiguration(const Serial& robot, std::mt19937& generator) {
+  Angles angles;
+  for(const auto& limit : robot.limits()) {
+    angles.push_back(std::uniform_real_distribution<Real>(limit[0], limit[1])(generator));
+  }
+  return angles;
+}
+
+// Motions between uniformly random collision free configurations. Most are easy to validate.
+std::vector<Motion> randomMotions(const Serial& robot, const SelfDistance& proxies, std::size_t count) {
+  std::mt19937 generator(1234);
+
+  const auto randomFreeConfiguration = [&]() {
+    while(true) {
+      const auto angles = randomConfiguration(robot, generator);
+      if(proxies.distance(angles) > 0) return angles;
+    }
+  };
+
+  std::vector<Motion> motions;
+  for(std::size_t i = 0; i < count; ++i) {
+    motions.emplace_back(randomFreeConfiguration(), randomFreeConfiguration());
+  }
+  return motions;
+}
+
+// Short motions through configurations where two links only just touch. These clip a link so briefly that
+// uniform sampling steps over the contact. The contact lies at a random fraction of the motion so it does not
+// coincide with the sampled configurations.
+std::vector<Motion> grazingMotions(const Serial& robot, const SelfDistance& proxies, std::size_t count) {
+  std::mt19937 generator(5678);
+  std::uniform_real_distribution<Real> offset(-toRadians(10), toRadians(10));
+  std::uniform_real_distribution<Real> fraction(0, 1);
+
+  std::vector<Motion> motions;
+  while(motions.size() < count) {
+    auto inside = randomConfiguration(robot, generator);
+    auto outside = randomConfiguration(robot, generator);
+    if(proxies.distance(inside) > 0 || proxies.distance(outside) <= 0) continue;
+
+    // Bisect towards a configuration penetrating by less than a millimeter
+    auto contact = inside;
+    for(int i = 0; i < 40; ++i) {
+      contact = lerp(inside, outside, 0.5);
+      const auto distance = proxies.distance(contact);
+      if(distance > 0) outside = contact;
+      else if(distance < -1) inside = contact;
+      else break;
+    }
+    if(proxies.distance(contact) > 0) continue;
+
+    const auto f = fraction(generator);
+    Angles start, end;
+    for(const auto& angle : contact) {
+      const auto delta = offset(generator);
+      start.push_back(angle - f * delta);
+      end.push_back(angle + (1 - f) * delta);
+    }
+
+    if(proxies.distance(start) > 0 && proxies.distance(end) > 0) motions.emplace_back(start, end);
+  }
+  return motions;
+}
+
+template <typename F>
+double microsecondsPerMotion(const std::vector<Motion>& motions, F&& check, std::size_t& detected) {
+  detected = 0;
+  const auto begin = std::chrono::steady_clock::now();
+
+  for(const auto& motion : motions) {
+    if(check(motion)) ++detected;
+  }
+
+  const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin);
+  return elapsed.count() / motions.size();
+}
+
+void compare(const std::string& name, const SelfDistance& proxies, const std::vector<Motion>& motions) {
+  const auto continuous = ContinuousSelfCollision(proxies);
+
+  std::size_t bisectionSteps = 0;
+  std::size_t reference = 0;
+  const auto bisectionTime = microsecondsPerMotion(motions, [&](const Motion& motion) {
+    const auto result = continuous.check(motion.first, motion.second);
+    bisectionSteps += result.steps;
+    return result.collides;
+  }, reference);
+
+  std::size_t advancementSteps = 0;
+  std::size_t advancementDetected = 0;
+  const auto advancementTime = microsecondsPerMotion(motions, [&](const Motion& motion) {
+    const auto result = continuous.firstContact(motion.first, motion.second);
+    advancementSteps += result.steps;
+    return result.collides;
+  }, advancementDetected);
+
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << name << ": " << motions.size() << " motions, " << reference << " colliding" << std::endl;
+  std::cout << std::setw(24) << "method" << std::setw(16) << "us / motion" << std::setw(16) << "evaluations"
+    << std::setw(12) << "missed" << std::endl;
+  std::cout << std::setw(24) << "continuous (bisection)" << std::setw(16) << bisectionTime
+    << std::setw(16) << static_cast<double>(bisectionSteps) / motions.size() << std::setw(12) << 0 << std::endl;
+  std::cout << std::setw(24) << "continuous (advancement)" << std::setw(16) << advancementTime
+    << std::setw(16) << static_cast<double>(advancementSteps) / motions.size()
+    << std::setw(12) << reference - advancementDetected << std::endl;
+
+  for(const std::size_t samples : { 10, 50, 200, 1000 }) {
+    std::size_t detected = 0;
+    const auto time = microsecondsPerMotion(motions, [&](const Motion& motion) {
+      return sampledCollision(proxies, motion, samples);
+    }, detected);
+
+    std::cout << std::setw(24) << ("uniform (" + std::to_string(samples) + ")") << std::setw(16) << time
+      << std::setw(16) << samples + 1 << std::setw(12) << reference - detected << std::endl;
+  }
+
+  std::cout << std::endl;
+}
+
+}
+
+int main() {
+  const auto robot = ABB_IRB_120;
+  const auto capsules = dhCapsules(robot);
+  const auto proxies = SelfDistance(robot, capsules, wristAllowed(capsules.size()));
+
+  compare("Random", proxies, randomMotions(robot, proxies, 200));
+  compare("Grazing", proxies, grazingMotions(robot, proxies, 200));
+}
@@ -0,0 +1,39 @@
+// Times convex hull construction over the vertices of the IRB 120 mesh in assets/meshes.
+
+#include "collision/convex_hull.hpp"
+#include "spatial/triangle.hpp"
+#include "visual/file_types/stl/stl_parser.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace rbt;
+using namespace rbt::collision;
+
+int main(int argc, char** argv) {
+  const std::string path = (argc > 1) ? argv[1] : ASSETS_DIRECTORY "/meshes/abb_irb_120.stl";
+
+  std::vector<Triangle> triangles;
+  visual::STLParser().parse(path, triangles);
+
+  const std::size_t repetitions = 20;
+  std::vector<double> times;
+  std::size_t vertices = 0, planes = 0;
+
+  for(std::size_t i = 0; i < repetitions; ++i) {
+    const auto begin = std::chrono::steady_clock::now();
+    const auto hull = ConvexHull(triangles);
+    times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+
+    vertices = hull.vertices().size();
+    planes = hull.planes().size();
+  }
+
+  std::sort(times.begin(), times.end());
+  std::cout << 3 * triangles.size() << " points -> " << vertices << " vertices, " << planes << " planes" << std::endl;
+  std::cout << "min " << times.front() << " ms, median " << times[times.size() / 2] << " ms, max " << times.back()
+    << " ms" << std::endl;
+}
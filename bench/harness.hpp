@@ -0,0 +1,142 @@
+#ifndef __HARNESS_HPP__
+#define __HARNESS_HPP__
+
+// A small benchmark runner shared by the benches: each benchmark is warmed up, then timed over repeated samples of a
+// fixed number of operations, and the per-operation times are summarized and written as text or JSON, along with
+// the build's optimization level and whether DEBUG and RBT_PROFILE were defined (either of which skews timings).
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef BENCH_OPTIMIZATION
+#define BENCH_OPTIMIZATION "unknown"
+#endif
+
+namespace bench {
+
+#ifdef DEBUG
+constexpr bool DEBUG_BUILD = true;
+#else
+constexpr bool DEBUG_BUILD = false;
+#endif
+
+#ifdef RBT_PROFILE
+constexpr bool PROFILE_BUILD = true;
+#else
+constexpr bool PROFILE_BUILD = false;
+#endif
+
+// Stop the compiler from optimizing away the computation of value.
+template <typename T>
+inline void keep(const T& value) {
+  asm volatile("" : : "r"(&value) : "memory");
+}
+
+struct Result {
+  std::string name;
+  // Operations per sample
+  std::size_t operations;
+  // Nanoseconds per operation, summarized over the samples
+  double median, mean, deviation, min, max;
+};
+
+class Suite {
+public:
+  std::size_t warmup = 3;
+  std::size_t repetitions = 20;
+
+  // Read --warmup N, --repetitions N and --json PATH from the command line.
+  Suite(int argc, char** argv) {
+    for(int i = 1; i + 1 < argc; i += 2) {
+      const std::string option = argv[i];
+      if(option == "--warmup") this->warmup = std::stoul(argv[i + 1]);
+      else if(option == "--repetitions") this->repetitions = std::max(1ul, std::stoul(argv[i + 1]));
+      else if(option == "--json") this->json = argv[i + 1];
+      else throw std::invalid_argument("Unknown option " + option);
+    }
+
+#ifndef __OPTIMIZE__
+    std::cerr << "Warning: benchmarks built without optimizations (set DEFINE_OPTIMIZE)" << std::endl;
+#endif
+    if(DEBUG_BUILD || PROFILE_BUILD) {
+      std::cerr << "Warning: benchmarks built with DEBUG or RBT_PROFILE (unset DEFINE_DEBUG and DEFINE_PROFILE)" << std::endl;
+    }
+  }
+
+  // Time f(), which performs the given number of operations, and print the result.
+  template <typename F>
+  void run(const std::string& name, std::size_t operations, const F& f) {
+    for(std::size_t i = 0; i < this->warmup; ++i) f();
+
+    std::vector<double> times;
+    for(std::size_t i = 0; i < this->repetitions; ++i) {
+      const auto begin = std::chrono::steady_clock::now();
+      f();
+      const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+      times.push_back(elapsed / static_cast<double>(operations));
+    }
+    std::sort(times.begin(), times.end());
+
+    const auto mean = std::accumulate(times.begin(), times.end(), 0.0) / static_cast<double>(times.size());
+    double variance = 0;
+    for(const auto time : times) variance += (time - mean) * (time - mean);
+    variance /= static_cast<double>(std::max<std::size_t>(1, times.size() - 1));
+
+    const auto middle = times.size() / 2;
+    const auto median = (times.size() % 2 == 1) ? times[middle] : (times[middle - 1] + times[middle]) / 2;
+
+    this->results.push_back(Result{ name, operations, median, mean, std::sqrt(variance), times.front(), times.back() });
+
+    const auto& result = this->results.back();
+    std::cout << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(1)
+      << " median " << std::setw(10) << result.median << " ns, min " << std::setw(10) << result.min
+      << " ns, max " << std::setw(10) << result.max << " ns, sd " << std::setw(6) << std::setprecision(1)
+      << ((result.mean > 0) ? 100 * result.deviation / result.mean : 0) << "%" << std::endl;
+  }
+
+  // Write the results as JSON to the --json path, if given.
+  void finish() const {
+    if(this->json.empty()) return;
+
+    auto file = std::ofstream(this->json, std::ios::out | std::ios::trunc);
+    if(!file.is_open()) throw std::runtime_error("Couldn't create " + this->json);
+
+    file << std::setprecision(6) << "{\n";
+    file << "  \"time\": " << std::time(nullptr) << ",\n";
+    file << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+    file << "  \"optimization\": \"" << BENCH_OPTIMIZATION << "\",\n";
+    file << "  \"debug\": " << (DEBUG_BUILD ? "true" : "false") << ",\n";
+    file << "  \"profile\": " << (PROFILE_BUILD ? "true" : "false") << ",\n";
+    file << "  \"warmup\": " << this->warmup << ",\n";
+    file << "  \"repetitions\": " << this->repetitions << ",\n";
+    file << "  \"benchmarks\": [";
+    for(std::size_t i = 0; i < this->results.size(); ++i) {
+      const auto& result = this->results[i];
+      file << ((i == 0) ? "\n" : ",\n")
+        << "    {\"name\": \"" << result.name << "\", \"operations\": " << result.operations
+        << ", \"unit\": \"ns\", \"median\": " << result.median << ", \"mean\": " << result.mean
+        << ", \"deviation\": " << result.deviation << ", \"min\": " << result.min << ", \"max\": " << result.max << "}";
+    }
+    file << "\n  ]\n}\n";
+
+    if(!file) throw std::runtime_error("Couldn't write " + this->json);
+  }
+
+private:
+  std::string json;
+  std::vector<Result> results;
+};
+
+}
+
+#endif /* __HARNESS_HPP__ */
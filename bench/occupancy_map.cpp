@@ -0,0 +1,61 @@
+// Times inserting a million point cloud of a cluttered workcell into an occupancy map, then checking random IRB 120
+// configurations against it with capsule link proxies.
+
+#include "robots/abb_irb_120.hpp"
+
+#include "collision/capsule.hpp"
+#include "collision/occupancy_map.hpp"
+#include "spatial/points.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace rbt;
+using namespace rbt::collision;
+
+int main() {
+  const auto robot = ABB_IRB_120;
+  std::vector<Capsule> proxies(1, Capsule(Vector3({0, 0, 0}), Vector3({0, 0, 200}), 80));
+  for(std::size_t link = 1; link <= robot.joints().size(); ++link) {
+    proxies.push_back(Capsule(Vector3({-40, 0, 0}), Vector3({40, 0, 0}), 50));
+  }
+
+  // Boxes scattered around the robot, sampled on their surfaces as a depth camera would see them
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<Real> place(-900, 900), unit(0, 1);
+  Points cloud;
+  for(std::size_t box = 0; box < 40; ++box) {
+    const auto center = Vector3({ place(generator), place(generator), Real(0.5) * place(generator) + 450 });
+    for(std::size_t i = 0; i < 25000; ++i) {
+      auto p = Vector3({ unit(generator), unit(generator), unit(generator) });
+      p[i % 3] = (i % 2) ? Real(1) : Real(0);
+      cloud.push_back(center + Real(120) * p);
+    }
+  }
+
+  auto map = OccupancyMap(10);
+  const auto insertBegin = std::chrono::steady_clock::now();
+  map.insert(cloud);
+  const auto insertTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - insertBegin).count();
+
+  std::uniform_real_distribution<Real> angle(-2, 2);
+  std::vector<double> times;
+  std::size_t colliding = 0, coarse = 0;
+  for(std::size_t i = 0; i < 10000; ++i) {
+    const Angles angles = { angle(generator), angle(generator), angle(generator), angle(generator), angle(generator), angle(generator) };
+
+    const auto begin = std::chrono::steady_clock::now();
+    colliding += map.inCollision(robot, proxies, angles);
+    times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count());
+
+    coarse += map.inCollision(robot, proxies, angles, 3);
+  }
+
+  std::sort(times.begin(), times.end());
+  std::cout << cloud.size() << " points -> " << map.count() << " voxels in " << insertTime << " ms" << std::endl;
+  std::cout << "configuration check: median " << times[times.size() / 2] << " us, max " << times.back() << " us; "
+    << colliding << " of " << times.size() << " colliding (" << coarse << " at level 3)" << std::endl;
+}
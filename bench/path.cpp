@@ -0,0 +1,52 @@
+// Times Cartesian path evaluation for the IRB 120 from test/robots: poses along a circular (MoveC) path one at a
+// time and in batches, the fused path to joint angles pipeline and timing the joint path.
+
+#include "harness.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "frame.hpp"
+#include "path.hpp"
+#include "timing.hpp"
+#include "utilities.hpp"
+
+#include <vector>
+
+using namespace rbt;
+
+int main(int argc, char** argv) {
+  auto suite = bench::Suite(argc, argv);
+  const auto& robot = ABB_IRB_120;
+
+  const auto start = Angles({ toRadians(10), toRadians(20), toRadians(-10), toRadians(30), toRadians(40), toRadians(-20) });
+  const auto via = Angles({ toRadians(-10), toRadians(30), toRadians(0), toRadians(0), toRadians(50), toRadians(0) });
+  const auto end = Angles({ toRadians(-30), toRadians(10), toRadians(5), toRadians(-20), toRadians(60), toRadians(10) });
+  const auto path = CartesianPath::circular(robot.pose(start), robot.pose(via), robot.pose(end));
+
+  const auto s = path.samples(0.01);
+  std::vector<Frame> frames(s.size());
+  std::cout << s.size() << " poses along a " << path.length() << " mm arc" << std::endl;
+
+  suite.run("pose at a time", s.size(), [&]() {
+    for(std::size_t i = 0; i < s.size(); ++i) frames[i] = path(s[i]);
+    bench::keep(frames);
+  });
+
+  suite.run("batch", s.size(), [&]() {
+    path.evaluate(s, frames);
+    bench::keep(frames);
+  });
+
+  const auto resolution = Real(0.1);
+  suite.run("jointPath", path.samples(resolution).size(), [&]() {
+    const auto joints = jointPath(path, robot, start, resolution);
+    bench::keep(joints);
+  });
+
+  const auto joints = jointPath(path, robot, start, resolution);
+  suite.run("timeOptimal", joints.size(), [&]() {
+    const auto times = timeOptimal(joints, robot);
+    bench::keep(times);
+  });
+
+  suite.finish();
+}
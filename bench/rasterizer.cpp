@@ -0,0 +1,56 @@
+// Times 640 x 480 depth renders of the IRB 120 mesh in assets/meshes. The asset is a single mesh of the whole robot,
+// so it is rendered as the base link, seen from around the robot.
+
+#include "robots/abb_irb_120.hpp"
+
+#include "spatial/triangle.hpp"
+#include "utilities.hpp"
+#include "visual/file_types/stl/stl_parser.hpp"
+#include "visual/rasterizer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace rbt;
+using namespace rbt::visual;
+
+int main(int argc, char** argv) {
+  const std::string path = (argc > 1) ? argv[1] : ASSETS_DIRECTORY "/meshes/abb_irb_120.stl";
+
+  std::vector<Mesh> links(ABB_IRB_120.joints().size() + 1);
+  STLParser().parse(path, links[0]);
+
+  auto rasterizer = Rasterizer(ABB_IRB_120, links);
+  const Angles home = { 0, 0, 0, 0, 0, 0 };
+
+  const std::size_t frames = 100;
+  DepthImage image;
+
+  for(const auto normals : { false, true }) {
+    std::vector<double> times;
+    std::size_t covered = 0;
+
+    for(std::size_t i = 0; i < frames; ++i) {
+      const auto angle = 2 * PI * Real(i) / Real(frames);
+      const auto eye = Vector3({ 1200 * std::cos(angle), 1200 * std::sin(angle), 600 });
+      const auto camera = Camera::with_field_of_view(640, 480, toRadians(60), look_at(eye, Vector3({ 200, 0, 400 })));
+
+      const auto begin = std::chrono::steady_clock::now();
+      rasterizer.render(camera, home, image, normals);
+      times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+
+      covered += static_cast<std::size_t>(std::count_if(image.depth.begin(), image.depth.end(), [](Real d) { return d != INF; }));
+    }
+
+    std::sort(times.begin(), times.end());
+    std::cout << (normals ? "depth and normals" : "depth") << ": median " << times[times.size() / 2] << " ms ("
+      << 1e3 / times[times.size() / 2] << " frames/s), max " << times.back() << " ms, "
+      << covered / frames << " pixels covered" << std::endl;
+  }
+
+  std::cout << links[0].size() << " triangles" << std::endl;
+}
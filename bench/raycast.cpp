@@ -0,0 +1,64 @@
+// Times scanner-like ray casting against the IRB 120 mesh in assets/meshes: a sensor beside the robot sweeps a fan
+// of beams across it, first by first hit and then by any hit.
+
+#include "collision/bvh.hpp"
+#include "collision/raycast.hpp"
+#include "spatial/points.hpp"
+#include "spatial/triangle.hpp"
+#include "utilities.hpp"
+#include "visual/file_types/stl/stl_parser.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace rbt;
+using namespace rbt::collision;
+
+int main(int argc, char** argv) {
+  const std::string path = (argc > 1) ? argv[1] : ASSETS_DIRECTORY "/meshes/abb_irb_120.stl";
+
+  std::vector<Triangle> triangles;
+  visual::STLParser().parse(path, triangles);
+  const auto bvh = BVH(triangles);
+  const auto box = bvh.bounds();
+  const auto center = box.center();
+
+  // A grid of beams fanning out from a sensor in front of the robot, covering its bounds
+  const std::size_t columns = 512, rows = 256;
+  const auto sensor = center + Vector3({ 3 * box.extent()[0], 0, 0 });
+  Points origins, directions;
+  for(std::size_t row = 0; row < rows; ++row) {
+    for(std::size_t column = 0; column < columns; ++column) {
+      const auto y = box.min[1] + (box.max[1] - box.min[1]) * Real(column) / Real(columns - 1);
+      const auto z = box.min[2] + (box.max[2] - box.min[2]) * Real(row) / Real(rows - 1);
+      origins.push_back(sensor);
+      directions.push_back(Vector3({ center[0], y, z }) - sensor);
+    }
+  }
+
+  const std::size_t repetitions = 10;
+  std::vector<RayHit> hits;
+  std::vector<uint8_t> occluded;
+
+  const auto time = [&](const char* name, auto f) {
+    std::vector<double> times;
+    for(std::size_t i = 0; i < repetitions; ++i) {
+      const auto begin = std::chrono::steady_clock::now();
+      f();
+      times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+    }
+    std::sort(times.begin(), times.end());
+    std::cout << name << ": median " << 1e3 * times[times.size() / 2] << " ms, "
+      << Real(origins.size()) / times[times.size() / 2] / 1e6 << " Mrays/s" << std::endl;
+  };
+
+  time("first hit", [&]() { raycast(bvh, origins, directions, hits); });
+  time("any hit", [&]() { collision::occluded(bvh, origins, directions, occluded); });
+
+  const auto hit = std::count_if(hits.begin(), hits.end(), [](const RayHit& h) { return h.hit(); });
+  std::cout << triangles.size() << " triangles, " << origins.size() << " rays, " << hit << " hits" << std::endl;
+}
@@ -0,0 +1,97 @@
+// Replays a capture of inverse and forward kinematics requests (see utils/capture.hpp) for the IRB 120 from
+// test/robots, on one thread and then on every hardware thread, reporting the throughput and latency distribution
+// of each kind of request. Without a capture file, replays a synthetic one of random reachable poses.
+
+#include "robots/abb_irb_120.hpp"
+
+#include "ik.hpp"
+#include "serial.hpp"
+#include "utilities.hpp"
+#include "utils/capture.hpp"
+#include "utils/metrics.hpp"
+#include "utils/parallel.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace rbt;
+using rbt::capture::Request;
+
+namespace {
+
+std::vector<Request> synthetic(std::size_t count) {
+  std::mt19937 generator(45);
+  std::vector<Request> requests;
+
+  for(std::size_t i = 0; i < count; ++i) {
+    Angles angles;
+    for(const auto& limits : ABB_IRB_120.limits()) {
+      angles.push_back(std::uniform_real_distribution<Real>(limits[0], limits[1])(generator));
+    }
+
+    if(i % 2 == 0) requests.push_back(Request{ Request::Kind::INVERSE, 0, ABB_IRB_120.pose(angles), Angles() });
+    else requests.push_back(Request{ Request::Kind::FORWARD, 0, Frame(), angles });
+  }
+  return requests;
+}
+
+void replay(const std::string& name, const std::vector<Request>& requests, std::size_t threads) {
+  metrics::Histogram latency;
+  std::size_t solutions = 0;
+
+  const auto serve = [&](std::size_t begin, std::size_t end) {
+    std::size_t found = 0;
+    for(auto i = begin; i < end; ++i) {
+      const metrics::Stopwatch stopwatch(latency);
+      const auto& request = requests[i];
+      if(request.kind == Request::Kind::INVERSE) found += ik::angles(request.pose, ABB_IRB_120).size();
+      else found += (ABB_IRB_120.pose(request.angles).position()[2] > 0);
+    }
+    return found;
+  };
+
+  const auto begin = std::chrono::steady_clock::now();
+  if(threads == 1) {
+    solutions = serve(0, requests.size());
+  } else {
+    std::vector<std::size_t> found(requests.size());
+    parallel_for(requests.size(), [&](std::size_t first, std::size_t last) { found[first] = serve(first, last); });
+    for(const auto count : found) solutions += count;
+  }
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+  const auto distribution = latency.distribution();
+  std::cout << std::left << std::setw(10) << name << std::right << std::setw(3) << threads << " threads: "
+    << std::setw(8) << requests.size() << " requests, " << std::fixed << std::setprecision(1)
+    << std::setw(8) << static_cast<double>(requests.size()) / seconds / 1e3 << " k/s, latency us p50 "
+    << std::setprecision(2) << static_cast<double>(distribution.quantile(0.5)) / 1e3 << ", p99 "
+    << static_cast<double>(distribution.quantile(0.99)) / 1e3 << ", p99.9 "
+    << static_cast<double>(distribution.quantile(0.999)) / 1e3 << ", max "
+    << static_cast<double>(distribution.max) / 1e3 << ", " << solutions << " results" << std::endl;
+}
+
+}
+
+int main(int argc, char** argv) {
+  const auto requests = (argc > 1) ? capture::read(argv[1]) : synthetic(200000);
+
+  // Only the requests of the IRB 120, in their captured order for the mixed replay
+  std::vector<Request> inverse, forward, mixed;
+  for(const auto& request : requests) {
+    if(request.robot != 0) continue;
+    (request.kind == Request::Kind::INVERSE ? inverse : forward).push_back(request);
+    mixed.push_back(request);
+  }
+  std::cout << requests.size() << " requests, replaying " << mixed.size() << " for robot 0" << std::endl;
+
+  for(const auto threads : { std::size_t(1), hardware_threads() }) {
+    replay("inverse", inverse, threads);
+    replay("forward", forward, threads);
+    replay("mixed", mixed, threads);
+    if(hardware_threads() == 1) break;
+  }
+}
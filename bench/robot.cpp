@@ -0,0 +1,117 @@
+// Times the core kinematics of the IRB 120 from test/robots: quaternion and dual quaternion products, joint
+// transforms, forward kinematics and inverse kinematics (over random reachable poses), and parsing its STL mesh.
+// Inputs are drawn from a fixed seed, so runs are comparable. Pass --json PATH to record the results.
+
+#include "harness.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "frame.hpp"
+#include "ik.hpp"
+#include "joint.hpp"
+#include "spatial/dual.hpp"
+#include "spatial/quaternion.hpp"
+#include "spatial/transform.hpp"
+#include "spatial/triangle.hpp"
+#include "utilities.hpp"
+#include "visual/file_types/stl/stl_parser.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace rbt;
+
+namespace {
+
+// Inputs per sample for the kinematics benchmarks.
+const std::size_t BATCH = 1024;
+
+Quaternion randomRotation(std::mt19937& generator) {
+  std::normal_distribution<Real> component(0, 1);
+  return normalize(Quaternion(component(generator), component(generator), component(generator), component(generator)));
+}
+
+// Angles uniformly within the joint limits, so their poses are reachable.
+Angles randomAngles(const Serial& robot, std::mt19937& generator) {
+  Angles angles;
+  for(const auto& limits : robot.limits()) {
+    angles.push_back(std::uniform_real_distribution<Real>(limits[0], limits[1])(generator));
+  }
+  return angles;
+}
+
+}
+
+int main(int argc, char** argv) {
+  auto suite = bench::Suite(argc, argv);
+  std::mt19937 generator(120);
+  const auto& robot = ABB_IRB_120;
+
+  std::vector<Quaternion> rotations, others;
+  std::vector<Dual<Quaternion>> transforms, otherTransforms;
+  std::vector<Real> thetas;
+  AngleSets angleSets;
+  std::vector<Frame> targets;
+
+  std::uniform_real_distribution<Real> angle(-PI, PI);
+  for(std::size_t i = 0; i < BATCH; ++i) {
+    rotations.push_back(randomRotation(generator));
+    others.push_back(randomRotation(generator));
+    transforms.push_back(Transform(Vector3({ 0, 0, 1 }), angle(generator), Vector3({ angle(generator), 1, 2 })).dual);
+    otherTransforms.push_back(Transform(Vector3({ 1, 0, 0 }), angle(generator), Vector3({ 3, angle(generator), 1 })).dual);
+    thetas.push_back(angle(generator));
+    angleSets.push_back(randomAngles(robot, generator));
+    targets.push_back(robot.pose(randomAngles(robot, generator)));
+  }
+
+  std::vector<Quaternion> products(BATCH);
+  suite.run("quaternion product", BATCH, [&]() {
+    for(std::size_t i = 0; i < BATCH; ++i) products[i] = rotations[i] * others[i];
+    bench::keep(products);
+  });
+
+  std::vector<Dual<Quaternion>> dualProducts(BATCH);
+  suite.run("dual quaternion product", BATCH, [&]() {
+    for(std::size_t i = 0; i < BATCH; ++i) dualProducts[i] = transforms[i] * otherTransforms[i];
+    bench::keep(dualProducts);
+  });
+
+  const auto joint = robot.joints()[1];
+  suite.run("Joint::transform", BATCH, [&]() {
+    for(std::size_t i = 0; i < BATCH; ++i) {
+      const auto t = joint.transform(thetas[i]);
+      bench::keep(t);
+    }
+  });
+
+  suite.run("Serial::pose", BATCH, [&]() {
+    for(const auto& angles : angleSets) {
+      const auto pose = robot.pose(angles);
+      bench::keep(pose);
+    }
+  });
+
+  suite.run("Serial::poses", BATCH, [&]() {
+    for(const auto& angles : angleSets) {
+      const auto poses = robot.poses(angles);
+      bench::keep(poses);
+    }
+  });
+
+  std::size_t solutions = 0;
+  suite.run("ik::angles", BATCH, [&]() {
+    for(const auto& target : targets) {
+      const auto sets = ik::angles(target, robot);
+      solutions += sets.size();
+      bench::keep(sets);
+    }
+  });
+
+  suite.run("STLParser::parse", 1, [&]() {
+    std::vector<Triangle> triangles;
+    visual::STLParser().parse(ASSETS_DIRECTORY "/meshes/abb_irb_120.stl", triangles);
+    bench::keep(triangles);
+  });
+
+  suite.finish();
+  bench::keep(solutions);
+}
@@ -0,0 +1,62 @@
+// Times self-collision checks of the IRB 120 from test/robots, with a sphere about the origin of each link frame: any
+// collision, and every colliding pair, at random configurations.
+
+#include "harness.hpp"
+#include "meshes/box.hpp"
+#include "meshes/sphere.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "collision/self_collision.hpp"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace rbt;
+using namespace rbt::collision;
+
+namespace {
+
+// Configurations per sample
+const std::size_t BATCH = 1024;
+
+}
+
+int main(int argc, char** argv) {
+  auto suite = bench::Suite(argc, argv);
+  const auto& robot = ABB_IRB_120;
+
+  std::vector<Mesh> links(1, box(Vector3({-100, -100, 0}), Vector3({100, 100, 200})));
+  for(std::size_t link = 1; link <= robot.joints().size(); ++link) links.push_back(sphere(Vector3(), 30));
+  const auto checker = SelfCollision(robot, links);
+
+  std::mt19937 generator(27);
+  std::vector<Angles> configurations;
+  for(std::size_t i = 0; i < BATCH; ++i) {
+    Angles angles;
+    for(const auto& limits : robot.limits()) {
+      angles.push_back(std::uniform_real_distribution<Real>(limits[0], limits[1])(generator));
+    }
+    configurations.push_back(angles);
+  }
+
+  std::size_t colliding = 0;
+  for(const auto& angles : configurations) colliding += checker.inCollision(angles);
+  std::cout << colliding << " of " << BATCH << " configurations in collision" << std::endl;
+
+  // As a planner would, reusing its scratch space
+  SelfCollision::Scratch scratch;
+  suite.run("in collision", BATCH, [&]() {
+    for(const auto& angles : configurations) bench::keep(checker.inCollision(angles, scratch));
+  });
+
+  std::vector<LinkPair> pairs;
+  suite.run("colliding pairs", BATCH, [&]() {
+    for(const auto& angles : configurations) {
+      checker.collisions(angles, pairs, scratch);
+      bench::keep(pairs);
+    }
+  });
+
+  suite.finish();
+}
@@ -0,0 +1,60 @@
+// Times self-distance queries of the IRB 120 from test/robots, with a capsule fitted to a box around each link: the
+// smallest distance over all pairs of links, and the distance of each pair, at random configurations.
+
+#include "harness.hpp"
+#include "meshes/box.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "collision/self_distance.hpp"
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace rbt;
+using namespace rbt::collision;
+
+namespace {
+
+// Configurations per sample
+const std::size_t BATCH = 1024;
+
+}
+
+int main(int argc, char** argv) {
+  auto suite = bench::Suite(argc, argv);
+  const auto& robot = ABB_IRB_120;
+
+  std::vector<Mesh> links(1, box(Vector3({-100, -100, 0}), Vector3({100, 100, 200})));
+  for(std::size_t link = 1; link <= robot.joints().size(); ++link) {
+    links.push_back(box(Vector3({-40, -40, -40}), Vector3({40, 40, 40})));
+  }
+  const auto proxies = SelfDistance(robot, links);
+  std::cout << proxies.pairs().size() << " pairs of links" << std::endl;
+
+  std::mt19937 generator(28);
+  std::vector<Angles> configurations;
+  for(std::size_t i = 0; i < BATCH; ++i) {
+    Angles angles;
+    for(const auto& limits : robot.limits()) {
+      angles.push_back(std::uniform_real_distribution<Real>(limits[0], limits[1])(generator));
+    }
+    configurations.push_back(angles);
+  }
+
+  // As a monitoring loop would, reusing its scratch space
+  SelfDistance::Scratch scratch;
+  suite.run("self distance", BATCH, [&]() {
+    for(const auto& angles : configurations) bench::keep(proxies.distance(angles, scratch));
+  });
+
+  std::vector<Real> distances;
+  suite.run("self distances of each pair", BATCH, [&]() {
+    for(const auto& angles : configurations) {
+      proxies.distances(angles, distances, scratch);
+      bench::keep(distances);
+    }
+  });
+
+  suite.finish();
+}
@@ -0,0 +1,52 @@
+// Times filtering a million point cloud, scattered through the IRB 120's workspace, against box links.
+
+#include "meshes/box.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "collision/self_filter.hpp"
+#include "spatial/points.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace rbt;
+using namespace rbt::collision;
+
+int main() {
+  const auto robot = ABB_IRB_120;
+  std::vector<Mesh> links(1, box(Vector3({-100, -100, 0}), Vector3({100, 100, 200})));
+  for(std::size_t link = 1; link <= robot.joints().size(); ++link) {
+    links.push_back(box(Vector3({-40, -40, -40}), Vector3({40, 40, 40})));
+  }
+  const auto filter = SelfFilter(robot, links, 10);
+
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<Real> coordinate(-800, 800);
+  Points cloud;
+  for(std::size_t i = 0; i < 1000000; ++i) {
+    cloud.push_back(Vector3({ coordinate(generator), coordinate(generator), Real(0.5) * coordinate(generator) + 400 }));
+  }
+
+  std::uniform_real_distribution<Real> angle(-1, 1);
+  std::vector<uint8_t> inside;
+  std::vector<double> times;
+  std::size_t removed = 0;
+
+  for(std::size_t i = 0; i < 50; ++i) {
+    const Angles angles = { angle(generator), angle(generator), angle(generator), angle(generator), angle(generator), angle(generator) };
+
+    const auto begin = std::chrono::steady_clock::now();
+    filter.inside(angles, cloud, inside);
+    times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+
+    removed += static_cast<std::size_t>(std::count(inside.begin(), inside.end(), 1));
+  }
+
+  std::sort(times.begin(), times.end());
+  std::cout << cloud.size() << " points, " << removed / times.size() << " on the robot on average" << std::endl;
+  std::cout << "min " << times.front() << " ms, median " << times[times.size() / 2] << " ms, max " << times.back()
+    << " ms" << std::endl;
+}
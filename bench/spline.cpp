@@ -0,0 +1,74 @@
+// Times joint splines for the IRB 120 from test/robots: fitting them to a timed joint path, and sampling the angles,
+// velocities and accelerations at the control rate a time at a time and in chunks.
+
+#include "harness.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "path.hpp"
+#include "spline.hpp"
+#include "timing.hpp"
+#include "utilities.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace rbt;
+
+int main(int argc, char** argv) {
+  auto suite = bench::Suite(argc, argv);
+  const auto& robot = ABB_IRB_120;
+
+  const auto start = Angles({ toRadians(10), toRadians(20), toRadians(-10), toRadians(30), toRadians(40), toRadians(-20) });
+  const auto via = Angles({ toRadians(-10), toRadians(30), toRadians(0), toRadians(0), toRadians(50), toRadians(0) });
+  const auto end = Angles({ toRadians(-30), toRadians(10), toRadians(5), toRadians(-20), toRadians(60), toRadians(10) });
+  const auto path = CartesianPath::circular(robot.pose(start), robot.pose(via), robot.pose(end));
+  const auto waypoints = jointPath(path, robot, start, 1);
+  const auto times = timeOptimal(waypoints, robot);
+
+  suite.run("fit cubic", waypoints.size(), [&]() {
+    const auto spline = JointSpline::cubic(waypoints, times);
+    bench::keep(spline);
+  });
+
+  suite.run("fit quintic", waypoints.size(), [&]() {
+    const auto spline = JointSpline::quintic(waypoints, times);
+    bench::keep(spline);
+  });
+
+  // Sampled at 4 kHz
+  const auto spline = JointSpline::quintic(waypoints, times);
+  std::vector<Real> samples;
+  for(Real time = spline.start(); time < spline.end(); time += Real(0.00025)) samples.push_back(time);
+  std::cout << waypoints.size() << " waypoints over " << spline.end() << " s, " << samples.size() << " samples"
+    << std::endl;
+
+  Angles angles;
+  suite.run("angles at a time", samples.size(), [&]() {
+    for(const auto time : samples) {
+      angles = spline(time);
+      bench::keep(angles);
+    }
+  });
+
+  // A chunk at a time, as a consumer would without storing the trajectory
+  const std::size_t chunk = 256;
+  std::vector<Real> positions(chunk * 6), velocities(chunk * 6), accelerations(chunk * 6);
+  suite.run("evaluate positions", samples.size(), [&]() {
+    for(std::size_t i = 0; i < samples.size(); i += chunk) {
+      spline.evaluate(&samples[i], std::min(chunk, samples.size() - i), positions.data());
+      bench::keep(positions);
+    }
+  });
+
+  suite.run("evaluate states", samples.size(), [&]() {
+    for(std::size_t i = 0; i < samples.size(); i += chunk) {
+      const auto count = std::min(chunk, samples.size() - i);
+      spline.evaluate(&samples[i], count, positions.data(), velocities.data(), accelerations.data());
+      bench::keep(positions);
+      bench::keep(velocities);
+      bench::keep(accelerations);
+    }
+  });
+
+  suite.finish();
+}
@@ -0,0 +1,99 @@
+// Times the online trajectory generator for the IRB 120 from test/robots: updates cycle by cycle along whole moves,
+// and from random states, with the median and slowest single updates of each. Each single update is timed as the
+// fastest of a few passes, so the slowest is that of the planning rather than of an interrupt. Fails if any single
+// update takes longer than SLOWEST.
+
+#include "harness.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "trajectory.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace rbt;
+
+namespace {
+
+// The longest a single update may take, in ns: the few microseconds include/trajectory.hpp bounds an update to
+const double SLOWEST = 5000;
+
+// Print and return the median and slowest of updates from the states onto the targets, made in order (each starting its search
+// from the plan of the one before, as it would in use).
+double single(OnlineTrajectory& generator, const std::string& name, const std::vector<JointState>& states,
+  const std::vector<JointTarget>& targets) {
+  std::vector<double> times(states.size(), std::numeric_limits<double>::infinity());
+  JointState next;
+  for(int run = 0; run < 5; ++run) {
+    for(std::size_t i = 0; i < states.size(); ++i) {
+      const auto begin = std::chrono::steady_clock::now();
+      generator.update(states[i], targets[i], next);
+      bench::keep(next);
+      times[i] = std::min(times[i], std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count());
+    }
+  }
+  std::sort(times.begin(), times.end());
+  std::cout << name << ": median " << times[times.size() / 2] << " ns, slowest " << times.back() << " ns" << std::endl;
+  return times.back();
+}
+
+}
+
+int main(int argc, char** argv) {
+  auto suite = bench::Suite(argc, argv);
+  auto generator = OnlineTrajectory(ABB_IRB_120, 0.001);
+  const auto limits = ABB_IRB_120.motionLimits();
+
+  JointTarget target;
+  target.position = { 1, -0.5, 0.3, 2, -1, 3 };
+  JointState state, next;
+  std::vector<JointState> move;
+  while(!generator.update(state, target, next)) {
+    move.push_back(state);
+    state = next;
+  }
+  const auto cycles = move.size();
+  std::cout << cycles << " cycles of 1 ms to the target" << std::endl;
+
+  suite.run("update along a move", cycles, [&]() {
+    auto current = JointState();
+    for(std::size_t i = 0; i < cycles; ++i) {
+      generator.update(current, target, next);
+      current = next;
+    }
+    bench::keep(current);
+  });
+
+  std::mt19937 random(1);
+  std::uniform_real_distribution<Real> fraction(-0.9, 0.9);
+  std::vector<JointState> states(1000);
+  std::vector<JointTarget> targets(states.size());
+  for(std::size_t i = 0; i < states.size(); ++i) {
+    for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+      states[i].position[j] = 3 * fraction(random);
+      states[i].velocity[j] = limits[j].velocity * fraction(random) / 2;
+      states[i].acceleration[j] = limits[j].acceleration * fraction(random);
+      targets[i].position[j] = 3 * fraction(random);
+      targets[i].velocity[j] = limits[j].velocity * fraction(random) / 2;
+    }
+  }
+
+  suite.run("update from random states", states.size(), [&]() {
+    for(std::size_t i = 0; i < states.size(); ++i) generator.update(states[i], targets[i], next);
+    bench::keep(next);
+  });
+
+  auto slowest = single(generator, "single updates along a move", move, std::vector<JointTarget>(cycles, target));
+  slowest = std::max(slowest, single(generator, "single updates from random states", states, targets));
+
+  suite.finish();
+
+  if(slowest > SLOWEST) {
+    std::cerr << "A single update took " << slowest << " ns, over " << SLOWEST << " ns" << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,51 @@
+// Times pose errors for a controller tracking many targets: the twist from one pose to each target, a pose at a time
+// and in batches, and moving the poses back by the twists.
+
+#include "harness.hpp"
+
+#include "spatial/dual.hpp"
+#include "spatial/transform.hpp"
+#include "spatial/twist.hpp"
+#include "utilities.hpp"
+
+#include <random>
+#include <vector>
+
+using namespace rbt;
+
+int main(int argc, char** argv) {
+  auto suite = bench::Suite(argc, argv);
+
+  std::mt19937 generator(3);
+  std::uniform_real_distribution<Real> component(-1, 1);
+  std::uniform_real_distribution<Real> angle(-180, 180);
+
+  const std::size_t count = 4096;
+  Poses targets;
+  for(std::size_t i = 0; i < count; ++i) {
+    const auto axis = unit(Vector3({ component(generator), component(generator), component(generator) }));
+    const auto translation = Vector3({ component(generator), component(generator), component(generator) });
+    targets.push_back(Transform(axis, toRadians(angle(generator)), translation).dual);
+  }
+  const auto current = Transform(unit(Vector3({1, 2, 3})), toRadians(30), Vector3({0.1, 0.2, 0.3})).dual;
+
+  std::vector<Twist> errors(count);
+  suite.run("twist at a time", count, [&]() {
+    for(std::size_t i = 0; i < count; ++i) errors[i] = twist(current, targets[i]);
+    bench::keep(errors);
+  });
+
+  Twists batch;
+  suite.run("twists", count, [&]() {
+    twists(current, targets, batch);
+    bench::keep(batch.wx);
+  });
+
+  Poses moved;
+  suite.run("displacements", count, [&]() {
+    displacements(batch, moved);
+    bench::keep(moved.rr);
+  });
+
+  suite.finish();
+}
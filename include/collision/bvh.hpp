@@ -0,0 +1,114 @@
+#ifndef __BVH_HPP__
+#define __BVH_HPP__
+
+#include "typedefs.hpp"
+#include "utilities.hpp"
+#include "spatial/aabb.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace rbt::collision {
+
+// A bounding volume hierarchy over a triangle mesh (e.g. the triangles produced by STLParser).
+// The tree is built top-down with a binned surface area heuristic and stored as a flat, depth-first array of nodes.
+class BVH {
+public:
+  // A 32 byte node. The first child of an interior node immediately follows it in the array; the second child is
+  // found at `offset` nodes past the parent. Leaves reference `count` consecutive triangles starting at `offset`.
+  struct Node {
+    Real min[3];
+    Real max[3];
+    uint32_t offset;
+    uint16_t count;
+    uint8_t axis;
+    uint8_t padding;
+
+    inline bool isLeaf() const { return this->count != 0; };
+    inline AABB box() const {
+      return AABB(Vector3({ min[0], min[1], min[2] }), Vector3({ max[0], max[1], max[2] }));
+    };
+  };
+
+  // The result of a closest point query.
+  struct Closest {
+    Vector3 point;
+    Real distance;
+    // Index of the triangle in the order it was given to the constructor.
+    std::size_t triangle;
+  };
+
+  // Number of centroid bins evaluated per axis when choosing a split.
+  static constexpr std::size_t SAH_BINS = 16;
+
+  // Ranges at or below this size are always made leaves.
+  static constexpr std::size_t MIN_LEAF_SIZE = 2;
+
+  // Ranges above this size are always split.
+  static constexpr std::size_t MAX_LEAF_SIZE = 16;
+
+  // Subtrees with more triangles than this are built on their own thread.
+  static constexpr std::size_t PARALLEL_THRESHOLD = 4096;
+
+  BVH(const std::vector<Triangle>& triangles);
+
+  // Recompute node bounds for moved vertices. The triangles must be given in their original order and topology.
+  void refit(const std::vector<Triangle>& triangles);
+
+  inline const std::vector<Node>& nodes() const { return this->n; };
+
+  // The triangles in leaf order (i.e. as referenced by the nodes).
+  inline const std::vector<Triangle>& triangles() const { return this->t; };
+
+  // Map a leaf order triangle index back to the index originally given to the constructor.
+  inline std::size_t originalIndex(std::size_t index) const { return this->order[index]; };
+
+  AABB bounds() const;
+
+  // Return the (original) indices of all triangles whose bounding boxes overlap the box.
+  std::vector<std::size_t> overlapping(const AABB& box) const;
+
+  // Return true if the triangle intersects any triangle of the mesh.
+  bool intersects(const Triangle& triangle) const;
+
+  // Find the point on the mesh closest to p. Points farther than maxDistance are ignored; if nothing is found
+  // within maxDistance, the returned distance is INF.
+  Closest closest(const Vector3& p, Real maxDistance = INF) const;
+
+private:
+  std::vector<Node> n;
+  std::vector<Triangle> t;
+  std::vector<uint32_t> order;
+
+  // Build the subtree over order[begin, end) into nodes, using per-triangle bounds and centroids.
+  void build(
+    std::vector<Node>& nodes,
+    const std::vector<AABB>& boxes,
+    const std::vector<Vector3>& centroids,
+    uint32_t begin,
+    uint32_t end,
+    std::size_t depth
+  );
+
+  // Choose a split of order[begin, end) and partition it in place. Return the index of the first right element, or
+  // `end` if the range should become a leaf.
+  uint32_t split(
+    const std::vector<AABB>& boxes,
+    const std::vector<Vector3>& centroids,
+    const AABB& box,
+    uint32_t begin,
+    uint32_t end,
+    uint8_t& axis
+  );
+};
+
+// Return true if any triangle of b, placed in the frame of a by bToA, intersects a triangle of a.
+// Both hierarchies are traversed simultaneously, pruning node pairs whose (oriented) boxes are separated.
+bool intersects(const BVH& a, const BVH& b, const RigidMatrix& bToA);
+
+}
+
+#endif /* __BVH_HPP__ */
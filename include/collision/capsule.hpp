@@ -0,0 +1,55 @@
+#ifndef __CAPSULE_HPP__
+#define __CAPSULE_HPP__
+
+#include "typedefs.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+
+#include <array>
+
+namespace rbt::collision {
+
+// All points within radius of the segment [a, b].
+class Capsule {
+public:
+  Vector3 a, b;
+  Real radius;
+  Capsule() : a(Vector3()), b(Vector3()), radius(0) {};
+  Capsule(const Vector3& a, const Vector3& b, const Real& radius) : a(a), b(b), radius(radius) {};
+};
+
+// Place the capsule with a rigid transformation.
+Capsule transform(const Capsule& capsule, const RigidMatrix& placement);
+
+// Fit a capsule enclosing every vertex of the mesh (and therefore every triangle).
+// For each principal axis of the vertices, the radius is the smallest circle enclosing the vertices projected across
+// the axis and the segment is trimmed so the end caps just cover the extreme vertices. The smallest of these capsules
+// (or of the bounding sphere) is returned.
+Capsule fitCapsule(const Mesh& mesh);
+
+// Signed distance between the capsule surfaces (negative when they overlap).
+Real distance(const Capsule& first, const Capsule& second);
+
+// A batch of capsules stored as structure-of-arrays so distances are computed one lane per capsule pair.
+struct CapsuleLanes {
+  static constexpr std::size_t WIDTH = 8;
+
+  std::array<Real, WIDTH> ax, ay, az;
+  std::array<Real, WIDTH> bx, by, bz;
+  std::array<Real, WIDTH> radius;
+
+  inline void set(std::size_t lane, const Capsule& capsule) {
+    this->ax[lane] = capsule.a[0]; this->ay[lane] = capsule.a[1]; this->az[lane] = capsule.a[2];
+    this->bx[lane] = capsule.b[0]; this->by[lane] = capsule.b[1]; this->bz[lane] = capsule.b[2];
+    this->radius[lane] = capsule.radius;
+  };
+};
+
+// Signed distances between lane i of first and lane i of second. The kernel is branch free, and uses AVX (all lanes at
+// once) when the processor supports it.
+void distances(const CapsuleLanes& first, const CapsuleLanes& second, std::array<Real, CapsuleLanes::WIDTH>& result);
+
+}
+
+#endif /* __CAPSULE_HPP__ */
@@ -0,0 +1,75 @@
+#ifndef __CONTINUOUS_HPP__
+#define __CONTINUOUS_HPP__
+
+#include "typedefs.hpp"
+#include "serial.hpp"
+#include "collision/self_distance.hpp"
+
+#include <vector>
+
+namespace rbt::collision {
+
+// Upper bounds on how far any point of a link can travel while the joints move, derived from the DH parameters.
+// Links follow Serial::linkPoses: link 0 is the fixed base and link k > 0 is moved by joints 0 to k - 1.
+class MotionBound {
+  // w[k][j] bounds the distance from the axis of joint j to any point of link k.
+  std::vector<std::vector<Real>> w;
+public:
+  // Each link radius is the largest distance of the link's geometry from its frame origin.
+  MotionBound(const Serial& robot, const std::vector<Real>& linkRadii);
+
+  // The longest path any point of the link can trace during a linear joint motion by delta, as seen from the frame
+  // of an earlier link. Joints before that link move both rigidly so only the joints between them contribute.
+  Real displacement(std::size_t link, const Angles& delta, std::size_t relativeTo = 0) const;
+};
+
+// Continuous self-collision checking of linear joint-space motions against the link capsules of a SelfDistance.
+// The clearance of each link pair at a configuration, divided by how fast the pair can approach (from MotionBound),
+// gives a stretch of the motion around that configuration which is certainly collision free. Both queries only
+// report a motion free once such stretches cover all of it, so no contact between the capsules can be missed.
+class ContinuousSelfCollision {
+public:
+  struct Result {
+    bool collides;
+    // The fraction [0, 1] of the motion at which contact was found (1 if there is none).
+    Real time;
+    // The number of configurations evaluated.
+    std::size_t steps;
+  };
+
+  // Motions needing more steps than this are reported as colliding.
+  static constexpr std::size_t MAX_STEPS = 10000;
+
+  ContinuousSelfCollision(const SelfDistance& proxies);
+
+  // Validate the motion from start to end (interpolated linearly in joint space) by bisection: intervals not yet
+  // certified free are split at their midpoints, coarse to fine. Finds contact quickly but not necessarily the first.
+  // Clearances at or below the tolerance count as contact.
+  Result check(const Angles& start, const Angles& end, Real tolerance = 0.01) const;
+
+  // Find the first contact along the motion by conservative advancement from the start.
+  Result firstContact(const Angles& start, const Angles& end, Real tolerance = 0.01) const;
+
+private:
+  SelfDistance proxies;
+  MotionBound bound;
+
+  // The fastest each checked pair can close its gap, per unit of motion.
+  std::vector<Real> rates(const Angles& start, const Angles& end) const;
+
+  // Evaluate the configuration at s along the motion. Return the distance along the motion (in either direction)
+  // which is certainly free, or a negative value if the configuration is in contact.
+  Real freeRadius(
+    const Angles& start,
+    const Angles& end,
+    const std::vector<Real>& rates,
+    Real s,
+    Real tolerance,
+    std::vector<Real>& distances,
+    SelfDistance::Scratch& scratch
+  ) const;
+};
+
+}
+
+#endif /* __CONTINUOUS_HPP__ */
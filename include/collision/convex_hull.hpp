@@ -0,0 +1,55 @@
+#ifndef __CONVEX_HULL_HPP__
+#define __CONVEX_HULL_HPP__
+
+#include "typedefs.hpp"
+#include "utilities.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace rbt::collision {
+
+// The convex hull of a point set (e.g. the vertices of a link mesh read by STLParser), built by quickhull.
+// Stored compactly as its vertices, its triangulated faces and the distinct planes of those faces.
+class ConvexHull {
+public:
+  // The points p with normal * p == offset. Normals are unit length and point out of the hull.
+  struct Plane {
+    Vector3 normal;
+    Real offset;
+  };
+
+  // Point sets larger than this are split across threads: each thread finds the hull of its share of the points
+  // and the final hull is built over the vertices of those.
+  static constexpr std::size_t PARALLEL_THRESHOLD = 16384;
+
+  ConvexHull() {};
+  ConvexHull(const std::vector<Vector3>& points);
+  explicit ConvexHull(const Mesh& mesh);
+
+  inline const std::vector<Vector3>& vertices() const { return this->v; };
+
+  // Counter-clockwise (seen from outside) triangles indexing vertices(). Flat point sets have no faces.
+  inline const std::vector<std::array<uint32_t, 3>>& faces() const { return this->f; };
+
+  // One plane per flat side of the hull, however many faces triangulate it.
+  inline const std::vector<Plane>& planes() const { return this->p; };
+
+  // The vertex furthest in the given direction.
+  Vector3 support(const Vector3& direction) const;
+
+  // True if the point is inside or on the hull (within the tolerance).
+  bool contains(const Vector3& point, Real tolerance = EPSILON) const;
+
+private:
+  std::vector<Vector3> v;
+  std::vector<std::array<uint32_t, 3>> f;
+  std::vector<Plane> p;
+};
+
+}
+
+#endif /* __CONVEX_HULL_HPP__ */
@@ -0,0 +1,100 @@
+#ifndef __DISTANCE_FIELD_HPP__
+#define __DISTANCE_FIELD_HPP__
+
+#include "typedefs.hpp"
+#include "utilities.hpp"
+#include "spatial/aabb.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace rbt::collision {
+
+// A signed distance field sampled on a regular grid around a closed mesh (e.g. an environment loaded by STLParser).
+// Distances are negative inside the mesh. Between samples, distance and gradient are interpolated trilinearly.
+//
+// The grid is stored in bricks of BRICK_SIZE^3 samples. Bricks lying entirely farther than a band from the surface
+// can be collapsed to a single value, so only the samples near the surface take up memory.
+class DistanceField {
+public:
+  // A brick either references BRICK_SIZE^3 samples starting at brick `offset` of the sample array, or has
+  // offset UNIFORM and stands for `value` everywhere.
+  struct Brick {
+    uint32_t offset;
+    Real value;
+  };
+
+  struct Sample {
+    Real distance;
+    Vector3 gradient;
+  };
+
+  // Samples along each edge of a brick.
+  static constexpr std::size_t BRICK_SIZE = 8;
+
+  static constexpr uint32_t UNIFORM = 0xFFFFFFFF;
+
+  // Sample the signed distance to the mesh every voxelSize units over its bounds grown by padding on all sides.
+  // Bricks whose samples are all at least band from the surface keep only the sample nearest the surface, so
+  // collapsed regions never overstate the clearance and always keep their sign.
+  // The mesh must be closed for inside and outside to be told apart.
+  DistanceField(const Mesh& mesh, Real voxelSize, Real padding, Real band = INF);
+
+  // Map a field written by save() into memory. The samples are paged in from the file on demand.
+  // Throws std::runtime_error if the file can't be read or isn't a distance field.
+  static DistanceField load(const std::string& file_path);
+
+  void save(const std::string& file_path) const;
+
+  // Distance and gradient at p. Points beyond the grid take the value at the nearest point of the grid plus the
+  // distance to it.
+  Sample sample(const Vector3& p) const;
+  Real distance(const Vector3& p) const;
+  Vector3 gradient(const Vector3& p) const;
+
+  // The sample at grid index (i, j, k), at origin() + voxelSize() * (i, j, k).
+  Real at(std::size_t i, std::size_t j, std::size_t k) const;
+
+  inline const Vector3& origin() const { return this->o; };
+  inline Real voxelSize() const { return this->h; };
+
+  // The number of samples along each axis (a multiple of BRICK_SIZE).
+  inline const std::array<std::size_t, 3>& samples() const { return this->n; };
+
+  AABB bounds() const;
+
+  // The number of bricks which store their samples.
+  inline std::size_t denseBricks() const { return this->dense; };
+  inline std::size_t bricks() const { return this->n[0] * this->n[1] * this->n[2] / BRICK_VOLUME; };
+
+private:
+  static constexpr std::size_t BRICK_VOLUME = BRICK_SIZE * BRICK_SIZE * BRICK_SIZE;
+
+  Vector3 o;
+  Real h;
+  std::array<std::size_t, 3> n;
+  std::size_t dense;
+
+  // Either owned arrays or a mapped file; shared so copies of a field are cheap.
+  std::shared_ptr<const void> storage;
+  const Brick* table;
+  const Real* values;
+
+  DistanceField(
+    const Vector3& origin,
+    Real voxelSize,
+    const std::array<std::size_t, 3>& samples,
+    std::size_t dense,
+    std::shared_ptr<const void> storage,
+    const Brick* table,
+    const Real* values
+  );
+};
+
+}
+
+#endif /* __DISTANCE_FIELD_HPP__ */
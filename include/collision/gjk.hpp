@@ -0,0 +1,94 @@
+#ifndef __GJK_HPP__
+#define __GJK_HPP__
+
+#include "typedefs.hpp"
+#include "frame.hpp"
+#include "collision/capsule.hpp"
+#include "collision/convex_hull.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/points.hpp"
+#include "spatial/transform.hpp"
+#include "spatial/vector.hpp"
+
+#include <array>
+
+namespace rbt::collision {
+
+// A box centered on the origin of its frame, spanning [-halfExtents, halfExtents].
+class Box {
+public:
+  Vector3 halfExtents;
+  Box(const Vector3& halfExtents) : halfExtents(halfExtents) {};
+};
+
+// A convex hull, capsule or box (given in its own frame) placed in the world, for GJK and EPA.
+// Each shape is a core (hull vertices, capsule segment or box) grown by a margin (the capsule radius), so queries
+// run on the cores and the margins are added afterwards.
+class ConvexShape {
+public:
+  ConvexShape(const ConvexHull& hull, const RigidMatrix& placement = RigidMatrix());
+  ConvexShape(const Capsule& capsule, const RigidMatrix& placement = RigidMatrix());
+  ConvexShape(const Box& box, const RigidMatrix& placement = RigidMatrix());
+
+  void place(const RigidMatrix& placement);
+  inline void place(const Frame& frame) { this->place(RigidMatrix(frame)); };
+  inline void place(const Transform& transform) { this->place(RigidMatrix(transform)); };
+
+  inline const RigidMatrix& placement() const { return this->world; };
+  inline Real margin() const { return this->radius; };
+
+  // The point of the core furthest in the (world) direction, in the world.
+  Vector3 support(const Vector3& direction) const;
+
+  // A point inside the core, in the world.
+  inline Vector3 center() const { return this->world(this->middle); };
+
+private:
+  enum class Type {
+    HULL,
+    SEGMENT,
+    BOX
+  };
+
+  Type type;
+  // Hull vertices, or the two segment end points
+  Points vertices;
+  Vector3 halfExtents;
+  Real radius;
+  Vector3 middle;
+
+  RigidMatrix world;
+  RigidMatrix local;
+};
+
+// The directions which produced the final simplex of a query. Passing the same Simplex to the next query between
+// the same shapes starts it from the supports in those directions, which after a small motion are usually already
+// (nearly) the answer.
+struct Simplex {
+  std::array<Vector3, 4> directions;
+  std::size_t size = 0;
+};
+
+// The result of a query between two shapes.
+struct Separation {
+  // The distance between the surfaces, or minus the penetration depth when they overlap.
+  Real distance;
+  // The closest points of each shape or, when overlapping, the deepest point of each shape inside the other.
+  Vector3 pointA, pointB;
+  // The unit direction from a towards b: (pointB - pointA) / distance when separated. When overlapping, moving b
+  // along it by the penetration depth brings the shapes into touching contact.
+  Vector3 normal;
+  // Support evaluations taken (by GJK and, when overlapping, EPA).
+  std::size_t iterations;
+};
+
+// Iterations of GJK or EPA after which the best answer so far is returned.
+constexpr std::size_t MAX_GJK_ITERATIONS = 64;
+
+// Distance (by GJK) or penetration (by EPA) between the shapes.
+Separation separation(const ConvexShape& a, const ConvexShape& b);
+Separation separation(const ConvexShape& a, const ConvexShape& b, Simplex& simplex);
+
+}
+
+#endif /* __GJK_HPP__ */
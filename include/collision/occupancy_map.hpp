@@ -0,0 +1,75 @@
+#ifndef __OCCUPANCY_MAP_HPP__
+#define __OCCUPANCY_MAP_HPP__
+
+#include "typedefs.hpp"
+#include "serial.hpp"
+#include "collision/capsule.hpp"
+#include "spatial/aabb.hpp"
+#include "spatial/points.hpp"
+#include "spatial/vector.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace rbt::collision {
+
+// Space occupied by obstacles, as cubic voxels marked wherever a point of a cloud has fallen.
+// Stored as a linear octree: the sorted Morton codes of the occupied voxels. Every octree cell (a block of 2^level
+// voxels along each side) is then a contiguous run of codes, so any level can be queried without storing it.
+class OccupancyMap {
+public:
+  // Voxels are indexed with this many bits along each axis, i.e. the map spans 2^21 voxels around its origin.
+  static constexpr std::size_t BITS = 21;
+  // The level of the single cell holding the whole map.
+  static constexpr std::size_t LEVELS = BITS;
+
+  // Batches with more points than this are encoded on all hardware threads.
+  static constexpr std::size_t PARALLEL_THRESHOLD = 65536;
+
+  OccupancyMap(Real voxelSize, const Vector3& origin = Vector3());
+
+  inline Real voxelSize() const { return this->size; };
+  // The number of occupied voxels.
+  inline std::size_t count() const { return this->codes.size(); };
+  inline bool empty() const { return this->codes.empty(); };
+
+  // Mark the voxels holding the points. Points outside the span of the map are ignored.
+  void insert(const Points& points);
+  void clear();
+
+  // Whether anything is in the cell at the level (0 for a single voxel) holding the point.
+  bool occupied(const Vector3& p, std::size_t level = 0) const;
+
+  // The box of the cell at the level holding the point, or none if the point is outside the span of the map (or NaN).
+  std::optional<AABB> cell(const Vector3& p, std::size_t level = 0) const;
+
+  // Whether the capsule touches an occupied voxel. Voxels are taken as the spheres around them, so the answer errs
+  // towards collision by up to half a voxel diagonal. Querying at a coarser level treats each occupied cell of that
+  // level as full, which is quicker and more conservative still.
+  bool collides(const Capsule& capsule, std::size_t level = 0) const;
+
+  // Whether any link of the robot, stood in for by a capsule in each link frame (following Serial::linkPoses),
+  // touches an occupied voxel at the configuration.
+  bool inCollision(const Serial& robot, const std::vector<Capsule>& proxies, const Angles& angles, std::size_t level = 0) const;
+
+  // The links touching occupied voxels.
+  std::vector<std::size_t> collisions(const Serial& robot, const std::vector<Capsule>& proxies, const Angles& angles, std::size_t level = 0) const;
+
+  // The centers of the occupied voxels, in Morton order.
+  Points voxels() const;
+
+private:
+  Real size;
+  Vector3 origin;
+  std::vector<uint64_t> codes;
+
+  bool code(const Vector3& p, uint64_t& result) const;
+  Vector3 corner(uint64_t code) const;
+
+  bool collides(const Capsule& capsule, uint64_t prefix, std::size_t level, std::size_t begin, std::size_t end, std::size_t stop) const;
+};
+
+}
+
+#endif /* __OCCUPANCY_MAP_HPP__ */
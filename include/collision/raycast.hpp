@@ -0,0 +1,73 @@
+#ifndef __RAYCAST_HPP__
+#define __RAYCAST_HPP__
+
+#include "typedefs.hpp"
+#include "frame.hpp"
+#include "utilities.hpp"
+#include "collision/bvh.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/points.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace rbt::collision {
+
+// The first surface met by a ray.
+struct RayHit {
+  // The hit is at origin + distance * direction, so distance is in units of the direction's length. INF if the ray
+  // hit nothing (within its maximum distance).
+  Real distance;
+  // Barycentric coordinates of the hit: origin + distance * direction = (1 - u - v) v0 + u v1 + v v2.
+  Real u, v;
+  // The (original) index of the triangle hit.
+  uint32_t triangle;
+  // The object hit, in a RayScene.
+  uint32_t object;
+
+  inline bool hit() const { return this->distance != INF; };
+};
+
+// Rays are traced together in packets of this many, one per SIMD lane (with AVX when the processor supports it).
+// Packets share a traversal of the tree, so neighbouring rays (e.g. successive beams of a scanner) are cheapest.
+constexpr std::size_t RAY_PACKET_SIZE = 8;
+
+// The first hit of each ray with the mesh, in either side of its triangles and no further than maxDistance.
+// hits is resized to the number of rays.
+void raycast(const BVH& bvh, const Points& origins, const Points& directions, std::vector<RayHit>& hits, Real maxDistance = INF);
+RayHit raycast(const BVH& bvh, const Vector3& origin, const Vector3& direction, Real maxDistance = INF);
+
+// Whether each ray hits anything within maxDistance. Each ray stops at the first hit found rather than searching for
+// the nearest, so this is cheaper than raycast. occluded is resized to the number of rays.
+void occluded(const BVH& bvh, const Points& origins, const Points& directions, std::vector<uint8_t>& occluded, Real maxDistance = INF);
+
+// Meshes which move rigidly (e.g. the links of a robot), each with a hierarchy built once in its own frame. Rays are
+// taken into each object's frame instead of refitting or rebuilding for every placement.
+class RayScene {
+public:
+  RayScene(const std::vector<Mesh>& objects);
+
+  inline std::size_t size() const { return this->bvhs.size(); };
+
+  void place(std::size_t object, const RigidMatrix& placement);
+  // Place every object, e.g. robot links with the frames of Serial::linkPoses.
+  void place(const std::vector<Frame>& frames);
+
+  inline const RigidMatrix& placement(std::size_t object) const { return this->placements[object]; };
+
+  void raycast(const Points& origins, const Points& directions, std::vector<RayHit>& hits, Real maxDistance = INF) const;
+  RayHit raycast(const Vector3& origin, const Vector3& direction, Real maxDistance = INF) const;
+  void occluded(const Points& origins, const Points& directions, std::vector<uint8_t>& occluded, Real maxDistance = INF) const;
+
+private:
+  std::vector<BVH> bvhs;
+  std::vector<RigidMatrix> placements;
+  // World to object
+  std::vector<RigidMatrix> inverses;
+};
+
+}
+
+#endif /* __RAYCAST_HPP__ */
@@ -0,0 +1,79 @@
+#ifndef __SELF_COLLISION_HPP__
+#define __SELF_COLLISION_HPP__
+
+#include "typedefs.hpp"
+#include "serial.hpp"
+#include "collision/bvh.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace rbt::collision {
+
+typedef std::pair<std::size_t, std::size_t> LinkPair;
+
+// A symmetric table of link pairs which are allowed to touch and are therefore never checked.
+class AllowedCollisionMatrix {
+  std::size_t n;
+  std::vector<bool> a;
+public:
+  // By default only adjacent links (which always touch at their shared joint) are allowed to collide.
+  AllowedCollisionMatrix(std::size_t links, bool allowAdjacent = true);
+
+  void allow(std::size_t first, std::size_t second, bool allowed = true);
+  bool allowed(std::size_t first, std::size_t second) const;
+
+  inline std::size_t size() const { return this->n; };
+};
+
+// Checks a Serial for collisions between its own links at a joint configuration.
+// Link 0 is the fixed base; link i > 0 moves with joint i - 1 (i.e. follows Serial::linkPoses).
+// Each link mesh is given in its own link frame.
+//
+// Queries place the links in scratch space owned by the caller, as SelfDistance's do: those given the same Scratch
+// don't allocate once it has grown, and those given Scratch of their own can run at the same time.
+class SelfCollision {
+public:
+  // Space a query places the links in.
+  struct Scratch {
+    std::vector<Frame> poses;
+    std::vector<RigidMatrix> placed;
+  };
+
+  SelfCollision(const Serial& robot, const std::vector<Mesh>& links);
+  SelfCollision(const Serial& robot, const std::vector<Mesh>& links, const AllowedCollisionMatrix& allowed);
+
+  // Return true if any pair of links that is not allowed to collide intersects. The angles must be finite.
+  bool inCollision(const Angles& angles, Scratch& scratch) const;
+  bool inCollision(const Angles& angles) const;
+
+  // Every colliding pair of links (lower link index first).
+  void collisions(const Angles& angles, std::vector<LinkPair>& result, Scratch& scratch) const;
+  std::vector<LinkPair> collisions(const Angles& angles) const;
+
+  inline const AllowedCollisionMatrix& allowed() const { return this->acm; };
+
+private:
+  Serial robot;
+  AllowedCollisionMatrix acm;
+  std::vector<BVH> meshes;
+
+  // The bounding sphere of each link in its own frame, used as the broad phase.
+  std::vector<Vector3> centers;
+  std::vector<Real> radii;
+
+  // Link pairs which need checking: not allowed to collide and both have geometry.
+  std::vector<LinkPair> pairs;
+
+  // Narrow phase check of the pair at the given link placements, after a bounding sphere test.
+  bool collides(const LinkPair& pair, const std::vector<RigidMatrix>& placements) const;
+
+  // Place every link at the given configuration, in scratch.placed.
+  void place(const Angles& angles, Scratch& scratch) const;
+};
+
+}
+
+#endif /* __SELF_COLLISION_HPP__ */
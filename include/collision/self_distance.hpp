@@ -0,0 +1,67 @@
+#ifndef __SELF_DISTANCE_HPP__
+#define __SELF_DISTANCE_HPP__
+
+#include "typedefs.hpp"
+#include "serial.hpp"
+#include "collision/capsule.hpp"
+#include "collision/self_collision.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+
+#include <array>
+#include <vector>
+
+namespace rbt::collision {
+
+// Separation distances between the links of a Serial, approximating each link by a capsule.
+// Much cheaper than SelfCollision and, unlike it, gives a clearance rather than a yes/no answer.
+// Links follow Serial::linkPoses: link 0 is the fixed base and link i > 0 moves with joint i - 1.
+// Queries place the capsules in scratch space owned by the caller: those given the same Scratch don't allocate once it
+// has grown, and those given Scratch of their own (e.g. one per thread) can run at the same time. Queries without
+// Scratch allocate their own.
+class SelfDistance {
+public:
+  // Space a query places the capsules in.
+  struct Scratch {
+    std::vector<Capsule> placed;
+  };
+
+  // Fit a capsule to each link mesh (given in its link frame). Links without geometry are never checked.
+  SelfDistance(const Serial& robot, const std::vector<Mesh>& links);
+  SelfDistance(const Serial& robot, const std::vector<Mesh>& links, const AllowedCollisionMatrix& allowed);
+  SelfDistance(const Serial& robot, const std::vector<Capsule>& capsules, const AllowedCollisionMatrix& allowed);
+
+  // The signed distance (negative when overlapping) between each pair of pairs(), at the given configuration.
+  void distances(const Angles& angles, std::vector<Real>& result, Scratch& scratch) const;
+  void distances(const Angles& angles, std::vector<Real>& result) const;
+
+  // The smallest signed distance between any checked pair, or INF if there is nothing to check.
+  Real distance(const Angles& angles, Scratch& scratch) const;
+  Real distance(const Angles& angles) const;
+
+  inline const std::vector<LinkPair>& pairs() const { return this->p; };
+  inline const std::vector<Capsule>& capsules() const { return this->c; };
+  inline const Serial& serial() const { return this->robot; };
+
+  // The capsules of all links placed at the given configuration.
+  std::vector<Capsule> posed(const Angles& angles) const;
+
+private:
+  Serial robot;
+  std::vector<Capsule> c;
+  std::vector<LinkPair> p;
+
+  // The cosine and sine of each joint's alpha, which don't change between queries
+  std::vector<Vector2> alphas;
+
+  void place(const Angles& angles, std::vector<Capsule>& placed) const;
+  // Evaluate the pairs [begin, begin + WIDTH) (those past the end repeating the first) of the placed capsules.
+  // Returns how many there are.
+  std::size_t batch(const std::vector<Capsule>& placed, std::size_t begin, std::array<Real, CapsuleLanes::WIDTH>& result) const;
+  void setAlphas();
+  void setPairs(const AllowedCollisionMatrix& allowed, const std::vector<bool>& present);
+};
+
+}
+
+#endif /* __SELF_DISTANCE_HPP__ */
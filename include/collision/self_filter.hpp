@@ -0,0 +1,45 @@
+#ifndef __SELF_FILTER_HPP__
+#define __SELF_FILTER_HPP__
+
+#include "typedefs.hpp"
+#include "serial.hpp"
+#include "collision/capsule.hpp"
+#include "spatial/points.hpp"
+#include "spatial/triangle.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace rbt::collision {
+
+// Finds the points of a sensor's point cloud which lie on the robot itself, so they can be dropped before the cloud
+// is used as obstacles. Each link is stood in for by a capsule grown by a padding, which covers sensor noise and
+// calibration error. Links follow Serial::linkPoses.
+class SelfFilter {
+public:
+  // Clouds with this many points or fewer are filtered on the calling thread.
+  static constexpr std::size_t PARALLEL_THRESHOLD = 65536;
+
+  // Fit a capsule to each link mesh (given in its link frame). Links with empty meshes filter nothing.
+  SelfFilter(const Serial& robot, const std::vector<Mesh>& links, Real padding);
+  // Use the given capsules (in link frames) instead, e.g. hand-tuned ones. Links with radius 0 capsules filter nothing.
+  SelfFilter(const Serial& robot, const std::vector<Capsule>& proxies, Real padding);
+
+  // The padded capsule of each link, in its link frame.
+  inline const std::vector<Capsule>& proxies() const { return this->p; };
+
+  // Set inside[i] to whether point i lies inside the robot at the configuration. inside is resized to fit.
+  // Points are tested 8 at a time (with AVX when the processor supports it) on all hardware threads.
+  void inside(const Angles& angles, const Points& points, std::vector<uint8_t>& inside) const;
+
+  // Drop the points inside the robot, keeping the order of the rest. Returns how many were dropped.
+  std::size_t remove(const Angles& angles, Points& points) const;
+
+private:
+  Serial robot;
+  std::vector<Capsule> p;
+};
+
+}
+
+#endif /* __SELF_FILTER_HPP__ */
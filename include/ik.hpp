@@ -10,6 +10,10 @@
 
 #include <limits>
 
+namespace rbt { namespace collision {
+  class SelfCollision;
+}}
+
 namespace rbt { namespace ik {
 
 const auto SINGULAR = std::numeric_limits<Real>::infinity();
@@ -38,6 +42,9 @@ Vector2 rsCoordinates(const Real& x, const Real& y, const Real& z, const Real& s
 // Check each solution against the joint limits and prune if any angles are outside their limit
 void removeIfBeyondLimits(AngleSets& sets, const std::vector<Vector2>& limits);
 
+// Prune each solution at which the robot collides with itself. Solutions with singular angles are kept.
+void removeIfSelfColliding(AngleSets& sets, const collision::SelfCollision& checker);
+
 // Return true if the angle is within the given limits
 bool withinLimits(const Real& angle, const Vector2& limits);
 
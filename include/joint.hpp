@@ -5,16 +5,33 @@
 #include "utilities.hpp"
 #include "spatial/vector.hpp"
 
+#include <limits>
+
 namespace rbt {
 
 class Transform;
 
+// How fast a joint can move either way: its largest speed (rad/s), acceleration (rad/s^2) and jerk (rad/s^3).
+// Unlimited by default.
+struct MotionLimits {
+  Real velocity = std::numeric_limits<Real>::infinity();
+  Real acceleration = std::numeric_limits<Real>::infinity();
+  Real jerk = std::numeric_limits<Real>::infinity();
+};
+
 class Joint {
 public:
   Real alpha, a, theta, d;
   Vector2 limits;
-  Joint(const Real& alpha, const Real& a, const Real& theta, const Real& d, Vector2 limits = Vector2({-2 * PI, 2 * PI}))
-    : alpha(alpha), a(a), theta(theta), d(d), limits(limits) {};
+  MotionLimits motion;
+  Joint(
+    const Real& alpha,
+    const Real& a,
+    const Real& theta,
+    const Real& d,
+    Vector2 limits = Vector2({-2 * PI, 2 * PI}),
+    MotionLimits motion = MotionLimits()
+  ) : alpha(alpha), a(a), theta(theta), d(d), limits(limits), motion(motion) {};
   Transform transform(const Real& theta = 0.0) const;
 };
 
@@ -0,0 +1,66 @@
+#ifndef __LINK_MESHES_HPP__
+#define __LINK_MESHES_HPP__
+
+#include "typedefs.hpp"
+#include "serial.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/points.hpp"
+#include "spatial/triangle.hpp"
+
+#include <vector>
+
+namespace rbt {
+
+// The meshes of every link of a Serial, kept as structure-of-arrays vertices and face normals so a whole
+// configuration can be posed with batch transforms. Links follow Serial::linkPoses: link 0 is the fixed base and
+// link i > 0 moves with joint i - 1.
+class LinkMeshes {
+public:
+  // The vertices (three per triangle, see spatial/points.hpp) and unit face normals of a mesh.
+  struct Geometry {
+    Points vertices;
+    Points normals;
+  };
+
+  // Space posing places the links in.
+  struct Scratch {
+    std::vector<Frame> poses;
+    std::vector<RigidMatrix> placements;
+  };
+
+  // Links with this many vertices or fewer between them are posed on the calling thread.
+  static constexpr std::size_t PARALLEL_THRESHOLD = 16384;
+
+  // Work is split across threads in blocks of this many vertices.
+  static constexpr std::size_t BLOCK_SIZE = 4096;
+
+  // Each mesh is given in its link frame.
+  LinkMeshes(const Serial& robot, const std::vector<Mesh>& links);
+
+  // Place every link at the configuration, in the base frame. The result and scratch are resized to fit, so reusing
+  // them between calls avoids allocating. Calls given Scratch of their own can run at the same time.
+  void pose(const Angles& angles, std::vector<Geometry>& result, Scratch& scratch) const;
+  void pose(const Angles& angles, std::vector<Geometry>& result) const;
+  std::vector<Geometry> pose(const Angles& angles) const;
+
+  inline const std::vector<Geometry>& links() const { return this->l; };
+
+private:
+  // A range of vertices (or normals) of one link.
+  struct Block {
+    std::size_t link;
+    bool normals;
+    std::size_t begin, end;
+  };
+
+  Serial robot;
+  std::vector<Geometry> l;
+
+  // The blocks of every link, and their total size, which posing splits its work into
+  std::vector<Block> blocks;
+  std::size_t total = 0;
+};
+
+}
+
+#endif /* __LINK_MESHES_HPP__ */
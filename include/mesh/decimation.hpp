@@ -0,0 +1,25 @@
+#ifndef __DECIMATION_HPP__
+#define __DECIMATION_HPP__
+
+#include "typedefs.hpp"
+#include "mesh/indexed_mesh.hpp"
+
+#include <vector>
+
+namespace rbt::mesh {
+
+// Simplify the mesh by repeatedly collapsing the edge whose merged vertex is cheapest by the quadric error metric
+// (Garland & Heckbert): the sum of squared distances from the vertex to the planes of the original triangles it
+// absorbed. Stops once at most targetTriangles remain or when the next collapse would cost more than maxError
+// squared, so maxError is roughly a distance from the original surface.
+// Collapses that would fold a triangle over or make the surface non-manifold are skipped. With preserveBoundaries,
+// vertices on open edges stay where they are, so holes and open borders keep their exact shape.
+IndexedMesh decimate(const IndexedMesh& mesh, std::size_t targetTriangles, Real maxError = INF, bool preserveBoundaries = true);
+
+// Levels of detail for the mesh, each with (up to) ratio times the triangles of the previous one. The first level
+// is the mesh itself.
+std::vector<IndexedMesh> levelsOfDetail(const IndexedMesh& mesh, std::size_t levels, Real ratio = 0.5, Real maxError = INF);
+
+}
+
+#endif /* __DECIMATION_HPP__ */
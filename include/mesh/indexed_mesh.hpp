@@ -0,0 +1,39 @@
+#ifndef __INDEXED_MESH_HPP__
+#define __INDEXED_MESH_HPP__
+
+#include "typedefs.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace rbt::mesh {
+
+// A triangle mesh whose triangles share vertices, as needed by algorithms that walk from triangle to triangle.
+// STL files (and so Mesh) instead repeat each vertex for every triangle using it; weld() converts between them.
+class IndexedMesh {
+public:
+  std::vector<Vector3> vertices;
+  // Counter-clockwise (seen from outside) vertex indices of each triangle.
+  std::vector<std::array<uint32_t, 3>> triangles;
+
+  IndexedMesh() {};
+  IndexedMesh(const std::vector<Vector3>& vertices, const std::vector<std::array<uint32_t, 3>>& triangles)
+    : vertices(vertices), triangles(triangles) {};
+};
+
+// Merge vertices no further apart than the tolerance (only identical vertices by default). Triangles left with a
+// repeated vertex are dropped.
+IndexedMesh weld(const Mesh& mesh, Real tolerance = 0);
+
+// Expand back into separate triangles.
+Mesh triangles(const IndexedMesh& mesh);
+
+// Pairs of vertices joined by an edge used by only one triangle.
+std::vector<std::array<uint32_t, 2>> boundaryEdges(const IndexedMesh& mesh);
+
+}
+
+#endif /* __INDEXED_MESH_HPP__ */
@@ -0,0 +1,23 @@
+#ifndef __MESH_NORMALS_HPP__
+#define __MESH_NORMALS_HPP__
+
+#include "typedefs.hpp"
+#include "mesh/indexed_mesh.hpp"
+#include "spatial/points.hpp"
+
+namespace rbt::mesh {
+
+// Meshes with this many triangles or fewer are processed on the calling thread.
+constexpr std::size_t NORMALS_PARALLEL_THRESHOLD = 16384;
+
+// The unit normal of each triangle (zero for degenerate triangles).
+Points faceNormals(const IndexedMesh& mesh);
+
+// The unit normal at each vertex, indexed as mesh.vertices: the normals of the triangles around it, each weighted by
+// the triangle's angle at the vertex (Thürmer & Wüthrich), so it does not depend on how the surface is triangulated.
+// Vertices used by no (non-degenerate) triangle get a zero normal. Vertices are processed on all hardware threads.
+Points vertexNormals(const IndexedMesh& mesh);
+
+}
+
+#endif /* __MESH_NORMALS_HPP__ */
@@ -0,0 +1,81 @@
+#ifndef __PATH_HPP__
+#define __PATH_HPP__
+
+#include "typedefs.hpp"
+#include "utilities.hpp"
+#include "frame.hpp"
+#include "serial.hpp"
+#include "spatial/dual.hpp"
+#include "spatial/quaternion.hpp"
+#include "spatial/vector.hpp"
+
+#include <vector>
+
+namespace rbt {
+
+// A Cartesian path of the tool, parameterized by s in [0, 1]. Its position moves along a line, circular arc or helix
+// at constant speed while its orientation turns at a constant rate about a fixed axis.
+class CartesianPath {
+public:
+  // Screw-linear interpolation (ScLERP): the constant screw motion (a helix) taking one pose to the other.
+  static CartesianPath screw(const Frame& from, const Frame& to);
+  // A straight line (MoveL), with the orientation interpolated spherically (slerp).
+  static CartesianPath linear(const Frame& from, const Frame& to);
+  // The circular arc from the first position through the via position to the last (MoveC), with the orientation
+  // interpolated spherically from the first pose to the last. Throws std::invalid_argument if the positions are
+  // collinear.
+  static CartesianPath circular(const Frame& from, const Frame& via, const Frame& to);
+
+  Frame operator()(Real s) const;
+
+  // The distance the position travels, and the angle the orientation turns through.
+  inline Real length() const { return this->distance; };
+  inline Real angle() const { return this->omega; };
+
+  // Evenly spaced parameters from 0 to 1 (inclusive) such that consecutive poses are at most resolution apart and
+  // turn at most angularResolution.
+  std::vector<Real> samples(Real resolution, Real angularResolution = toRadians(1)) const;
+
+  // Set frames[i] to the pose at s[i] for i in [0, count). Uses AVX (8 poses at a time) when the processor
+  // supports it.
+  void evaluate(const Real* s, std::size_t count, Frame* frames) const;
+  void evaluate(const std::vector<Real>& s, std::vector<Frame>& frames) const;
+
+  // The poses at samples(resolution, angularResolution).
+  std::vector<Frame> frames(Real resolution, Real angularResolution = toRadians(1)) const;
+
+private:
+  // position(s) = start + (cos(s phi) - 1) u + sin(s phi) v + s w
+  Vector3 start, u, v, w;
+  Real phi;
+  // orientation(s) = initial * (cos(s omega / 2) + sin(s omega / 2) axis)
+  Quaternion initial;
+  Vector3 axis;
+  Real omega;
+
+  Real distance;
+
+  CartesianPath(const Frame& from, const Frame& to);
+};
+
+// The pose a fraction t of the way along the screw motion from one pose to the other.
+Dual<Quaternion> sclerp(const Dual<Quaternion>& from, const Dual<Quaternion>& to, Real t);
+
+// Poses evaluated and solved for together by jointPath.
+constexpr std::size_t PATH_CHUNK = 256;
+
+// The joint angles at path.samples(resolution, angularResolution): of the inverse kinematics solutions at each
+// sample, the closest to those of the previous sample (or to start, at the first sample, unless it's empty).
+// Poses are evaluated and solved in chunks of PATH_CHUNK, solving in parallel. Stops at the first unreachable sample,
+// so the result is shorter than the samples when part of the path is unreachable.
+AngleSets jointPath(
+  const CartesianPath& path,
+  const Serial& robot,
+  const Angles& start,
+  Real resolution,
+  Real angularResolution = toRadians(1)
+);
+
+}
+
+#endif /* __PATH_HPP__ */
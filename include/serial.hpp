@@ -15,12 +15,16 @@ class Serial {
 public:
   Serial(std::vector<Joint> joints) : j(joints) {};
 
-  std::vector<Joint> joints() const;
+  const std::vector<Joint>& joints() const;
 
   // Return the pose of the final joint
   Frame pose(Angles angles) const;
   // Return the poses of all joints
   std::vector<Frame> poses(Angles angles) const;
+  // Return the poses of all links: the fixed base (at the origin) followed by the pose of each joint
+  std::vector<Frame> linkPoses(Angles angles) const;
+  // As above, into frames, reusing its storage. Missing angles are 0.
+  void linkPoses(const Angles& angles, std::vector<Frame>& frames) const;
 
   inline Real upperArmLength() const { return this->j[1].a; };
   inline Real foreArmLength() const {
@@ -52,6 +56,14 @@ public:
     return limits;
   }
 
+  inline std::vector<MotionLimits> motionLimits() const {
+    std::vector<MotionLimits> limits;
+    for(auto joint : this->j) {
+      limits.push_back(joint.motion);
+    }
+    return limits;
+  }
+
 };
 
 }
@@ -0,0 +1,43 @@
+#ifndef __AABB_HPP__
+#define __AABB_HPP__
+
+#include "typedefs.hpp"
+#include "utilities.hpp"
+#include "spatial/vector.hpp"
+
+namespace rbt {
+
+class Triangle;
+class RigidMatrix;
+
+// An axis-aligned bounding box. Default constructed boxes are empty (inverted) and absorb the first expansion.
+class AABB {
+public:
+  Vector3 min, max;
+  AABB() : min(Vector3({INF, INF, INF})), max(Vector3({-INF, -INF, -INF})) {};
+  AABB(const Vector3& min, const Vector3& max) : min(min), max(max) {};
+
+  void expand(const Vector3& p);
+  void expand(const AABB& box);
+
+  bool empty() const;
+
+  Vector3 center() const;
+  Vector3 extent() const;
+  Real surfaceArea() const;
+};
+
+AABB bounds(const Triangle& t);
+
+bool overlaps(const AABB& a, const AABB& b);
+
+// Return true if box a overlaps box b placed in the frame of a by bToA (separating axis test of the oriented box).
+bool overlaps(const AABB& a, const AABB& b, const RigidMatrix& bToA);
+bool contains(const AABB& box, const Vector3& p);
+
+// Squared distance from the point to the box (zero inside the box).
+Real distanceSq(const AABB& box, const Vector3& p);
+
+}
+
+#endif /* __AABB_HPP__ */
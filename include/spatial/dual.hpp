@@ -57,6 +57,20 @@ Dual<T> norm(const Dual<Quaternion>& a);
 
 Real norm(const Dual<Quaternion>& a);
 
+// The inverse of a unit dual quaternion. (conjugate also negates the dual part, as needed for transforming points.)
+Dual<Quaternion> inverse(const Dual<Quaternion>& a);
+
+// The exponential of a pure dual quaternion w + εv (both with zero real parts): the unit dual quaternion turning by
+// 2|w| about the axis along w while moving as v. Uses Taylor series for small turns, where the closed forms cancel.
+Dual<Quaternion> exp(const Dual<Quaternion>& a);
+
+// The logarithm of a unit dual quaternion: the pure dual quaternion l with exp(l) = a (or -a, the same pose, so the
+// result always turns the shorter way around).
+Dual<Quaternion> log(const Dual<Quaternion>& a);
+
+// exp(t log(a)): a fraction (or multiple) t of the screw motion of a.
+Dual<Quaternion> pow(const Dual<Quaternion>& a, Real t);
+
 #ifdef DEBUG
 template <typename T>
 std::ostream& operator<<(std::ostream& os, const Dual<T>& a);
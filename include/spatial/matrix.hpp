@@ -0,0 +1,43 @@
+#ifndef __MATRIX_HPP__
+#define __MATRIX_HPP__
+
+#include "typedefs.hpp"
+#include "frame.hpp"
+#include "spatial/dual.hpp"
+#include "spatial/quaternion.hpp"
+#include "spatial/transform.hpp"
+#include "spatial/vector.hpp"
+
+#include <array>
+
+namespace rbt {
+
+// A rigid transformation stored as a row-major 3x4 matrix [R | t].
+// Applying it to a point costs 9 multiplies, compared with the dual quaternion sandwich of a Transform.
+class RigidMatrix {
+public:
+  std::array<Real, 12> m;
+  RigidMatrix() : m({1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0}) {};
+  RigidMatrix(const std::array<Real, 12>& m) : m(m) {};
+  explicit RigidMatrix(const Dual<Quaternion>& pose);
+  explicit RigidMatrix(const Transform& transform) : RigidMatrix(transform.dual) {};
+  explicit RigidMatrix(const Frame& frame) : RigidMatrix(frame.pose()) {};
+
+  inline Real operator()(std::size_t row, std::size_t column) const { return this->m[4 * row + column]; };
+
+  // Rotate and translate a point.
+  Vector3 operator()(const Vector3& p) const;
+
+  // Rotate a direction (no translation).
+  Vector3 rotate(const Vector3& v) const;
+
+  Vector3 translation() const;
+};
+
+RigidMatrix operator*(const RigidMatrix& a, const RigidMatrix& b);
+
+RigidMatrix inverse(const RigidMatrix& a);
+
+}
+
+#endif /* __MATRIX_HPP__ */
@@ -0,0 +1,55 @@
+#ifndef __POINTS_HPP__
+#define __POINTS_HPP__
+
+#include "typedefs.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+
+#include <vector>
+
+namespace rbt {
+
+// Points (or directions) stored as structure-of-arrays, so batches of them can be transformed several at a time.
+class Points {
+public:
+  std::vector<Real> x, y, z;
+  Points() {};
+  explicit Points(std::size_t size) : x(size), y(size), z(size) {};
+  Points(const std::vector<Vector3>& points);
+
+  inline std::size_t size() const { return this->x.size(); };
+  void resize(std::size_t size);
+
+  inline Vector3 operator[](std::size_t index) const {
+    return Vector3({ this->x[index], this->y[index], this->z[index] });
+  };
+  void set(std::size_t index, const Vector3& p);
+  void push_back(const Vector3& p);
+};
+
+// Set out[i] = placement(in[i]) for i in [begin, end). out must already be at least as large as in.
+// Uses AVX (8 points per instruction) when the processor supports it.
+void transform(const RigidMatrix& placement, const Points& in, Points& out, std::size_t begin, std::size_t end);
+void transform(const RigidMatrix& placement, const Points& in, Points& out);
+
+// As transform, but only rotating (e.g. normals).
+void rotate(const RigidMatrix& placement, const Points& in, Points& out, std::size_t begin, std::size_t end);
+void rotate(const RigidMatrix& placement, const Points& in, Points& out);
+
+// The index of the point furthest along the direction (the first of any ties). The points must not be empty.
+// Uses AVX when the processor supports it.
+std::size_t farthest(const Points& points, const Vector3& direction);
+
+// The vertices of the mesh: triangle t has vertices 3t, 3t + 1 and 3t + 2.
+Points vertices(const Mesh& mesh);
+
+// The unit normal of each triangle.
+Points normals(const Mesh& mesh);
+
+// The triangles of vertices laid out as by vertices(mesh).
+Mesh triangles(const Points& vertices);
+
+}
+
+#endif /* __POINTS_HPP__ */
@@ -4,6 +4,7 @@
 #include "spatial/vector.hpp"
 
 #include <array>
+#include <vector>
 
 namespace rbt
 {
@@ -12,8 +13,23 @@ class Triangle {
   std::array<Vector3, 3> vertices;
 public:
   Triangle(std::array<Vector3, 3> vertices) : vertices(std::move(vertices)) {};
+
+  const Vector3& operator[](std::size_t index) const { return this->vertices[index]; }
 };
 
+typedef std::vector<Triangle> Mesh;
+
+// Return the (unnormalized) normal given by the counter-clockwise winding of the vertices.
+Vector3 normal(const Triangle& t);
+
+Vector3 centroid(const Triangle& t);
+
+// Return the point on the triangle (including its interior) closest to the given point.
+Vector3 closestPoint(const Triangle& t, const Vector3& p);
+
+// Return true if the triangles touch or overlap (separating axis test).
+bool intersects(const Triangle& a, const Triangle& b);
+
 }
 
 #endif /* __TRIANGLE_HPP__ */
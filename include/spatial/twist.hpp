@@ -0,0 +1,66 @@
+#ifndef __TWIST_HPP__
+#define __TWIST_HPP__
+
+#include "typedefs.hpp"
+#include "spatial/dual.hpp"
+#include "spatial/quaternion.hpp"
+#include "spatial/vector.hpp"
+
+#include <vector>
+
+namespace rbt {
+
+// A rigid body velocity: turning at angular (radians about its direction) about an axis through the origin while the
+// origin moves at linear. Over unit time it moves a pose by displacement(twist).
+struct Twist {
+  Vector3 angular, linear;
+};
+
+// The motion of a twist over unit time, exp(twist / 2).
+Dual<Quaternion> displacement(const Twist& twist);
+
+// The twist taking one pose to the other over unit time, the shorter way around: 2 log(to * inverse(from)), so
+// displacement(twist(from, to)) * from = to. The difference (error) between poses, in world coordinates.
+Twist twist(const Dual<Quaternion>& from, const Dual<Quaternion>& to);
+
+// Unit dual quaternions (poses) stored as structure-of-arrays, for batches.
+class Poses {
+public:
+  std::vector<Real> rr, rx, ry, rz, dr, dx, dy, dz;
+  Poses() {};
+  explicit Poses(std::size_t size) { this->resize(size); };
+
+  inline std::size_t size() const { return this->rr.size(); };
+  void resize(std::size_t size);
+
+  Dual<Quaternion> operator[](std::size_t index) const;
+  void set(std::size_t index, const Dual<Quaternion>& pose);
+  void push_back(const Dual<Quaternion>& pose);
+};
+
+// Twists stored as structure-of-arrays: angular (wx, wy, wz) and linear (vx, vy, vz).
+class Twists {
+public:
+  std::vector<Real> wx, wy, wz, vx, vy, vz;
+  Twists() {};
+  explicit Twists(std::size_t size) { this->resize(size); };
+
+  inline std::size_t size() const { return this->wx.size(); };
+  void resize(std::size_t size);
+
+  Twist operator[](std::size_t index) const;
+  void set(std::size_t index, const Twist& twist);
+};
+
+// Set out[i] = twist(from, to[i]) (or twist(from[i], to[i])), e.g. the errors of many poses from their targets. out
+// is resized to fit. Uses AVX (8 twists at a time) when the processor supports it, with polynomial approximations
+// good to a few single precision ulps.
+void twists(const Dual<Quaternion>& from, const Poses& to, Twists& out);
+void twists(const Poses& from, const Poses& to, Twists& out);
+
+// Set out[i] = displacement(twists[i]), resizing out to fit. Uses AVX when the processor supports it.
+void displacements(const Twists& twists, Poses& out);
+
+}
+
+#endif /* __TWIST_HPP__ */
@@ -3,6 +3,9 @@
 
 #include <array>
 #include <cmath>
+#ifdef DEBUG
+#include <iostream>
+#endif
 
 #include "typedefs.hpp"
 #include "utilities.hpp"
@@ -37,9 +40,15 @@ Vector<T, N> operator*(const Vector<T, N>& a, const U& s);
 template <typename T, typename U, std::size_t N>
 Vector<T, N> operator/(const Vector<T, N>& a, const U& s);
 
+template <typename T, std::size_t N>
+Vector<T, N> operator+(const Vector<T, N>& a, const Vector<T, N>& b);
+
 template <typename T, std::size_t N>
 Vector<T, N> operator-(const Vector<T, N> a, const Vector<T, N> b);
 
+template <typename T>
+Vector<T, 3> cross(const Vector<T, 3>& a, const Vector<T, 3>& b);
+
 template <typename T, std::size_t N>
 T lengthSq(const Vector<T, N>& a);
 
@@ -36,6 +36,17 @@ Vector<T, N> operator/(const Vector<T, N>& a, const U& s) {
   return q * a;
 }
 
+template <typename T, std::size_t N>
+Vector<T, N> operator+(const Vector<T, N>& a, const Vector<T, N>& b) {
+  auto v = Vector<T, N>();
+
+  for(std::size_t i = 0; i < N; ++i) {
+    v[i] = a[i] + b[i];
+  }
+
+  return v;
+}
+
 template <typename T, std::size_t N>
 Vector<T, N> operator-(const Vector<T, N> a, const Vector<T, N> b) {
   auto v = Vector<T, N>();
@@ -47,6 +58,15 @@ Vector<T, N> operator-(const Vector<T, N> a, const Vector<T, N> b) {
   return v;
 }
 
+template <typename T>
+Vector<T, 3> cross(const Vector<T, 3>& a, const Vector<T, 3>& b) {
+  return Vector<T, 3>({
+    a[1] * b[2] - a[2] * b[1],
+    a[2] * b[0] - a[0] * b[2],
+    a[0] * b[1] - a[1] * b[0]
+  });
+}
+
 template <typename T, std::size_t N>
 T lengthSq(const Vector<T, N>& a) {
   auto lengthSq = T();
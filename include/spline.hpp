@@ -0,0 +1,65 @@
+#ifndef __SPLINE_HPP__
+#define __SPLINE_HPP__
+
+#include "typedefs.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace rbt {
+
+// A smooth joint trajectory through waypoints at given times (e.g. a joint path timed by timeOptimal). Each fit sets
+// the velocities and accelerations of the joints at the waypoints; between them the joints follow the quintic
+// (Hermite) polynomials that match them, so positions, velocities and accelerations are continuous.
+//
+// Evaluated at any times, so the trajectory can be sampled densely (e.g. at the control rate, for forward kinematics
+// and collision checks) a chunk at a time rather than stored.
+class JointSpline {
+public:
+  // The cubic spline through the waypoints (the interpolating cubic B-spline), starting and ending at rest: velocities
+  // and accelerations are continuous.
+  static JointSpline cubic(const AngleSets& waypoints, const std::vector<Real>& times);
+  // The quintic spline through the waypoints, starting and ending at rest with no acceleration: jerks (and their
+  // rates of change) are continuous too, which suits jerk limited joints.
+  static JointSpline quintic(const AngleSets& waypoints, const std::vector<Real>& times);
+  // Quintic Hermite interpolation of the waypoints with the velocities and accelerations given at each.
+  static JointSpline hermite(
+    const AngleSets& waypoints,
+    const AngleSets& velocities,
+    const AngleSets& accelerations,
+    const std::vector<Real>& times
+  );
+
+  inline std::size_t joints() const { return this->count; };
+  inline Real start() const { return this->knots.front(); };
+  inline Real end() const { return this->knots.back(); };
+
+  // The angles at a time. Times before the start or after the end are taken as the start or end.
+  Angles operator()(Real time) const;
+
+  // Set the angles, velocities and accelerations of the joints at times[i] for i in [0, count), joints() values
+  // each, time after time (so positions + i * joints() are the angles at times[i]). Any of the outputs may be null
+  // to skip it. The times may come in any order, but in order they're found fastest. Uses AVX (8 joints per
+  // instruction) when the processor supports it.
+  void evaluate(const Real* times, std::size_t count, Real* positions, Real* velocities = nullptr,
+    Real* accelerations = nullptr) const;
+  void evaluate(const std::vector<Real>& times, AngleSets& positions) const;
+
+  // Coefficients of the polynomial of each piece, from the constant one up.
+  static constexpr std::size_t ORDER = 6;
+
+private:
+  std::size_t count;
+  // The joints, rounded up to a whole number of AVX registers
+  std::size_t lanes;
+  std::vector<Real> knots;
+  // Of each piece, in the time since its start: coefficient k of joint j at (piece * ORDER + k) * lanes + j
+  std::vector<Real> coefficients;
+
+  JointSpline(const AngleSets& waypoints, const std::vector<double>& velocities,
+    const std::vector<double>& accelerations, const std::vector<Real>& times);
+};
+
+}
+
+#endif /* __SPLINE_HPP__ */
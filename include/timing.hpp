@@ -0,0 +1,28 @@
+#ifndef __TIMING_HPP__
+#define __TIMING_HPP__
+
+#include "typedefs.hpp"
+#include "joint.hpp"
+#include "serial.hpp"
+
+#include <vector>
+
+namespace rbt {
+
+// The times (in seconds, from 0) at which the joints can pass each waypoint of a joint path (e.g. from jointPath),
+// starting and stopping at rest, so the path takes as little time as the velocity and acceleration limits allow.
+//
+// Uses time-optimal path parameterization by reachability analysis (TOPP-RA): the path is taken as the smooth curve
+// through the waypoints, with its derivatives estimated by finite differences, so the waypoints should be dense
+// (the limits hold at the waypoints, not between them). A backward pass finds the fastest speed along the path from
+// which each waypoint can still be left and the end reached at rest; a forward pass then accelerates as hard as it
+// can while staying within them. Linear in the number of waypoints.
+//
+// Throws std::invalid_argument if a waypoint has a different number of angles than there are limits, or an angle is
+// not finite, or a limit is not positive. Unlimited joints don't constrain the timing.
+std::vector<Real> timeOptimal(const AngleSets& path, const std::vector<MotionLimits>& limits);
+std::vector<Real> timeOptimal(const AngleSets& path, const Serial& robot);
+
+}
+
+#endif /* __TIMING_HPP__ */
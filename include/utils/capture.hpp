@@ -0,0 +1,72 @@
+#ifndef __CAPTURE_HPP__
+#define __CAPTURE_HPP__
+
+#include "typedefs.hpp"
+#include "frame.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rbt {
+  class Serial;
+}
+
+// Capture of the inverse and forward kinematics requests a program makes, to replay them later (e.g. in ReplayBench).
+//
+// A capture file is the magic "RBTW", a uint32 format version, then one record per request (all little-endian):
+//   uint8 kind (0 inverse, 1 forward), uint8 angle count, uint16 robot id,
+//   for inverse requests the target pose as 8 floats (the real then dual quaternion, each r, x, y, z),
+//   then the angles as floats: the seed joints of an inverse request (if any) or the joints of a forward request.
+namespace rbt::capture {
+
+constexpr uint32_t VERSION = 1;
+
+struct Request {
+  enum class Kind : uint8_t {
+    INVERSE,
+    FORWARD
+  };
+
+  Kind kind;
+  uint16_t robot;
+  Frame pose;
+  Angles angles;
+};
+
+// Start recording every ik::angles and Serial::pose call (from any thread) to the file, replacing it. Throws if the
+// file can't be created.
+//
+// Each thread encodes its requests into a buffer of its own, written to the file in batches (and when the thread exits
+// or recording stops), so the requests of one thread are in order but those of different threads are interleaved a
+// batch at a time.
+void start(const std::string& file_path);
+// Stop recording, write out the requests of every thread and close the file.
+void stop();
+bool recording();
+
+// Record the requests of robots with these parameters (e.g. copies of the robot) under the given id. Robots not given an
+// id are numbered in the order their requests are written, skipping ids already given.
+void identify(const Serial& robot, uint16_t id);
+
+// Record a request, if recording. Called by ik::angles and Serial::pose.
+void record(const Frame& pose, const Serial& robot, const Angles& seed = Angles());
+void record(const Angles& angles, const Serial& robot);
+
+// Don't record the requests a thread makes while one exists, e.g. the forward kinematics inside inverse kinematics.
+class Suppress {
+public:
+  Suppress();
+  ~Suppress();
+
+  Suppress(const Suppress&) = delete;
+  Suppress& operator=(const Suppress&) = delete;
+};
+
+// Read and write whole capture files. Throws if the file can't be opened or isn't a valid capture.
+std::vector<Request> read(const std::string& file_path);
+void write(const std::string& file_path, const std::vector<Request>& requests);
+
+}
+
+#endif /* __CAPTURE_HPP__ */
@@ -1,11 +1,23 @@
 #ifndef __LOGGER_HPP__
 #define __LOGGER_HPP__
 
-#include <sstream>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
 #include <string>
+#include <type_traits>
 
-// Shorthand logging call.
-#define LOG(x) Logger().out(LEVEL::x)
+// Levels below this are compiled out: LOG calls at them evaluate nothing, not even their arguments.
+// 0 logs everything, 1 only warnings and errors, 2 only errors and 3 nothing.
+#ifndef RBT_LOG_LEVEL
+#define RBT_LOG_LEVEL 0
+#endif
+
+// Log a message, e.g. LOG(WARN, "joint {} is {} past its limit", index, excess). Each {} in the format (which must be
+// a string literal) is replaced by the next argument. Formatting and output happen later on the logger's own thread.
+#define LOG(level, ...) do { \
+  if constexpr(static_cast<int>(rbt::LEVEL::level) >= RBT_LOG_LEVEL) rbt::Logger::write(rbt::LEVEL::level, __VA_ARGS__); \
+} while(false)
 
 namespace rbt {
 
@@ -15,16 +27,131 @@ enum class LEVEL {
   ERROR
 };
 
+// An asynchronous logger. Each logging thread copies its messages' arguments into its own ring buffer (never
+// allocating or blocking), and a background thread formats them and writes them to the sink in batches, at most
+// LATENCY after they're logged, or once a ring is half full. When a thread's ring is full its messages are dropped and
+// counted rather than waiting.
+//
+// Arguments are copied as they are, and formatted by the background thread, if they are numbers, strings or trivially
+// copyable (e.g. vectors). Anything else streamable is formatted on the calling thread, straight into its message. An
+// argument that doesn't fit in what's left of its message is truncated (strings) or left out, and written as "...".
 class Logger {
 public:
-  Logger();
-  ~Logger();
+  // Bytes per message, including its arguments.
+  static constexpr std::size_t MESSAGE_SIZE = 256;
+  // Messages each thread can have waiting to be written.
+  static constexpr std::size_t CAPACITY = 1024;
+  // Milliseconds messages may wait to be written.
+  static constexpr std::size_t LATENCY = 50;
+
+  template <typename... Arguments>
+  static void write(LEVEL level, const char* format, const Arguments&... arguments) {
+    auto message = Logger::claim();
+    if(message == nullptr) return;
+
+    message->level = level;
+    message->format = format;
+    message->size = 0;
+    message->truncated = false;
+    (Logger::encode(*message, arguments), ...);
+    Logger::publish();
+  }
+
+  // Write out every message logged (by any thread) before the call, then flush the sink.
+  static void flush();
+
+  // Where messages are written (std::cout until set). The stream must outlive its use.
+  static void set_sink(std::ostream& out);
+
+  // The number of messages dropped so far because their thread's ring was full.
+  static std::size_t dropped();
+
+  // Writes a value of type T copied to bytes (for the background thread), returning sizeof(T).
+  using Writer = std::size_t (*)(std::ostream& out, const char* bytes);
+
+  // A message as stored in the rings.
+  struct Message {
+    uint64_t time;
+    const char* format;
+    LEVEL level;
+    uint16_t size;
+    // Whether an argument was left out, after which no more are stored
+    bool truncated;
+    // Each argument as a type tag followed by its value
+    char arguments[MESSAGE_SIZE - 2 * sizeof(uint64_t) - 2 * sizeof(uint32_t)];
+  };
 
-  std::stringstream& out(const LEVEL& level);
 private:
-  std::stringstream os;
+  // The next free message of the calling thread's ring, or nullptr (counting a drop) when it's full.
+  static Message* claim();
+  // Hand the claimed message to the background thread.
+  static void publish();
+
+  // Whether size more bytes fit in the message, marking it truncated if not.
+  static bool fits(Message& message, std::size_t size) {
+    if(!message.truncated && message.size + size <= sizeof(message.arguments)) return true;
+
+    message.truncated = true;
+    return false;
+  }
+
+  template <typename T>
+  static void put(Message& message, char tag, const T& value) {
+    if(!Logger::fits(message, 1 + sizeof(T))) return;
+
+    message.arguments[message.size] = tag;
+    std::memcpy(message.arguments + message.size + 1, &value, sizeof(T));
+    message.size = static_cast<uint16_t>(message.size + 1 + sizeof(T));
+  }
+
+  template <typename T>
+  static std::size_t write_object(std::ostream& out, const char* bytes) {
+    std::aligned_storage_t<sizeof(T), alignof(T)> value;
+    std::memcpy(&value, bytes, sizeof(T));
+    out << *reinterpret_cast<const T*>(&value);
+    return sizeof(T);
+  }
+
+  template <typename T>
+  static void put_object(Message& message, const T& value) {
+    if(!Logger::fits(message, 1 + sizeof(Writer) + sizeof(T))) return;
+
+    const Writer writer = &Logger::write_object<T>;
+    message.arguments[message.size] = 'o';
+    std::memcpy(message.arguments + message.size + 1, &writer, sizeof(Writer));
+    std::memcpy(message.arguments + message.size + 1 + sizeof(Writer), &value, sizeof(T));
+    message.size = static_cast<uint16_t>(message.size + 1 + sizeof(Writer) + sizeof(T));
+  }
+
+  static void put(Message& message, const char* text, std::size_t length);
+  // Store what format writes of value as a string, formatting it straight into the message.
+  static void put(Message& message, void (*format)(std::ostream&, const void*), const void* value);
+
+  static inline void encode(Message& message, const char* text) { Logger::put(message, text, std::strlen(text)); };
+  static inline void encode(Message& message, const std::string& text) { Logger::put(message, text.data(), text.size()); };
 
-  std::string level_to_string(const LEVEL& level);
+  template <typename T>
+  static void encode(Message& message, const T& value) {
+    if constexpr(std::is_same_v<T, bool>) {
+      Logger::put(message, 'b', value);
+    } else if constexpr(std::is_same_v<T, char>) {
+      Logger::put(message, &value, 1);
+    } else if constexpr(std::is_integral_v<T> && std::is_signed_v<T>) {
+      Logger::put(message, 'i', static_cast<int64_t>(value));
+    } else if constexpr(std::is_integral_v<T>) {
+      Logger::put(message, 'u', static_cast<uint64_t>(value));
+    } else if constexpr(std::is_floating_point_v<T>) {
+      Logger::put(message, 'f', static_cast<double>(value));
+    } else if constexpr(std::is_enum_v<T>) {
+      Logger::put(message, 'i', static_cast<int64_t>(value));
+    } else if constexpr(std::is_convertible_v<T, const char*>) {
+      Logger::encode(message, static_cast<const char*>(value));
+    } else if constexpr(std::is_trivially_copyable_v<T>) {
+      Logger::put_object(message, value);
+    } else {
+      Logger::put(message, [](std::ostream& out, const void* object) { out << *static_cast<const T*>(object); }, &value);
+    }
+  }
 };
 
 }
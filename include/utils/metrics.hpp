@@ -0,0 +1,123 @@
+#ifndef __METRICS_HPP__
+#define __METRICS_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace rbt::metrics {
+
+// Counters and histograms are split into shards, each thread updating its own, so threads recording the same metric
+// don't fight over a cache line. Reads sum the shards.
+constexpr std::size_t SHARDS = 8;
+
+// The shard of the calling thread.
+std::size_t shard();
+
+// A count which only goes up.
+class Counter {
+public:
+  inline void add(uint64_t amount = 1) {
+    this->shards[shard()].value.fetch_add(amount, std::memory_order_relaxed);
+  };
+
+  uint64_t value() const;
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value{0};
+  };
+
+  std::array<Shard, SHARDS> shards;
+};
+
+// A value which can go up and down, e.g. the size of something.
+class Gauge {
+public:
+  inline void set(double value) { this->current.store(value, std::memory_order_relaxed); };
+  void add(double amount);
+
+  inline double value() const { return this->current.load(std::memory_order_relaxed); };
+
+private:
+  std::atomic<double> current{0};
+};
+
+// The distribution of a histogram at one moment. Values are bucketed log-linearly (as in HDR histograms): 16 buckets
+// per power of two, so quantiles are within 1/16 of the recorded values.
+struct Distribution {
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  uint64_t max = 0;
+  std::vector<uint64_t> buckets;
+
+  // The largest value which would share a bucket with the value at quantile q (in [0, 1]), or 0 if empty.
+  uint64_t quantile(double q) const;
+  inline double mean() const { return (this->count == 0) ? 0 : static_cast<double>(this->sum) / static_cast<double>(this->count); };
+};
+
+// A distribution of non-negative integers, typically latencies in nanoseconds.
+class Histogram {
+public:
+  static constexpr std::size_t SUB_BUCKETS = 16;
+  static constexpr std::size_t BUCKETS = (64 - 3) * SUB_BUCKETS;
+
+  void record(uint64_t value);
+
+  Distribution distribution() const;
+
+  // The bucket of a value, and the smallest and largest values in a bucket.
+  static std::size_t bucket(uint64_t value);
+  static uint64_t lowest(std::size_t bucket);
+  static uint64_t highest(std::size_t bucket);
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> count{0}, sum{0}, max{0};
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+  };
+
+  std::array<Shard, SHARDS> shards;
+};
+
+// Records the nanoseconds from its creation to its destruction into a histogram.
+class Stopwatch {
+public:
+  explicit Stopwatch(Histogram& histogram);
+  ~Stopwatch();
+
+  Stopwatch(const Stopwatch&) = delete;
+  Stopwatch& operator=(const Stopwatch&) = delete;
+
+private:
+  Histogram& histogram;
+  uint64_t begin;
+};
+
+// The metric with the given name, created (with the help text) on first use. The metric lives for the rest of the
+// program, so hot paths can look it up once into a static reference. A name may only be used for one kind of metric.
+Counter& counter(const std::string& name, const std::string& help);
+Gauge& gauge(const std::string& name, const std::string& help);
+Histogram& histogram(const std::string& name, const std::string& help);
+
+// The value of every metric at one moment, by name.
+struct Snapshot {
+  std::map<std::string, uint64_t> counters;
+  std::map<std::string, double> gauges;
+  std::map<std::string, Distribution> histograms;
+};
+
+Snapshot snapshot();
+
+// Write every metric in the Prometheus text exposition format. Histograms (taken to be in nanoseconds) are written
+// as summaries in seconds, with 0.5, 0.9, 0.99 and 0.999 quantiles.
+void write_prometheus(std::ostream& out);
+void write_prometheus(const std::string& file_path);
+
+}
+
+#endif /* __METRICS_HPP__ */
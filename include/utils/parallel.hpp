@@ -0,0 +1,38 @@
+#ifndef __PARALLEL_HPP__
+#define __PARALLEL_HPP__
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+
+namespace rbt {
+
+// The number of threads parallel_for splits work across.
+inline std::size_t hardware_threads() {
+  static const std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  return threads;
+}
+
+// Call chunk(f, begin, end) on the chunks [begin, begin + size) of [0, count), on the threads of a pool started on
+// first use (one fewer than hardware_threads()) and the calling thread, returning once every chunk is done. Rethrows
+// the first exception a chunk throws.
+//
+// One call uses the pool at a time: a call made while the pool is busy, or from inside a chunk, runs every chunk on
+// its own thread.
+void parallel_chunks(std::size_t count, std::size_t size, void (*chunk)(const void*, std::size_t, std::size_t),
+  const void* f);
+
+// Call f(begin, end) on contiguous chunks of [0, count), one chunk per hardware thread, as parallel_chunks.
+template <typename F>
+void parallel_for(std::size_t count, const F& f) {
+  const auto chunk = (count + hardware_threads() - 1) / hardware_threads();
+  if(chunk == 0) return;
+
+  parallel_chunks(count, chunk, [](const void* g, std::size_t begin, std::size_t end) {
+    (*static_cast<const F*>(g))(begin, end);
+  }, &f);
+}
+
+}
+
+#endif /* __PARALLEL_HPP__ */
@@ -0,0 +1,71 @@
+#ifndef __PROFILER_HPP__
+#define __PROFILER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Time the rest of the enclosing scope as a zone with the given name (a string literal). Zones opened inside it on the
+// same thread nest under it. Compiles to nothing unless RBT_PROFILE is defined (see DEFINE_PROFILE in CMakeLists).
+#ifdef RBT_PROFILE
+#define PROFILE_CONCATENATE_(a, b) a##b
+#define PROFILE_CONCATENATE(a, b) PROFILE_CONCATENATE_(a, b)
+#define PROFILE_ZONE(name) const rbt::profiler::Zone PROFILE_CONCATENATE(profile_zone_, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_ZONE(__func__)
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_FUNCTION()
+#endif
+
+namespace rbt::profiler {
+
+// Nanoseconds on a monotonic clock.
+uint64_t now();
+
+// Zone paths, nesting depth and trace events kept per thread. Zones beyond the first MAX_ZONES paths or nested deeper
+// than MAX_DEPTH aren't recorded, and traces keep only the last TRACE_EVENTS zones closed on each thread.
+constexpr std::size_t MAX_ZONES = 128;
+constexpr std::size_t MAX_DEPTH = 64;
+constexpr std::size_t TRACE_EVENTS = 4096;
+
+// A zone open for as long as it exists. Each thread aggregates its zones into its own fixed buffer, without locking
+// or allocating, so zones on different threads never contend. Buffers of exited threads are reused by new ones.
+class Zone {
+public:
+  explicit Zone(const char* name);
+  ~Zone();
+
+  Zone(const Zone&) = delete;
+  Zone& operator=(const Zone&) = delete;
+};
+
+// Timings aggregated over every run of a zone, on all threads. Zones are identified by their path of enclosing zone
+// names, e.g. "main/parse".
+struct Statistics {
+  std::string path;
+  std::size_t depth;
+  std::size_t count;
+  // Nanoseconds. The percentiles are from a histogram, so within about 3% (and never above max).
+  double total, mean;
+  uint64_t p50, p99, max;
+};
+
+// Statistics for each zone closed so far, in the order each zone was first opened.
+std::vector<Statistics> statistics();
+
+// Print the statistics as an indented table.
+void print_report(std::ostream& out);
+
+// Write the zones closed so far (the last TRACE_EVENTS of each thread's buffer, whose index is the tid) as Chrome
+// trace event JSON (viewable in chrome://tracing or Perfetto).
+void write_chrome_trace(std::ostream& out);
+void write_chrome_trace(const std::string& file_path);
+
+// Forget every zone recorded so far (zones still open are kept).
+void clear();
+
+}
+
+#endif /* __PROFILER_HPP__ */
@@ -0,0 +1,146 @@
+#ifndef __SIMD_HPP__
+#define __SIMD_HPP__
+
+// Polynomial approximations of the trigonometric functions the AVX kernels need, with scalar versions of the same
+// arithmetic for the kernels' scalar fallbacks (so results don't depend on the path taken).
+//
+// Where RBT_AVX_KERNEL is defined, kernels marked __attribute__((target("avx"))) are compiled for AVX whatever the
+// target, and each module picks its AVX kernel at run time when avx() says the processor supports it, or its scalar
+// kernel otherwise.
+
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RBT_AVX_KERNEL
+#include <immintrin.h>
+#endif
+
+namespace rbt::simd {
+
+// Whether the processor runs AVX kernels (never without RBT_AVX_KERNEL). Checked once.
+inline bool avx() {
+#ifdef RBT_AVX_KERNEL
+  static const bool supported = __builtin_cpu_supports("avx");
+  return supported;
+#else
+  return false;
+#endif
+}
+
+// Coefficients of sin(x) / x and (cos(x) - 1) / x^2 on [-PI / 2, PI / 2]
+constexpr float S1 = -1.f / 6, S2 = 1.f / 120, S3 = -1.f / 5040, S4 = 1.f / 362880, S5 = -1.f / 39916800;
+constexpr float C1 = -1.f / 2, C2 = 1.f / 24, C3 = -1.f / 720, C4 = 1.f / 40320, C5 = -1.f / 3628800, C6 = 1.f / 479001600;
+// Coefficients of atan(x) / x on [-tan(PI / 8), tan(PI / 8)] (from Cephes)
+constexpr float A1 = -3.33329491539e-1f, A2 = 1.99777106478e-1f, A3 = -1.38776856032e-1f, A4 = 8.05374449538e-2f;
+constexpr float TWO_PI = 6.28318530717958647f, HALF_PI = 1.57079632679489662f, QUARTER_PI = 0.78539816339744831f;
+constexpr float TAN_EIGHTH_PI = 0.41421356237309505f;
+// Below these angles the closed forms of sin(x) / x and cos_minus_sinc lose precision, so their Taylor series are used
+constexpr float TINY_ANGLE = 1e-4f, SMALL_ANGLE = 0.2f;
+// Coefficients of the Taylor series of cos_minus_sinc
+constexpr float T1 = -1.f / 3, T2 = 1.f / 30, T3 = -1.f / 840, T4 = 1.f / 45360;
+
+// sin(x) and cos(x) - 1 (accurate relative to x near 0, where cos(x) - 1 is tiny).
+inline void sin_cos_minus_one(float x, float& sin, float& cos_minus_one) {
+  x -= std::nearbyint(x * (1 / TWO_PI)) * TWO_PI;
+
+  // Fold into [-PI / 2, PI / 2], where cos(PI - x) = -cos(x)
+  const bool folded = (x > HALF_PI) || (x < -HALF_PI);
+  if(x > HALF_PI) x = 2 * HALF_PI - x;
+  else if(x < -HALF_PI) x = -2 * HALF_PI - x;
+
+  const auto x2 = x * x;
+  sin = x + x * (x2 * (S1 + x2 * (S2 + x2 * (S3 + x2 * (S4 + x2 * S5)))));
+  const auto c = x2 * (C1 + x2 * (C2 + x2 * (C3 + x2 * (C4 + x2 * (C5 + x2 * C6)))));
+  cos_minus_one = folded ? -2 - c : c;
+}
+
+// (cos(x) - sin(x) / x) / x^2 for x >= 0, given cos(x) and sin(x) / x.
+inline float cos_minus_sinc(float x, float cos, float sinc) {
+  if(x > SMALL_ANGLE) return (cos - sinc) / (x * x);
+
+  const auto x2 = x * x;
+  return T1 + x2 * (T2 + x2 * (T3 + x2 * T4));
+}
+
+// atan2(y, x) for y, x >= 0 (0 when both are).
+inline float atan2_positive(float y, float x) {
+  // Reduce to atan(z) for z in [0, 1], then to [0, tan(PI / 8)] by atan(z) = PI / 4 + atan((z - 1) / (z + 1))
+  const bool swapped = y > x;
+  const auto denominator = swapped ? y : x;
+  auto z = (denominator > 0) ? (swapped ? x : y) / denominator : 0;
+
+  const bool shifted = z > TAN_EIGHTH_PI;
+  if(shifted) z = (z - 1) / (z + 1);
+
+  const auto z2 = z * z;
+  const auto angle = (shifted ? QUARTER_PI : 0) + (z + z * (z2 * (A1 + z2 * (A2 + z2 * (A3 + z2 * A4)))));
+  return swapped ? HALF_PI - angle : angle;
+}
+
+#ifdef RBT_AVX_KERNEL
+
+// As sin_cos_minus_one, for 8 values.
+__attribute__((target("avx"))) inline void sin_cos_minus_one(__m256 x, __m256& sin, __m256& cos_minus_one) {
+  x = _mm256_sub_ps(x, _mm256_mul_ps(
+    _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1 / TWO_PI)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC),
+    _mm256_set1_ps(TWO_PI)
+  ));
+
+  const auto above = _mm256_cmp_ps(x, _mm256_set1_ps(HALF_PI), _CMP_GT_OQ);
+  const auto below = _mm256_cmp_ps(x, _mm256_set1_ps(-HALF_PI), _CMP_LT_OQ);
+  x = _mm256_blendv_ps(x, _mm256_sub_ps(_mm256_set1_ps(2 * HALF_PI), x), above);
+  x = _mm256_blendv_ps(x, _mm256_sub_ps(_mm256_set1_ps(-2 * HALF_PI), x), below);
+
+  const auto x2 = _mm256_mul_ps(x, x);
+  auto p = _mm256_add_ps(_mm256_set1_ps(S4), _mm256_mul_ps(x2, _mm256_set1_ps(S5)));
+  p = _mm256_add_ps(_mm256_set1_ps(S3), _mm256_mul_ps(x2, p));
+  p = _mm256_add_ps(_mm256_set1_ps(S2), _mm256_mul_ps(x2, p));
+  p = _mm256_add_ps(_mm256_set1_ps(S1), _mm256_mul_ps(x2, p));
+  sin = _mm256_add_ps(x, _mm256_mul_ps(x, _mm256_mul_ps(x2, p)));
+
+  auto c = _mm256_add_ps(_mm256_set1_ps(C5), _mm256_mul_ps(x2, _mm256_set1_ps(C6)));
+  c = _mm256_add_ps(_mm256_set1_ps(C4), _mm256_mul_ps(x2, c));
+  c = _mm256_add_ps(_mm256_set1_ps(C3), _mm256_mul_ps(x2, c));
+  c = _mm256_add_ps(_mm256_set1_ps(C2), _mm256_mul_ps(x2, c));
+  c = _mm256_mul_ps(x2, _mm256_add_ps(_mm256_set1_ps(C1), _mm256_mul_ps(x2, c)));
+  cos_minus_one = _mm256_blendv_ps(c, _mm256_sub_ps(_mm256_set1_ps(-2), c), _mm256_or_ps(above, below));
+}
+
+// As cos_minus_sinc, for 8 values.
+__attribute__((target("avx"))) inline __m256 cos_minus_sinc(__m256 x, __m256 cos, __m256 sinc) {
+  const auto x2 = _mm256_mul_ps(x, x);
+  auto taylor = _mm256_add_ps(_mm256_set1_ps(T3), _mm256_mul_ps(x2, _mm256_set1_ps(T4)));
+  taylor = _mm256_add_ps(_mm256_set1_ps(T2), _mm256_mul_ps(x2, taylor));
+  taylor = _mm256_add_ps(_mm256_set1_ps(T1), _mm256_mul_ps(x2, taylor));
+
+  const auto large = _mm256_cmp_ps(x, _mm256_set1_ps(SMALL_ANGLE), _CMP_GT_OQ);
+  return _mm256_blendv_ps(taylor, _mm256_div_ps(_mm256_sub_ps(cos, sinc), x2), large);
+}
+
+// As atan2_positive, for 8 values.
+__attribute__((target("avx"))) inline __m256 atan2_positive(__m256 y, __m256 x) {
+  const auto swapped = _mm256_cmp_ps(y, x, _CMP_GT_OQ);
+  const auto denominator = _mm256_blendv_ps(x, y, swapped);
+  const auto numerator = _mm256_blendv_ps(y, x, swapped);
+  const auto positive = _mm256_cmp_ps(denominator, _mm256_setzero_ps(), _CMP_GT_OQ);
+  auto z = _mm256_and_ps(_mm256_div_ps(numerator, denominator), positive);
+
+  const auto one = _mm256_set1_ps(1);
+  const auto shifted = _mm256_cmp_ps(z, _mm256_set1_ps(TAN_EIGHTH_PI), _CMP_GT_OQ);
+  z = _mm256_blendv_ps(z, _mm256_div_ps(_mm256_sub_ps(z, one), _mm256_add_ps(z, one)), shifted);
+
+  const auto z2 = _mm256_mul_ps(z, z);
+  auto p = _mm256_add_ps(_mm256_set1_ps(A3), _mm256_mul_ps(z2, _mm256_set1_ps(A4)));
+  p = _mm256_add_ps(_mm256_set1_ps(A2), _mm256_mul_ps(z2, p));
+  p = _mm256_add_ps(_mm256_set1_ps(A1), _mm256_mul_ps(z2, p));
+  const auto angle = _mm256_add_ps(_mm256_and_ps(_mm256_set1_ps(QUARTER_PI), shifted),
+    _mm256_add_ps(z, _mm256_mul_ps(z, _mm256_mul_ps(z2, p))));
+
+  return _mm256_blendv_ps(angle, _mm256_sub_ps(_mm256_set1_ps(HALF_PI), angle), swapped);
+}
+
+#endif
+
+}
+
+#endif /* __SIMD_HPP__ */
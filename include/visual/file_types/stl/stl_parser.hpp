@@ -8,6 +8,7 @@
 #include "typedefs.hpp"
 
 namespace rbt {
+  class Points;
   class Triangle;
 }
 
@@ -19,6 +20,9 @@ public:
   // Open and parse the given file and populate the provided vector of triangles.
   void parse(const std::string& file_path, std::vector<Triangle>& triangles);
 
+  // As above, also populating the facet normals stored in the file, one per triangle. Files may store zero normals.
+  void parse(const std::string& file_path, std::vector<Triangle>& triangles, Points& normals);
+
 private:
   // The layout of each facet in the STL file.
   // See more: https://en.wikipedia.org/wiki/STL_(file_format)
@@ -0,0 +1,56 @@
+#ifndef __STL_WRITER_H__
+#define __STL_WRITER_H__
+
+#include <string>
+#include <vector>
+
+#include "typedefs.hpp"
+#include "link_meshes.hpp"
+
+namespace rbt {
+  class Points;
+  class Triangle;
+}
+
+namespace rbt::visual {
+
+// A class for writing meshes, or whole posed robots, out as binary STL files.
+// Facets are laid out in one buffer (in parallel for large meshes) which is written with a single call. The buffer,
+// posed geometry and posing scratch are kept between calls, so writing many snapshots of a robot only allocates to
+// open each file. Writing triangles lays out their vertices and normals anew each time.
+class STLWriter {
+public:
+  // Meshes with more facets than this are laid out on all hardware threads.
+  static constexpr std::size_t PARALLEL_THRESHOLD = 16384;
+
+  // Write the triangles, with normals computed from their winding. Throw an exception on failure.
+  void write(const std::string& file_path, const std::vector<Triangle>& triangles);
+
+  // Write every link of the robot, placed at the configuration, into one file.
+  void write(const std::string& file_path, const LinkMeshes& robot, const Angles& angles);
+
+private:
+  // The number of bytes comprising the header at the top of an STL file.
+  static const int STL_HEADER_SIZE_IN_BYTES = 80;
+
+  // The size of each facet in the file: a normal and three vertices, then a 16 bit attribute.
+  static const int STL_FACET_SIZE_IN_BYTES = 50;
+
+  std::vector<char> buffer;
+  std::vector<LinkMeshes::Geometry> posed;
+  LinkMeshes::Scratch scratch;
+
+  // Size the buffer for the number of facets and fill in the header.
+  void start(std::size_t number_of_triangles);
+
+  // Lay out facets [begin, end) of the vertices (three per facet, see spatial/points.hpp) and their normals, starting
+  // at facet `first` of the file.
+  void fill(const Points& vertices, const Points& normals, std::size_t first, std::size_t begin, std::size_t end);
+
+  // Write the buffer to the file in one call.
+  void flush(const std::string& file_path);
+};
+
+}
+
+#endif /* __STL_WRITER_H__ */
@@ -0,0 +1,103 @@
+#ifndef __RASTERIZER_HPP__
+#define __RASTERIZER_HPP__
+
+#include "typedefs.hpp"
+#include "link_meshes.hpp"
+#include "serial.hpp"
+#include "utilities.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/points.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace rbt::visual {
+
+// A pinhole camera. It looks along the +z axis of its pose, with +x to the right of the image and +y down it.
+class Camera {
+public:
+  std::size_t width, height;
+  // Focal lengths and principal point, in pixels
+  Real fx, fy, cx, cy;
+  // Surfaces closer (along the view axis) than near or farther than far are not drawn.
+  Real near, far;
+  // Camera to world
+  RigidMatrix pose;
+
+  Camera(std::size_t width, std::size_t height, Real fx, Real fy, Real cx, Real cy, const RigidMatrix& pose, Real near = 1, Real far = INF)
+    : width(width), height(height), fx(fx), fy(fy), cx(cx), cy(cy), near(near), far(far), pose(pose) {};
+
+  // A camera with square pixels and the principal point in the middle of the image, given its horizontal field of
+  // view (in radians).
+  static Camera with_field_of_view(std::size_t width, std::size_t height, Real fieldOfView, const RigidMatrix& pose, Real near = 1, Real far = INF);
+};
+
+// The pose of a camera at eye looking towards target, with up pointing (as nearly as it can) up the image.
+RigidMatrix look_at(const Vector3& eye, const Vector3& target, const Vector3& up = Vector3({0, 0, 1}));
+
+// Row-major images rendered by a Rasterizer.
+class DepthImage {
+public:
+  std::size_t width = 0, height = 0;
+  // Distance along the view axis (not along the pixel's ray) of the nearest surface, or INF where there is none.
+  std::vector<Real> depth;
+  // The link seen at each pixel, or NO_LINK.
+  std::vector<uint8_t> links;
+  // Unit (world frame) normals of the surfaces seen, facing the camera, if asked for. Zero where there is none.
+  Points normals;
+
+  static constexpr uint8_t NO_LINK = 0xff;
+
+  inline Real at(std::size_t x, std::size_t y) const { return this->depth[y * this->width + x]; };
+};
+
+// Renders a Serial's link meshes into depth images on the CPU.
+// Triangles are set up and sorted into square tiles of the image, then tiles are rasterized independently on all
+// hardware threads. Edge functions are evaluated 8 pixels at a time (with AVX when the processor supports it), and
+// each 8 x 8 block of a tile keeps its farthest depth so triangles entirely behind a block skip it (hierarchical-Z).
+class Rasterizer {
+public:
+  static constexpr std::size_t TILE_SIZE = 32;
+  static constexpr std::size_t BLOCK_SIZE = 8;
+
+  // Each mesh is given in its link frame, laid out as for LinkMeshes.
+  Rasterizer(const Serial& robot, const std::vector<Mesh>& links);
+
+  // Render the robot at the configuration into the image, which is resized to fit the camera. The link pose, vertex,
+  // triangle and pixel buffers are kept between calls and reused, so once they have grown to fit nothing is allocated
+  // and a Rasterizer renders one image at a time.
+  void render(const Camera& camera, const Angles& angles, DepthImage& image, bool normals = false);
+
+private:
+  // A projected triangle: edge functions a x + b y + c (non-negative inside) and the plane of inverse depth.
+  struct Setup {
+    Real a[3], b[3], c[3];
+    Real wa, wb, wc;
+    // The inverse depth of its nearest point
+    Real nearest;
+    int32_t minX, minY, maxX, maxY;
+    uint32_t triangle;
+  };
+
+  Serial robot;
+  LinkMeshes meshes;
+  // The first triangle of each link, numbering all the links' triangles together, and the link of each triangle
+  std::vector<uint32_t> firsts;
+  std::vector<uint8_t> owners;
+
+  // The pose of each link, and its vertices in the camera frame and projected into the image
+  std::vector<Frame> frames;
+  std::vector<RigidMatrix> placements;
+  std::vector<Points> viewed, projected;
+  // Triangles set up, and the tiles they cover, by each worker
+  std::vector<std::vector<Setup>> setups;
+  std::vector<std::vector<std::vector<uint32_t>>> bins;
+  // The triangle seen at each pixel
+  std::vector<uint32_t> ids;
+};
+
+}
+
+#endif /* __RASTERIZER_HPP__ */
@@ -0,0 +1,390 @@
+#include "collision/bvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <future>
+#include <numeric>
+#include <thread>
+
+namespace rbt::collision {
+
+namespace {
+
+// Beyond this depth ranges are split at the median to bound the depth of the tree (and the traversal stack).
+const std::size_t MAX_SAH_DEPTH = 48;
+
+// Enough for MAX_SAH_DEPTH levels plus median splits of up to 2^32 triangles.
+const std::size_t STACK_SIZE = MAX_SAH_DEPTH + 32;
+
+void setBounds(BVH::Node& node, const AABB& box) {
+  for(std::size_t i = 0; i < 3; ++i) {
+    node.min[i] = box.min[i];
+    node.max[i] = box.max[i];
+  }
+}
+
+std::size_t binIndex(const Real& centroid, const Real& min, const Real& scale) {
+  const auto bin = static_cast<std::size_t>((centroid - min) * scale);
+  return std::min(bin, BVH::SAH_BINS - 1);
+}
+
+}
+
+BVH::BVH(const std::vector<Triangle>& triangles) {
+  const auto count = triangles.size();
+
+  std::vector<AABB> boxes;
+  std::vector<Vector3> centroids;
+  boxes.reserve(count);
+  centroids.reserve(count);
+
+  for(const auto& triangle : triangles) {
+    boxes.push_back(rbt::bounds(triangle));
+    centroids.push_back(boxes.back().center());
+  }
+
+  this->order.resize(count);
+  std::iota(this->order.begin(), this->order.end(), 0);
+
+  if(count == 0) return;
+
+  // A binary tree has at most 2n - 1 nodes
+  this->n.reserve(2 * count - 1);
+  this->build(this->n, boxes, centroids, 0, static_cast<uint32_t>(count), 0);
+
+  // Store the triangles in leaf order so leaves reference contiguous memory
+  this->t.reserve(count);
+  for(const auto index : this->order) {
+    this->t.push_back(triangles[index]);
+  }
+}
+
+void BVH::build(
+  std::vector<Node>& nodes,
+  const std::vector<AABB>& boxes,
+  const std::vector<Vector3>& centroids,
+  uint32_t begin,
+  uint32_t end,
+  std::size_t depth
+) {
+  AABB box;
+  for(auto i = begin; i < end; ++i) {
+    box.expand(boxes[this->order[i]]);
+  }
+
+  Node node = {};
+  setBounds(node, box);
+
+  uint32_t mid = end;
+  if(depth < MAX_SAH_DEPTH) {
+    mid = this->split(boxes, centroids, box, begin, end, node.axis);
+  } else if(end - begin > MIN_LEAF_SIZE) {
+    const auto extent = box.extent();
+    node.axis = static_cast<uint8_t>(std::max_element(&extent[0], &extent[0] + 3) - &extent[0]);
+    mid = begin + (end - begin) / 2;
+
+    const auto axis = node.axis;
+    std::nth_element(this->order.begin() + begin, this->order.begin() + mid, this->order.begin() + end,
+      [&centroids, axis](const uint32_t& a, const uint32_t& b) { return centroids[a][axis] < centroids[b][axis]; });
+  }
+
+  if(mid == end) {
+    node.offset = begin;
+    node.count = static_cast<uint16_t>(end - begin);
+    nodes.push_back(node);
+    return;
+  }
+
+  static const auto threads = std::max(1u, std::thread::hardware_concurrency());
+  const bool parallel = (end - begin) > PARALLEL_THRESHOLD && (std::size_t(1) << depth) < threads;
+
+  if(parallel) {
+    // Subtrees are built into their own arrays; since child offsets are relative, they can be concatenated as-is
+    std::vector<Node> left;
+    std::vector<Node> right;
+
+    auto task = std::async(std::launch::async, [&]() {
+      this->build(left, boxes, centroids, begin, mid, depth + 1);
+    });
+    this->build(right, boxes, centroids, mid, end, depth + 1);
+    task.get();
+
+    node.offset = static_cast<uint32_t>(1 + left.size());
+    nodes.push_back(node);
+    nodes.insert(nodes.end(), left.begin(), left.end());
+    nodes.insert(nodes.end(), right.begin(), right.end());
+  } else {
+    const auto index = nodes.size();
+    nodes.push_back(node);
+
+    this->build(nodes, boxes, centroids, begin, mid, depth + 1);
+    nodes[index].offset = static_cast<uint32_t>(nodes.size() - index);
+    this->build(nodes, boxes, centroids, mid, end, depth + 1);
+  }
+}
+
+uint32_t BVH::split(
+  const std::vector<AABB>& boxes,
+  const std::vector<Vector3>& centroids,
+  const AABB& box,
+  uint32_t begin,
+  uint32_t end,
+  uint8_t& axis
+) {
+  const auto count = end - begin;
+  if(count <= MIN_LEAF_SIZE) return end;
+
+  AABB centroidBox;
+  for(auto i = begin; i < end; ++i) {
+    centroidBox.expand(centroids[this->order[i]]);
+  }
+
+  const auto extent = centroidBox.extent();
+
+  struct Bin {
+    AABB box;
+    uint32_t count = 0;
+  };
+
+  Real bestCost = INF;
+  std::size_t bestBin = 0;
+
+  for(std::size_t a = 0; a < 3; ++a) {
+    if(extent[a] <= 0) continue;
+
+    const auto scale = SAH_BINS / extent[a];
+
+    std::array<Bin, SAH_BINS> bins;
+    for(auto i = begin; i < end; ++i) {
+      const auto index = this->order[i];
+      auto& bin = bins[binIndex(centroids[index][a], centroidBox.min[a], scale)];
+      bin.count++;
+      bin.box.expand(boxes[index]);
+    }
+
+    // Sweep from the left, recording the cost of everything left of each split plane
+    std::array<Real, SAH_BINS> leftCost;
+    std::array<uint32_t, SAH_BINS> leftCount;
+    AABB left;
+    uint32_t numberLeft = 0;
+    for(std::size_t b = 1; b < SAH_BINS; ++b) {
+      left.expand(bins[b - 1].box);
+      numberLeft += bins[b - 1].count;
+      leftCost[b] = left.surfaceArea() * numberLeft;
+      leftCount[b] = numberLeft;
+    }
+
+    // Sweep from the right, combining with the left costs. Split plane b puts bins [b, SAH_BINS) on the right.
+    AABB right;
+    uint32_t numberRight = 0;
+    for(std::size_t b = SAH_BINS - 1; b > 0; --b) {
+      right.expand(bins[b].box);
+      numberRight += bins[b].count;
+
+      if(numberRight == 0 || leftCount[b] == 0) continue;
+
+      const auto cost = leftCost[b] + right.surfaceArea() * numberRight;
+      if(cost < bestCost) {
+        bestCost = cost;
+        bestBin = b;
+        axis = static_cast<uint8_t>(a);
+      }
+    }
+  }
+
+  // Every centroid coincides; nothing to split on except the count
+  if(isInf(bestCost)) {
+    return (count <= MAX_LEAF_SIZE) ? end : begin + count / 2;
+  }
+
+  // Compare against the cost of intersecting every triangle (unit cost for traversal and intersection)
+  const auto area = std::max(box.surfaceArea(), EPSILON);
+  const auto splitCost = 1 + bestCost / area;
+  if(count <= MAX_LEAF_SIZE && count <= splitCost) return end;
+
+  const auto min = centroidBox.min[axis];
+  const auto scale = SAH_BINS / extent[axis];
+  const auto a = axis;
+  const auto middle = std::partition(this->order.begin() + begin, this->order.begin() + end,
+    [&](const uint32_t& index) { return binIndex(centroids[index][a], min, scale) < bestBin; });
+
+  return static_cast<uint32_t>(middle - this->order.begin());
+}
+
+void BVH::refit(const std::vector<Triangle>& triangles) {
+  assert_msg(triangles.size() == this->t.size(), "Refit requires the same triangles the hierarchy was built with");
+
+  for(std::size_t i = 0; i < this->order.size(); ++i) {
+    this->t[i] = triangles[this->order[i]];
+  }
+
+  // Children always follow their parent so a reverse sweep visits children first
+  for(auto i = this->n.size(); i-- > 0;) {
+    auto& node = this->n[i];
+    AABB box;
+
+    if(node.isLeaf()) {
+      for(auto k = node.offset; k < node.offset + node.count; ++k) {
+        box.expand(rbt::bounds(this->t[k]));
+      }
+    } else {
+      box = this->n[i + 1].box();
+      box.expand(this->n[i + node.offset].box());
+    }
+
+    setBounds(node, box);
+  }
+}
+
+AABB BVH::bounds() const {
+  if(this->n.empty()) return AABB();
+  return this->n.front().box();
+}
+
+std::vector<std::size_t> BVH::overlapping(const AABB& box) const {
+  std::vector<std::size_t> result;
+  if(this->n.empty()) return result;
+
+  std::array<uint32_t, STACK_SIZE> stack;
+  std::size_t top = 0;
+  stack[top++] = 0;
+
+  while(top > 0) {
+    const auto index = stack[--top];
+    const auto& node = this->n[index];
+
+    if(!overlaps(node.box(), box)) continue;
+
+    if(node.isLeaf()) {
+      for(auto k = node.offset; k < node.offset + node.count; ++k) {
+        if(overlaps(rbt::bounds(this->t[k]), box)) result.push_back(this->order[k]);
+      }
+    } else {
+      stack[top++] = index + node.offset;
+      stack[top++] = index + 1;
+    }
+  }
+
+  return result;
+}
+
+bool BVH::intersects(const Triangle& triangle) const {
+  if(this->n.empty()) return false;
+
+  const auto box = rbt::bounds(triangle);
+
+  std::array<uint32_t, STACK_SIZE> stack;
+  std::size_t top = 0;
+  stack[top++] = 0;
+
+  while(top > 0) {
+    const auto index = stack[--top];
+    const auto& node = this->n[index];
+
+    if(!overlaps(node.box(), box)) continue;
+
+    if(node.isLeaf()) {
+      for(auto k = node.offset; k < node.offset + node.count; ++k) {
+        if(rbt::intersects(this->t[k], triangle)) return true;
+      }
+    } else {
+      stack[top++] = index + node.offset;
+      stack[top++] = index + 1;
+    }
+  }
+
+  return false;
+}
+
+BVH::Closest BVH::closest(const Vector3& p, Real maxDistance) const {
+  auto best = Closest{ Vector3(), INF, 0 };
+  if(this->n.empty()) return best;
+
+  auto bestSq = maxDistance * maxDistance;
+
+  std::array<uint32_t, STACK_SIZE> stack;
+  std::size_t top = 0;
+  stack[top++] = 0;
+
+  while(top > 0) {
+    const auto index = stack[--top];
+    const auto& node = this->n[index];
+
+    if(distanceSq(node.box(), p) > bestSq) continue;
+
+    if(node.isLeaf()) {
+      for(auto k = node.offset; k < node.offset + node.count; ++k) {
+        const auto q = closestPoint(this->t[k], p);
+        const auto d = lengthSq(q - p);
+
+        if(d < bestSq) {
+          bestSq = d;
+          best.point = q;
+          best.triangle = this->order[k];
+          best.distance = std::sqrt(d);
+        }
+      }
+    } else {
+      // Push the nearer child last so it is searched first, which tightens the bound early
+      const auto first = index + 1;
+      const auto second = index + node.offset;
+      const auto dFirst = distanceSq(this->n[first].box(), p);
+      const auto dSecond = distanceSq(this->n[second].box(), p);
+
+      if(dFirst <= dSecond) {
+        if(dSecond <= bestSq) stack[top++] = second;
+        if(dFirst <= bestSq) stack[top++] = first;
+      } else {
+        if(dFirst <= bestSq) stack[top++] = first;
+        if(dSecond <= bestSq) stack[top++] = second;
+      }
+    }
+  }
+
+  return best;
+}
+
+bool intersects(const BVH& a, const BVH& b, const RigidMatrix& bToA) {
+  const auto& nodesA = a.nodes();
+  const auto& nodesB = b.nodes();
+  if(nodesA.empty() || nodesB.empty()) return false;
+
+  // Each step descends one of the two trees so the stack is bounded by the sum of their depths
+  std::array<std::pair<uint32_t, uint32_t>, 2 * STACK_SIZE> stack;
+  std::size_t top = 0;
+  stack[top++] = { 0, 0 };
+
+  while(top > 0) {
+    const auto [i, j] = stack[--top];
+    const auto& nodeA = nodesA[i];
+    const auto& nodeB = nodesB[j];
+
+    if(!overlaps(nodeA.box(), nodeB.box(), bToA)) continue;
+
+    if(nodeA.isLeaf() && nodeB.isLeaf()) {
+      for(auto l = nodeB.offset; l < nodeB.offset + nodeB.count; ++l) {
+        const auto& original = b.triangles()[l];
+        const auto placed = Triangle({ bToA(original[0]), bToA(original[1]), bToA(original[2]) });
+
+        for(auto k = nodeA.offset; k < nodeA.offset + nodeA.count; ++k) {
+          if(rbt::intersects(a.triangles()[k], placed)) return true;
+        }
+      }
+      continue;
+    }
+
+    // Descend the larger node to shrink the overlap region fastest
+    const bool descendA = nodeB.isLeaf() || (!nodeA.isLeaf() && nodeA.box().surfaceArea() >= nodeB.box().surfaceArea());
+    if(descendA) {
+      stack[top++] = { i + nodeA.offset, j };
+      stack[top++] = { i + 1, j };
+    } else {
+      stack[top++] = { i, j + nodeB.offset };
+      stack[top++] = { i, j + 1 };
+    }
+  }
+
+  return false;
+}
+
+}
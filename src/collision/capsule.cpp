@@ -0,0 +1,317 @@
+#include "collision/capsule.hpp"
+
+#include "spatial/aabb.hpp"
+#include "utils/simd.hpp"
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace rbt::collision {
+
+namespace {
+
+struct Circle {
+  Vector2 center;
+  Real radius;
+};
+
+bool inside(const Circle& circle, const Vector2& p) {
+  return length(p - circle.center) <= circle.radius * (1 + EPSILON) + EPSILON;
+}
+
+Circle circleFrom(const Vector2& a, const Vector2& b) {
+  const auto center = (a + b) / Real(2);
+  return Circle{ center, length(a - center) };
+}
+
+Circle circleFrom(const Vector2& a, const Vector2& b, const Vector2& c) {
+  const auto ab = b - a;
+  const auto ac = c - a;
+  const auto d = 2 * (ab[0] * ac[1] - ab[1] * ac[0]);
+
+  // Collinear points are enclosed by the circle through the farthest pair
+  if(std::abs(d) <= EPSILON) {
+    auto circle = circleFrom(a, b);
+    for(const auto& candidate : { circleFrom(a, c), circleFrom(b, c) }) {
+      if(candidate.radius > circle.radius) circle = candidate;
+    }
+    return circle;
+  }
+
+  const auto abSq = lengthSq(ab);
+  const auto acSq = lengthSq(ac);
+  const auto offset = Vector2({ (ac[1] * abSq - ab[1] * acSq) / d, (ab[0] * acSq - ac[0] * abSq) / d });
+
+  return Circle{ a + offset, length(offset) };
+}
+
+// Smallest enclosing circle by randomized incremental construction (Welzl), expected linear time.
+Circle enclosingCircle(std::vector<Vector2> points) {
+  if(points.empty()) return Circle{ Vector2(), 0 };
+
+  std::shuffle(points.begin(), points.end(), std::mt19937(0));
+
+  auto circle = Circle{ points[0], 0 };
+  for(std::size_t i = 1; i < points.size(); ++i) {
+    if(inside(circle, points[i])) continue;
+
+    circle = Circle{ points[i], 0 };
+    for(std::size_t j = 0; j < i; ++j) {
+      if(inside(circle, points[j])) continue;
+
+      circle = circleFrom(points[i], points[j]);
+      for(std::size_t k = 0; k < j; ++k) {
+        if(!inside(circle, points[k])) circle = circleFrom(points[i], points[j], points[k]);
+      }
+    }
+  }
+
+  return circle;
+}
+
+// Dominant eigenvector of the symmetric matrix c (stored as its upper triangle) by power iteration, restricted to
+// the plane perpendicular to `excluded` (if given).
+Vector3 dominantAxis(const std::array<Real, 6>& c, const Vector3& excluded) {
+  const auto restrict = [&excluded](const Vector3& v) { return v - excluded * (v * excluded); };
+
+  // Start away from any axis so symmetric shapes don't stall on an eigenvector of a smaller eigenvalue
+  auto axis = unit(restrict(Vector3({ 1, 0.7071, 0.5773 })));
+  for(int iteration = 0; iteration < 64; ++iteration) {
+    const auto next = restrict(Vector3({
+      c[0] * axis[0] + c[1] * axis[1] + c[2] * axis[2],
+      c[1] * axis[0] + c[3] * axis[1] + c[4] * axis[2],
+      c[2] * axis[0] + c[4] * axis[1] + c[5] * axis[2]
+    }));
+
+    const auto magnitude = length(next);
+    if(approxZero(magnitude)) break;
+
+    axis = next / magnitude;
+  }
+
+  return axis;
+}
+
+// The principal axes of the points, largest variance first.
+std::array<Vector3, 3> principalAxes(const std::vector<Vector3>& points, const Vector3& mean) {
+  std::array<Real, 6> c = {};
+  for(const auto& point : points) {
+    const auto d = point - mean;
+    c[0] += d[0] * d[0]; c[1] += d[0] * d[1]; c[2] += d[0] * d[2];
+    c[3] += d[1] * d[1]; c[4] += d[1] * d[2]; c[5] += d[2] * d[2];
+  }
+
+  const auto first = dominantAxis(c, Vector3());
+  const auto second = dominantAxis(c, first);
+
+  return {{ first, second, cross(first, second) }};
+}
+
+// The tightest capsule around the points with the given axis.
+Capsule fitAlong(const std::vector<Vector3>& points, const Vector3& mean, const Vector3& axis) {
+  // An orthonormal basis across the axis
+  const auto helper = (std::abs(axis[0]) < 0.9) ? Vector3({ 1, 0, 0 }) : Vector3({ 0, 1, 0 });
+  const auto u = unit(cross(axis, helper));
+  const auto v = cross(axis, u);
+
+  std::vector<Vector2> projected;
+  projected.reserve(points.size());
+  for(const auto& point : points) {
+    const auto d = point - mean;
+    projected.push_back(Vector2({ d * u, d * v }));
+  }
+
+  const auto circle = enclosingCircle(projected);
+  const auto radius = circle.radius * (1 + EPSILON) + EPSILON;
+  const auto center = mean + u * circle.center[0] + v * circle.center[1];
+
+  // Pull each end of the segment in as far as possible while its hemispherical cap still covers every vertex
+  auto top = -INF;
+  auto bottom = INF;
+  for(std::size_t i = 0; i < points.size(); ++i) {
+    const auto t = (points[i] - center) * axis;
+    const auto cap = std::sqrt(std::max(radius * radius - lengthSq(projected[i] - circle.center), Real(0)));
+
+    top = std::max(top, t - cap);
+    bottom = std::min(bottom, t + cap);
+  }
+
+  // Short, round point sets need only a sphere
+  if(top < bottom) top = bottom = (top + bottom) / 2;
+
+  return Capsule(center + axis * bottom, center + axis * top, radius);
+}
+
+Real volume(const Capsule& capsule) {
+  const auto r = capsule.radius;
+  return PI * r * r * (length(capsule.b - capsule.a) + 4 * r / 3);
+}
+
+Real clamp(const Real& value) {
+  return std::min(std::max(value, Real(0)), Real(1));
+}
+
+// Ericson's segment-segment closest point (Real-Time Collision Detection, 5.1.9) with every branch turned into a
+// select. Degenerate segments (points) are handled by zeroing their reciprocal lengths rather than branching.
+void distancesScalar(const CapsuleLanes& first, const CapsuleLanes& second, std::array<Real, CapsuleLanes::WIDTH>& result) {
+  const auto& p = first;
+  const auto& q = second;
+  const Real tiny = EPSILON * EPSILON;
+
+  for(std::size_t i = 0; i < CapsuleLanes::WIDTH; ++i) {
+    const auto d1x = p.bx[i] - p.ax[i], d1y = p.by[i] - p.ay[i], d1z = p.bz[i] - p.az[i];
+    const auto d2x = q.bx[i] - q.ax[i], d2y = q.by[i] - q.ay[i], d2z = q.bz[i] - q.az[i];
+    const auto rx = p.ax[i] - q.ax[i], ry = p.ay[i] - q.ay[i], rz = p.az[i] - q.az[i];
+
+    const auto a = d1x * d1x + d1y * d1y + d1z * d1z;
+    const auto e = d2x * d2x + d2y * d2y + d2z * d2z;
+    const auto b = d1x * d2x + d1y * d2y + d1z * d2z;
+    const auto c = d1x * rx + d1y * ry + d1z * rz;
+    const auto f = d2x * rx + d2y * ry + d2z * rz;
+
+    const auto inverseA = (a > tiny) ? 1 / a : Real(0);
+    const auto inverseE = (e > tiny) ? 1 / e : Real(0);
+    const auto denominator = a * e - b * b;
+
+    // Closest point of the infinite lines, or (for near parallel lines) the projection of the second start point
+    auto s = (denominator > EPSILON * a * e) ? clamp((b * f - c * e) / denominator) : clamp(-c * inverseA);
+    const auto t = (b * s + f) * inverseE;
+    const auto tClamped = clamp(t);
+    s = (t == tClamped) ? s : clamp((b * tClamped - c) * inverseA);
+
+    const auto dx = rx + d1x * s - d2x * tClamped;
+    const auto dy = ry + d1y * s - d2y * tClamped;
+    const auto dz = rz + d1z * s - d2z * tClamped;
+
+    result[i] = std::sqrt(dx * dx + dy * dy + dz * dz) - p.radius[i] - q.radius[i];
+  }
+}
+
+#ifdef RBT_AVX_KERNEL
+
+static_assert(std::is_same<Real, float>::value && CapsuleLanes::WIDTH == 8, "The AVX kernel measures 8 single precision pairs at a time");
+
+// As distancesScalar, all lanes at once, with the same arithmetic in the same order.
+__attribute__((target("avx"))) void distancesAVX(const CapsuleLanes& first, const CapsuleLanes& second, std::array<Real, CapsuleLanes::WIDTH>& result) {
+  const auto& p = first;
+  const auto& q = second;
+  const auto zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1);
+  const auto tiny = _mm256_set1_ps(EPSILON * EPSILON), epsilon = _mm256_set1_ps(EPSILON);
+
+  const auto pax = _mm256_loadu_ps(p.ax.data()), pay = _mm256_loadu_ps(p.ay.data()), paz = _mm256_loadu_ps(p.az.data());
+  const auto qax = _mm256_loadu_ps(q.ax.data()), qay = _mm256_loadu_ps(q.ay.data()), qaz = _mm256_loadu_ps(q.az.data());
+  const auto d1x = _mm256_sub_ps(_mm256_loadu_ps(p.bx.data()), pax);
+  const auto d1y = _mm256_sub_ps(_mm256_loadu_ps(p.by.data()), pay);
+  const auto d1z = _mm256_sub_ps(_mm256_loadu_ps(p.bz.data()), paz);
+  const auto d2x = _mm256_sub_ps(_mm256_loadu_ps(q.bx.data()), qax);
+  const auto d2y = _mm256_sub_ps(_mm256_loadu_ps(q.by.data()), qay);
+  const auto d2z = _mm256_sub_ps(_mm256_loadu_ps(q.bz.data()), qaz);
+  const auto rx = _mm256_sub_ps(pax, qax), ry = _mm256_sub_ps(pay, qay), rz = _mm256_sub_ps(paz, qaz);
+
+  const auto a = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(d1x, d1x), _mm256_mul_ps(d1y, d1y)), _mm256_mul_ps(d1z, d1z));
+  const auto e = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(d2x, d2x), _mm256_mul_ps(d2y, d2y)), _mm256_mul_ps(d2z, d2z));
+  const auto b = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(d1x, d2x), _mm256_mul_ps(d1y, d2y)), _mm256_mul_ps(d1z, d2z));
+  const auto c = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(d1x, rx), _mm256_mul_ps(d1y, ry)), _mm256_mul_ps(d1z, rz));
+  const auto f = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(d2x, rx), _mm256_mul_ps(d2y, ry)), _mm256_mul_ps(d2z, rz));
+
+  // clamp(x) is min(max(x, 0), 1)
+  const auto inverseA = _mm256_blendv_ps(zero, _mm256_div_ps(one, a), _mm256_cmp_ps(a, tiny, _CMP_GT_OQ));
+  const auto inverseE = _mm256_blendv_ps(zero, _mm256_div_ps(one, e), _mm256_cmp_ps(e, tiny, _CMP_GT_OQ));
+  const auto denominator = _mm256_sub_ps(_mm256_mul_ps(a, e), _mm256_mul_ps(b, b));
+
+  const auto crossing = _mm256_div_ps(_mm256_sub_ps(_mm256_mul_ps(b, f), _mm256_mul_ps(c, e)), denominator);
+  const auto parallel = _mm256_mul_ps(_mm256_xor_ps(c, _mm256_set1_ps(-0.f)), inverseA);
+  const auto skew = _mm256_cmp_ps(denominator, _mm256_mul_ps(_mm256_mul_ps(epsilon, a), e), _CMP_GT_OQ);
+  auto s = _mm256_min_ps(one, _mm256_max_ps(zero, _mm256_blendv_ps(parallel, crossing, skew)));
+
+  const auto t = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(b, s), f), inverseE);
+  const auto tClamped = _mm256_min_ps(one, _mm256_max_ps(zero, t));
+  const auto sClamped = _mm256_min_ps(one, _mm256_max_ps(zero, _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(b, tClamped), c), inverseA)));
+  s = _mm256_blendv_ps(sClamped, s, _mm256_cmp_ps(t, tClamped, _CMP_EQ_OQ));
+
+  const auto dx = _mm256_sub_ps(_mm256_add_ps(rx, _mm256_mul_ps(d1x, s)), _mm256_mul_ps(d2x, tClamped));
+  const auto dy = _mm256_sub_ps(_mm256_add_ps(ry, _mm256_mul_ps(d1y, s)), _mm256_mul_ps(d2y, tClamped));
+  const auto dz = _mm256_sub_ps(_mm256_add_ps(rz, _mm256_mul_ps(d1z, s)), _mm256_mul_ps(d2z, tClamped));
+  const auto separation = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz)));
+
+  const auto clearance = _mm256_sub_ps(_mm256_sub_ps(separation, _mm256_loadu_ps(p.radius.data())), _mm256_loadu_ps(q.radius.data()));
+  _mm256_storeu_ps(result.data(), clearance);
+}
+
+#endif
+
+}
+
+Capsule transform(const Capsule& capsule, const RigidMatrix& placement) {
+  return Capsule(placement(capsule.a), placement(capsule.b), capsule.radius);
+}
+
+Capsule fitCapsule(const Mesh& mesh) {
+  if(mesh.empty()) return Capsule();
+
+  // Shared vertices must only count once or they skew the principal axes
+  std::vector<Vector3> points;
+  points.reserve(3 * mesh.size());
+  for(const auto& triangle : mesh) {
+    for(std::size_t i = 0; i < 3; ++i) {
+      points.push_back(triangle[i]);
+    }
+  }
+
+  const auto lexicographic = [](const Vector3& a, const Vector3& b) {
+    return std::tie(a[0], a[1], a[2]) < std::tie(b[0], b[1], b[2]);
+  };
+  std::sort(points.begin(), points.end(), lexicographic);
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+
+  auto mean = Vector3();
+  for(const auto& point : points) {
+    mean = mean + point;
+  }
+  mean = mean / static_cast<Real>(points.size());
+
+  // A bounding sphere is the fallback for meshes without a dominant direction
+  AABB box;
+  for(const auto& point : points) {
+    box.expand(point);
+  }
+
+  Real radiusSq = 0;
+  for(const auto& point : points) {
+    radiusSq = std::max(radiusSq, lengthSq(point - box.center()));
+  }
+
+  auto best = Capsule(box.center(), box.center(), std::sqrt(radiusSq) * (1 + EPSILON) + EPSILON);
+  for(const auto& axis : principalAxes(points, mean)) {
+    const auto candidate = fitAlong(points, mean, axis);
+    if(volume(candidate) < volume(best)) best = candidate;
+  }
+
+  return best;
+}
+
+Real distance(const Capsule& first, const Capsule& second) {
+  CapsuleLanes p = {}, q = {};
+  p.set(0, first);
+  q.set(0, second);
+
+  std::array<Real, CapsuleLanes::WIDTH> result;
+  distances(p, q, result);
+
+  return result[0];
+}
+
+void distances(const CapsuleLanes& first, const CapsuleLanes& second, std::array<Real, CapsuleLanes::WIDTH>& result) {
+#ifdef RBT_AVX_KERNEL
+  if(simd::avx()) {
+    distancesAVX(first, second, result);
+    return;
+  }
+#endif
+  distancesScalar(first, second, result);
+}
+
+}
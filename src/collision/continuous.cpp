@@ -0,0 +1,145 @@
+#include "collision/continuous.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
+namespace rbt::collision {
+
+namespace {
+
+std::vector<Real> capsuleRadii(const std::vector<Capsule>& capsules) {
+  std::vector<Real> radii;
+  for(const auto& capsule : capsules) {
+    radii.push_back(std::max(length(capsule.a), length(capsule.b)) + capsule.radius);
+  }
+  return radii;
+}
+
+}
+
+// Joint j rotates about the Z axis of link frame j. Each joint moves the next frame origin by (a, 0, d) in its own
+// frame, so the origin of frame k is at most the sum of sqrt(a^2 + d^2) over joints j to k - 1 from that axis.
+MotionBound::MotionBound(const Serial& robot, const std::vector<Real>& linkRadii) {
+  const auto joints = robot.joints();
+  assert_msg(linkRadii.size() == joints.size() + 1, "Expected a radius for the base and one for each joint");
+
+  this->w.resize(linkRadii.size());
+  for(std::size_t k = 0; k < linkRadii.size(); ++k) {
+    this->w[k].assign(joints.size(), 0);
+
+    Real reach = linkRadii[k];
+    for(std::size_t j = k; j-- > 0;) {
+      reach += std::sqrt(joints[j].a * joints[j].a + joints[j].d * joints[j].d);
+      this->w[k][j] = reach;
+    }
+  }
+}
+
+Real MotionBound::displacement(std::size_t link, const Angles& delta, std::size_t relativeTo) const {
+  const auto& weights = this->w[link];
+
+  Real distance = 0;
+  for(std::size_t j = relativeTo; j < link && j < delta.size(); ++j) {
+    distance += weights[j] * std::abs(delta[j]);
+  }
+
+  return distance;
+}
+
+ContinuousSelfCollision::ContinuousSelfCollision(const SelfDistance& proxies)
+  : proxies(proxies), bound(proxies.serial(), capsuleRadii(proxies.capsules())) {}
+
+std::vector<Real> ContinuousSelfCollision::rates(const Angles& start, const Angles& end) const {
+  assert_msg(start.size() == end.size(), "Motion endpoints must have the same number of joints");
+
+  Angles delta(start.size());
+  for(std::size_t j = 0; j < start.size(); ++j) {
+    delta[j] = end[j] - start[j];
+  }
+
+  // The later link of each pair moving in the frame of the earlier link
+  std::vector<Real> rates;
+  for(const auto& [first, second] : this->proxies.pairs()) {
+    rates.push_back(this->bound.displacement(second, delta, first));
+  }
+
+  return rates;
+}
+
+Real ContinuousSelfCollision::freeRadius(
+  const Angles& start,
+  const Angles& end,
+  const std::vector<Real>& rates,
+  Real s,
+  Real tolerance,
+  std::vector<Real>& distances,
+  SelfDistance::Scratch& scratch
+) const {
+  Angles angles(start.size());
+  for(std::size_t j = 0; j < start.size(); ++j) {
+    angles[j] = start[j] + s * (end[j] - start[j]);
+  }
+
+  this->proxies.distances(angles, distances, scratch);
+
+  Real radius = INF;
+  for(std::size_t k = 0; k < distances.size(); ++k) {
+    if(distances[k] <= tolerance) return -1;
+    if(rates[k] > 0) radius = std::min(radius, distances[k] / rates[k]);
+  }
+
+  return radius;
+}
+
+ContinuousSelfCollision::Result ContinuousSelfCollision::check(const Angles& start, const Angles& end, Real tolerance) const {
+  const auto rates = this->rates(start, end);
+  std::vector<Real> distances;
+  SelfDistance::Scratch scratch;
+
+  const auto first = this->freeRadius(start, end, rates, 0, tolerance, distances, scratch);
+  if(first < 0) return Result{ true, 0, 1 };
+
+  const auto last = this->freeRadius(start, end, rates, 1, tolerance, distances, scratch);
+  if(last < 0) return Result{ true, 1, 2 };
+
+  // Uncovered intervals, processed in breadth-first order so sampling refines evenly over the motion
+  std::deque<std::pair<Real, Real>> uncovered;
+  if(first + last < 1) uncovered.emplace_back(first, 1 - last);
+
+  std::size_t steps = 2;
+  while(!uncovered.empty()) {
+    if(++steps > MAX_STEPS) return Result{ true, uncovered.front().first, MAX_STEPS };
+
+    const auto [a, b] = uncovered.front();
+    uncovered.pop_front();
+
+    const auto s = (a + b) / 2;
+    const auto radius = this->freeRadius(start, end, rates, s, tolerance, distances, scratch);
+    if(radius < 0) return Result{ true, s, steps };
+
+    if(s - radius > a) uncovered.emplace_back(a, s - radius);
+    if(s + radius < b) uncovered.emplace_back(s + radius, b);
+  }
+
+  return Result{ false, 1, steps };
+}
+
+ContinuousSelfCollision::Result ContinuousSelfCollision::firstContact(const Angles& start, const Angles& end, Real tolerance) const {
+  const auto rates = this->rates(start, end);
+  std::vector<Real> distances;
+  SelfDistance::Scratch scratch;
+  Real s = 0;
+
+  for(std::size_t steps = 1; steps <= MAX_STEPS; ++steps) {
+    const auto radius = this->freeRadius(start, end, rates, s, tolerance, distances, scratch);
+    if(radius < 0) return Result{ true, s, steps };
+
+    if(s + radius >= 1) return Result{ false, 1, steps };
+    s += radius;
+  }
+
+  return Result{ true, s, MAX_STEPS };
+}
+
+}
@@ -0,0 +1,425 @@
+#include "collision/convex_hull.hpp"
+#include "utils/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+
+namespace rbt::collision {
+
+namespace {
+
+// Hulls are built in double precision from the single precision input.
+typedef std::array<double, 3> Point;
+
+const uint32_t NONE = 0xFFFFFFFF;
+
+Point subtract(const Point& a, const Point& b) {
+  return {{ a[0] - b[0], a[1] - b[1], a[2] - b[2] }};
+}
+
+Point crossProduct(const Point& a, const Point& b) {
+  return {{ a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] }};
+}
+
+double dotProduct(const Point& a, const Point& b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// A triangle of the hull under construction, with the points still outside it.
+struct Face {
+  std::array<uint32_t, 3> v;
+  // The face across the edge from v[i] to v[i + 1]
+  std::array<uint32_t, 3> adjacent;
+  Point normal;
+  double offset;
+  std::vector<uint32_t> outside;
+  uint32_t farthest;
+  double farthestDistance;
+  bool removed;
+  uint32_t visited;
+};
+
+// Quickhull (Barber, Dobkin and Huhdanpaa) over a fixed set of points.
+class Builder {
+public:
+  std::vector<Face> faces;
+
+  Builder(const std::vector<Point>& points) : points(points) {
+    double scale = 0;
+    for(std::size_t axis = 0; axis < 3; ++axis) {
+      double largest = 0;
+      for(const auto& p : points) {
+        largest = std::max(largest, std::abs(p[axis]));
+      }
+      scale += largest;
+    }
+
+    // Points closer to a plane than the input precision can resolve count as on it
+    this->epsilon = 3 * std::numeric_limits<Real>::epsilon() * scale;
+  };
+
+  // Build the hull. Return false if the points are flat (or fewer than four).
+  bool run() {
+    if(!this->initial()) return false;
+
+    std::vector<uint32_t> pending;
+    for(uint32_t face = 0; face < this->faces.size(); ++face) {
+      pending.push_back(face);
+    }
+
+    while(!pending.empty()) {
+      const auto face = pending.back();
+      pending.pop_back();
+
+      if(this->faces[face].removed || this->faces[face].outside.empty()) continue;
+      this->expand(face, pending);
+    }
+
+    return true;
+  };
+
+private:
+  const std::vector<Point>& points;
+  double epsilon;
+  uint32_t stamp = 0;
+
+  double distance(const Face& face, uint32_t point) const {
+    return dotProduct(face.normal, this->points[point]) - face.offset;
+  };
+
+  uint32_t addFace(uint32_t a, uint32_t b, uint32_t c) {
+    Face face;
+    face.v = {{ a, b, c }};
+    face.adjacent = {{ NONE, NONE, NONE }};
+
+    const auto& pa = this->points[a];
+    const auto n = crossProduct(subtract(this->points[b], pa), subtract(this->points[c], pa));
+    const auto magnitude = std::sqrt(dotProduct(n, n));
+    face.normal = (magnitude > 0) ? Point({{ n[0] / magnitude, n[1] / magnitude, n[2] / magnitude }}) : n;
+    face.offset = dotProduct(face.normal, pa);
+
+    face.farthest = NONE;
+    face.farthestDistance = 0;
+    face.removed = false;
+    face.visited = 0;
+
+    this->faces.push_back(face);
+    return static_cast<uint32_t>(this->faces.size() - 1);
+  };
+
+  // Add the point to the outside set of the first face it is in front of. Return false if there is none.
+  bool assign(uint32_t point, const std::vector<uint32_t>& candidates) {
+    for(const auto candidate : candidates) {
+      auto& face = this->faces[candidate];
+      const auto d = this->distance(face, point);
+      if(d <= this->epsilon) continue;
+
+      face.outside.push_back(point);
+      if(d > face.farthestDistance) {
+        face.farthestDistance = d;
+        face.farthest = point;
+      }
+      return true;
+    }
+    return false;
+  };
+
+  // Start from a tetrahedron of extreme points.
+  bool initial() {
+    const auto& p = this->points;
+    if(p.size() < 4) return false;
+
+    // The most distant pair of the axis extremes
+    std::array<uint32_t, 6> extremes = {};
+    for(uint32_t i = 0; i < p.size(); ++i) {
+      for(std::size_t axis = 0; axis < 3; ++axis) {
+        if(p[i][axis] < p[extremes[2 * axis]][axis]) extremes[2 * axis] = i;
+        if(p[i][axis] > p[extremes[2 * axis + 1]][axis]) extremes[2 * axis + 1] = i;
+      }
+    }
+
+    uint32_t a = 0, b = 0;
+    double widest = -1;
+    for(const auto i : extremes) {
+      for(const auto j : extremes) {
+        const auto d = subtract(p[i], p[j]);
+        if(dotProduct(d, d) > widest) {
+          widest = dotProduct(d, d);
+          a = i;
+          b = j;
+        }
+      }
+    }
+    if(std::sqrt(widest) <= this->epsilon) return false;
+
+    // The point farthest from that line
+    const auto ab = subtract(p[b], p[a]);
+    uint32_t c = 0;
+    double farthest = -1;
+    for(uint32_t i = 0; i < p.size(); ++i) {
+      const auto n = crossProduct(ab, subtract(p[i], p[a]));
+      if(dotProduct(n, n) > farthest) {
+        farthest = dotProduct(n, n);
+        c = i;
+      }
+    }
+    if(std::sqrt(farthest / dotProduct(ab, ab)) <= this->epsilon) return false;
+
+    // The point farthest from that plane
+    auto normal = crossProduct(ab, subtract(p[c], p[a]));
+    const auto magnitude = std::sqrt(dotProduct(normal, normal));
+    normal = {{ normal[0] / magnitude, normal[1] / magnitude, normal[2] / magnitude }};
+
+    uint32_t d = 0;
+    double height = 0;
+    for(uint32_t i = 0; i < p.size(); ++i) {
+      const auto h = dotProduct(normal, subtract(p[i], p[a]));
+      if(std::abs(h) > std::abs(height)) {
+        height = h;
+        d = i;
+      }
+    }
+    if(std::abs(height) <= this->epsilon) return false;
+
+    // Wind every face so the remaining vertex is behind it
+    if(height > 0) std::swap(b, c);
+
+    const auto f0 = this->addFace(a, b, c);
+    const auto f1 = this->addFace(a, d, b);
+    const auto f2 = this->addFace(b, d, c);
+    const auto f3 = this->addFace(c, d, a);
+
+    this->faces[f0].adjacent = {{ f1, f2, f3 }};
+    this->faces[f1].adjacent = {{ f3, f2, f0 }};
+    this->faces[f2].adjacent = {{ f1, f3, f0 }};
+    this->faces[f3].adjacent = {{ f2, f1, f0 }};
+
+    const std::vector<uint32_t> all = { f0, f1, f2, f3 };
+    for(uint32_t i = 0; i < p.size(); ++i) {
+      if(i == a || i == b || i == c || i == d) continue;
+      this->assign(i, all);
+    }
+
+    return true;
+  };
+
+  // Add the farthest outside point of the face to the hull, replacing every face it can see.
+  void expand(uint32_t start, std::vector<uint32_t>& pending) {
+    const auto eye = this->faces[start].farthest;
+    ++this->stamp;
+
+    // Faces visible from the eye form a connected patch around the start face
+    std::vector<uint32_t> visible = { start };
+    this->faces[start].visited = this->stamp;
+    for(std::size_t i = 0; i < visible.size(); ++i) {
+      for(const auto neighbor : this->faces[visible[i]].adjacent) {
+        auto& face = this->faces[neighbor];
+        if(face.visited == this->stamp || this->distance(face, eye) <= this->epsilon) continue;
+
+        face.visited = this->stamp;
+        visible.push_back(neighbor);
+      }
+    }
+
+    // Cone the eye to each edge of the horizon around the patch
+    std::vector<uint32_t> created;
+    std::unordered_map<uint32_t, uint32_t> startingAt, endingAt;
+    for(const auto index : visible) {
+      for(std::size_t e = 0; e < 3; ++e) {
+        const auto& face = this->faces[index];
+        const auto neighbor = face.adjacent[e];
+        if(this->faces[neighbor].visited == this->stamp) continue;
+
+        const auto a = face.v[e];
+        const auto b = face.v[(e + 1) % 3];
+        const auto added = this->addFace(a, b, eye);
+        this->faces[added].adjacent[0] = neighbor;
+
+        auto& behind = this->faces[neighbor];
+        for(std::size_t k = 0; k < 3; ++k) {
+          if(behind.v[k] == b && behind.v[(k + 1) % 3] == a) behind.adjacent[k] = added;
+        }
+
+        startingAt[a] = added;
+        endingAt[b] = added;
+        created.push_back(added);
+      }
+    }
+
+    for(const auto index : created) {
+      auto& face = this->faces[index];
+      face.adjacent[1] = startingAt[face.v[1]];
+      face.adjacent[2] = endingAt[face.v[0]];
+    }
+
+    // Points outside the replaced faces are either outside a new face or now inside the hull
+    for(const auto index : visible) {
+      auto& face = this->faces[index];
+      face.removed = true;
+
+      for(const auto point : face.outside) {
+        if(point != eye) this->assign(point, created);
+      }
+      std::vector<uint32_t>().swap(face.outside);
+    }
+
+    for(const auto index : created) {
+      if(!this->faces[index].outside.empty()) pending.push_back(index);
+    }
+  };
+};
+
+// The indices of the hull vertices of the points, or of every distinct point if they are flat.
+std::vector<uint32_t> hullVertices(const std::vector<Point>& points, std::vector<Face>& faces) {
+  auto builder = Builder(points);
+  std::vector<uint32_t> result;
+
+  if(builder.run()) {
+    for(const auto& face : builder.faces) {
+      if(face.removed) continue;
+      result.insert(result.end(), face.v.begin(), face.v.end());
+      faces.push_back(face);
+    }
+  } else {
+    result.resize(points.size());
+    std::iota(result.begin(), result.end(), 0);
+  }
+
+  std::sort(result.begin(), result.end(), [&points](uint32_t a, uint32_t b) {
+    return std::tie(points[a], a) < std::tie(points[b], b);
+  });
+  result.erase(std::unique(result.begin(), result.end(), [&points](uint32_t a, uint32_t b) {
+    return points[a] == points[b];
+  }), result.end());
+
+  return result;
+}
+
+// Find the representative of the set containing i, flattening the path.
+uint32_t find(std::vector<uint32_t>& parent, uint32_t i) {
+  while(parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+}
+
+ConvexHull::ConvexHull(const std::vector<Vector3>& points) {
+  std::vector<Point> input;
+  input.reserve(points.size());
+  for(const auto& point : points) {
+    input.push_back({{ point[0], point[1], point[2] }});
+  }
+
+  // Large inputs are first reduced to the hull vertices of each thread's share
+  if(input.size() > PARALLEL_THRESHOLD && hardware_threads() > 1) {
+    std::vector<Point> reduced;
+    std::mutex mutex;
+
+    parallel_for(input.size(), [&](std::size_t begin, std::size_t end) {
+      const auto share = std::vector<Point>(input.begin() + begin, input.begin() + end);
+
+      std::vector<Face> unused;
+      const auto vertices = hullVertices(share, unused);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      for(const auto index : vertices) {
+        reduced.push_back(share[index]);
+      }
+    });
+
+    input = reduced;
+  }
+
+  std::vector<Face> faces;
+  const auto vertices = hullVertices(input, faces);
+
+  std::unordered_map<uint32_t, uint32_t> compact;
+  for(const auto index : vertices) {
+    compact[index] = static_cast<uint32_t>(this->v.size());
+    const auto& point = input[index];
+    this->v.push_back(Vector3({ Real(point[0]), Real(point[1]), Real(point[2]) }));
+  }
+
+  for(const auto& face : faces) {
+    this->f.push_back({{ compact[face.v[0]], compact[face.v[1]], compact[face.v[2]] }});
+  }
+
+  // Adjacent faces lying in the same plane share a single Plane
+  std::vector<uint32_t> parent(faces.size());
+  std::iota(parent.begin(), parent.end(), 0);
+
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t> edges;
+  for(uint32_t i = 0; i < faces.size(); ++i) {
+    for(std::size_t e = 0; e < 3; ++e) {
+      edges[{ faces[i].v[e], faces[i].v[(e + 1) % 3] }] = i;
+    }
+  }
+
+  for(uint32_t i = 0; i < faces.size(); ++i) {
+    for(std::size_t e = 0; e < 3; ++e) {
+      const auto twin = edges.find({ faces[i].v[(e + 1) % 3], faces[i].v[e] });
+      if(twin == edges.end()) continue;
+
+      const auto j = twin->second;
+      if(dotProduct(faces[i].normal, faces[j].normal) < 1 - 1e-10) continue;
+      parent[find(parent, i)] = find(parent, j);
+    }
+  }
+
+  std::unordered_map<uint32_t, std::size_t> planeOf;
+  for(uint32_t i = 0; i < faces.size(); ++i) {
+    const auto root = find(parent, i);
+    if(planeOf.count(root) != 0) continue;
+
+    planeOf[root] = this->p.size();
+    const auto& face = faces[root];
+    this->p.push_back(Plane{
+      Vector3({ Real(face.normal[0]), Real(face.normal[1]), Real(face.normal[2]) }),
+      Real(face.offset)
+    });
+  }
+}
+
+ConvexHull::ConvexHull(const Mesh& mesh) : ConvexHull([&mesh]() {
+  std::vector<Vector3> points;
+  points.reserve(3 * mesh.size());
+  for(const auto& triangle : mesh) {
+    for(std::size_t i = 0; i < 3; ++i) {
+      points.push_back(triangle[i]);
+    }
+  }
+  return points;
+}()) {}
+
+Vector3 ConvexHull::support(const Vector3& direction) const {
+  std::size_t best = 0;
+  auto bestDistance = -INF;
+  for(std::size_t i = 0; i < this->v.size(); ++i) {
+    const auto d = this->v[i] * direction;
+    if(d > bestDistance) {
+      bestDistance = d;
+      best = i;
+    }
+  }
+  return this->v.empty() ? Vector3() : this->v[best];
+}
+
+bool ConvexHull::contains(const Vector3& point, Real tolerance) const {
+  if(this->p.empty()) return false;
+
+  for(const auto& plane : this->p) {
+    if(plane.normal * point - plane.offset > tolerance) return false;
+  }
+  return true;
+}
+
+}
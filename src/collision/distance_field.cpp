@@ -0,0 +1,494 @@
+#include "collision/distance_field.hpp"
+#include "utils/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rbt::collision {
+
+namespace {
+
+const uint32_t NO_TRIANGLE = 0xFFFFFFFF;
+
+const char MAGIC[8] = { 'R', 'B', 'T', 'S', 'D', 'F', '\0', '\0' };
+const uint32_t VERSION = 1;
+
+// The layout of the start of a distance field file, followed by the brick table and then the samples of the dense
+// bricks. Its size keeps both arrays aligned when the file is mapped.
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t brickSize;
+  uint32_t samples[3];
+  uint32_t dense;
+  Real origin[3];
+  Real voxelSize;
+  uint8_t padding[16];
+};
+static_assert(sizeof(FileHeader) == 64, "The distance field file header must be 64 bytes");
+
+// The arrays of a field built in memory.
+struct OwnedStorage {
+  std::vector<DistanceField::Brick> table;
+  std::vector<Real> values;
+};
+
+// A read-only mapping of a whole file.
+struct MappedStorage {
+  void* address;
+  std::size_t length;
+
+  MappedStorage(void* address, std::size_t length) : address(address), length(length) {};
+  MappedStorage(const MappedStorage&) = delete;
+  ~MappedStorage() { munmap(this->address, this->length); };
+};
+
+// Twice the signed area of the triangle (0, 0), (x1, y1), (x2, y2), with ties broken consistently (by symbolic
+// perturbation) so a point on an edge shared by two triangles lies in exactly one of them.
+// From Bridson's makelevelset3.
+int orientation(double x1, double y1, double x2, double y2, double& area) {
+  area = y1 * x2 - x1 * y2;
+  if(area > 0) return 1;
+  if(area < 0) return -1;
+  if(y2 > y1) return 1;
+  if(y2 < y1) return -1;
+  if(x1 > x2) return 1;
+  if(x1 < x2) return -1;
+  return 0;
+}
+
+// If (x0, y0) lies in the 2D triangle, return true along with its barycentric coordinates.
+bool pointInTriangle(
+  double x0, double y0,
+  double x1, double y1, double x2, double y2, double x3, double y3,
+  double& a, double& b, double& c
+) {
+  x1 -= x0; x2 -= x0; x3 -= x0;
+  y1 -= y0; y2 -= y0; y3 -= y0;
+
+  const auto signA = orientation(x2, y2, x3, y3, a);
+  if(signA == 0) return false;
+
+  const auto signB = orientation(x3, y3, x1, y1, b);
+  if(signB != signA) return false;
+
+  const auto signC = orientation(x1, y1, x2, y2, c);
+  if(signC != signA) return false;
+
+  const auto sum = a + b + c;
+  if(sum == 0) return false;
+
+  a /= sum; b /= sum; c /= sum;
+  return true;
+}
+
+// Dense grids used while building, indexed x fastest.
+struct Grid {
+  std::array<std::size_t, 3> n;
+
+  inline std::size_t index(std::size_t i, std::size_t j, std::size_t k) const {
+    return i + this->n[0] * (j + this->n[1] * k);
+  };
+  inline std::size_t size() const { return this->n[0] * this->n[1] * this->n[2]; };
+};
+
+// Seed the samples within a voxel of each triangle with their exact distance and closest triangle.
+void seed(
+  const Mesh& mesh,
+  const Grid& grid,
+  const Vector3& origin,
+  Real h,
+  std::vector<Real>& distances,
+  std::vector<uint32_t>& closest
+) {
+  // Each chunk of z slices is owned by one thread, which visits only the triangles reaching into it
+  parallel_for(grid.n[2], [&](std::size_t kBegin, std::size_t kEnd) {
+    for(std::size_t t = 0; t < mesh.size(); ++t) {
+      const auto box = bounds(mesh[t]);
+
+      std::array<std::size_t, 3> lower, upper;
+      for(std::size_t axis = 0; axis < 3; ++axis) {
+        const auto low = std::floor((box.min[axis] - origin[axis]) / h) - 1;
+        const auto high = std::ceil((box.max[axis] - origin[axis]) / h) + 1;
+        const auto last = static_cast<Real>(grid.n[axis] - 1);
+        lower[axis] = static_cast<std::size_t>(std::clamp(low, Real(0), last));
+        upper[axis] = static_cast<std::size_t>(std::clamp(high, Real(0), last));
+      }
+      lower[2] = std::max(lower[2], kBegin);
+      upper[2] = std::min(upper[2], kEnd - 1);
+
+      for(auto k = lower[2]; k <= upper[2]; ++k) {
+        for(auto j = lower[1]; j <= upper[1]; ++j) {
+          for(auto i = lower[0]; i <= upper[0]; ++i) {
+            const auto p = origin + Vector3({ Real(i), Real(j), Real(k) }) * h;
+            const auto d = length(closestPoint(mesh[t], p) - p);
+            const auto index = grid.index(i, j, k);
+
+            if(d < distances[index]) {
+              distances[index] = d;
+              closest[index] = static_cast<uint32_t>(t);
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+// Spread the closest triangles from the seeded samples to the rest of the grid by jump flooding: each pass offers
+// every sample the closest triangles of its 26 neighbors at a halving step, then a final pass at step 1 cleans up.
+void flood(
+  const Mesh& mesh,
+  const Grid& grid,
+  const Vector3& origin,
+  Real h,
+  std::vector<Real>& distances,
+  std::vector<uint32_t>& closest
+) {
+  std::size_t step = 1;
+  while(2 * step < *std::max_element(grid.n.begin(), grid.n.end())) step *= 2;
+
+  std::vector<std::size_t> steps;
+  for(auto s = step; s > 0; s /= 2) {
+    steps.push_back(s);
+  }
+  steps.push_back(1);
+
+  auto nextDistances = distances;
+  auto nextClosest = closest;
+
+  for(const auto s : steps) {
+    const auto offset = static_cast<long>(s);
+
+    parallel_for(grid.n[2], [&](std::size_t kBegin, std::size_t kEnd) {
+      for(auto k = kBegin; k < kEnd; ++k) {
+        for(std::size_t j = 0; j < grid.n[1]; ++j) {
+          for(std::size_t i = 0; i < grid.n[0]; ++i) {
+            const auto index = grid.index(i, j, k);
+            const auto p = origin + Vector3({ Real(i), Real(j), Real(k) }) * h;
+
+            auto best = distances[index];
+            auto triangle = closest[index];
+
+            for(long dk = -offset; dk <= offset; dk += offset) {
+              for(long dj = -offset; dj <= offset; dj += offset) {
+                for(long di = -offset; di <= offset; di += offset) {
+                  const auto ni = static_cast<long>(i) + di;
+                  const auto nj = static_cast<long>(j) + dj;
+                  const auto nk = static_cast<long>(k) + dk;
+                  if(ni < 0 || nj < 0 || nk < 0) continue;
+                  if(ni >= static_cast<long>(grid.n[0]) || nj >= static_cast<long>(grid.n[1])) continue;
+                  if(nk >= static_cast<long>(grid.n[2])) continue;
+
+                  const auto candidate = closest[grid.index(ni, nj, nk)];
+                  if(candidate == NO_TRIANGLE || candidate == triangle) continue;
+
+                  const auto d = length(closestPoint(mesh[candidate], p) - p);
+                  if(d < best) {
+                    best = d;
+                    triangle = candidate;
+                  }
+                }
+              }
+            }
+
+            nextDistances[index] = best;
+            nextClosest[index] = triangle;
+          }
+        }
+      }
+    });
+
+    std::swap(distances, nextDistances);
+    std::swap(closest, nextClosest);
+  }
+}
+
+// Count, for each sample, the surface crossings of the ray from the -X side of the grid to it. Samples with an odd
+// count are inside the mesh.
+std::vector<bool> inside(const Mesh& mesh, const Grid& grid, const Vector3& origin, Real h) {
+  std::vector<uint32_t> crossings(grid.size(), 0);
+
+  parallel_for(grid.n[2], [&](std::size_t kBegin, std::size_t kEnd) {
+    for(const auto& triangle : mesh) {
+      std::array<std::array<double, 3>, 3> v;
+      for(std::size_t corner = 0; corner < 3; ++corner) {
+        for(std::size_t axis = 0; axis < 3; ++axis) {
+          v[corner][axis] = (static_cast<double>(triangle[corner][axis]) - origin[axis]) / h;
+        }
+      }
+
+      const auto jLow = std::max(0.0, std::ceil(std::min({ v[0][1], v[1][1], v[2][1] })));
+      const auto jHigh = std::min(grid.n[1] - 1.0, std::floor(std::max({ v[0][1], v[1][1], v[2][1] })));
+      const auto kLow = std::max(static_cast<double>(kBegin), std::ceil(std::min({ v[0][2], v[1][2], v[2][2] })));
+      const auto kHigh = std::min(kEnd - 1.0, std::floor(std::max({ v[0][2], v[1][2], v[2][2] })));
+
+      for(auto k = kLow; k <= kHigh; ++k) {
+        for(auto j = jLow; j <= jHigh; ++j) {
+          double a, b, c;
+          if(!pointInTriangle(j, k, v[0][1], v[0][2], v[1][1], v[1][2], v[2][1], v[2][2], a, b, c)) continue;
+
+          // Samples past the crossing along the ray count it
+          const auto x = std::ceil(a * v[0][0] + b * v[1][0] + c * v[2][0]);
+          if(x >= static_cast<double>(grid.n[0])) continue;
+
+          const auto i = static_cast<std::size_t>(std::max(x, 0.0));
+          ++crossings[grid.index(i, static_cast<std::size_t>(j), static_cast<std::size_t>(k))];
+        }
+      }
+    }
+  });
+
+  std::vector<bool> result(grid.size());
+  for(std::size_t k = 0; k < grid.n[2]; ++k) {
+    for(std::size_t j = 0; j < grid.n[1]; ++j) {
+      uint32_t total = 0;
+      for(std::size_t i = 0; i < grid.n[0]; ++i) {
+        total += crossings[grid.index(i, j, k)];
+        result[grid.index(i, j, k)] = (total % 2) == 1;
+      }
+    }
+  }
+
+  return result;
+}
+
+}
+
+DistanceField::DistanceField(const Mesh& mesh, Real voxelSize, Real padding, Real band) : h(voxelSize) {
+  assert_msg(voxelSize > 0, "The voxel size must be positive");
+
+  AABB box;
+  for(const auto& triangle : mesh) {
+    box.expand(rbt::bounds(triangle));
+  }
+  if(box.empty()) box = AABB(Vector3(), Vector3());
+
+  this->o = box.min - Vector3({ padding, padding, padding });
+
+  // Enough samples to cover the padded bounds, rounded up to whole bricks
+  Grid grid;
+  for(std::size_t axis = 0; axis < 3; ++axis) {
+    const auto span = box.max[axis] - box.min[axis] + 2 * padding;
+    const auto count = static_cast<std::size_t>(std::ceil(span / voxelSize)) + 1;
+    grid.n[axis] = (count + BRICK_SIZE - 1) / BRICK_SIZE * BRICK_SIZE;
+  }
+  this->n = grid.n;
+
+  std::vector<Real> distances(grid.size(), INF);
+  std::vector<uint32_t> closest(grid.size(), NO_TRIANGLE);
+  seed(mesh, grid, this->o, this->h, distances, closest);
+  flood(mesh, grid, this->o, this->h, distances, closest);
+
+  const auto interior = inside(mesh, grid, this->o, this->h);
+  for(std::size_t index = 0; index < grid.size(); ++index) {
+    if(interior[index]) distances[index] = -distances[index];
+  }
+
+  // Pack into bricks, collapsing those entirely outside the band
+  auto owned = std::make_shared<OwnedStorage>();
+  const std::array<std::size_t, 3> bricks = {
+    grid.n[0] / BRICK_SIZE, grid.n[1] / BRICK_SIZE, grid.n[2] / BRICK_SIZE
+  };
+
+  for(std::size_t bk = 0; bk < bricks[2]; ++bk) {
+    for(std::size_t bj = 0; bj < bricks[1]; ++bj) {
+      for(std::size_t bi = 0; bi < bricks[0]; ++bi) {
+        std::array<Real, BRICK_VOLUME> brick;
+        for(std::size_t k = 0; k < BRICK_SIZE; ++k) {
+          for(std::size_t j = 0; j < BRICK_SIZE; ++j) {
+            for(std::size_t i = 0; i < BRICK_SIZE; ++i) {
+              const auto index = grid.index(bi * BRICK_SIZE + i, bj * BRICK_SIZE + j, bk * BRICK_SIZE + k);
+              brick[i + BRICK_SIZE * (j + BRICK_SIZE * k)] = distances[index];
+            }
+          }
+        }
+
+        const auto nearest = *std::min_element(brick.begin(), brick.end(),
+          [](const Real& a, const Real& b) { return std::abs(a) < std::abs(b); });
+        const auto uniform = std::all_of(brick.begin(), brick.end(),
+          [&band, &nearest](const Real& d) { return std::abs(d) >= band && (d < 0) == (nearest < 0); });
+
+        if(uniform) {
+          owned->table.push_back(Brick{ UNIFORM, nearest });
+        } else {
+          owned->table.push_back(Brick{ static_cast<uint32_t>(owned->values.size() / BRICK_VOLUME), 0 });
+          owned->values.insert(owned->values.end(), brick.begin(), brick.end());
+        }
+      }
+    }
+  }
+
+  this->dense = owned->values.size() / BRICK_VOLUME;
+  this->table = owned->table.data();
+  this->values = owned->values.data();
+  this->storage = owned;
+}
+
+DistanceField::DistanceField(
+  const Vector3& origin,
+  Real voxelSize,
+  const std::array<std::size_t, 3>& samples,
+  std::size_t dense,
+  std::shared_ptr<const void> storage,
+  const Brick* table,
+  const Real* values
+) : o(origin), h(voxelSize), n(samples), dense(dense), storage(std::move(storage)), table(table), values(values) {}
+
+DistanceField DistanceField::load(const std::string& file_path) {
+  const auto fd = open(file_path.c_str(), O_RDONLY);
+  if(fd < 0) throw std::runtime_error("Couldn't open the distance field " + file_path);
+
+  struct stat status;
+  if(fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(FileHeader)) {
+    close(fd);
+    throw std::runtime_error("Couldn't read the distance field " + file_path);
+  }
+
+  const auto length = static_cast<std::size_t>(status.st_size);
+  const auto address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(address == MAP_FAILED) throw std::runtime_error("Couldn't map the distance field " + file_path);
+
+  const auto mapped = std::make_shared<MappedStorage>(address, length);
+  const auto bytes = static_cast<const char*>(address);
+
+  FileHeader header;
+  std::memcpy(&header, bytes, sizeof(FileHeader));
+
+  if(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+    throw std::runtime_error(file_path + " is not a distance field");
+  }
+
+  std::array<std::size_t, 3> samples;
+  for(std::size_t axis = 0; axis < 3; ++axis) {
+    samples[axis] = header.samples[axis];
+    if(header.brickSize != BRICK_SIZE || samples[axis] == 0 || samples[axis] % BRICK_SIZE != 0) {
+      throw std::runtime_error(file_path + " has an unsupported brick layout");
+    }
+  }
+
+  const auto brickCount = samples[0] * samples[1] * samples[2] / BRICK_VOLUME;
+  const auto expected = sizeof(FileHeader) + brickCount * sizeof(Brick) + header.dense * BRICK_VOLUME * sizeof(Real);
+  if(length != expected) throw std::runtime_error(file_path + " is truncated");
+
+  const auto table = reinterpret_cast<const Brick*>(bytes + sizeof(FileHeader));
+  const auto values = reinterpret_cast<const Real*>(bytes + sizeof(FileHeader) + brickCount * sizeof(Brick));
+
+  for(std::size_t b = 0; b < brickCount; ++b) {
+    if(table[b].offset != UNIFORM && table[b].offset >= header.dense) {
+      throw std::runtime_error(file_path + " references a missing brick");
+    }
+  }
+
+  return DistanceField(
+    Vector3({ header.origin[0], header.origin[1], header.origin[2] }),
+    header.voxelSize,
+    samples,
+    header.dense,
+    mapped,
+    table,
+    values
+  );
+}
+
+void DistanceField::save(const std::string& file_path) const {
+  FileHeader header = {};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.brickSize = BRICK_SIZE;
+  header.dense = static_cast<uint32_t>(this->dense);
+  header.voxelSize = this->h;
+  for(std::size_t axis = 0; axis < 3; ++axis) {
+    header.samples[axis] = static_cast<uint32_t>(this->n[axis]);
+    header.origin[axis] = this->o[axis];
+  }
+
+  auto file = std::ofstream(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!file.is_open()) throw std::runtime_error("Couldn't create the distance field " + file_path);
+
+  file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+  file.write(reinterpret_cast<const char*>(this->table), this->bricks() * sizeof(Brick));
+  file.write(reinterpret_cast<const char*>(this->values), this->dense * BRICK_VOLUME * sizeof(Real));
+
+  if(!file) throw std::runtime_error("Couldn't write the distance field " + file_path);
+}
+
+Real DistanceField::at(std::size_t i, std::size_t j, std::size_t k) const {
+  const auto& brick = this->table[
+    i / BRICK_SIZE + this->n[0] / BRICK_SIZE * (j / BRICK_SIZE + this->n[1] / BRICK_SIZE * (k / BRICK_SIZE))
+  ];
+  if(brick.offset == UNIFORM) return brick.value;
+
+  const auto local = i % BRICK_SIZE + BRICK_SIZE * (j % BRICK_SIZE + BRICK_SIZE * (k % BRICK_SIZE));
+  return this->values[brick.offset * BRICK_VOLUME + local];
+}
+
+AABB DistanceField::bounds() const {
+  const auto size = Vector3({ Real(this->n[0] - 1), Real(this->n[1] - 1), Real(this->n[2] - 1) }) * this->h;
+  return AABB(this->o, this->o + size);
+}
+
+DistanceField::Sample DistanceField::sample(const Vector3& p) const {
+  const auto box = this->bounds();
+
+  // Outside the grid, continue from the nearest point of the grid
+  Vector3 q;
+  for(std::size_t axis = 0; axis < 3; ++axis) {
+    q[axis] = std::clamp(p[axis], box.min[axis], box.max[axis]);
+  }
+
+  std::array<std::size_t, 3> cell;
+  std::array<Real, 3> f;
+  for(std::size_t axis = 0; axis < 3; ++axis) {
+    const auto u = (q[axis] - this->o[axis]) / this->h;
+    cell[axis] = std::min(static_cast<std::size_t>(std::max(u, Real(0))), this->n[axis] - 2);
+    f[axis] = std::clamp(u - cell[axis], Real(0), Real(1));
+  }
+
+  const auto [i, j, k] = cell;
+  const Real c000 = this->at(i, j, k), c100 = this->at(i + 1, j, k);
+  const Real c010 = this->at(i, j + 1, k), c110 = this->at(i + 1, j + 1, k);
+  const Real c001 = this->at(i, j, k + 1), c101 = this->at(i + 1, j, k + 1);
+  const Real c011 = this->at(i, j + 1, k + 1), c111 = this->at(i + 1, j + 1, k + 1);
+
+  const auto lerp = [](const Real& a, const Real& b, const Real& t) { return a + t * (b - a); };
+
+  // Interpolate along x, then y, then z; the derivative along each axis follows from the same corners
+  const auto c00 = lerp(c000, c100, f[0]), c10 = lerp(c010, c110, f[0]);
+  const auto c01 = lerp(c001, c101, f[0]), c11 = lerp(c011, c111, f[0]);
+  const auto c0 = lerp(c00, c10, f[1]), c1 = lerp(c01, c11, f[1]);
+
+  const auto dx = lerp(lerp(c100 - c000, c110 - c010, f[1]), lerp(c101 - c001, c111 - c011, f[1]), f[2]);
+  const auto dy = lerp(c10 - c00, c11 - c01, f[2]);
+  const auto dz = c1 - c0;
+
+  auto result = Sample{ lerp(c0, c1, f[2]), Vector3({ dx, dy, dz }) / this->h };
+
+  const auto outside = length(p - q);
+  if(outside > 0) {
+    result.distance += outside;
+    result.gradient = (p - q) / outside;
+  }
+
+  return result;
+}
+
+Real DistanceField::distance(const Vector3& p) const {
+  return this->sample(p).distance;
+}
+
+Vector3 DistanceField::gradient(const Vector3& p) const {
+  return this->sample(p).gradient;
+}
+
+}
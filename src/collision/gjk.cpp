@@ -0,0 +1,434 @@
+#include "collision/gjk.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace rbt::collision {
+
+namespace {
+
+// GJK stops once the support point improves the (squared) distance by less than this fraction.
+const Real RELATIVE_TOLERANCE = 1e-5;
+
+// A point of the Minkowski difference a - b with the support points that produced it.
+struct Vertex {
+  Vector3 w, a, b;
+  Vector3 direction;
+};
+
+// The simplex under construction, with the barycentric weight of each vertex in its point closest to the origin.
+struct Working {
+  std::array<Vertex, 4> v;
+  std::array<Real, 4> weight;
+  std::size_t size = 0;
+};
+
+Vertex supportVertex(const ConvexShape& a, const ConvexShape& b, const Vector3& direction) {
+  Vertex vertex;
+  vertex.direction = direction;
+  vertex.a = a.support(direction);
+  vertex.b = b.support(Real(-1) * direction);
+  vertex.w = vertex.a - vertex.b;
+  return vertex;
+}
+
+// Keep only the listed vertices, with their weights.
+void keep(Working& s, std::initializer_list<std::pair<std::size_t, Real>> kept) {
+  Working reduced;
+  for(const auto& [index, weight] : kept) {
+    reduced.v[reduced.size] = s.v[index];
+    reduced.weight[reduced.size] = weight;
+    ++reduced.size;
+  }
+  s = reduced;
+}
+
+// The closest point to the origin of the triangle of vertices i, j, k (Ericson, Real-Time Collision Detection 5.1.5).
+// Reduces the simplex to the vertices of the closest feature.
+Vector3 closestTriangle(Working& s, std::size_t i, std::size_t j, std::size_t k) {
+  const auto a = s.v[i].w, b = s.v[j].w, c = s.v[k].w;
+  const auto ab = b - a, ac = c - a;
+
+  const auto d1 = ab * (Real(-1) * a), d2 = ac * (Real(-1) * a);
+  if(d1 <= 0 && d2 <= 0) {
+    keep(s, {{ i, 1 }});
+    return a;
+  }
+
+  const auto d3 = ab * (Real(-1) * b), d4 = ac * (Real(-1) * b);
+  if(d3 >= 0 && d4 <= d3) {
+    keep(s, {{ j, 1 }});
+    return b;
+  }
+
+  const auto vc = d1 * d4 - d3 * d2;
+  if(vc <= 0 && d1 >= 0 && d3 <= 0) {
+    const auto t = d1 / (d1 - d3);
+    keep(s, {{ i, 1 - t }, { j, t }});
+    return a + t * ab;
+  }
+
+  const auto d5 = ab * (Real(-1) * c), d6 = ac * (Real(-1) * c);
+  if(d6 >= 0 && d5 <= d6) {
+    keep(s, {{ k, 1 }});
+    return c;
+  }
+
+  const auto vb = d5 * d2 - d1 * d6;
+  if(vb <= 0 && d2 >= 0 && d6 <= 0) {
+    const auto t = d2 / (d2 - d6);
+    keep(s, {{ i, 1 - t }, { k, t }});
+    return a + t * ac;
+  }
+
+  const auto va = d3 * d6 - d5 * d4;
+  if(va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+    const auto t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    keep(s, {{ j, 1 - t }, { k, t }});
+    return b + t * (c - b);
+  }
+
+  const auto denominator = 1 / (va + vb + vc);
+  const auto v = vb * denominator, w = vc * denominator;
+  keep(s, {{ i, 1 - v - w }, { j, v }, { k, w }});
+  return a + v * ab + w * ac;
+}
+
+// The closest point to the origin of the simplex, reducing it to the vertices of the closest feature.
+// Sets inside if the origin is enclosed by a tetrahedral simplex.
+Vector3 closest(Working& s, bool& inside) {
+  inside = false;
+
+  if(s.size == 1) {
+    s.weight[0] = 1;
+    return s.v[0].w;
+  }
+
+  if(s.size == 2) {
+    const auto a = s.v[0].w, ab = s.v[1].w - a;
+    const auto lengthSquared = ab * ab;
+    const auto t = (lengthSquared > 0) ? std::clamp((Real(-1) * a * ab) / lengthSquared, Real(0), Real(1)) : Real(0);
+
+    if(t <= 0) keep(s, {{ 0, 1 }});
+    else if(t >= 1) keep(s, {{ 1, 1 }});
+    else keep(s, {{ 0, 1 - t }, { 1, t }});
+
+    return a + t * ab;
+  }
+
+  if(s.size == 3) return closestTriangle(s, 0, 1, 2);
+
+  // The origin is outside the tetrahedron if it is beyond any face, seen from the opposite vertex
+  const std::array<std::array<std::size_t, 4>, 4> faces = {{ {{0, 1, 2, 3}}, {{0, 2, 3, 1}}, {{0, 3, 1, 2}}, {{1, 3, 2, 0}} }};
+
+  auto best = Vector3();
+  auto bestDistance = INF;
+  Working bestSimplex;
+
+  for(const auto& face : faces) {
+    const auto a = s.v[face[0]].w;
+    const auto n = cross(s.v[face[1]].w - a, s.v[face[2]].w - a);
+    const auto origin = Real(-1) * (n * a);
+    const auto opposite = n * (s.v[face[3]].w - a);
+
+    // Flat tetrahedra have every face "outside" so the closest face is still found
+    if(origin * opposite > 0 && std::abs(opposite) > EPSILON * EPSILON) continue;
+
+    auto candidate = s;
+    const auto p = closestTriangle(candidate, face[0], face[1], face[2]);
+    if(lengthSq(p) < bestDistance) {
+      bestDistance = lengthSq(p);
+      best = p;
+      bestSimplex = candidate;
+    }
+  }
+
+  if(bestDistance == INF) {
+    inside = true;
+    return Vector3();
+  }
+
+  s = bestSimplex;
+  return best;
+}
+
+bool contains(const Working& s, const Vector3& w) {
+  for(std::size_t i = 0; i < s.size; ++i) {
+    if(lengthSq(s.v[i].w - w) <= EPSILON * EPSILON) return true;
+  }
+  return false;
+}
+
+// A face of the EPA polytope with its unit outward normal and distance from the origin.
+struct Face {
+  std::array<std::size_t, 3> v;
+  Vector3 normal;
+  Real distance;
+};
+
+Face makeFace(const std::vector<Vertex>& vertices, std::size_t i, std::size_t j, std::size_t k) {
+  const auto n = cross(vertices[j].w - vertices[i].w, vertices[k].w - vertices[i].w);
+  const auto magnitude = length(n);
+  if(magnitude <= 0) return Face{ {{ i, j, k }}, Vector3(), INF };
+
+  const auto normal = n / magnitude;
+  return Face{ {{ i, j, k }}, normal, normal * vertices[i].w };
+}
+
+// Grow the simplex (which encloses or touches the origin) into a tetrahedron. Return false if the shapes are flat
+// in every direction tried.
+bool inflate(const ConvexShape& a, const ConvexShape& b, Working& s) {
+  const std::array<Vector3, 6> axes = {
+    Vector3({1, 0, 0}), Vector3({-1, 0, 0}), Vector3({0, 1, 0}), Vector3({0, -1, 0}), Vector3({0, 0, 1}), Vector3({0, 0, -1})
+  };
+
+  const auto tryAdd = [&](const Vector3& direction) {
+    const auto vertex = supportVertex(a, b, direction);
+    if(contains(s, vertex.w)) return false;
+
+    // The new vertex must also lie off the line or plane of the existing ones
+    if(s.size == 2 && lengthSq(cross(s.v[1].w - s.v[0].w, vertex.w - s.v[0].w)) <= EPSILON * EPSILON) return false;
+    if(s.size == 3) {
+      const auto n = cross(s.v[1].w - s.v[0].w, s.v[2].w - s.v[0].w);
+      if(std::abs(n * (vertex.w - s.v[0].w)) <= EPSILON * EPSILON) return false;
+    }
+
+    s.v[s.size++] = vertex;
+    return true;
+  };
+
+  if(s.size == 1) {
+    for(const auto& axis : axes) {
+      if(tryAdd(axis)) break;
+    }
+  }
+
+  if(s.size == 2) {
+    const auto d = s.v[1].w - s.v[0].w;
+    const auto helper = (std::abs(d[0]) < std::abs(d[1])) ? Vector3({1, 0, 0}) : Vector3({0, 1, 0});
+    const auto u = cross(d, helper);
+    const auto v = cross(d, u);
+    for(const auto& direction : { u, Real(-1) * u, v, Real(-1) * v, u + v, Real(-1) * (u + v) }) {
+      if(tryAdd(direction)) break;
+    }
+  }
+
+  if(s.size == 3) {
+    const auto n = cross(s.v[1].w - s.v[0].w, s.v[2].w - s.v[0].w);
+    if(!tryAdd(n)) tryAdd(Real(-1) * n);
+  }
+
+  return s.size == 4;
+}
+
+// Expanding polytope algorithm: grow the tetrahedron towards the boundary of a - b until the face nearest the
+// origin is on it. Returns that face (and the polytope's vertices).
+Face expand(const ConvexShape& a, const ConvexShape& b, const Working& s, std::vector<Vertex>& vertices, std::size_t& iterations) {
+  vertices.assign(s.v.begin(), s.v.begin() + 4);
+
+  std::vector<Face> faces;
+  for(const auto& f : std::array<std::array<std::size_t, 4>, 4>{{ {{0, 1, 2, 3}}, {{0, 3, 1, 2}}, {{0, 2, 3, 1}}, {{1, 3, 2, 0}} }}) {
+    // Wind each face so its normal points away from the opposite vertex
+    auto face = makeFace(vertices, f[0], f[1], f[2]);
+    if(face.normal * (vertices[f[3]].w - vertices[f[0]].w) > 0) face = makeFace(vertices, f[0], f[2], f[1]);
+    faces.push_back(face);
+  }
+
+  Face nearest = faces.front();
+  for(std::size_t iteration = 0; iteration < MAX_GJK_ITERATIONS; ++iteration) {
+    nearest = *std::min_element(faces.begin(), faces.end(),
+      [](const Face& x, const Face& y) { return x.distance < y.distance; });
+    if(nearest.distance == INF) break;
+
+    const auto vertex = supportVertex(a, b, nearest.normal);
+    ++iterations;
+    if(vertex.w * nearest.normal - nearest.distance <= RELATIVE_TOLERANCE * std::max(nearest.distance, Real(1))) break;
+
+    // Remove every face the new vertex can see and patch the hole with faces to it from the horizon
+    vertices.push_back(vertex);
+    const auto added = vertices.size() - 1;
+
+    std::vector<std::pair<std::size_t, std::size_t>> horizon;
+    std::vector<Face> kept;
+    for(const auto& face : faces) {
+      if(face.normal * (vertex.w - vertices[face.v[0]].w) <= 0) {
+        kept.push_back(face);
+        continue;
+      }
+
+      for(std::size_t e = 0; e < 3; ++e) {
+        const auto edge = std::make_pair(face.v[e], face.v[(e + 1) % 3]);
+        const auto twin = std::find(horizon.begin(), horizon.end(), std::make_pair(edge.second, edge.first));
+        if(twin != horizon.end()) horizon.erase(twin);
+        else horizon.push_back(edge);
+      }
+    }
+
+    for(const auto& edge : horizon) {
+      kept.push_back(makeFace(vertices, edge.first, edge.second, added));
+    }
+    faces = kept;
+  }
+
+  return nearest;
+}
+
+Separation separated(const ConvexShape& a, const ConvexShape& b, const Working& s, const Vector3& v, std::size_t iterations) {
+  auto pa = Vector3(), pb = Vector3();
+  for(std::size_t i = 0; i < s.size; ++i) {
+    pa = pa + s.weight[i] * s.v[i].a;
+    pb = pb + s.weight[i] * s.v[i].b;
+  }
+
+  const auto coreDistance = length(v);
+  const auto normal = Real(-1) * v / coreDistance;
+
+  return Separation{
+    coreDistance - a.margin() - b.margin(),
+    pa + a.margin() * normal,
+    pb - b.margin() * normal,
+    normal,
+    iterations
+  };
+}
+
+}
+
+ConvexShape::ConvexShape(const ConvexHull& hull, const RigidMatrix& placement)
+  : type(Type::HULL), vertices(hull.vertices()), radius(0) {
+  assert_msg(!hull.vertices().empty(), "A hull needs vertices");
+
+  auto sum = Vector3();
+  for(const auto& vertex : hull.vertices()) {
+    sum = sum + vertex;
+  }
+  this->middle = sum / static_cast<Real>(hull.vertices().size());
+  this->place(placement);
+}
+
+ConvexShape::ConvexShape(const Capsule& capsule, const RigidMatrix& placement)
+  : type(Type::SEGMENT), vertices(std::vector<Vector3>({ capsule.a, capsule.b })), radius(capsule.radius),
+    middle((capsule.a + capsule.b) / Real(2)) {
+  this->place(placement);
+}
+
+ConvexShape::ConvexShape(const Box& box, const RigidMatrix& placement)
+  : type(Type::BOX), halfExtents(box.halfExtents), radius(0), middle(Vector3()) {
+  this->place(placement);
+}
+
+void ConvexShape::place(const RigidMatrix& placement) {
+  this->world = placement;
+  this->local = inverse(placement);
+}
+
+Vector3 ConvexShape::support(const Vector3& direction) const {
+  const auto d = this->local.rotate(direction);
+
+  switch(this->type) {
+    case Type::HULL:
+      return this->world(this->vertices[farthest(this->vertices, d)]);
+    case Type::SEGMENT:
+      return this->world((d * (this->vertices[1] - this->vertices[0]) > 0) ? this->vertices[1] : this->vertices[0]);
+    case Type::BOX:
+      return this->world(Vector3({
+        (d[0] >= 0) ? this->halfExtents[0] : -this->halfExtents[0],
+        (d[1] >= 0) ? this->halfExtents[1] : -this->halfExtents[1],
+        (d[2] >= 0) ? this->halfExtents[2] : -this->halfExtents[2]
+      }));
+  }
+
+  return this->center();
+}
+
+Separation separation(const ConvexShape& a, const ConvexShape& b) {
+  Simplex simplex;
+  return separation(a, b, simplex);
+}
+
+Separation separation(const ConvexShape& a, const ConvexShape& b, Simplex& simplex) {
+  Working s;
+  std::size_t iterations = 0;
+
+  // Start from the previous simplex's directions, or from the direction between the shapes
+  for(std::size_t i = 0; i < simplex.size; ++i) {
+    const auto vertex = supportVertex(a, b, simplex.directions[i]);
+    ++iterations;
+    if(!contains(s, vertex.w)) s.v[s.size++] = vertex;
+  }
+
+  if(s.size == 0) {
+    auto direction = b.center() - a.center();
+    if(lengthSq(direction) <= EPSILON * EPSILON) direction = Vector3({1, 0, 0});
+    s.v[s.size++] = supportVertex(a, b, direction);
+    ++iterations;
+  }
+
+  bool inside = false;
+  auto v = closest(s, inside);
+
+  for(std::size_t iteration = 0; iteration < MAX_GJK_ITERATIONS && !inside; ++iteration) {
+    const auto distanceSquared = lengthSq(v);
+    if(distanceSquared <= EPSILON * EPSILON) break;
+
+    const auto vertex = supportVertex(a, b, Real(-1) * v);
+    ++iterations;
+
+    // No support point gets meaningfully closer: v is the closest point
+    if(distanceSquared - v * vertex.w <= RELATIVE_TOLERANCE * distanceSquared || contains(s, vertex.w)) break;
+
+    s.v[s.size++] = vertex;
+    v = closest(s, inside);
+  }
+
+  simplex.size = s.size;
+  for(std::size_t i = 0; i < s.size; ++i) {
+    simplex.directions[i] = s.v[i].direction;
+  }
+
+  if(!inside && lengthSq(v) > EPSILON * EPSILON) return separated(a, b, s, v, iterations);
+
+  // The cores touch or overlap: measure the penetration with EPA (cores which only touch or are flat have depth 0)
+  std::vector<Vertex> vertices;
+  Real depth = 0;
+  auto normal = Vector3({0, 0, 1});
+  auto pa = a.center(), pb = b.center();
+
+  if(inflate(a, b, s)) {
+    const auto face = expand(a, b, s, vertices, iterations);
+
+    if(face.distance < INF) {
+      depth = std::max(face.distance, Real(0));
+      normal = face.normal;
+
+      // Barycentric coordinates of the origin's projection onto the face give the deepest points
+      const auto& x = vertices[face.v[0]];
+      const auto& y = vertices[face.v[1]];
+      const auto& z = vertices[face.v[2]];
+      const auto p = depth * normal;
+
+      const auto n = cross(y.w - x.w, z.w - x.w);
+      const auto area = n * n;
+      const auto u = (cross(y.w - p, z.w - p) * n) / area;
+      const auto w = (cross(x.w - p, y.w - p) * n) / area;
+      const auto t = 1 - u - w;
+
+      pa = u * x.a + t * y.a + w * z.a;
+      pb = u * x.b + t * y.b + w * z.b;
+    }
+  } else if(s.size > 0) {
+    pa = s.v[0].a;
+    pb = s.v[0].b;
+  }
+
+  return Separation{
+    -(depth + a.margin() + b.margin()),
+    pa + a.margin() * normal,
+    pb - b.margin() * normal,
+    normal,
+    iterations
+  };
+}
+
+}
@@ -0,0 +1,245 @@
+#include "collision/occupancy_map.hpp"
+#include "spatial/matrix.hpp"
+#include "utils/parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace rbt::collision {
+
+namespace {
+
+// Voxel indices are offset by this so that the origin sits in the middle of the map.
+const int64_t OFFSET = int64_t(1) << (OccupancyMap::BITS - 1);
+const int64_t SPAN = int64_t(1) << OccupancyMap::BITS;
+
+// Spread the low 21 bits of v so there are two zero bits between each.
+uint64_t spread(uint64_t v) {
+  v &= 0x1fffff;
+  v = (v | (v << 32)) & 0x1f00000000ffffull;
+  v = (v | (v << 16)) & 0x1f0000ff0000ffull;
+  v = (v | (v << 8))  & 0x100f00f00f00f00full;
+  v = (v | (v << 4))  & 0x10c30c30c30c30c3ull;
+  v = (v | (v << 2))  & 0x1249249249249249ull;
+  return v;
+}
+
+// The inverse of spread.
+uint64_t compact(uint64_t v) {
+  v &= 0x1249249249249249ull;
+  v = (v | (v >> 2))  & 0x10c30c30c30c30c3ull;
+  v = (v | (v >> 4))  & 0x100f00f00f00f00full;
+  v = (v | (v >> 8))  & 0x1f0000ff0000ffull;
+  v = (v | (v >> 16)) & 0x1f00000000ffffull;
+  v = (v | (v >> 32)) & 0x1fffff;
+  return v;
+}
+
+// Sort by 11 bits at a time, least significant first. Codes use 63 bits, so 6 passes.
+void radixSort(std::vector<uint64_t>& keys) {
+  const std::size_t DIGIT = 11, BUCKETS = std::size_t(1) << DIGIT;
+  std::vector<uint64_t> buffer(keys.size());
+  std::vector<std::size_t> counts(BUCKETS);
+
+  for(std::size_t shift = 0; shift < 3 * OccupancyMap::BITS; shift += DIGIT) {
+    std::fill(counts.begin(), counts.end(), 0);
+    for(const auto key : keys) ++counts[(key >> shift) & (BUCKETS - 1)];
+
+    std::size_t total = 0;
+    for(auto& count : counts) {
+      const auto start = total;
+      total += count;
+      count = start;
+    }
+    for(const auto key : keys) buffer[counts[(key >> shift) & (BUCKETS - 1)]++] = key;
+
+    keys.swap(buffer);
+  }
+}
+
+// Keep the first of each distinct key (in no particular order) and drop any empty ones, using an open addressing
+// hash set.
+void unique(std::vector<uint64_t>& keys, uint64_t empty) {
+  std::size_t bits = 4;
+  while((std::size_t(1) << bits) < 2 * keys.size()) ++bits;
+  std::vector<uint64_t> table(std::size_t(1) << bits, empty);
+  const auto mask = table.size() - 1;
+
+  std::size_t kept = 0;
+  for(const auto key : keys) {
+    if(key == empty) continue;
+
+    auto slot = static_cast<std::size_t>((key * 0x9e3779b97f4a7c15ull) >> (64 - bits));
+    while(table[slot] != empty && table[slot] != key) slot = (slot + 1) & mask;
+    if(table[slot] == key) continue;
+
+    table[slot] = key;
+    keys[kept++] = key;
+  }
+  keys.resize(kept);
+}
+
+Real distanceSq(const Vector3& p, const Capsule& capsule) {
+  const auto d = capsule.b - capsule.a;
+  const auto length = d * d;
+  const auto t = (length > 0) ? std::min(std::max(((p - capsule.a) * d) / length, Real(0)), Real(1)) : Real(0);
+  return lengthSq(p - capsule.a - t * d);
+}
+
+}
+
+OccupancyMap::OccupancyMap(Real voxelSize, const Vector3& origin) : size(voxelSize), origin(origin) {
+  assert_msg(voxelSize > 0, "Voxels must have a size");
+}
+
+bool OccupancyMap::code(const Vector3& p, uint64_t& result) const {
+  std::array<uint64_t, 3> index;
+  for(std::size_t i = 0; i < 3; ++i) {
+    const auto v = std::floor((p[i] - this->origin[i]) / this->size);
+    // Also rejects NaN
+    if(!(v >= Real(-OFFSET) && v < Real(SPAN - OFFSET))) return false;
+    index[i] = static_cast<uint64_t>(static_cast<int64_t>(v) + OFFSET);
+  }
+
+  result = spread(index[0]) | (spread(index[1]) << 1) | (spread(index[2]) << 2);
+  return true;
+}
+
+Vector3 OccupancyMap::corner(uint64_t code) const {
+  Vector3 result;
+  for(std::size_t i = 0; i < 3; ++i) {
+    const auto index = static_cast<int64_t>(compact(code >> i)) - OFFSET;
+    result[i] = this->origin[i] + Real(index) * this->size;
+  }
+  return result;
+}
+
+void OccupancyMap::insert(const Points& points) {
+  // Points outside the map are given an impossible code (all 64 bits set) and dropped
+  const auto invalid = ~uint64_t(0);
+  std::vector<uint64_t> added(points.size());
+
+  const auto encode = [&](std::size_t begin, std::size_t end) {
+    for(auto i = begin; i < end; ++i) {
+      if(!this->code(points[i], added[i])) added[i] = invalid;
+    }
+  };
+  if(points.size() <= PARALLEL_THRESHOLD) {
+    encode(0, points.size());
+  } else {
+    parallel_for(points.size(), encode);
+  }
+
+  // Clouds are usually far denser than the voxels, so drop repeats before sorting
+  unique(added, invalid);
+  if(added.size() > 256) {
+    radixSort(added);
+  } else {
+    std::sort(added.begin(), added.end());
+  }
+
+  // Both runs are sorted, so merge them
+  const auto middle = this->codes.size();
+  this->codes.insert(this->codes.end(), added.begin(), added.end());
+  std::inplace_merge(this->codes.begin(), this->codes.begin() + static_cast<std::ptrdiff_t>(middle), this->codes.end());
+  this->codes.erase(std::unique(this->codes.begin(), this->codes.end()), this->codes.end());
+}
+
+void OccupancyMap::clear() {
+  this->codes.clear();
+}
+
+bool OccupancyMap::occupied(const Vector3& p, std::size_t level) const {
+  uint64_t key;
+  if(!this->code(p, key)) return false;
+
+  // The cell's codes are those sharing its prefix
+  const auto shift = 3 * std::min(level, LEVELS);
+  const auto first = (key >> shift) << shift;
+  const auto found = std::lower_bound(this->codes.begin(), this->codes.end(), first);
+  return found != this->codes.end() && (*found >> shift) == (key >> shift);
+}
+
+std::optional<AABB> OccupancyMap::cell(const Vector3& p, std::size_t level) const {
+  uint64_t key;
+  if(!this->code(p, key)) return std::nullopt;
+
+  const auto shift = 3 * std::min(level, LEVELS);
+  const auto min = this->corner((key >> shift) << shift);
+  const auto side = this->size * Real(uint64_t(1) << std::min(level, LEVELS));
+  return AABB(min, min + Vector3({ side, side, side }));
+}
+
+bool OccupancyMap::collides(const Capsule& capsule, std::size_t level) const {
+  if(this->codes.empty()) return false;
+  return this->collides(capsule, 0, LEVELS, 0, this->codes.size(), std::min(level, LEVELS));
+}
+
+bool OccupancyMap::collides(
+  const Capsule& capsule,
+  uint64_t prefix,
+  std::size_t level,
+  std::size_t begin,
+  std::size_t end,
+  std::size_t stop
+) const {
+  // Codes [begin, end) all lie in the cell `prefix` at `level`. Prune the cell if its bounding sphere misses.
+  const auto side = this->size * Real(uint64_t(1) << level);
+  const auto shift = 3 * level;
+  const auto center = this->corner(prefix << shift) + Real(0.5) * Vector3({ side, side, side });
+  const auto reach = capsule.radius + side * Real(0.8660254);
+  if(level < LEVELS && distanceSq(center, capsule) > reach * reach) return false;
+
+  if(level == stop) return true;
+
+  // Split the run between the children, which follow each other in code order
+  auto childBegin = begin;
+  for(uint64_t child = 0; child < 8 && childBegin < end; ++child) {
+    const auto childPrefix = (prefix << 3) | child;
+    const auto childShift = shift - 3;
+    const auto childEnd = static_cast<std::size_t>(std::upper_bound(
+      this->codes.begin() + static_cast<std::ptrdiff_t>(childBegin),
+      this->codes.begin() + static_cast<std::ptrdiff_t>(end),
+      childPrefix,
+      [childShift](uint64_t prefix, uint64_t code) { return prefix < (code >> childShift); }
+    ) - this->codes.begin());
+
+    if(childEnd > childBegin && this->collides(capsule, childPrefix, level - 1, childBegin, childEnd, stop)) return true;
+    childBegin = childEnd;
+  }
+
+  return false;
+}
+
+bool OccupancyMap::inCollision(const Serial& robot, const std::vector<Capsule>& proxies, const Angles& angles, std::size_t level) const {
+  assert_msg(proxies.size() == robot.joints().size() + 1, "Expected a capsule for the base and one for each joint");
+
+  const auto frames = robot.linkPoses(angles);
+  for(std::size_t link = 0; link < proxies.size(); ++link) {
+    if(this->collides(transform(proxies[link], RigidMatrix(frames[link])), level)) return true;
+  }
+  return false;
+}
+
+std::vector<std::size_t> OccupancyMap::collisions(const Serial& robot, const std::vector<Capsule>& proxies, const Angles& angles, std::size_t level) const {
+  assert_msg(proxies.size() == robot.joints().size() + 1, "Expected a capsule for the base and one for each joint");
+
+  std::vector<std::size_t> result;
+  const auto frames = robot.linkPoses(angles);
+  for(std::size_t link = 0; link < proxies.size(); ++link) {
+    if(this->collides(transform(proxies[link], RigidMatrix(frames[link])), level)) result.push_back(link);
+  }
+  return result;
+}
+
+Points OccupancyMap::voxels() const {
+  Points result(this->codes.size());
+  const auto half = Real(0.5) * this->size;
+  for(std::size_t i = 0; i < this->codes.size(); ++i) {
+    result.set(i, this->corner(this->codes[i]) + Vector3({ half, half, half }));
+  }
+  return result;
+}
+
+}
@@ -0,0 +1,380 @@
+#include "collision/raycast.hpp"
+#include "utils/simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <type_traits>
+
+namespace rbt::collision {
+
+namespace {
+
+// Deeper than any tree BVH builds (see its STACK_SIZE).
+const std::size_t STACK_SIZE = 128;
+
+const std::size_t LANES = RAY_PACKET_SIZE;
+const uint32_t ALL_LANES = (1u << LANES) - 1;
+
+// Rays in structure-of-arrays form, one per lane, along with the closest hit of each so far.
+struct alignas(32) Packet {
+  std::array<Real, LANES> ox, oy, oz;
+  std::array<Real, LANES> dx, dy, dz;
+  // Reciprocal directions for the slab test
+  std::array<Real, LANES> ix, iy, iz;
+
+  // Hits nearer than this are searched for
+  std::array<Real, LANES> tmax;
+  std::array<Real, LANES> u, v;
+  std::array<uint32_t, LANES> triangle, object;
+
+  // Lanes holding rays still being traced
+  uint32_t active;
+  // Whether the rays mostly travel towards -x, -y and -z, for visiting the nearer child first
+  std::array<bool, 3> negative;
+};
+
+// Fill the packet with rays [begin, begin + count), taken into a frame by the placement.
+void load(Packet& packet, const Points& origins, const Points& directions, std::size_t begin, std::size_t count, const RigidMatrix& placement) {
+  const auto& m = placement.m;
+  std::array<Real, 3> sum = {{ 0, 0, 0 }};
+
+  for(std::size_t lane = 0; lane < LANES; ++lane) {
+    // Pad partial packets with copies of their first ray, which are never active
+    const auto i = begin + ((lane < count) ? lane : 0);
+    const auto x = origins.x[i], y = origins.y[i], z = origins.z[i];
+    const auto a = directions.x[i], b = directions.y[i], c = directions.z[i];
+
+    packet.ox[lane] = m[0] * x + m[1] * y + m[2]  * z + m[3];
+    packet.oy[lane] = m[4] * x + m[5] * y + m[6]  * z + m[7];
+    packet.oz[lane] = m[8] * x + m[9] * y + m[10] * z + m[11];
+    packet.dx[lane] = m[0] * a + m[1] * b + m[2]  * c;
+    packet.dy[lane] = m[4] * a + m[5] * b + m[6]  * c;
+    packet.dz[lane] = m[8] * a + m[9] * b + m[10] * c;
+
+    // Keep reciprocals finite so that a ray starting on a slab boundary gives 0 rather than 0 * INF = NaN
+    const auto reciprocal = [](Real d) {
+      const Real tiny = 1e-30f;
+      return Real(1) / ((std::abs(d) > tiny) ? d : std::copysign(tiny, d));
+    };
+    packet.ix[lane] = reciprocal(packet.dx[lane]);
+    packet.iy[lane] = reciprocal(packet.dy[lane]);
+    packet.iz[lane] = reciprocal(packet.dz[lane]);
+
+    if(lane < count) {
+      sum[0] += packet.dx[lane];
+      sum[1] += packet.dy[lane];
+      sum[2] += packet.dz[lane];
+    }
+  }
+
+  for(std::size_t i = 0; i < 3; ++i) packet.negative[i] = sum[i] < 0;
+}
+
+// Lanes (of those given) whose rays enter the node's box before their current hit.
+uint32_t boxScalar(const BVH::Node& node, const Packet& p, uint32_t lanes) {
+  uint32_t result = 0;
+  for(std::size_t lane = 0; lane < LANES; ++lane) {
+    if(!(lanes & (1u << lane))) continue;
+
+    const auto x0 = (node.min[0] - p.ox[lane]) * p.ix[lane], x1 = (node.max[0] - p.ox[lane]) * p.ix[lane];
+    const auto y0 = (node.min[1] - p.oy[lane]) * p.iy[lane], y1 = (node.max[1] - p.oy[lane]) * p.iy[lane];
+    const auto z0 = (node.min[2] - p.oz[lane]) * p.iz[lane], z1 = (node.max[2] - p.oz[lane]) * p.iz[lane];
+
+    const auto near = std::max(std::max(std::min(x0, x1), std::min(y0, y1)), std::max(std::min(z0, z1), Real(0)));
+    const auto far = std::min(std::min(std::max(x0, x1), std::max(y0, y1)), std::min(std::max(z0, z1), p.tmax[lane]));
+    if(near <= far) result |= 1u << lane;
+  }
+  return result;
+}
+
+// Möller–Trumbore intersection of the lanes' rays with a triangle, keeping nearer hits. Returns the lanes hit.
+uint32_t triangleScalar(const Triangle& t, uint32_t index, Packet& p, uint32_t lanes) {
+  const auto e1 = t[1] - t[0], e2 = t[2] - t[0];
+
+  uint32_t result = 0;
+  for(std::size_t lane = 0; lane < LANES; ++lane) {
+    if(!(lanes & (1u << lane))) continue;
+
+    const auto px = p.dy[lane] * e2[2] - p.dz[lane] * e2[1];
+    const auto py = p.dz[lane] * e2[0] - p.dx[lane] * e2[2];
+    const auto pz = p.dx[lane] * e2[1] - p.dy[lane] * e2[0];
+    const auto det = e1[0] * px + e1[1] * py + e1[2] * pz;
+    const auto inv = Real(1) / det;
+
+    const auto sx = p.ox[lane] - t[0][0], sy = p.oy[lane] - t[0][1], sz = p.oz[lane] - t[0][2];
+    const auto u = (sx * px + sy * py + sz * pz) * inv;
+
+    const auto qx = sy * e1[2] - sz * e1[1];
+    const auto qy = sz * e1[0] - sx * e1[2];
+    const auto qz = sx * e1[1] - sy * e1[0];
+    const auto v = (p.dx[lane] * qx + p.dy[lane] * qy + p.dz[lane] * qz) * inv;
+    const auto distance = (e2[0] * qx + e2[1] * qy + e2[2] * qz) * inv;
+
+    if(det != 0 && u >= 0 && v >= 0 && u + v <= 1 && distance >= 0 && distance < p.tmax[lane]) {
+      p.tmax[lane] = distance;
+      p.u[lane] = u;
+      p.v[lane] = v;
+      p.triangle[lane] = index;
+      result |= 1u << lane;
+    }
+  }
+  return result;
+}
+
+#ifdef RBT_AVX_KERNEL
+
+static_assert(std::is_same<Real, float>::value && LANES == 8, "The AVX kernels trace 8 single precision rays at a time");
+
+// As boxScalar, all lanes at once.
+__attribute__((target("avx"))) uint32_t boxAVX(const BVH::Node& node, const Packet& p, uint32_t lanes) {
+  const auto ox = _mm256_load_ps(p.ox.data()), oy = _mm256_load_ps(p.oy.data()), oz = _mm256_load_ps(p.oz.data());
+  const auto ix = _mm256_load_ps(p.ix.data()), iy = _mm256_load_ps(p.iy.data()), iz = _mm256_load_ps(p.iz.data());
+
+  const auto x0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.min[0]), ox), ix);
+  const auto x1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.max[0]), ox), ix);
+  const auto y0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.min[1]), oy), iy);
+  const auto y1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.max[1]), oy), iy);
+  const auto z0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.min[2]), oz), iz);
+  const auto z1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(node.max[2]), oz), iz);
+
+  const auto near = _mm256_max_ps(
+    _mm256_max_ps(_mm256_min_ps(x0, x1), _mm256_min_ps(y0, y1)),
+    _mm256_max_ps(_mm256_min_ps(z0, z1), _mm256_setzero_ps())
+  );
+  const auto far = _mm256_min_ps(
+    _mm256_min_ps(_mm256_max_ps(x0, x1), _mm256_max_ps(y0, y1)),
+    _mm256_min_ps(_mm256_max_ps(z0, z1), _mm256_load_ps(p.tmax.data()))
+  );
+
+  return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(near, far, _CMP_LE_OQ))) & lanes;
+}
+
+// As triangleScalar, all lanes at once.
+__attribute__((target("avx"))) uint32_t triangleAVX(const Triangle& t, uint32_t index, Packet& p, uint32_t lanes) {
+  const auto e1 = t[1] - t[0], e2 = t[2] - t[0];
+  const auto e1x = _mm256_set1_ps(e1[0]), e1y = _mm256_set1_ps(e1[1]), e1z = _mm256_set1_ps(e1[2]);
+  const auto e2x = _mm256_set1_ps(e2[0]), e2y = _mm256_set1_ps(e2[1]), e2z = _mm256_set1_ps(e2[2]);
+  const auto dx = _mm256_load_ps(p.dx.data()), dy = _mm256_load_ps(p.dy.data()), dz = _mm256_load_ps(p.dz.data());
+
+  const auto px = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+  const auto py = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+  const auto pz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+  const auto det = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, px), _mm256_mul_ps(e1y, py)), _mm256_mul_ps(e1z, pz));
+  const auto inv = _mm256_div_ps(_mm256_set1_ps(1), det);
+
+  const auto sx = _mm256_sub_ps(_mm256_load_ps(p.ox.data()), _mm256_set1_ps(t[0][0]));
+  const auto sy = _mm256_sub_ps(_mm256_load_ps(p.oy.data()), _mm256_set1_ps(t[0][1]));
+  const auto sz = _mm256_sub_ps(_mm256_load_ps(p.oz.data()), _mm256_set1_ps(t[0][2]));
+  const auto u = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, px), _mm256_mul_ps(sy, py)), _mm256_mul_ps(sz, pz)), inv);
+
+  const auto qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y));
+  const auto qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z));
+  const auto qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+  const auto v = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)), inv);
+  const auto distance = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)), inv);
+
+  const auto zero = _mm256_setzero_ps();
+  const auto tmax = _mm256_load_ps(p.tmax.data());
+  auto hit = _mm256_cmp_ps(det, zero, _CMP_NEQ_OQ);
+  hit = _mm256_and_ps(hit, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+  hit = _mm256_and_ps(hit, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+  hit = _mm256_and_ps(hit, _mm256_cmp_ps(_mm256_add_ps(u, v), _mm256_set1_ps(1), _CMP_LE_OQ));
+  hit = _mm256_and_ps(hit, _mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+  hit = _mm256_and_ps(hit, _mm256_cmp_ps(distance, tmax, _CMP_LT_OQ));
+
+  const auto result = static_cast<uint32_t>(_mm256_movemask_ps(hit)) & lanes;
+  if(result == 0) return 0;
+
+  // Only the requested lanes may take the hit
+  const auto selected = _mm256_castsi256_ps(_mm256_set_epi32(
+    (result & 0x80) ? -1 : 0, (result & 0x40) ? -1 : 0, (result & 0x20) ? -1 : 0, (result & 0x10) ? -1 : 0,
+    (result & 0x08) ? -1 : 0, (result & 0x04) ? -1 : 0, (result & 0x02) ? -1 : 0, (result & 0x01) ? -1 : 0
+  ));
+  _mm256_store_ps(p.tmax.data(), _mm256_blendv_ps(tmax, distance, selected));
+  _mm256_store_ps(p.u.data(), _mm256_blendv_ps(_mm256_load_ps(p.u.data()), u, selected));
+  _mm256_store_ps(p.v.data(), _mm256_blendv_ps(_mm256_load_ps(p.v.data()), v, selected));
+
+  const auto triangles = reinterpret_cast<float*>(p.triangle.data());
+  const auto indices = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(index)));
+  _mm256_store_ps(triangles, _mm256_blendv_ps(_mm256_load_ps(triangles), indices, selected));
+
+  return result;
+}
+
+#endif
+
+struct Kernels {
+  uint32_t (*box)(const BVH::Node&, const Packet&, uint32_t);
+  uint32_t (*triangle)(const Triangle&, uint32_t, Packet&, uint32_t);
+};
+
+const Kernels& kernels() {
+#ifdef RBT_AVX_KERNEL
+  static const Kernels selected = simd::avx()
+    ? Kernels{ boxAVX, triangleAVX }
+    : Kernels{ boxScalar, triangleScalar };
+#else
+  static const Kernels selected = { boxScalar, triangleScalar };
+#endif
+  return selected;
+}
+
+// Trace the packet's active lanes through the tree, recording hits against the object. With any, lanes stop (and
+// leave the active set) at their first hit.
+void trace(const BVH& bvh, Packet& packet, bool any, uint32_t object) {
+  const auto& nodes = bvh.nodes();
+  if(nodes.empty() || packet.active == 0) return;
+
+  const auto& kernel = kernels();
+  const auto& triangles = bvh.triangles();
+
+  std::array<uint32_t, STACK_SIZE> stack;
+  std::size_t top = 0;
+  stack[top++] = 0;
+
+  while(top > 0) {
+    const auto index = stack[--top];
+    const auto& node = nodes[index];
+
+    const auto lanes = kernel.box(node, packet, packet.active);
+    if(lanes == 0) continue;
+
+    if(node.isLeaf()) {
+      for(auto k = node.offset; k < node.offset + node.count; ++k) {
+        const auto hits = kernel.triangle(triangles[k], static_cast<uint32_t>(bvh.originalIndex(k)), packet, lanes);
+        if(hits == 0) continue;
+
+        for(std::size_t lane = 0; lane < LANES; ++lane) {
+          if(hits & (1u << lane)) packet.object[lane] = object;
+        }
+
+        if(any) {
+          packet.active &= ~hits;
+          if(packet.active == 0) return;
+        }
+      }
+    } else {
+      // Visit the child nearer the rays' origins first, so their hits cull the farther one
+      const auto first = index + 1, second = index + node.offset;
+      if(packet.negative[node.axis]) {
+        stack[top++] = first;
+        stack[top++] = second;
+      } else {
+        stack[top++] = second;
+        stack[top++] = first;
+      }
+    }
+  }
+}
+
+void reset(Packet& packet, std::size_t count, Real maxDistance) {
+  packet.tmax.fill(maxDistance);
+  packet.u.fill(0);
+  packet.v.fill(0);
+  packet.triangle.fill(0);
+  packet.object.fill(0);
+  packet.active = ALL_LANES >> (LANES - count);
+}
+
+void store(const Packet& packet, std::size_t count, Real maxDistance, RayHit* hits) {
+  for(std::size_t lane = 0; lane < count; ++lane) {
+    auto& hit = hits[lane];
+    // A lane hit something exactly when its bound moved in from maxDistance
+    hit.distance = (packet.tmax[lane] < maxDistance) ? packet.tmax[lane] : INF;
+    hit.u = packet.u[lane];
+    hit.v = packet.v[lane];
+    hit.triangle = packet.triangle[lane];
+    hit.object = packet.object[lane];
+  }
+}
+
+// Apply f(packet, begin, count) to each packet of the rays.
+template <typename F>
+void packets(const Points& origins, const Points& directions, F f) {
+  assert_msg(origins.size() == directions.size(), "Every ray needs an origin and a direction");
+
+  Packet packet;
+  for(std::size_t begin = 0; begin < origins.size(); begin += LANES) {
+    f(packet, begin, std::min(LANES, origins.size() - begin));
+  }
+}
+
+}
+
+void raycast(const BVH& bvh, const Points& origins, const Points& directions, std::vector<RayHit>& hits, Real maxDistance) {
+  hits.resize(origins.size());
+  packets(origins, directions, [&](Packet& packet, std::size_t begin, std::size_t count) {
+    load(packet, origins, directions, begin, count, RigidMatrix());
+    reset(packet, count, maxDistance);
+    trace(bvh, packet, false, 0);
+    store(packet, count, maxDistance, hits.data() + begin);
+  });
+}
+
+RayHit raycast(const BVH& bvh, const Vector3& origin, const Vector3& direction, Real maxDistance) {
+  std::vector<RayHit> hits;
+  raycast(bvh, Points({ origin }), Points({ direction }), hits, maxDistance);
+  return hits.front();
+}
+
+void occluded(const BVH& bvh, const Points& origins, const Points& directions, std::vector<uint8_t>& occluded, Real maxDistance) {
+  occluded.resize(origins.size());
+  packets(origins, directions, [&](Packet& packet, std::size_t begin, std::size_t count) {
+    load(packet, origins, directions, begin, count, RigidMatrix());
+    reset(packet, count, maxDistance);
+    const auto lanes = packet.active;
+    trace(bvh, packet, true, 0);
+    for(std::size_t lane = 0; lane < count; ++lane) occluded[begin + lane] = (lanes & ~packet.active & (1u << lane)) != 0;
+  });
+}
+
+RayScene::RayScene(const std::vector<Mesh>& objects) : placements(objects.size()), inverses(objects.size()) {
+  this->bvhs.reserve(objects.size());
+  for(const auto& mesh : objects) this->bvhs.emplace_back(mesh);
+}
+
+void RayScene::place(std::size_t object, const RigidMatrix& placement) {
+  this->placements[object] = placement;
+  this->inverses[object] = inverse(placement);
+}
+
+void RayScene::place(const std::vector<Frame>& frames) {
+  assert_msg(frames.size() == this->size(), "A frame is needed for every object");
+  for(std::size_t i = 0; i < frames.size(); ++i) this->place(i, RigidMatrix(frames[i]));
+}
+
+void RayScene::raycast(const Points& origins, const Points& directions, std::vector<RayHit>& hits, Real maxDistance) const {
+  hits.resize(origins.size());
+  packets(origins, directions, [&](Packet& packet, std::size_t begin, std::size_t count) {
+    reset(packet, count, maxDistance);
+    // Placements are rigid, so distances along the rays are the same in every object's frame and the nearest hit so
+    // far carries from one object to the next
+    for(std::size_t i = 0; i < this->bvhs.size(); ++i) {
+      load(packet, origins, directions, begin, count, this->inverses[i]);
+      trace(this->bvhs[i], packet, false, static_cast<uint32_t>(i));
+    }
+    store(packet, count, maxDistance, hits.data() + begin);
+  });
+}
+
+RayHit RayScene::raycast(const Vector3& origin, const Vector3& direction, Real maxDistance) const {
+  std::vector<RayHit> hits;
+  this->raycast(Points({ origin }), Points({ direction }), hits, maxDistance);
+  return hits.front();
+}
+
+void RayScene::occluded(const Points& origins, const Points& directions, std::vector<uint8_t>& occluded, Real maxDistance) const {
+  occluded.resize(origins.size());
+  packets(origins, directions, [&](Packet& packet, std::size_t begin, std::size_t count) {
+    reset(packet, count, maxDistance);
+    const auto lanes = packet.active;
+    for(std::size_t i = 0; i < this->bvhs.size() && packet.active != 0; ++i) {
+      load(packet, origins, directions, begin, count, this->inverses[i]);
+      trace(this->bvhs[i], packet, true, static_cast<uint32_t>(i));
+    }
+    for(std::size_t lane = 0; lane < count; ++lane) occluded[begin + lane] = (lanes & ~packet.active & (1u << lane)) != 0;
+  });
+}
+
+}
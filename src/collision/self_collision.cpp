@@ -0,0 +1,109 @@
+#include "collision/self_collision.hpp"
+#include "spatial/matrix.hpp"
+
+#include <algorithm>
+
+namespace rbt::collision {
+
+AllowedCollisionMatrix::AllowedCollisionMatrix(std::size_t links, bool allowAdjacent) : n(links), a(links * links, false) {
+  if(!allowAdjacent) return;
+
+  for(std::size_t i = 0; i + 1 < links; ++i) {
+    this->allow(i, i + 1);
+  }
+}
+
+void AllowedCollisionMatrix::allow(std::size_t first, std::size_t second, bool allowed) {
+  assert_msg(first < this->n && second < this->n, "Link index out of range");
+
+  this->a[first * this->n + second] = allowed;
+  this->a[second * this->n + first] = allowed;
+}
+
+bool AllowedCollisionMatrix::allowed(std::size_t first, std::size_t second) const {
+  // A link can not collide with itself
+  return first == second || this->a[first * this->n + second];
+}
+
+SelfCollision::SelfCollision(const Serial& robot, const std::vector<Mesh>& links)
+  : SelfCollision(robot, links, AllowedCollisionMatrix(links.size())) {}
+
+SelfCollision::SelfCollision(const Serial& robot, const std::vector<Mesh>& links, const AllowedCollisionMatrix& allowed)
+  : robot(robot), acm(allowed) {
+  assert_msg(links.size() == robot.joints().size() + 1, "Expected a mesh for the base and one for each joint");
+  assert_msg(allowed.size() == links.size(), "Allowed collision matrix does not match the number of links");
+
+  this->meshes.reserve(links.size());
+
+  for(const auto& link : links) {
+    this->meshes.emplace_back(link);
+
+    const auto center = this->meshes.back().bounds().center();
+    Real radiusSq = 0;
+    for(const auto& triangle : link) {
+      for(std::size_t i = 0; i < 3; ++i) {
+        radiusSq = std::max(radiusSq, lengthSq(triangle[i] - center));
+      }
+    }
+
+    this->centers.push_back(center);
+    this->radii.push_back(std::sqrt(radiusSq));
+  }
+
+  for(std::size_t i = 0; i < links.size(); ++i) {
+    for(std::size_t j = i + 1; j < links.size(); ++j) {
+      if(allowed.allowed(i, j) || links[i].empty() || links[j].empty()) continue;
+      this->pairs.emplace_back(i, j);
+    }
+  }
+}
+
+void SelfCollision::place(const Angles& angles, Scratch& scratch) const {
+  this->robot.linkPoses(angles, scratch.poses);
+
+  scratch.placed.resize(scratch.poses.size());
+  for(std::size_t i = 0; i < scratch.poses.size(); ++i) scratch.placed[i] = RigidMatrix(scratch.poses[i].pose());
+}
+
+bool SelfCollision::collides(const LinkPair& pair, const std::vector<RigidMatrix>& placements) const {
+  const auto [i, j] = pair;
+
+  // Broad phase: bounding spheres in the world frame
+  const auto distance = length(placements[i](this->centers[i]) - placements[j](this->centers[j]));
+  if(distance > this->radii[i] + this->radii[j]) return false;
+
+  // Narrow phase: place link j in the frame of link i and traverse both hierarchies
+  const auto jToI = inverse(placements[i]) * placements[j];
+  return intersects(this->meshes[i], this->meshes[j], jToI);
+}
+
+bool SelfCollision::inCollision(const Angles& angles, Scratch& scratch) const {
+  this->place(angles, scratch);
+
+  return std::any_of(this->pairs.begin(), this->pairs.end(), [this, &scratch](const LinkPair& pair) {
+    return this->collides(pair, scratch.placed);
+  });
+}
+
+bool SelfCollision::inCollision(const Angles& angles) const {
+  Scratch scratch;
+  return this->inCollision(angles, scratch);
+}
+
+void SelfCollision::collisions(const Angles& angles, std::vector<LinkPair>& result, Scratch& scratch) const {
+  this->place(angles, scratch);
+
+  result.clear();
+  for(const auto& pair : this->pairs) {
+    if(this->collides(pair, scratch.placed)) result.push_back(pair);
+  }
+}
+
+std::vector<LinkPair> SelfCollision::collisions(const Angles& angles) const {
+  Scratch scratch;
+  std::vector<LinkPair> result;
+  this->collisions(angles, result, scratch);
+  return result;
+}
+
+}
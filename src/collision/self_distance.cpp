@@ -0,0 +1,149 @@
+#include "collision/self_distance.hpp"
+#include "spatial/matrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace rbt::collision {
+
+SelfDistance::SelfDistance(const Serial& robot, const std::vector<Mesh>& links)
+  : SelfDistance(robot, links, AllowedCollisionMatrix(links.size())) {}
+
+SelfDistance::SelfDistance(const Serial& robot, const std::vector<Mesh>& links, const AllowedCollisionMatrix& allowed)
+  : robot(robot) {
+  assert_msg(links.size() == robot.joints().size() + 1, "Expected a mesh for the base and one for each joint");
+
+  std::vector<bool> present;
+  for(const auto& link : links) {
+    this->c.push_back(fitCapsule(link));
+    present.push_back(!link.empty());
+  }
+
+  this->setAlphas();
+  this->setPairs(allowed, present);
+}
+
+SelfDistance::SelfDistance(const Serial& robot, const std::vector<Capsule>& capsules, const AllowedCollisionMatrix& allowed)
+  : robot(robot), c(capsules) {
+  assert_msg(capsules.size() == robot.joints().size() + 1, "Expected a capsule for the base and one for each joint");
+
+  this->setAlphas();
+  this->setPairs(allowed, std::vector<bool>(capsules.size(), true));
+}
+
+void SelfDistance::setPairs(const AllowedCollisionMatrix& allowed, const std::vector<bool>& present) {
+  assert_msg(allowed.size() == this->c.size(), "Allowed collision matrix does not match the number of links");
+
+  for(std::size_t i = 0; i < this->c.size(); ++i) {
+    for(std::size_t j = i + 1; j < this->c.size(); ++j) {
+      if(allowed.allowed(i, j) || !present[i] || !present[j]) continue;
+      this->p.emplace_back(i, j);
+    }
+  }
+}
+
+void SelfDistance::setAlphas() {
+  for(const auto& joint : this->robot.joints()) {
+    this->alphas.push_back(Vector2({ std::cos(joint.alpha), std::sin(joint.alpha) }));
+  }
+}
+
+void SelfDistance::place(const Angles& angles, std::vector<Capsule>& placed) const {
+  // As Serial::linkPoses, without building the frames: missing angles are 0. Each joint's transform (see
+  // Joint::transform) is built as a matrix, needing only the sine and cosine of its angle.
+  const auto& joints = this->robot.joints();
+  placed.resize(this->c.size());
+  placed[0] = this->c[0];
+
+  auto t = RigidMatrix();
+  auto& m = t.m;
+  for(std::size_t i = 0; i + 1 < this->c.size(); ++i) {
+    const auto& joint = joints[i];
+    const auto theta = joint.theta + ((i < angles.size()) ? angles[i] : 0);
+    const auto ct = std::cos(theta), st = std::sin(theta);
+    const auto ca = this->alphas[i][0], sa = this->alphas[i][1];
+
+    // Multiply by Rotate_z(theta) * Rotate_x(alpha) after d along z and a along the rotated x axis, i.e.
+    //   [ ct  -st ca   st sa  a ct ]
+    //   [ st   ct ca  -ct sa  a st ]
+    //   [  0      sa      ca     d ]
+    // a row at a time
+    for(std::size_t row = 0; row < 12; row += 4) {
+      const auto x = m[row], y = m[row + 1], z = m[row + 2];
+      const auto along = x * ct + y * st, across = y * ct - x * st;
+      m[row] = along;
+      m[row + 1] = across * ca + z * sa;
+      m[row + 2] = z * ca - across * sa;
+      m[row + 3] += along * joint.a + z * joint.d;
+    }
+
+    // As transform(capsule, t), in place
+    const auto& local = this->c[i + 1];
+    auto& capsule = placed[i + 1];
+    for(std::size_t k = 0; k < 3; ++k) {
+      const auto row = 4 * k;
+      capsule.a[k] = m[row] * local.a[0] + m[row + 1] * local.a[1] + m[row + 2] * local.a[2] + m[row + 3];
+      capsule.b[k] = m[row] * local.b[0] + m[row + 1] * local.b[1] + m[row + 2] * local.b[2] + m[row + 3];
+    }
+    capsule.radius = local.radius;
+  }
+}
+
+std::vector<Capsule> SelfDistance::posed(const Angles& angles) const {
+  std::vector<Capsule> result;
+  this->place(angles, result);
+  return result;
+}
+
+std::size_t SelfDistance::batch(const std::vector<Capsule>& placed, std::size_t begin, std::array<Real, CapsuleLanes::WIDTH>& result) const {
+  constexpr auto WIDTH = CapsuleLanes::WIDTH;
+  const auto count = std::min(WIDTH, this->p.size() - begin);
+
+  CapsuleLanes first, second;
+  for(std::size_t lane = 0; lane < WIDTH; ++lane) {
+    const auto& pair = this->p[begin + ((lane < count) ? lane : 0)];
+    first.set(lane, placed[pair.first]);
+    second.set(lane, placed[pair.second]);
+  }
+
+  rbt::collision::distances(first, second, result);
+  return count;
+}
+
+void SelfDistance::distances(const Angles& angles, std::vector<Real>& result, Scratch& scratch) const {
+  this->place(angles, scratch.placed);
+  result.resize(this->p.size());
+
+  // Gather pairs into lanes and evaluate a full batch at a time; the final batch is padded with its first pair
+  std::array<Real, CapsuleLanes::WIDTH> batch;
+  for(std::size_t begin = 0; begin < this->p.size(); begin += CapsuleLanes::WIDTH) {
+    const auto count = this->batch(scratch.placed, begin, batch);
+    std::copy(batch.begin(), batch.begin() + count, result.begin() + begin);
+  }
+}
+
+void SelfDistance::distances(const Angles& angles, std::vector<Real>& result) const {
+  Scratch scratch;
+  this->distances(angles, result, scratch);
+}
+
+Real SelfDistance::distance(const Angles& angles, Scratch& scratch) const {
+  this->place(angles, scratch.placed);
+
+  // The padding of the final batch repeats a pair, so doesn't change the smallest
+  Real result = INF;
+  std::array<Real, CapsuleLanes::WIDTH> batch;
+  for(std::size_t begin = 0; begin < this->p.size(); begin += CapsuleLanes::WIDTH) {
+    this->batch(scratch.placed, begin, batch);
+    result = std::min(result, *std::min_element(batch.begin(), batch.end()));
+  }
+
+  return result;
+}
+
+Real SelfDistance::distance(const Angles& angles) const {
+  Scratch scratch;
+  return this->distance(angles, scratch);
+}
+
+}
@@ -0,0 +1,208 @@
+#include "collision/self_filter.hpp"
+#include "spatial/matrix.hpp"
+#include "utils/parallel.hpp"
+#include "utils/simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <type_traits>
+
+namespace rbt::collision {
+
+namespace {
+
+const std::size_t LANES = 8;
+
+// A posed capsule set up for point tests: the segment a + t d for t in [0, 1].
+struct Proxy {
+  Real ax, ay, az;
+  Real dx, dy, dz;
+  // 1 / |d|^2, or 0 for a sphere
+  Real inverseLengthSq;
+  Real radiusSq;
+};
+
+// The proxies posed, with the box bounding them all for rejecting far away points quickly.
+struct Posed {
+  std::vector<Proxy> proxies;
+  Real min[3], max[3];
+};
+
+Posed pose(const Serial& robot, const std::vector<Capsule>& proxies, const Angles& angles) {
+  const auto frames = robot.linkPoses(angles);
+
+  Posed result;
+  for(std::size_t i = 0; i < 3; ++i) {
+    result.min[i] = INF;
+    result.max[i] = -INF;
+  }
+
+  for(std::size_t link = 0; link < proxies.size(); ++link) {
+    const auto& local = proxies[link];
+    if(local.radius <= 0) continue;
+
+    const auto capsule = transform(local, RigidMatrix(frames[link]));
+    const auto d = capsule.b - capsule.a;
+    const auto lengthSq = d * d;
+
+    result.proxies.push_back(Proxy{
+      capsule.a[0], capsule.a[1], capsule.a[2],
+      d[0], d[1], d[2],
+      (lengthSq > 0) ? 1 / lengthSq : 0,
+      capsule.radius * capsule.radius
+    });
+
+    for(std::size_t i = 0; i < 3; ++i) {
+      result.min[i] = std::min({ result.min[i], capsule.a[i] - capsule.radius, capsule.b[i] - capsule.radius });
+      result.max[i] = std::max({ result.max[i], capsule.a[i] + capsule.radius, capsule.b[i] + capsule.radius });
+    }
+  }
+
+  return result;
+}
+
+// Mark the points [begin, end) inside any proxy.
+void kernel(const Posed& posed, const Points& points, uint8_t* inside, std::size_t begin, std::size_t end) {
+  for(auto i = begin; i < end; ++i) {
+    const auto x = points.x[i], y = points.y[i], z = points.z[i];
+    bool result = false;
+
+    if(x >= posed.min[0] && x <= posed.max[0] && y >= posed.min[1] && y <= posed.max[1] && z >= posed.min[2] && z <= posed.max[2]) {
+      for(const auto& p : posed.proxies) {
+        const auto px = x - p.ax, py = y - p.ay, pz = z - p.az;
+        const auto t = std::min(std::max((px * p.dx + py * p.dy + pz * p.dz) * p.inverseLengthSq, Real(0)), Real(1));
+        const auto ex = px - t * p.dx, ey = py - t * p.dy, ez = pz - t * p.dz;
+        if(ex * ex + ey * ey + ez * ez <= p.radiusSq) {
+          result = true;
+          break;
+        }
+      }
+    }
+
+    inside[i] = result;
+  }
+}
+
+#ifdef RBT_AVX_KERNEL
+
+// Each 8 bit mask spread into 8 bytes of 0 or 1, in lane order
+constexpr std::array<std::array<uint8_t, LANES>, 256> spreadMasks() {
+  std::array<std::array<uint8_t, LANES>, 256> result = {};
+  for(std::size_t mask = 0; mask < 256; ++mask) {
+    for(std::size_t lane = 0; lane < LANES; ++lane) result[mask][lane] = (mask >> lane) & 1;
+  }
+  return result;
+}
+
+constexpr auto BYTES = spreadMasks();
+
+static_assert(std::is_same<Real, float>::value, "The AVX kernel tests 8 single precision points at a time");
+
+// As kernel, 8 points at a time. Blocks of points wholly outside the bounding box skip the proxies.
+__attribute__((target("avx"))) void avxKernel(const Posed& posed, const Points& points, uint8_t* inside, std::size_t begin, std::size_t end) {
+  const auto minX = _mm256_set1_ps(posed.min[0]), minY = _mm256_set1_ps(posed.min[1]), minZ = _mm256_set1_ps(posed.min[2]);
+  const auto maxX = _mm256_set1_ps(posed.max[0]), maxY = _mm256_set1_ps(posed.max[1]), maxZ = _mm256_set1_ps(posed.max[2]);
+  const auto zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1);
+
+  auto i = begin;
+  for(; i + LANES <= end; i += LANES) {
+    const auto x = _mm256_loadu_ps(&points.x[i]), y = _mm256_loadu_ps(&points.y[i]), z = _mm256_loadu_ps(&points.z[i]);
+
+    auto candidates = _mm256_and_ps(_mm256_cmp_ps(x, minX, _CMP_GE_OQ), _mm256_cmp_ps(x, maxX, _CMP_LE_OQ));
+    candidates = _mm256_and_ps(candidates, _mm256_and_ps(_mm256_cmp_ps(y, minY, _CMP_GE_OQ), _mm256_cmp_ps(y, maxY, _CMP_LE_OQ)));
+    candidates = _mm256_and_ps(candidates, _mm256_and_ps(_mm256_cmp_ps(z, minZ, _CMP_GE_OQ), _mm256_cmp_ps(z, maxZ, _CMP_LE_OQ)));
+
+    auto hit = _mm256_setzero_ps();
+    if(_mm256_movemask_ps(candidates) != 0) {
+      for(const auto& p : posed.proxies) {
+        const auto dx = _mm256_set1_ps(p.dx), dy = _mm256_set1_ps(p.dy), dz = _mm256_set1_ps(p.dz);
+        const auto px = _mm256_sub_ps(x, _mm256_set1_ps(p.ax));
+        const auto py = _mm256_sub_ps(y, _mm256_set1_ps(p.ay));
+        const auto pz = _mm256_sub_ps(z, _mm256_set1_ps(p.az));
+
+        const auto projection = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px, dx), _mm256_mul_ps(py, dy)), _mm256_mul_ps(pz, dz));
+        const auto t = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(projection, _mm256_set1_ps(p.inverseLengthSq)), zero), one);
+
+        const auto ex = _mm256_sub_ps(px, _mm256_mul_ps(t, dx));
+        const auto ey = _mm256_sub_ps(py, _mm256_mul_ps(t, dy));
+        const auto ez = _mm256_sub_ps(pz, _mm256_mul_ps(t, dz));
+        const auto distanceSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ex, ex), _mm256_mul_ps(ey, ey)), _mm256_mul_ps(ez, ez));
+
+        hit = _mm256_or_ps(hit, _mm256_cmp_ps(distanceSq, _mm256_set1_ps(p.radiusSq), _CMP_LE_OQ));
+      }
+      hit = _mm256_and_ps(hit, candidates);
+    }
+
+    std::memcpy(inside + i, &BYTES[static_cast<std::size_t>(_mm256_movemask_ps(hit))], LANES);
+  }
+
+  kernel(posed, points, inside, i, end);
+}
+
+#endif
+
+void run(const Posed& posed, const Points& points, uint8_t* inside, std::size_t begin, std::size_t end) {
+#ifdef RBT_AVX_KERNEL
+  if(simd::avx()) {
+    avxKernel(posed, points, inside, begin, end);
+    return;
+  }
+#endif
+  kernel(posed, points, inside, begin, end);
+}
+
+}
+
+SelfFilter::SelfFilter(const Serial& robot, const std::vector<Mesh>& links, Real padding) : robot(robot) {
+  assert_msg(links.size() == robot.joints().size() + 1, "Expected a mesh for the base and one for each joint");
+
+  for(const auto& link : links) {
+    auto capsule = fitCapsule(link);
+    if(!link.empty()) capsule.radius += padding;
+    this->p.push_back(capsule);
+  }
+}
+
+SelfFilter::SelfFilter(const Serial& robot, const std::vector<Capsule>& proxies, Real padding) : robot(robot), p(proxies) {
+  assert_msg(proxies.size() == robot.joints().size() + 1, "Expected a capsule for the base and one for each joint");
+
+  for(auto& capsule : this->p) {
+    if(capsule.radius > 0) capsule.radius += padding;
+  }
+}
+
+void SelfFilter::inside(const Angles& angles, const Points& points, std::vector<uint8_t>& inside) const {
+  const auto posed = pose(this->robot, this->p, angles);
+  inside.resize(points.size());
+
+  if(points.size() <= PARALLEL_THRESHOLD) {
+    run(posed, points, inside.data(), 0, points.size());
+    return;
+  }
+
+  parallel_for(points.size(), [&](std::size_t begin, std::size_t end) {
+    run(posed, points, inside.data(), begin, end);
+  });
+}
+
+std::size_t SelfFilter::remove(const Angles& angles, Points& points) const {
+  std::vector<uint8_t> inside;
+  this->inside(angles, points, inside);
+
+  std::size_t kept = 0;
+  for(std::size_t i = 0; i < points.size(); ++i) {
+    if(inside[i]) continue;
+
+    points.x[kept] = points.x[i];
+    points.y[kept] = points.y[i];
+    points.z[kept] = points.z[i];
+    ++kept;
+  }
+
+  const auto removed = points.size() - kept;
+  points.resize(kept);
+  return removed;
+}
+
+}
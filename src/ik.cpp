@@ -1,7 +1,10 @@
 #include "ik.hpp"
 #include "utilities.hpp"
+#include "collision/self_collision.hpp"
 #include "spatial/transform.hpp"
 #include "spatial/vector.hpp"
+#include "utils/capture.hpp"
+#include "utils/metrics.hpp"
 
 #include <algorithm>
 #include <iterator>
@@ -119,6 +122,18 @@ void transformAnglesToRobot(AngleSets& angleSets, const Serial& robot) {
 }
 
 AngleSets angles(const Frame& pose, const Serial& robot) {
+  static auto& calls = metrics::counter("rbt_ik_calls_total", "Inverse kinematics calls");
+  static auto& unsolved = metrics::counter("rbt_ik_unsolved_total", "Inverse kinematics calls without a solution within the joint limits");
+  static auto& found = metrics::counter("rbt_ik_solutions_total", "Solutions returned by inverse kinematics");
+  static auto& latency = metrics::histogram("rbt_ik_seconds", "Inverse kinematics latency");
+
+  const metrics::Stopwatch stopwatch(latency);
+  calls.add();
+
+  capture::record(pose, robot);
+  // Only capture the request, not the forward kinematics it makes
+  const capture::Suppress internal;
+
   // Transform end-effector tip frame to wrist center frame
   const auto target = wristCenterPoint(pose, robot.wristLength());
 
@@ -134,7 +149,11 @@ AngleSets angles(const Frame& pose, const Serial& robot) {
 
   removeIfBeyondLimits(solutions, robot.limits());
 
-  if(solutions.empty()) return AngleSets();
+  if(solutions.empty()) {
+    unsolved.add();
+    return AngleSets();
+  }
+  found.add(solutions.size());
 
   for(auto&& set : solutions) {
     const auto wristCenterFrame = robot.pose(set);
@@ -180,6 +199,8 @@ bool withinLimits(const Real& angle, const Vector2& limits) {
 }
 
 void removeIfBeyondLimits(AngleSets& sets, const std::vector<Vector2>& limits) {
+  static auto& pruned = metrics::counter("rbt_ik_beyond_limits_total", "Solutions pruned for being beyond the joint limits");
+
   const auto last = std::remove_if(sets.begin(), sets.end(), [limits](const Angles& set) {
     auto limIter = limits.begin();
     for(auto& angle : set) {
@@ -188,6 +209,18 @@ void removeIfBeyondLimits(AngleSets& sets, const std::vector<Vector2>& limits) {
     return false;
   });
 
+  pruned.add(static_cast<uint64_t>(std::distance(last, sets.end())));
+  sets.erase(last, sets.end());
+}
+
+void removeIfSelfColliding(AngleSets& sets, const collision::SelfCollision& checker) {
+  collision::SelfCollision::Scratch scratch;
+  const auto last = std::remove_if(sets.begin(), sets.end(), [&checker, &scratch](const Angles& set) {
+    // Singular angles stand for a whole range of values so there is no single configuration to check
+    const bool singular = std::any_of(set.begin(), set.end(), [](const Real& angle) { return angle == SINGULAR; });
+    return !singular && checker.inCollision(set, scratch);
+  });
+
   sets.erase(last, sets.end());
 }
 
@@ -9,16 +9,17 @@ namespace rbt {
 
 // Create transformation from Denavit-Hartenberg parameters
 // Transform = Translate_z(d) * Rotate_z(theta) * Translate_x(a) * Rotate_x(alpha);
+// in closed form: the rotation Rotate_z(theta) * Rotate_x(alpha) after the translation of d along z and a along the
+// rotated x axis.
 Transform Joint::transform(const Real& theta) const {
-  auto transform = Transform();
-  auto sum = this->theta + theta;
+  const auto half = (this->theta + theta) / 2, twist = this->alpha / 2;
+  const auto ct = std::cos(half), st = std::sin(half);
+  const auto ca = std::cos(twist), sa = std::sin(twist);
 
-  if(this->d != 0)      transform *= Transform(Vector3({0, 0, this->d}));
-  if(sum != 0)          transform *= Transform(Vector3({0, 0, 1}), sum);
-  if(this->a != 0)      transform *= Transform(Vector3({this->a, 0, 0}));
-  if(this->alpha != 0)  transform *= Transform(Vector3({1, 0, 0}), this->alpha);
+  const auto r = Quaternion(ct * ca, ct * sa, st * sa, st * ca);
+  const auto t = Quaternion(0, this->a * (ct * ct - st * st), this->a * 2 * st * ct, this->d);
 
-  return transform;
+  return Transform(Dual<Quaternion>(r, static_cast<Real>(0.5) * t * r));
 }
 
 }
@@ -0,0 +1,67 @@
+#include "link_meshes.hpp"
+#include "utils/parallel.hpp"
+
+namespace rbt {
+
+LinkMeshes::LinkMeshes(const Serial& robot, const std::vector<Mesh>& links) : robot(robot) {
+  assert_msg(links.size() == robot.joints().size() + 1, "Expected a mesh for the base and one for each joint");
+
+  for(const auto& link : links) {
+    this->l.push_back(Geometry{ vertices(link), normals(link) });
+  }
+
+  for(std::size_t link = 0; link < this->l.size(); ++link) {
+    for(const auto normals : { false, true }) {
+      const auto size = normals ? this->l[link].normals.size() : this->l[link].vertices.size();
+      for(std::size_t begin = 0; begin < size; begin += BLOCK_SIZE) {
+        this->blocks.push_back(Block{ link, normals, begin, std::min(begin + BLOCK_SIZE, size) });
+      }
+      this->total += size;
+    }
+  }
+}
+
+void LinkMeshes::pose(const Angles& angles, std::vector<Geometry>& result, Scratch& scratch) const {
+  this->robot.linkPoses(angles, scratch.poses);
+  scratch.placements.resize(scratch.poses.size());
+  for(std::size_t i = 0; i < scratch.poses.size(); ++i) scratch.placements[i] = RigidMatrix(scratch.poses[i]);
+
+  result.resize(this->l.size());
+  for(std::size_t link = 0; link < this->l.size(); ++link) {
+    result[link].vertices.resize(this->l[link].vertices.size());
+    result[link].normals.resize(this->l[link].normals.size());
+  }
+
+  const auto run = [&](std::size_t first, std::size_t last) {
+    for(auto b = first; b < last; ++b) {
+      const auto& block = this->blocks[b];
+      const auto& placement = scratch.placements[block.link];
+      const auto& geometry = this->l[block.link];
+
+      if(block.normals) {
+        rotate(placement, geometry.normals, result[block.link].normals, block.begin, block.end);
+      } else {
+        transform(placement, geometry.vertices, result[block.link].vertices, block.begin, block.end);
+      }
+    }
+  };
+
+  if(this->total <= PARALLEL_THRESHOLD) {
+    run(0, this->blocks.size());
+  } else {
+    parallel_for(this->blocks.size(), run);
+  }
+}
+
+void LinkMeshes::pose(const Angles& angles, std::vector<Geometry>& result) const {
+  Scratch scratch;
+  this->pose(angles, result, scratch);
+}
+
+std::vector<LinkMeshes::Geometry> LinkMeshes::pose(const Angles& angles) const {
+  std::vector<Geometry> result;
+  this->pose(angles, result);
+  return result;
+}
+
+}
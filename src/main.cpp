@@ -5,7 +5,7 @@
 #include "spatial/transform.hpp"
 #include "spatial/triangle.hpp"
 #include "spatial/vector.hpp"
-#include "utils/timer.hpp"
+#include "utils/profiler.hpp"
 #include "visual/file_types/stl/stl_parser.hpp"
 
 #include <iostream>
@@ -17,11 +17,12 @@ using rbt::Vector2;
 using rbt::Serial;
 using rbt::Joint;
 using rbt::toRadians;
-using rbt::Timer;
 using rbt::Triangle;
 
-int main() {
-  Timer t("Program main");
+namespace {
+
+void run() {
+  PROFILE_ZONE("Program main");
   // ABB IRB120
   const auto ABB_IRB_120 = Serial({
     Joint(toRadians( -90),    0, toRadians(   0),  290, Vector2({ toRadians(-165), toRadians(165) })),
@@ -42,5 +43,11 @@ int main() {
   // p.parse("..\\meshes\\abb_irb_120.stl");
   std::vector<Triangle> triangles;
   p.parse("..\\assets\\meshes\\abb_irb_120.stl", triangles);
+}
 
 }
+
+int main() {
+  run();
+  rbt::profiler::print_report(std::cout);
+}
@@ -0,0 +1,349 @@
+#include "mesh/decimation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <queue>
+
+namespace rbt::mesh {
+
+namespace {
+
+// Points and quadrics are kept in double precision so that long chains of collapses do not accumulate rounding
+typedef std::array<double, 3> Point;
+
+Point operator-(const Point& a, const Point& b) { return {{ a[0] - b[0], a[1] - b[1], a[2] - b[2] }}; }
+double dot(const Point& a, const Point& b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+Point cross(const Point& a, const Point& b) {
+  return {{ a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] }};
+}
+
+// The symmetric matrix Q such that [p 1] Q [p 1]^T is the sum of squared distances of p to the planes added to it,
+// stored as its upper triangle.
+class Quadric {
+  std::array<double, 10> q = {};
+public:
+  // Add the plane n.p + d = 0, weighted.
+  void add(const Point& n, double d, double weight = 1) {
+    const std::array<double, 4> p = {{ n[0], n[1], n[2], d }};
+    std::size_t k = 0;
+    for(std::size_t i = 0; i < 4; ++i) {
+      for(std::size_t j = i; j < 4; ++j) this->q[k++] += weight * p[i] * p[j];
+    }
+  }
+
+  Quadric& operator+=(const Quadric& other) {
+    for(std::size_t k = 0; k < 10; ++k) this->q[k] += other.q[k];
+    return *this;
+  }
+
+  double error(const Point& p) const {
+    const auto& q = this->q;
+    return q[0] * p[0] * p[0] + 2 * q[1] * p[0] * p[1] + 2 * q[2] * p[0] * p[2] + 2 * q[3] * p[0]
+      + q[4] * p[1] * p[1] + 2 * q[5] * p[1] * p[2] + 2 * q[6] * p[1]
+      + q[7] * p[2] * p[2] + 2 * q[8] * p[2]
+      + q[9];
+  }
+
+  // The point of least error, if the quadric is well conditioned.
+  bool minimum(Point& result, double scale) const {
+    const auto& q = this->q;
+    // Solve A p = -b by Cramer's rule
+    const std::array<double, 9> a = {{ q[0], q[1], q[2], q[1], q[4], q[5], q[2], q[5], q[7] }};
+    const Point b = {{ -q[3], -q[6], -q[8] }};
+
+    const auto det = a[0] * (a[4] * a[8] - a[5] * a[7]) - a[1] * (a[3] * a[8] - a[5] * a[6]) + a[2] * (a[3] * a[7] - a[4] * a[6]);
+    const auto norm = std::max({ std::abs(a[0]), std::abs(a[4]), std::abs(a[8]) });
+    if(!(std::abs(det) > 1e-9 * norm * norm * norm)) return false;
+
+    result[0] = (b[0] * (a[4] * a[8] - a[5] * a[7]) - a[1] * (b[1] * a[8] - a[5] * b[2]) + a[2] * (b[1] * a[7] - a[4] * b[2])) / det;
+    result[1] = (a[0] * (b[1] * a[8] - a[5] * b[2]) - b[0] * (a[3] * a[8] - a[5] * a[6]) + a[2] * (a[3] * b[2] - b[1] * a[6])) / det;
+    result[2] = (a[0] * (a[4] * b[2] - b[1] * a[7]) - a[1] * (a[3] * b[2] - b[1] * a[6]) + b[0] * (a[3] * a[7] - a[4] * a[6])) / det;
+    return std::isfinite(result[0]) && std::isfinite(result[1]) && std::isfinite(result[2])
+      && std::abs(result[0]) + std::abs(result[1]) + std::abs(result[2]) < scale;
+  }
+};
+
+// A possible collapse of edge (a, b) into position, valid while neither vertex has changed since it was costed.
+struct Collapse {
+  double cost;
+  uint32_t a, b;
+  uint32_t versionA, versionB;
+  Point position;
+
+  bool operator<(const Collapse& other) const { return this->cost > other.cost; }
+};
+
+class Decimator {
+public:
+  Decimator(const IndexedMesh& mesh, bool preserveBoundaries);
+
+  void run(std::size_t targetTriangles, double maxCost);
+  IndexedMesh result() const;
+
+private:
+  std::vector<Point> positions;
+  std::vector<Quadric> quadrics;
+  std::vector<uint32_t> versions;
+  std::vector<bool> locked, removed;
+  std::vector<std::vector<uint32_t>> vertexTriangles;
+
+  std::vector<std::array<uint32_t, 3>> triangles;
+  std::vector<bool> dead;
+  std::size_t alive;
+
+  // Positions beyond this are taken to be a badly conditioned quadric's minimum, not a real one
+  double scale;
+
+  std::priority_queue<Collapse> queue;
+
+  Point normal(const std::array<uint32_t, 3>& triangle) const;
+  std::vector<uint32_t> neighbors(uint32_t vertex) const;
+  void push(uint32_t a, uint32_t b);
+  bool valid(const Collapse& collapse) const;
+  void collapse(const Collapse& collapse);
+};
+
+Decimator::Decimator(const IndexedMesh& mesh, bool preserveBoundaries)
+  : quadrics(mesh.vertices.size()), versions(mesh.vertices.size(), 0), locked(mesh.vertices.size(), false),
+    removed(mesh.vertices.size(), false), vertexTriangles(mesh.vertices.size()), triangles(mesh.triangles),
+    dead(mesh.triangles.size(), false), alive(mesh.triangles.size()), scale(0) {
+  this->positions.reserve(mesh.vertices.size());
+  for(const auto& v : mesh.vertices) {
+    this->positions.push_back({{ v[0], v[1], v[2] }});
+    this->scale = std::max({ this->scale, std::abs(double(v[0])), std::abs(double(v[1])), std::abs(double(v[2])) });
+  }
+  this->scale = 1e3 * std::max(this->scale, 1.0);
+
+  for(uint32_t t = 0; t < this->triangles.size(); ++t) {
+    const auto& triangle = this->triangles[t];
+    const auto n = this->normal(triangle);
+    const auto area = std::sqrt(dot(n, n));
+    if(area > 0) {
+      const Point unit = {{ n[0] / area, n[1] / area, n[2] / area }};
+      for(const auto v : triangle) this->quadrics[v].add(unit, -dot(unit, this->positions[triangle[0]]));
+    }
+    for(const auto v : triangle) this->vertexTriangles[v].push_back(t);
+  }
+
+  // Open edges get a plane through them perpendicular to their triangle, so collapses keep them (nearly) in place
+  for(const auto& edge : boundaryEdges(mesh)) {
+    const auto a = edge[0], b = edge[1];
+    for(const auto t : this->vertexTriangles[a]) {
+      const auto& triangle = this->triangles[t];
+      if(std::find(triangle.begin(), triangle.end(), b) == triangle.end()) continue;
+
+      const auto along = this->positions[b] - this->positions[a];
+      const auto perpendicular = cross(along, this->normal(triangle));
+      const auto size = std::sqrt(dot(perpendicular, perpendicular));
+      if(size > 0) {
+        const Point unit = {{ perpendicular[0] / size, perpendicular[1] / size, perpendicular[2] / size }};
+        Quadric plane;
+        plane.add(unit, -dot(unit, this->positions[a]), 1e3);
+        this->quadrics[a] += plane;
+        this->quadrics[b] += plane;
+      }
+      break;
+    }
+
+    if(preserveBoundaries) {
+      this->locked[a] = true;
+      this->locked[b] = true;
+    }
+  }
+
+  // Interior edges appear in two triangles, so cost each edge once
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  edges.reserve(3 * this->triangles.size());
+  for(const auto& triangle : this->triangles) {
+    for(std::size_t e = 0; e < 3; ++e) edges.push_back(std::minmax(triangle[e], triangle[(e + 1) % 3]));
+  }
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+  for(const auto& edge : edges) this->push(edge.first, edge.second);
+}
+
+Point Decimator::normal(const std::array<uint32_t, 3>& triangle) const {
+  const auto& p = this->positions;
+  return cross(p[triangle[1]] - p[triangle[0]], p[triangle[2]] - p[triangle[0]]);
+}
+
+std::vector<uint32_t> Decimator::neighbors(uint32_t vertex) const {
+  std::vector<uint32_t> result;
+  for(const auto t : this->vertexTriangles[vertex]) {
+    for(const auto v : this->triangles[t]) {
+      if(v != vertex) result.push_back(v);
+    }
+  }
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+void Decimator::push(uint32_t a, uint32_t b) {
+  if(this->locked[a] && this->locked[b]) return;
+  // A locked vertex stays, so collapse into it
+  if(this->locked[b]) std::swap(a, b);
+
+  auto quadric = this->quadrics[a];
+  quadric += this->quadrics[b];
+
+  Collapse collapse;
+  collapse.a = a;
+  collapse.b = b;
+  collapse.versionA = this->versions[a];
+  collapse.versionB = this->versions[b];
+
+  if(!this->locked[a] && quadric.minimum(collapse.position, this->scale)) {
+    collapse.cost = quadric.error(collapse.position);
+  } else {
+    // Fall back to the best of the end points (and, unless one is locked, the midpoint)
+    const auto& pa = this->positions[a], & pb = this->positions[b];
+    const std::array<Point, 3> candidates = {{ pa, pb, {{ (pa[0] + pb[0]) / 2, (pa[1] + pb[1]) / 2, (pa[2] + pb[2]) / 2 }} }};
+    const std::size_t count = this->locked[a] ? 1 : 3;
+
+    collapse.cost = INF;
+    for(std::size_t i = 0; i < count; ++i) {
+      const auto cost = quadric.error(candidates[i]);
+      if(cost < collapse.cost) {
+        collapse.cost = cost;
+        collapse.position = candidates[i];
+      }
+    }
+  }
+  collapse.cost = std::max(collapse.cost, 0.0);
+
+  this->queue.push(collapse);
+}
+
+bool Decimator::valid(const Collapse& collapse) const {
+  const auto a = collapse.a, b = collapse.b;
+
+  // Link condition: the only vertices joined to both are those opposite the edge in its triangles; otherwise the
+  // collapse would pinch the surface into a non-manifold one
+  std::size_t shared = 0;
+  for(const auto t : this->vertexTriangles[a]) {
+    const auto& triangle = this->triangles[t];
+    if(std::find(triangle.begin(), triangle.end(), b) != triangle.end()) ++shared;
+  }
+  const auto na = this->neighbors(a), nb = this->neighbors(b);
+  std::vector<uint32_t> common;
+  std::set_intersection(na.begin(), na.end(), nb.begin(), nb.end(), std::back_inserter(common));
+  if(shared == 0 || common.size() != shared) return false;
+
+  // A closed surface can't shrink below a tetrahedron
+  if(this->alive - shared < 4) return false;
+
+  // No remaining triangle may flip over or degenerate
+  for(const auto v : { a, b }) {
+    for(const auto t : this->vertexTriangles[v]) {
+      auto triangle = this->triangles[t];
+      if(std::find(triangle.begin(), triangle.end(), a) != triangle.end()
+          && std::find(triangle.begin(), triangle.end(), b) != triangle.end()) continue;
+
+      const auto before = this->normal(triangle);
+      std::array<Point, 3> moved = {{ this->positions[triangle[0]], this->positions[triangle[1]], this->positions[triangle[2]] }};
+      for(std::size_t i = 0; i < 3; ++i) {
+        if(triangle[i] == v) moved[i] = collapse.position;
+      }
+      const auto after = cross(moved[1] - moved[0], moved[2] - moved[0]);
+
+      const auto sizes = std::sqrt(dot(before, before) * dot(after, after));
+      if(!(dot(before, after) > 0.2 * sizes)) return false;
+    }
+  }
+
+  return true;
+}
+
+void Decimator::collapse(const Collapse& collapse) {
+  const auto a = collapse.a, b = collapse.b;
+
+  for(const auto t : this->vertexTriangles[b]) {
+    auto& triangle = this->triangles[t];
+    if(std::find(triangle.begin(), triangle.end(), a) != triangle.end()) {
+      // The edge's own triangles vanish
+      this->dead[t] = true;
+      --this->alive;
+      for(const auto v : triangle) {
+        if(v == b) continue;
+        auto& list = this->vertexTriangles[v];
+        list.erase(std::remove(list.begin(), list.end(), t), list.end());
+      }
+    } else {
+      std::replace(triangle.begin(), triangle.end(), b, a);
+      this->vertexTriangles[a].push_back(t);
+    }
+  }
+  this->vertexTriangles[b].clear();
+  this->removed[b] = true;
+
+  this->positions[a] = collapse.position;
+  this->quadrics[a] += this->quadrics[b];
+  ++this->versions[a];
+
+  for(const auto n : this->neighbors(a)) this->push(a, n);
+}
+
+void Decimator::run(std::size_t targetTriangles, double maxCost) {
+  while(this->alive > targetTriangles && !this->queue.empty()) {
+    const auto next = this->queue.top();
+    if(next.cost > maxCost) break;
+    this->queue.pop();
+
+    // Skip collapses costed before either vertex last changed
+    if(this->removed[next.a] || this->removed[next.b]) continue;
+    if(next.versionA != this->versions[next.a] || next.versionB != this->versions[next.b]) continue;
+
+    if(this->valid(next)) this->collapse(next);
+  }
+}
+
+IndexedMesh Decimator::result() const {
+  IndexedMesh result;
+
+  std::vector<uint32_t> index(this->positions.size(), UINT32_MAX);
+  for(std::size_t t = 0; t < this->triangles.size(); ++t) {
+    if(this->dead[t]) continue;
+
+    std::array<uint32_t, 3> triangle;
+    for(std::size_t i = 0; i < 3; ++i) {
+      const auto v = this->triangles[t][i];
+      if(index[v] == UINT32_MAX) {
+        index[v] = static_cast<uint32_t>(result.vertices.size());
+        const auto& p = this->positions[v];
+        result.vertices.push_back(Vector3({ Real(p[0]), Real(p[1]), Real(p[2]) }));
+      }
+      triangle[i] = index[v];
+    }
+    result.triangles.push_back(triangle);
+  }
+
+  return result;
+}
+
+}
+
+IndexedMesh decimate(const IndexedMesh& mesh, std::size_t targetTriangles, Real maxError, bool preserveBoundaries) {
+  if(mesh.triangles.size() <= targetTriangles) return mesh;
+
+  Decimator decimator(mesh, preserveBoundaries);
+  decimator.run(targetTriangles, double(maxError) * double(maxError));
+  return decimator.result();
+}
+
+std::vector<IndexedMesh> levelsOfDetail(const IndexedMesh& mesh, std::size_t levels, Real ratio, Real maxError) {
+  std::vector<IndexedMesh> result;
+  if(levels == 0) return result;
+
+  result.push_back(mesh);
+  while(result.size() < levels) {
+    const auto target = static_cast<std::size_t>(Real(result.back().triangles.size()) * ratio);
+    result.push_back(decimate(result.back(), target, maxError));
+  }
+  return result;
+}
+
+}
@@ -0,0 +1,98 @@
+#include "mesh/indexed_mesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+namespace rbt::mesh {
+
+namespace {
+
+typedef std::tuple<int64_t, int64_t, int64_t> Cell;
+
+struct CellHash {
+  std::size_t operator()(const Cell& cell) const {
+    return static_cast<std::size_t>(std::get<0>(cell) * 73856093 ^ std::get<1>(cell) * 19349663 ^ std::get<2>(cell) * 83492791);
+  }
+};
+
+}
+
+IndexedMesh weld(const Mesh& mesh, Real tolerance) {
+  IndexedMesh result;
+
+  // Vertices are bucketed by grid cell so only nearby cells need searching
+  const auto cellSize = (tolerance > 0) ? tolerance : Real(1);
+  const auto cellOf = [&cellSize](const Vector3& p) {
+    return Cell(
+      static_cast<int64_t>(std::floor(p[0] / cellSize)),
+      static_cast<int64_t>(std::floor(p[1] / cellSize)),
+      static_cast<int64_t>(std::floor(p[2] / cellSize))
+    );
+  };
+
+  std::unordered_map<Cell, std::vector<uint32_t>, CellHash> cells;
+  const auto index = [&](const Vector3& p) {
+    const auto [x, y, z] = cellOf(p);
+    const int64_t reach = (tolerance > 0) ? 1 : 0;
+
+    for(auto i = x - reach; i <= x + reach; ++i) {
+      for(auto j = y - reach; j <= y + reach; ++j) {
+        for(auto k = z - reach; k <= z + reach; ++k) {
+          const auto cell = cells.find(Cell(i, j, k));
+          if(cell == cells.end()) continue;
+
+          for(const auto candidate : cell->second) {
+            const auto& q = result.vertices[candidate];
+            if((tolerance > 0) ? length(q - p) <= tolerance : q == p) return candidate;
+          }
+        }
+      }
+    }
+
+    const auto added = static_cast<uint32_t>(result.vertices.size());
+    result.vertices.push_back(p);
+    cells[Cell(x, y, z)].push_back(added);
+    return added;
+  };
+
+  for(const auto& triangle : mesh) {
+    const std::array<uint32_t, 3> indices = {{ index(triangle[0]), index(triangle[1]), index(triangle[2]) }};
+    if(indices[0] == indices[1] || indices[1] == indices[2] || indices[2] == indices[0]) continue;
+
+    result.triangles.push_back(indices);
+  }
+
+  return result;
+}
+
+Mesh triangles(const IndexedMesh& mesh) {
+  Mesh result;
+  result.reserve(mesh.triangles.size());
+  for(const auto& triangle : mesh.triangles) {
+    result.push_back(Triangle({ mesh.vertices[triangle[0]], mesh.vertices[triangle[1]], mesh.vertices[triangle[2]] }));
+  }
+  return result;
+}
+
+std::vector<std::array<uint32_t, 2>> boundaryEdges(const IndexedMesh& mesh) {
+  // Count each undirected edge, remembering its direction in the first triangle using it
+  std::map<std::pair<uint32_t, uint32_t>, std::pair<std::array<uint32_t, 2>, int>> edges;
+  for(const auto& triangle : mesh.triangles) {
+    for(std::size_t e = 0; e < 3; ++e) {
+      const auto a = triangle[e], b = triangle[(e + 1) % 3];
+      auto& edge = edges[std::minmax(a, b)];
+      if(edge.second++ == 0) edge.first = {{ a, b }};
+    }
+  }
+
+  std::vector<std::array<uint32_t, 2>> result;
+  for(const auto& edge : edges) {
+    if(edge.second.second == 1) result.push_back(edge.second.first);
+  }
+  return result;
+}
+
+}
@@ -0,0 +1,80 @@
+#include "mesh/normals.hpp"
+#include "utils/parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace rbt::mesh {
+
+namespace {
+
+// Call f(begin, end) over [0, count), in parallel if count is large enough.
+template <typename F>
+void run(std::size_t count, const F& f) {
+  if(count <= NORMALS_PARALLEL_THRESHOLD) {
+    f(0, count);
+  } else {
+    parallel_for(count, f);
+  }
+}
+
+Vector3 faceNormal(const IndexedMesh& mesh, const std::array<uint32_t, 3>& triangle) {
+  const auto& v = mesh.vertices;
+  const auto n = cross(v[triangle[1]] - v[triangle[0]], v[triangle[2]] - v[triangle[0]]);
+  const auto size = length(n);
+  return (size > 0) ? n / size : Vector3();
+}
+
+}
+
+Points faceNormals(const IndexedMesh& mesh) {
+  Points result(mesh.triangles.size());
+  run(mesh.triangles.size(), [&](std::size_t begin, std::size_t end) {
+    for(auto t = begin; t < end; ++t) result.set(t, faceNormal(mesh, mesh.triangles[t]));
+  });
+  return result;
+}
+
+Points vertexNormals(const IndexedMesh& mesh) {
+  const auto faces = faceNormals(mesh);
+
+  // The corners (3 t + i) around each vertex, compressed: those of vertex v are corners[offsets[v], offsets[v + 1])
+  std::vector<uint32_t> offsets(mesh.vertices.size() + 1, 0);
+  for(const auto& triangle : mesh.triangles) {
+    for(const auto v : triangle) ++offsets[v + 1];
+  }
+  for(std::size_t v = 0; v < mesh.vertices.size(); ++v) offsets[v + 1] += offsets[v];
+
+  std::vector<uint32_t> corners(offsets.back());
+  auto next = offsets;
+  for(std::size_t t = 0; t < mesh.triangles.size(); ++t) {
+    for(std::size_t i = 0; i < 3; ++i) corners[next[mesh.triangles[t][i]]++] = static_cast<uint32_t>(3 * t + i);
+  }
+
+  // Each vertex gathers from its own corners, so threads never write to the same normal
+  Points result(mesh.vertices.size());
+  run(mesh.vertices.size(), [&](std::size_t begin, std::size_t end) {
+    for(auto v = begin; v < end; ++v) {
+      auto sum = Vector3();
+      for(auto c = offsets[v]; c < offsets[v + 1]; ++c) {
+        const auto t = corners[c] / 3, i = corners[c] % 3;
+        const auto& triangle = mesh.triangles[t];
+        const auto& p = mesh.vertices[triangle[i]];
+        const auto a = mesh.vertices[triangle[(i + 1) % 3]] - p, b = mesh.vertices[triangle[(i + 2) % 3]] - p;
+
+        const auto lengths = length(a) * length(b);
+        if(!(lengths > 0)) continue;
+        const auto angle = std::acos(std::min(std::max((a * b) / lengths, Real(-1)), Real(1)));
+        sum = sum + angle * faces[t];
+      }
+
+      const auto size = length(sum);
+      result.set(v, (size > 0) ? sum / size : Vector3());
+    }
+  });
+
+  return result;
+}
+
+}
@@ -0,0 +1,319 @@
+#include "path.hpp"
+#include "ik.hpp"
+#include "utils/parallel.hpp"
+#include "utils/simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+namespace rbt {
+
+namespace {
+
+// Rotations smaller than this are taken to be none.
+const Real SMALL_ANGLE = 1e-6;
+
+// The coefficients of a path's position and orientation, flattened for the kernels.
+struct Coefficients {
+  float start[3], u[3], v[3], w[3];
+  float phi, halfOmega;
+  // orientation = (r cos - a sin, q cos + b sin), with (cos, sin) of s omega / 2
+  float r, a, q[3], b[3];
+};
+
+Frame frame(float r, float x, float y, float z, float px, float py, float pz) {
+  // The dual part is (0, p) * rotation / 2
+  return Frame(Dual<Quaternion>(
+    Quaternion(r, x, y, z),
+    Quaternion(
+      0.5f * (-(px * x + py * y + pz * z)),
+      0.5f * (r * px + (py * z - pz * y)),
+      0.5f * (r * py + (pz * x - px * z)),
+      0.5f * (r * pz + (px * y - py * x))
+    )
+  ));
+}
+
+void kernel(const Coefficients& k, const Real* s, std::size_t begin, std::size_t end, Frame* frames) {
+  for(auto i = begin; i < end; ++i) {
+    float sp, cp, sr, cr;
+    simd::sin_cos_minus_one(s[i] * k.phi, sp, cp);
+    simd::sin_cos_minus_one(s[i] * k.halfOmega, sr, cr);
+    cr += 1;
+
+    const auto px = k.start[0] + cp * k.u[0] + sp * k.v[0] + s[i] * k.w[0];
+    const auto py = k.start[1] + cp * k.u[1] + sp * k.v[1] + s[i] * k.w[1];
+    const auto pz = k.start[2] + cp * k.u[2] + sp * k.v[2] + s[i] * k.w[2];
+
+    frames[i] = frame(
+      k.r * cr - k.a * sr, k.q[0] * cr + k.b[0] * sr, k.q[1] * cr + k.b[1] * sr, k.q[2] * cr + k.b[2] * sr,
+      px, py, pz
+    );
+  }
+}
+
+#ifdef RBT_AVX_KERNEL
+
+static_assert(std::is_same<Real, float>::value, "The AVX kernel evaluates 8 single precision poses at a time");
+
+// As kernel, 8 poses at a time.
+__attribute__((target("avx"))) void avxKernel(const Coefficients& k, const Real* s, std::size_t count, Frame* frames) {
+  const auto phi = _mm256_set1_ps(k.phi), halfOmega = _mm256_set1_ps(k.halfOmega), one = _mm256_set1_ps(1);
+  const auto half = _mm256_set1_ps(0.5f);
+
+  std::size_t i = 0;
+  for(; i + 8 <= count; i += 8) {
+    const auto t = _mm256_loadu_ps(s + i);
+    __m256 sp, cp, sr, cr;
+    simd::sin_cos_minus_one(_mm256_mul_ps(t, phi), sp, cp);
+    simd::sin_cos_minus_one(_mm256_mul_ps(t, halfOmega), sr, cr);
+    cr = _mm256_add_ps(cr, one);
+
+    // Position and rotation, in the same order of operations as kernel
+    __m256 p[3], q[3];
+    for(std::size_t j = 0; j < 3; ++j) {
+      p[j] = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_set1_ps(k.start[j]),
+        _mm256_mul_ps(cp, _mm256_set1_ps(k.u[j]))), _mm256_mul_ps(sp, _mm256_set1_ps(k.v[j]))),
+        _mm256_mul_ps(t, _mm256_set1_ps(k.w[j])));
+      q[j] = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(k.q[j]), cr), _mm256_mul_ps(_mm256_set1_ps(k.b[j]), sr));
+    }
+    const auto r = _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(k.r), cr), _mm256_mul_ps(_mm256_set1_ps(k.a), sr));
+
+    // The dual part (0, p) * rotation / 2
+    const auto dr = _mm256_mul_ps(half, _mm256_sub_ps(_mm256_setzero_ps(), _mm256_add_ps(_mm256_add_ps(
+      _mm256_mul_ps(p[0], q[0]), _mm256_mul_ps(p[1], q[1])), _mm256_mul_ps(p[2], q[2]))));
+    const auto dx = _mm256_mul_ps(half, _mm256_add_ps(_mm256_mul_ps(r, p[0]),
+      _mm256_sub_ps(_mm256_mul_ps(p[1], q[2]), _mm256_mul_ps(p[2], q[1]))));
+    const auto dy = _mm256_mul_ps(half, _mm256_add_ps(_mm256_mul_ps(r, p[1]),
+      _mm256_sub_ps(_mm256_mul_ps(p[2], q[0]), _mm256_mul_ps(p[0], q[2]))));
+    const auto dz = _mm256_mul_ps(half, _mm256_add_ps(_mm256_mul_ps(r, p[2]),
+      _mm256_sub_ps(_mm256_mul_ps(p[0], q[1]), _mm256_mul_ps(p[1], q[0]))));
+
+    alignas(32) float lanes[8][8];
+    _mm256_store_ps(lanes[0], r);
+    _mm256_store_ps(lanes[1], q[0]);
+    _mm256_store_ps(lanes[2], q[1]);
+    _mm256_store_ps(lanes[3], q[2]);
+    _mm256_store_ps(lanes[4], dr);
+    _mm256_store_ps(lanes[5], dx);
+    _mm256_store_ps(lanes[6], dy);
+    _mm256_store_ps(lanes[7], dz);
+
+    for(std::size_t l = 0; l < 8; ++l) {
+      frames[i + l] = Frame(Dual<Quaternion>(
+        Quaternion(lanes[0][l], lanes[1][l], lanes[2][l], lanes[3][l]),
+        Quaternion(lanes[4][l], lanes[5][l], lanes[6][l], lanes[7][l])
+      ));
+    }
+  }
+
+  kernel(k, s, i, count, frames);
+}
+
+#endif
+
+void store(const Vector3& vector, float* out) {
+  out[0] = vector[0]; out[1] = vector[1]; out[2] = vector[2];
+}
+
+Vector3 vector(const Quaternion& q) {
+  return Vector3({ q.x, q.y, q.z });
+}
+
+// The translation of a (unit) dual quaternion.
+Vector3 translation(const Dual<Quaternion>& pose) {
+  return Frame(pose).position();
+}
+
+// The squared distance between joint angles, skipping singular angles.
+Real distanceSq(const Angles& a, const Angles& b) {
+  Real sum = 0;
+  for(std::size_t i = 0; i < std::min(a.size(), b.size()); ++i) {
+    if(isInf(a[i]) || isInf(b[i])) continue;
+    sum += (a[i] - b[i]) * (a[i] - b[i]);
+  }
+  return sum;
+}
+
+}
+
+// Turning from the first orientation to the last, the shorter way around.
+CartesianPath::CartesianPath(const Frame& from, const Frame& to) {
+  this->initial = from.orientation();
+  auto relative = conjugate(from.orientation()) * to.orientation();
+  if(relative.r < 0) relative = -relative;
+
+  const auto sine = rbt::length(vector(relative));
+  this->omega = 2 * std::atan2(sine, relative.r);
+  this->axis = (sine > SMALL_ANGLE) ? vector(relative) / sine : Vector3({ 1, 0, 0 });
+  if(sine <= SMALL_ANGLE) this->omega = 0;
+
+  this->start = from.position();
+  this->u = this->v = this->w = Vector3();
+  this->phi = 0;
+  this->distance = 0;
+}
+
+CartesianPath CartesianPath::linear(const Frame& from, const Frame& to) {
+  auto path = CartesianPath(from, to);
+  path.w = to.position() - from.position();
+  path.distance = rbt::length(path.w);
+  return path;
+}
+
+CartesianPath CartesianPath::screw(const Frame& from, const Frame& to) {
+  // The motion (in the world) taking from to to, the shorter way around
+  auto motion = to.pose() * inverse(from.pose());
+  if(motion.r.r < 0) motion = Real(-1) * motion;
+
+  const auto sine = rbt::length(vector(motion.r));
+  if(sine <= SMALL_ANGLE) return CartesianPath::linear(from, to);
+
+  auto path = CartesianPath(from, to);
+  const auto theta = 2 * std::atan2(sine, motion.r.r);
+  const auto n = vector(motion.r) / sine;
+  const auto t = translation(motion);
+
+  // Slide along the screw axis by d while turning about it by theta. The axis passes through c.
+  const auto d = t * n;
+  const auto c = Real(0.5) * ((t - d * n) + (motion.r.r / sine) * cross(n, t));
+
+  const auto offset = path.start - c;
+  path.u = offset - (offset * n) * n;
+  path.v = cross(n, path.u);
+  path.w = d * n;
+  path.phi = theta;
+  path.distance = std::sqrt(lengthSq(path.u) * theta * theta + d * d);
+  return path;
+}
+
+CartesianPath CartesianPath::circular(const Frame& from, const Frame& via, const Frame& to) {
+  const auto a = from.position(), b = via.position(), c = to.position();
+  const auto ab = b - a, ac = c - a;
+  const auto normal = cross(ab, ac);
+  const auto normalSq = lengthSq(normal);
+  if(normalSq <= EPSILON * lengthSq(ab) * lengthSq(ac)) {
+    throw std::invalid_argument("The positions of a circular path must not be collinear");
+  }
+
+  // The circumcenter of the three positions
+  const auto center = a + (lengthSq(ac) * cross(normal, ab) + lengthSq(ab) * cross(ac, normal)) / (2 * normalSq);
+  const auto n = normal / std::sqrt(normalSq);
+
+  auto path = CartesianPath(from, to);
+  path.u = a - center;
+  path.v = cross(n, path.u);
+  // The normal orients the circle so the via position is passed on the way from first to last
+  const auto radiusSq = lengthSq(path.u);
+  auto end = std::atan2((c - center) * path.v, (c - center) * path.u);
+  if(end <= 0) end += 2 * PI;
+  path.phi = end;
+  path.distance = std::sqrt(radiusSq) * end;
+  return path;
+}
+
+Frame CartesianPath::operator()(Real s) const {
+  Frame result;
+  this->evaluate(&s, 1, &result);
+  return result;
+}
+
+std::vector<Real> CartesianPath::samples(Real resolution, Real angularResolution) const {
+  const auto steps = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(std::max(
+    this->distance / resolution,
+    this->omega / angularResolution
+  ))));
+
+  std::vector<Real> s(steps + 1);
+  for(std::size_t i = 0; i <= steps; ++i) s[i] = Real(i) / Real(steps);
+  return s;
+}
+
+void CartesianPath::evaluate(const Real* s, std::size_t count, Frame* frames) const {
+  Coefficients k;
+  store(this->start, k.start);
+  store(this->u, k.u);
+  store(this->v, k.v);
+  store(this->w, k.w);
+  k.phi = this->phi;
+  k.halfOmega = this->omega / 2;
+
+  // initial * (cos, sin axis) = (r cos - sin (q . axis), cos q + sin (r axis + q x axis))
+  const auto q = vector(this->initial);
+  k.r = this->initial.r;
+  k.a = q * this->axis;
+  store(q, k.q);
+  store(this->initial.r * this->axis + cross(q, this->axis), k.b);
+
+#ifdef RBT_AVX_KERNEL
+  if(simd::avx()) return avxKernel(k, s, count, frames);
+#endif
+
+  kernel(k, s, 0, count, frames);
+}
+
+void CartesianPath::evaluate(const std::vector<Real>& s, std::vector<Frame>& frames) const {
+  frames.resize(s.size());
+  this->evaluate(s.data(), s.size(), frames.data());
+}
+
+std::vector<Frame> CartesianPath::frames(Real resolution, Real angularResolution) const {
+  std::vector<Frame> frames;
+  this->evaluate(this->samples(resolution, angularResolution), frames);
+  return frames;
+}
+
+Dual<Quaternion> sclerp(const Dual<Quaternion>& from, const Dual<Quaternion>& to, Real t) {
+  return CartesianPath::screw(from, to)(t).pose();
+}
+
+AngleSets jointPath(
+  const CartesianPath& path,
+  const Serial& robot,
+  const Angles& start,
+  Real resolution,
+  Real angularResolution
+) {
+  const auto s = path.samples(resolution, angularResolution);
+
+  AngleSets result;
+  result.reserve(s.size());
+  std::vector<Frame> frames(PATH_CHUNK);
+  std::vector<AngleSets> solutions(PATH_CHUNK);
+  auto previous = start;
+
+  for(std::size_t begin = 0; begin < s.size(); begin += PATH_CHUNK) {
+    const auto count = std::min(PATH_CHUNK, s.size() - begin);
+    path.evaluate(s.data() + begin, count, frames.data());
+
+    parallel_for(count, [&](std::size_t first, std::size_t last) {
+      for(auto i = first; i < last; ++i) solutions[i] = ik::angles(frames[i], robot);
+    });
+
+    for(std::size_t i = 0; i < count; ++i) {
+      if(solutions[i].empty()) return result;
+
+      // A singular joint can take any angle, so it keeps its previous one. Before choosing, as otherwise every
+      // solution with a singular joint is infinitely far away.
+      for(auto& solution : solutions[i]) {
+        for(std::size_t j = 0; j < solution.size(); ++j) {
+          if(isInf(solution[j])) solution[j] = (j < previous.size()) ? previous[j] : 0;
+        }
+      }
+
+      const auto closest = previous.empty() ? solutions[i].begin() : std::min_element(
+        solutions[i].begin(), solutions[i].end(),
+        [&previous](const Angles& a, const Angles& b) { return distanceSq(a, previous) < distanceSq(b, previous); }
+      );
+
+      result.push_back(*closest);
+      previous = *closest;
+    }
+  }
+
+  return result;
+}
+
+}
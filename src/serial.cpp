@@ -1,16 +1,22 @@
 #include "serial.hpp"
 #include "joint.hpp"
 #include "spatial/transform.hpp"
+#include "utils/capture.hpp"
+#include "utils/metrics.hpp"
 
 #include <algorithm>
 
 namespace rbt {
 
-std::vector<Joint> Serial::joints() const {
+const std::vector<Joint>& Serial::joints() const {
   return this->j;
 }
 
 Frame Serial::pose(Angles angles) const {
+  static auto& calls = metrics::counter("rbt_serial_pose_total", "Forward kinematics (Serial::pose) calls");
+  calls.add();
+  capture::record(angles, *this);
+
   auto t = Transform();
   angles.resize(this->j.size());
   auto angle = angles.begin();
@@ -36,4 +42,21 @@ std::vector<Frame> Serial::poses(Angles angles) const {
   return frames;
 }
 
+std::vector<Frame> Serial::linkPoses(Angles angles) const {
+  auto frames = this->poses(angles);
+  frames.insert(frames.begin(), Frame());
+  return frames;
+}
+
+void Serial::linkPoses(const Angles& angles, std::vector<Frame>& frames) const {
+  frames.resize(this->j.size() + 1);
+  frames[0] = Frame();
+
+  auto t = Transform();
+  for(std::size_t i = 0; i < this->j.size(); ++i) {
+    t *= this->j[i].transform((i < angles.size()) ? angles[i] : 0);
+    frames[i + 1] = Frame(t.dual);
+  }
+}
+
 }
@@ -0,0 +1,115 @@
+#include "spatial/aabb.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/triangle.hpp"
+
+#include <algorithm>
+
+namespace rbt {
+
+void AABB::expand(const Vector3& p) {
+  for(std::size_t i = 0; i < 3; ++i) {
+    this->min[i] = std::min(this->min[i], p[i]);
+    this->max[i] = std::max(this->max[i], p[i]);
+  }
+}
+
+void AABB::expand(const AABB& box) {
+  for(std::size_t i = 0; i < 3; ++i) {
+    this->min[i] = std::min(this->min[i], box.min[i]);
+    this->max[i] = std::max(this->max[i], box.max[i]);
+  }
+}
+
+bool AABB::empty() const {
+  return this->min[0] > this->max[0] || this->min[1] > this->max[1] || this->min[2] > this->max[2];
+}
+
+Vector3 AABB::center() const {
+  return (this->min + this->max) / Real(2);
+}
+
+Vector3 AABB::extent() const {
+  return this->max - this->min;
+}
+
+Real AABB::surfaceArea() const {
+  if(this->empty()) return 0;
+
+  const auto e = this->extent();
+  return 2 * (e[0] * e[1] + e[1] * e[2] + e[2] * e[0]);
+}
+
+AABB bounds(const Triangle& t) {
+  auto box = AABB(t[0], t[0]);
+  box.expand(t[1]);
+  box.expand(t[2]);
+  return box;
+}
+
+bool overlaps(const AABB& a, const AABB& b) {
+  for(std::size_t i = 0; i < 3; ++i) {
+    if(a.max[i] < b.min[i] || b.max[i] < a.min[i]) return false;
+  }
+  return true;
+}
+
+// From Ericson, Real-Time Collision Detection (4.4.1) with box a as the reference frame
+bool overlaps(const AABB& a, const AABB& b, const RigidMatrix& bToA) {
+  const auto ea = a.extent() / Real(2);
+  const auto eb = b.extent() / Real(2);
+  const auto t = bToA(b.center()) - a.center();
+
+  // Padding the absolute rotation guards against near-parallel edges producing null cross product axes
+  std::array<std::array<Real, 3>, 3> absR;
+  for(std::size_t i = 0; i < 3; ++i) {
+    for(std::size_t j = 0; j < 3; ++j) {
+      absR[i][j] = std::abs(bToA(i, j)) + EPSILON;
+    }
+  }
+
+  // The axes of a
+  for(std::size_t i = 0; i < 3; ++i) {
+    const auto rb = eb[0] * absR[i][0] + eb[1] * absR[i][1] + eb[2] * absR[i][2];
+    if(std::abs(t[i]) > ea[i] + rb) return false;
+  }
+
+  // The axes of b
+  for(std::size_t j = 0; j < 3; ++j) {
+    const auto ra = ea[0] * absR[0][j] + ea[1] * absR[1][j] + ea[2] * absR[2][j];
+    const auto projection = t[0] * bToA(0, j) + t[1] * bToA(1, j) + t[2] * bToA(2, j);
+    if(std::abs(projection) > ra + eb[j]) return false;
+  }
+
+  // The cross products of each pair of axes
+  for(std::size_t i = 0; i < 3; ++i) {
+    const auto i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+    for(std::size_t j = 0; j < 3; ++j) {
+      const auto j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+      const auto ra = ea[i1] * absR[i2][j] + ea[i2] * absR[i1][j];
+      const auto rb = eb[j1] * absR[i][j2] + eb[j2] * absR[i][j1];
+      if(std::abs(t[i2] * bToA(i1, j) - t[i1] * bToA(i2, j)) > ra + rb) return false;
+    }
+  }
+
+  return true;
+}
+
+bool contains(const AABB& box, const Vector3& p) {
+  for(std::size_t i = 0; i < 3; ++i) {
+    if(p[i] < box.min[i] || p[i] > box.max[i]) return false;
+  }
+  return true;
+}
+
+Real distanceSq(const AABB& box, const Vector3& p) {
+  Real distance = 0;
+
+  for(std::size_t i = 0; i < 3; ++i) {
+    const auto excess = std::max({ box.min[i] - p[i], Real(0), p[i] - box.max[i] });
+    distance += excess * excess;
+  }
+
+  return distance;
+}
+
+}
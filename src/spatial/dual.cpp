@@ -1,4 +1,7 @@
 #include "spatial/dual.hpp"
+#include "utils/simd.hpp"
+
+#include <cmath>
 
 namespace rbt {
 
@@ -14,4 +17,63 @@ Real norm(const Dual<Quaternion>& a) {
   return norm(a.r);
 }
 
+namespace {
+
+using simd::TINY_ANGLE;
+
+Real dot(const Quaternion& a, const Quaternion& b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+}
+
+Dual<Quaternion> inverse(const Dual<Quaternion>& a) {
+  return Dual<Quaternion>(conjugate(a.r), conjugate(a.d));
+}
+
+// With the dual angle x + εδ (x = |w|, δ = w.v / x) and dual axis n + εm, exp(a) = cos(x + εδ) + sin(x + εδ)(n + εm),
+// which expands to (cos(x), sinc(x) w) + ε(-sinc(x) w.v, sinc(x) v + (w.v) cos_minus_sinc(x) w).
+Dual<Quaternion> exp(const Dual<Quaternion>& a) {
+  const auto x = std::sqrt(dot(a.r, a.r));
+  const auto cos = std::cos(x);
+  const auto sinc = (x > TINY_ANGLE) ? std::sin(x) / x : 1 - x * x / 6;
+  const auto c = simd::cos_minus_sinc(x, cos, sinc);
+  const auto wv = dot(a.r, a.d);
+
+  return Dual<Quaternion>(
+    Quaternion(cos, sinc * a.r.x, sinc * a.r.y, sinc * a.r.z),
+    Quaternion(
+      -sinc * wv,
+      sinc * a.d.x + wv * c * a.r.x,
+      sinc * a.d.y + wv * c * a.r.y,
+      sinc * a.d.z + wv * c * a.r.z
+    )
+  );
+}
+
+// Inverts exp: w = x / sin(x) times the vector of the real part, then w.v and v from the dual part.
+Dual<Quaternion> log(const Dual<Quaternion>& a) {
+  const auto q = (a.r.r < 0) ? Real(-1) * a : a;
+
+  const auto sin = std::sqrt(dot(q.r, q.r));
+  const auto x = std::atan2(sin, q.r.r);
+  // x / sin(x), i.e. 1 / sinc(x)
+  const auto k = (sin > TINY_ANGLE) ? x / sin : 1 + sin * sin / 6;
+  const auto c = simd::cos_minus_sinc(x, q.r.r, 1 / k);
+
+  const auto w = Quaternion(0, k * q.r.x, k * q.r.y, k * q.r.z);
+  const auto wv = -k * q.d.r;
+
+  return Dual<Quaternion>(w, Quaternion(
+    0,
+    k * (q.d.x - wv * c * w.x),
+    k * (q.d.y - wv * c * w.y),
+    k * (q.d.z - wv * c * w.z)
+  ));
+}
+
+Dual<Quaternion> pow(const Dual<Quaternion>& a, Real t) {
+  return exp(t * log(a));
+}
+
 }
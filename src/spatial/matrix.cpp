@@ -0,0 +1,68 @@
+#include "spatial/matrix.hpp"
+
+namespace rbt {
+
+RigidMatrix::RigidMatrix(const Dual<Quaternion>& pose) {
+  const auto& q = pose.r;
+  const auto t = 2 * pose.d * conjugate(q);
+
+  const auto xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+  const auto xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+  const auto rx = q.r * q.x, ry = q.r * q.y, rz = q.r * q.z;
+
+  this->m = {
+    1 - 2 * (yy + zz),     2 * (xy - rz),     2 * (xz + ry), t.x,
+        2 * (xy + rz), 1 - 2 * (xx + zz),     2 * (yz - rx), t.y,
+        2 * (xz - ry),     2 * (yz + rx), 1 - 2 * (xx + yy), t.z
+  };
+}
+
+Vector3 RigidMatrix::operator()(const Vector3& p) const {
+  const auto& m = this->m;
+  return Vector3({
+    m[0] * p[0] + m[1] * p[1] + m[2]  * p[2] + m[3],
+    m[4] * p[0] + m[5] * p[1] + m[6]  * p[2] + m[7],
+    m[8] * p[0] + m[9] * p[1] + m[10] * p[2] + m[11]
+  });
+}
+
+Vector3 RigidMatrix::rotate(const Vector3& v) const {
+  const auto& m = this->m;
+  return Vector3({
+    m[0] * v[0] + m[1] * v[1] + m[2]  * v[2],
+    m[4] * v[0] + m[5] * v[1] + m[6]  * v[2],
+    m[8] * v[0] + m[9] * v[1] + m[10] * v[2]
+  });
+}
+
+Vector3 RigidMatrix::translation() const {
+  return Vector3({ this->m[3], this->m[7], this->m[11] });
+}
+
+RigidMatrix operator*(const RigidMatrix& a, const RigidMatrix& b) {
+  std::array<Real, 12> m;
+
+  for(std::size_t row = 0; row < 3; ++row) {
+    for(std::size_t column = 0; column < 4; ++column) {
+      m[4 * row + column] =
+        a(row, 0) * b(0, column) +
+        a(row, 1) * b(1, column) +
+        a(row, 2) * b(2, column) +
+        ((column == 3) ? a(row, 3) : 0);
+    }
+  }
+
+  return RigidMatrix(m);
+}
+
+// The inverse of [R | t] is [R^T | -R^T t]
+RigidMatrix inverse(const RigidMatrix& a) {
+  const auto& m = a.m;
+  return RigidMatrix({
+    m[0], m[4], m[8],  -(m[0] * m[3] + m[4] * m[7] + m[8]  * m[11]),
+    m[1], m[5], m[9],  -(m[1] * m[3] + m[5] * m[7] + m[9]  * m[11]),
+    m[2], m[6], m[10], -(m[2] * m[3] + m[6] * m[7] + m[10] * m[11])
+  });
+}
+
+}
@@ -0,0 +1,228 @@
+#include "spatial/points.hpp"
+#include "utils/simd.hpp"
+
+#include <type_traits>
+
+namespace rbt {
+
+namespace {
+
+// out = R * in (+ t) one point at a time.
+void kernel(
+  const RigidMatrix& placement,
+  bool translate,
+  const Points& in,
+  Points& out,
+  std::size_t begin,
+  std::size_t end
+) {
+  const auto& m = placement.m;
+  const auto tx = translate ? m[3] : 0, ty = translate ? m[7] : 0, tz = translate ? m[11] : 0;
+
+  for(auto i = begin; i < end; ++i) {
+    const auto x = in.x[i], y = in.y[i], z = in.z[i];
+    out.x[i] = m[0] * x + m[1] * y + m[2]  * z + tx;
+    out.y[i] = m[4] * x + m[5] * y + m[6]  * z + ty;
+    out.z[i] = m[8] * x + m[9] * y + m[10] * z + tz;
+  }
+}
+
+std::size_t farthestScalar(const Points& points, const Vector3& direction, std::size_t begin, std::size_t best) {
+  auto bestDot = points.x[best] * direction[0] + points.y[best] * direction[1] + points.z[best] * direction[2];
+  for(auto i = begin; i < points.size(); ++i) {
+    const auto dot = points.x[i] * direction[0] + points.y[i] * direction[1] + points.z[i] * direction[2];
+    if(dot > bestDot) {
+      bestDot = dot;
+      best = i;
+    }
+  }
+  return best;
+}
+
+#ifdef RBT_AVX_KERNEL
+
+static_assert(std::is_same<Real, float>::value, "The AVX kernel transforms 8 single precision points at a time");
+
+// As kernel, 8 points at a time.
+__attribute__((target("avx"))) void avxKernel(
+  const RigidMatrix& placement,
+  bool translate,
+  const Points& in,
+  Points& out,
+  std::size_t begin,
+  std::size_t end
+) {
+  const auto& m = placement.m;
+  const auto r00 = _mm256_set1_ps(m[0]), r01 = _mm256_set1_ps(m[1]), r02 = _mm256_set1_ps(m[2]);
+  const auto r10 = _mm256_set1_ps(m[4]), r11 = _mm256_set1_ps(m[5]), r12 = _mm256_set1_ps(m[6]);
+  const auto r20 = _mm256_set1_ps(m[8]), r21 = _mm256_set1_ps(m[9]), r22 = _mm256_set1_ps(m[10]);
+  const auto tx = _mm256_set1_ps(translate ? m[3] : 0);
+  const auto ty = _mm256_set1_ps(translate ? m[7] : 0);
+  const auto tz = _mm256_set1_ps(translate ? m[11] : 0);
+
+  // Same order of operations as kernel, so results don't depend on the path taken
+  auto i = begin;
+  for(; i + 8 <= end; i += 8) {
+    const auto x = _mm256_loadu_ps(&in.x[i]);
+    const auto y = _mm256_loadu_ps(&in.y[i]);
+    const auto z = _mm256_loadu_ps(&in.z[i]);
+
+    const auto ox = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r00, x), _mm256_mul_ps(r01, y)),
+      _mm256_mul_ps(r02, z)), tx);
+    const auto oy = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r10, x), _mm256_mul_ps(r11, y)),
+      _mm256_mul_ps(r12, z)), ty);
+    const auto oz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r20, x), _mm256_mul_ps(r21, y)),
+      _mm256_mul_ps(r22, z)), tz);
+
+    _mm256_storeu_ps(&out.x[i], ox);
+    _mm256_storeu_ps(&out.y[i], oy);
+    _mm256_storeu_ps(&out.z[i], oz);
+  }
+
+  kernel(placement, translate, in, out, i, end);
+}
+
+// As farthestScalar, tracking the best point of each lane. Indices are held as floats, exact below 2^24.
+__attribute__((target("avx"))) std::size_t farthestAVX(const Points& points, const Vector3& direction) {
+  const auto dx = _mm256_set1_ps(direction[0]);
+  const auto dy = _mm256_set1_ps(direction[1]);
+  const auto dz = _mm256_set1_ps(direction[2]);
+  const auto step = _mm256_set1_ps(8);
+
+  auto best = _mm256_set1_ps(-INF);
+  auto bestIndex = _mm256_setzero_ps();
+  auto index = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+
+  std::size_t i = 0;
+  for(; i + 8 <= points.size(); i += 8) {
+    const auto dot = _mm256_add_ps(_mm256_add_ps(
+      _mm256_mul_ps(_mm256_loadu_ps(&points.x[i]), dx),
+      _mm256_mul_ps(_mm256_loadu_ps(&points.y[i]), dy)),
+      _mm256_mul_ps(_mm256_loadu_ps(&points.z[i]), dz));
+
+    const auto greater = _mm256_cmp_ps(dot, best, _CMP_GT_OQ);
+    best = _mm256_blendv_ps(best, dot, greater);
+    bestIndex = _mm256_blendv_ps(bestIndex, index, greater);
+    index = _mm256_add_ps(index, step);
+  }
+
+  if(i == 0) return farthestScalar(points, direction, 1, 0);
+
+  alignas(32) float lanes[8], indices[8];
+  _mm256_store_ps(lanes, best);
+  _mm256_store_ps(indices, bestIndex);
+
+  std::size_t lane = 0;
+  for(std::size_t l = 1; l < 8; ++l) {
+    if(lanes[l] > lanes[lane] || (lanes[l] == lanes[lane] && indices[l] < indices[lane])) lane = l;
+  }
+
+  return farthestScalar(points, direction, i, static_cast<std::size_t>(indices[lane]));
+}
+
+#endif
+
+void dispatch(
+  const RigidMatrix& placement,
+  bool translate,
+  const Points& in,
+  Points& out,
+  std::size_t begin,
+  std::size_t end
+) {
+  assert_msg(end <= in.size() && end <= out.size(), "Point range out of bounds");
+
+#ifdef RBT_AVX_KERNEL
+  if(simd::avx()) {
+    avxKernel(placement, translate, in, out, begin, end);
+    return;
+  }
+#endif
+
+  kernel(placement, translate, in, out, begin, end);
+}
+
+}
+
+Points::Points(const std::vector<Vector3>& points) : Points(points.size()) {
+  for(std::size_t i = 0; i < points.size(); ++i) {
+    this->set(i, points[i]);
+  }
+}
+
+void Points::resize(std::size_t size) {
+  this->x.resize(size);
+  this->y.resize(size);
+  this->z.resize(size);
+}
+
+void Points::set(std::size_t index, const Vector3& p) {
+  this->x[index] = p[0];
+  this->y[index] = p[1];
+  this->z[index] = p[2];
+}
+
+void Points::push_back(const Vector3& p) {
+  this->x.push_back(p[0]);
+  this->y.push_back(p[1]);
+  this->z.push_back(p[2]);
+}
+
+void transform(const RigidMatrix& placement, const Points& in, Points& out, std::size_t begin, std::size_t end) {
+  dispatch(placement, true, in, out, begin, end);
+}
+
+void transform(const RigidMatrix& placement, const Points& in, Points& out) {
+  dispatch(placement, true, in, out, 0, in.size());
+}
+
+void rotate(const RigidMatrix& placement, const Points& in, Points& out, std::size_t begin, std::size_t end) {
+  dispatch(placement, false, in, out, begin, end);
+}
+
+void rotate(const RigidMatrix& placement, const Points& in, Points& out) {
+  dispatch(placement, false, in, out, 0, in.size());
+}
+
+std::size_t farthest(const Points& points, const Vector3& direction) {
+  assert_msg(points.size() > 0, "No points to choose from");
+
+#ifdef RBT_AVX_KERNEL
+  if(simd::avx()) return farthestAVX(points, direction);
+#endif
+
+  return farthestScalar(points, direction, 1, 0);
+}
+
+Points vertices(const Mesh& mesh) {
+  Points result(3 * mesh.size());
+  for(std::size_t t = 0; t < mesh.size(); ++t) {
+    for(std::size_t corner = 0; corner < 3; ++corner) {
+      result.set(3 * t + corner, mesh[t][corner]);
+    }
+  }
+  return result;
+}
+
+Points normals(const Mesh& mesh) {
+  Points result(mesh.size());
+  for(std::size_t t = 0; t < mesh.size(); ++t) {
+    const auto n = normal(mesh[t]);
+    const auto magnitude = length(n);
+
+    // Degenerate triangles have no direction
+    result.set(t, (magnitude > 0) ? n / magnitude : Vector3());
+  }
+  return result;
+}
+
+Mesh triangles(const Points& vertices) {
+  Mesh mesh;
+  mesh.reserve(vertices.size() / 3);
+  for(std::size_t t = 0; 3 * t + 2 < vertices.size(); ++t) {
+    mesh.push_back(Triangle({ vertices[3 * t], vertices[3 * t + 1], vertices[3 * t + 2] }));
+  }
+  return mesh;
+}
+
+}
@@ -0,0 +1,99 @@
+#include "spatial/triangle.hpp"
+
+#include <algorithm>
+
+namespace rbt {
+
+namespace {
+
+// Project the triangle onto the axis and return the interval [min, max].
+Vector2 project(const Triangle& t, const Vector3& axis) {
+  const auto a = t[0] * axis;
+  const auto b = t[1] * axis;
+  const auto c = t[2] * axis;
+
+  return Vector2({ std::min({a, b, c}), std::max({a, b, c}) });
+}
+
+bool separatedAlong(const Triangle& a, const Triangle& b, const Vector3& axis) {
+  // Degenerate axes (e.g. from parallel edges) cannot separate anything
+  if(lengthSq(axis) <= EPSILON * EPSILON) return false;
+
+  const auto p = project(a, axis);
+  const auto q = project(b, axis);
+
+  return p[1] < q[0] || q[1] < p[0];
+}
+
+}
+
+Vector3 normal(const Triangle& t) {
+  return cross(t[1] - t[0], t[2] - t[0]);
+}
+
+Vector3 centroid(const Triangle& t) {
+  return (t[0] + t[1] + t[2]) / Real(3);
+}
+
+// Voronoi region classification from Ericson, Real-Time Collision Detection (5.1.5)
+Vector3 closestPoint(const Triangle& t, const Vector3& p) {
+  const auto& a = t[0];
+  const auto& b = t[1];
+  const auto& c = t[2];
+
+  const auto ab = b - a;
+  const auto ac = c - a;
+  const auto ap = p - a;
+
+  const auto d1 = ab * ap;
+  const auto d2 = ac * ap;
+  if(d1 <= 0 && d2 <= 0) return a;
+
+  const auto bp = p - b;
+  const auto d3 = ab * bp;
+  const auto d4 = ac * bp;
+  if(d3 >= 0 && d4 <= d3) return b;
+
+  const auto vc = d1 * d4 - d3 * d2;
+  if(vc <= 0 && d1 >= 0 && d3 <= 0) return a + (d1 / (d1 - d3)) * ab;
+
+  const auto cp = p - c;
+  const auto d5 = ab * cp;
+  const auto d6 = ac * cp;
+  if(d6 >= 0 && d5 <= d6) return c;
+
+  const auto vb = d5 * d2 - d1 * d6;
+  if(vb <= 0 && d2 >= 0 && d6 <= 0) return a + (d2 / (d2 - d6)) * ac;
+
+  const auto va = d3 * d6 - d5 * d4;
+  if(va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) return b + ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (c - b);
+
+  // Inside the face region
+  const auto denominator = 1 / (va + vb + vc);
+  return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+bool intersects(const Triangle& a, const Triangle& b) {
+  const auto nA = normal(a);
+  const auto nB = normal(b);
+
+  if(separatedAlong(a, b, nA) || separatedAlong(a, b, nB)) return false;
+
+  const std::array<Vector3, 3> edgesA = {{ a[1] - a[0], a[2] - a[1], a[0] - a[2] }};
+  const std::array<Vector3, 3> edgesB = {{ b[1] - b[0], b[2] - b[1], b[0] - b[2] }};
+
+  for(const auto& edgeA : edgesA) {
+    for(const auto& edgeB : edgesB) {
+      if(separatedAlong(a, b, cross(edgeA, edgeB))) return false;
+    }
+  }
+
+  // In-plane axes are only needed to separate coplanar triangles
+  for(std::size_t i = 0; i < 3; ++i) {
+    if(separatedAlong(a, b, cross(nA, edgesA[i])) || separatedAlong(a, b, cross(nB, edgesB[i]))) return false;
+  }
+
+  return true;
+}
+
+}
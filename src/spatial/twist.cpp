@@ -0,0 +1,298 @@
+#include "spatial/twist.hpp"
+#include "utilities.hpp"
+#include "utils/simd.hpp"
+
+#include <cmath>
+
+#include <type_traits>
+
+namespace rbt {
+
+namespace {
+
+using simd::TINY_ANGLE;
+
+// The components of a batch of poses, or of one pose repeated (with a step of 0).
+struct PoseArrays {
+  const Real* c[8];
+  std::size_t step;
+};
+
+PoseArrays arrays(const Poses& poses) {
+  return PoseArrays{ { poses.rr.data(), poses.rx.data(), poses.ry.data(), poses.rz.data(),
+    poses.dr.data(), poses.dx.data(), poses.dy.data(), poses.dz.data() }, 1 };
+}
+
+// out[i] = 2 log(to[i] * inverse(from[i])) for i in [begin, end).
+void twistKernel(const PoseArrays& from, const Poses& to, Twists& out, std::size_t begin, std::size_t end) {
+  for(auto i = begin; i < end; ++i) {
+    const auto j = i * from.step;
+    const auto fr = from.c[0][j], fx = from.c[1][j], fy = from.c[2][j], fz = from.c[3][j];
+    const auto gr = from.c[4][j], gx = from.c[5][j], gy = from.c[6][j], gz = from.c[7][j];
+    const auto tr = to.rr[i], tx = to.rx[i], ty = to.ry[i], tz = to.rz[i];
+    const auto sr = to.dr[i], sx = to.dx[i], sy = to.dy[i], sz = to.dz[i];
+
+    // m = to * inverse(from): p * conjugate(q) = (p.r q.r + p.v . q.v, q.r p.v - p.r q.v - p.v x q.v)
+    auto mr = tr * fr + (tx * fx + ty * fy + tz * fz);
+    auto mx = fr * tx - tr * fx - (ty * fz - tz * fy);
+    auto my = fr * ty - tr * fy - (tz * fx - tx * fz);
+    auto mz = fr * tz - tr * fz - (tx * fy - ty * fx);
+    auto nr = (tr * gr + (tx * gx + ty * gy + tz * gz)) + (sr * fr + (sx * fx + sy * fy + sz * fz));
+    auto nx = (gr * tx - tr * gx - (ty * gz - tz * gy)) + (fr * sx - sr * fx - (sy * fz - sz * fy));
+    auto ny = (gr * ty - tr * gy - (tz * gx - tx * gz)) + (fr * sy - sr * fy - (sz * fx - sx * fz));
+    auto nz = (gr * tz - tr * gz - (tx * gy - ty * gx)) + (fr * sz - sr * fz - (sx * fy - sy * fx));
+
+    // The shorter way around
+    if(mr < 0) {
+      mr = -mr; mx = -mx; my = -my; mz = -mz;
+      nr = -nr; nx = -nx; ny = -ny; nz = -nz;
+    }
+
+    // As log in dual.cpp
+    const auto sin = std::sqrt(mx * mx + my * my + mz * mz);
+    const auto x = simd::atan2_positive(sin, mr);
+    const auto k = (sin > TINY_ANGLE) ? x / sin : 1 + sin * sin / 6;
+    const auto c = simd::cos_minus_sinc(x, mr, 1 / k);
+
+    const auto wx = k * mx, wy = k * my, wz = k * mz;
+    const auto wvc = -k * nr * c;
+
+    out.wx[i] = 2 * wx;
+    out.wy[i] = 2 * wy;
+    out.wz[i] = 2 * wz;
+    out.vx[i] = 2 * (k * (nx - wvc * wx));
+    out.vy[i] = 2 * (k * (ny - wvc * wy));
+    out.vz[i] = 2 * (k * (nz - wvc * wz));
+  }
+}
+
+// out[i] = exp(twists[i] / 2) for i in [begin, end), as exp in dual.cpp.
+void displacementKernel(const Twists& twists, Poses& out, std::size_t begin, std::size_t end) {
+  for(auto i = begin; i < end; ++i) {
+    const auto wx = 0.5f * twists.wx[i], wy = 0.5f * twists.wy[i], wz = 0.5f * twists.wz[i];
+    const auto vx = 0.5f * twists.vx[i], vy = 0.5f * twists.vy[i], vz = 0.5f * twists.vz[i];
+
+    const auto x = std::sqrt(wx * wx + wy * wy + wz * wz);
+    float sin, cos;
+    simd::sin_cos_minus_one(x, sin, cos);
+    cos += 1;
+    const auto sinc = (x > TINY_ANGLE) ? sin / x : 1 - x * x / 6;
+    const auto wvc = (wx * vx + wy * vy + wz * vz) * simd::cos_minus_sinc(x, cos, sinc);
+
+    out.rr[i] = cos;
+    out.rx[i] = sinc * wx;
+    out.ry[i] = sinc * wy;
+    out.rz[i] = sinc * wz;
+    out.dr[i] = -sinc * (wx * vx + wy * vy + wz * vz);
+    out.dx[i] = sinc * vx + wvc * wx;
+    out.dy[i] = sinc * vy + wvc * wy;
+    out.dz[i] = sinc * vz + wvc * wz;
+  }
+}
+
+#ifdef RBT_AVX_KERNEL
+
+static_assert(std::is_same<Real, float>::value, "The AVX kernels process 8 single precision poses at a time");
+
+// a . b for 3 vectors of lanes.
+__attribute__((target("avx"))) __m256 dot(__m256 ax, __m256 ay, __m256 az, __m256 bx, __m256 by, __m256 bz) {
+  return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax, bx), _mm256_mul_ps(ay, by)), _mm256_mul_ps(az, bz));
+}
+
+// p * conjugate(q) for the vectors of lanes, as in twistKernel.
+__attribute__((target("avx"))) void multiplyConjugate(
+  const __m256* p,
+  const __m256* q,
+  __m256* out
+) {
+  out[0] = _mm256_add_ps(_mm256_mul_ps(p[0], q[0]), dot(p[1], p[2], p[3], q[1], q[2], q[3]));
+  out[1] = _mm256_sub_ps(_mm256_sub_ps(_mm256_mul_ps(q[0], p[1]), _mm256_mul_ps(p[0], q[1])),
+    _mm256_sub_ps(_mm256_mul_ps(p[2], q[3]), _mm256_mul_ps(p[3], q[2])));
+  out[2] = _mm256_sub_ps(_mm256_sub_ps(_mm256_mul_ps(q[0], p[2]), _mm256_mul_ps(p[0], q[2])),
+    _mm256_sub_ps(_mm256_mul_ps(p[3], q[1]), _mm256_mul_ps(p[1], q[3])));
+  out[3] = _mm256_sub_ps(_mm256_sub_ps(_mm256_mul_ps(q[0], p[3]), _mm256_mul_ps(p[0], q[3])),
+    _mm256_sub_ps(_mm256_mul_ps(p[1], q[2]), _mm256_mul_ps(p[2], q[1])));
+}
+
+// As twistKernel, 8 twists at a time.
+__attribute__((target("avx"))) void avxTwistKernel(const PoseArrays& from, const Poses& to, Twists& out) {
+  const auto one = _mm256_set1_ps(1), two = _mm256_set1_ps(2), zero = _mm256_setzero_ps();
+  const auto signs = _mm256_set1_ps(-0.f);
+
+  std::size_t i = 0;
+  for(; i + 8 <= to.size(); i += 8) {
+    __m256 f[8], t[4], s[4];
+    for(std::size_t c = 0; c < 8; ++c) {
+      f[c] = (from.step == 0) ? _mm256_set1_ps(from.c[c][0]) : _mm256_loadu_ps(from.c[c] + i);
+    }
+    t[0] = _mm256_loadu_ps(&to.rr[i]); t[1] = _mm256_loadu_ps(&to.rx[i]);
+    t[2] = _mm256_loadu_ps(&to.ry[i]); t[3] = _mm256_loadu_ps(&to.rz[i]);
+    s[0] = _mm256_loadu_ps(&to.dr[i]); s[1] = _mm256_loadu_ps(&to.dx[i]);
+    s[2] = _mm256_loadu_ps(&to.dy[i]); s[3] = _mm256_loadu_ps(&to.dz[i]);
+
+    __m256 m[4], n[4], e[4];
+    multiplyConjugate(t, f, m);
+    multiplyConjugate(t, f + 4, n);
+    multiplyConjugate(s, f, e);
+
+    // The shorter way around: flip the sign bits of the lanes with a negative real part
+    const auto flip = _mm256_and_ps(_mm256_cmp_ps(m[0], zero, _CMP_LT_OQ), signs);
+    for(std::size_t c = 0; c < 4; ++c) {
+      m[c] = _mm256_xor_ps(m[c], flip);
+      n[c] = _mm256_xor_ps(_mm256_add_ps(n[c], e[c]), flip);
+    }
+
+    const auto sin = _mm256_sqrt_ps(dot(m[1], m[2], m[3], m[1], m[2], m[3]));
+    const auto x = simd::atan2_positive(sin, m[0]);
+    const auto tiny = _mm256_cmp_ps(sin, _mm256_set1_ps(TINY_ANGLE), _CMP_GT_OQ);
+    const auto k = _mm256_blendv_ps(
+      _mm256_add_ps(one, _mm256_div_ps(_mm256_mul_ps(sin, sin), _mm256_set1_ps(6))),
+      _mm256_div_ps(x, sin),
+      tiny
+    );
+    const auto c = simd::cos_minus_sinc(x, m[0], _mm256_div_ps(one, k));
+
+    const auto wx = _mm256_mul_ps(k, m[1]), wy = _mm256_mul_ps(k, m[2]), wz = _mm256_mul_ps(k, m[3]);
+    const auto wvc = _mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(zero, k), n[0]), c);
+
+    _mm256_storeu_ps(&out.wx[i], _mm256_mul_ps(two, wx));
+    _mm256_storeu_ps(&out.wy[i], _mm256_mul_ps(two, wy));
+    _mm256_storeu_ps(&out.wz[i], _mm256_mul_ps(two, wz));
+    _mm256_storeu_ps(&out.vx[i], _mm256_mul_ps(two, _mm256_mul_ps(k, _mm256_sub_ps(n[1], _mm256_mul_ps(wvc, wx)))));
+    _mm256_storeu_ps(&out.vy[i], _mm256_mul_ps(two, _mm256_mul_ps(k, _mm256_sub_ps(n[2], _mm256_mul_ps(wvc, wy)))));
+    _mm256_storeu_ps(&out.vz[i], _mm256_mul_ps(two, _mm256_mul_ps(k, _mm256_sub_ps(n[3], _mm256_mul_ps(wvc, wz)))));
+  }
+
+  twistKernel(from, to, out, i, to.size());
+}
+
+// As displacementKernel, 8 poses at a time.
+__attribute__((target("avx"))) void avxDisplacementKernel(const Twists& twists, Poses& out) {
+  const auto half = _mm256_set1_ps(0.5f), one = _mm256_set1_ps(1), zero = _mm256_setzero_ps();
+
+  std::size_t i = 0;
+  for(; i + 8 <= twists.size(); i += 8) {
+    const auto wx = _mm256_mul_ps(half, _mm256_loadu_ps(&twists.wx[i]));
+    const auto wy = _mm256_mul_ps(half, _mm256_loadu_ps(&twists.wy[i]));
+    const auto wz = _mm256_mul_ps(half, _mm256_loadu_ps(&twists.wz[i]));
+    const auto vx = _mm256_mul_ps(half, _mm256_loadu_ps(&twists.vx[i]));
+    const auto vy = _mm256_mul_ps(half, _mm256_loadu_ps(&twists.vy[i]));
+    const auto vz = _mm256_mul_ps(half, _mm256_loadu_ps(&twists.vz[i]));
+
+    const auto x = _mm256_sqrt_ps(dot(wx, wy, wz, wx, wy, wz));
+    __m256 sin, cos;
+    simd::sin_cos_minus_one(x, sin, cos);
+    cos = _mm256_add_ps(cos, one);
+    const auto sinc = _mm256_blendv_ps(
+      _mm256_sub_ps(one, _mm256_div_ps(_mm256_mul_ps(x, x), _mm256_set1_ps(6))),
+      _mm256_div_ps(sin, x),
+      _mm256_cmp_ps(x, _mm256_set1_ps(TINY_ANGLE), _CMP_GT_OQ)
+    );
+    const auto wv = dot(wx, wy, wz, vx, vy, vz);
+    const auto wvc = _mm256_mul_ps(wv, simd::cos_minus_sinc(x, cos, sinc));
+
+    _mm256_storeu_ps(&out.rr[i], cos);
+    _mm256_storeu_ps(&out.rx[i], _mm256_mul_ps(sinc, wx));
+    _mm256_storeu_ps(&out.ry[i], _mm256_mul_ps(sinc, wy));
+    _mm256_storeu_ps(&out.rz[i], _mm256_mul_ps(sinc, wz));
+    _mm256_storeu_ps(&out.dr[i], _mm256_mul_ps(_mm256_sub_ps(zero, sinc), wv));
+    _mm256_storeu_ps(&out.dx[i], _mm256_add_ps(_mm256_mul_ps(sinc, vx), _mm256_mul_ps(wvc, wx)));
+    _mm256_storeu_ps(&out.dy[i], _mm256_add_ps(_mm256_mul_ps(sinc, vy), _mm256_mul_ps(wvc, wy)));
+    _mm256_storeu_ps(&out.dz[i], _mm256_add_ps(_mm256_mul_ps(sinc, vz), _mm256_mul_ps(wvc, wz)));
+  }
+
+  displacementKernel(twists, out, i, twists.size());
+}
+
+#endif
+
+void twists(const PoseArrays& from, const Poses& to, Twists& out) {
+  out.resize(to.size());
+
+#ifdef RBT_AVX_KERNEL
+  if(simd::avx()) return avxTwistKernel(from, to, out);
+#endif
+
+  twistKernel(from, to, out, 0, to.size());
+}
+
+}
+
+Dual<Quaternion> displacement(const Twist& twist) {
+  return exp(Dual<Quaternion>(Quaternion(0, Real(0.5) * twist.angular), Quaternion(0, Real(0.5) * twist.linear)));
+}
+
+Twist twist(const Dual<Quaternion>& from, const Dual<Quaternion>& to) {
+  const auto l = log(to * inverse(from));
+  return Twist{
+    Vector3({ 2 * l.r.x, 2 * l.r.y, 2 * l.r.z }),
+    Vector3({ 2 * l.d.x, 2 * l.d.y, 2 * l.d.z })
+  };
+}
+
+void Poses::resize(std::size_t size) {
+  for(auto component : { &this->rr, &this->rx, &this->ry, &this->rz, &this->dr, &this->dx, &this->dy, &this->dz }) {
+    component->resize(size);
+  }
+}
+
+Dual<Quaternion> Poses::operator[](std::size_t i) const {
+  return Dual<Quaternion>(
+    Quaternion(this->rr[i], this->rx[i], this->ry[i], this->rz[i]),
+    Quaternion(this->dr[i], this->dx[i], this->dy[i], this->dz[i])
+  );
+}
+
+void Poses::set(std::size_t i, const Dual<Quaternion>& pose) {
+  this->rr[i] = pose.r.r; this->rx[i] = pose.r.x; this->ry[i] = pose.r.y; this->rz[i] = pose.r.z;
+  this->dr[i] = pose.d.r; this->dx[i] = pose.d.x; this->dy[i] = pose.d.y; this->dz[i] = pose.d.z;
+}
+
+void Poses::push_back(const Dual<Quaternion>& pose) {
+  this->resize(this->size() + 1);
+  this->set(this->size() - 1, pose);
+}
+
+void Twists::resize(std::size_t size) {
+  for(auto component : { &this->wx, &this->wy, &this->wz, &this->vx, &this->vy, &this->vz }) {
+    component->resize(size);
+  }
+}
+
+Twist Twists::operator[](std::size_t i) const {
+  return Twist{
+    Vector3({ this->wx[i], this->wy[i], this->wz[i] }),
+    Vector3({ this->vx[i], this->vy[i], this->vz[i] })
+  };
+}
+
+void Twists::set(std::size_t i, const Twist& twist) {
+  this->wx[i] = twist.angular[0]; this->wy[i] = twist.angular[1]; this->wz[i] = twist.angular[2];
+  this->vx[i] = twist.linear[0]; this->vy[i] = twist.linear[1]; this->vz[i] = twist.linear[2];
+}
+
+void twists(const Dual<Quaternion>& from, const Poses& to, Twists& out) {
+  const Real components[8] = { from.r.r, from.r.x, from.r.y, from.r.z, from.d.r, from.d.x, from.d.y, from.d.z };
+  PoseArrays repeated;
+  for(std::size_t c = 0; c < 8; ++c) repeated.c[c] = &components[c];
+  repeated.step = 0;
+
+  twists(repeated, to, out);
+}
+
+void twists(const Poses& from, const Poses& to, Twists& out) {
+  assert_msg(from.size() == to.size(), "There must be a pose to start from for each target");
+  twists(arrays(from), to, out);
+}
+
+void displacements(const Twists& twists, Poses& out) {
+  out.resize(twists.size());
+
+#ifdef RBT_AVX_KERNEL
+  if(simd::avx()) return avxDisplacementKernel(twists, out);
+#endif
+
+  displacementKernel(twists, out, 0, twists.size());
+}
+
+}
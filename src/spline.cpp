@@ -0,0 +1,431 @@
+#include "spline.hpp"
+#include "utilities.hpp"
+#include "utils/simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+namespace rbt {
+
+namespace {
+
+// Values per AVX register
+const std::size_t LANES = 8;
+
+// Throws std::invalid_argument unless there are at least 2 waypoints, each with a finite angle for each joint, at
+// finite, increasing times.
+void check(const AngleSets& waypoints, const std::vector<Real>& times) {
+  if(waypoints.size() < 2) throw std::invalid_argument("A spline needs at least 2 waypoints");
+  if(times.size() != waypoints.size()) throw std::invalid_argument("There must be a time for each waypoint");
+
+  for(std::size_t i = 0; i < waypoints.size(); ++i) {
+    if(waypoints[i].size() != waypoints[0].size()) {
+      throw std::invalid_argument("Each waypoint must have an angle for each joint");
+    }
+    for(const auto angle : waypoints[i]) {
+      if(!std::isfinite(angle)) throw std::invalid_argument("Waypoint angles must be finite");
+    }
+    if(!std::isfinite(times[i]) || (i > 0 && !(times[i] > times[i - 1]))) {
+      throw std::invalid_argument("Waypoint times must be finite and increasing");
+    }
+  }
+}
+
+// Angles (or their rates) of waypoint-major sets, in double precision: joint j of waypoint i at i * joints + j.
+std::vector<double> flatten(const AngleSets& sets, std::size_t joints) {
+  std::vector<double> values;
+  values.reserve(sets.size() * joints);
+  for(const auto& set : sets) {
+    if(set.size() != joints) throw std::invalid_argument("Each waypoint must have a rate for each joint");
+    values.insert(values.end(), set.begin(), set.end());
+  }
+  return values;
+}
+
+// The velocities (waypoint-major) of the cubic spline: at rest at the ends, with equal accelerations either side of
+// the waypoints between. With the pieces before and after waypoint i taking g and h and changing the angle by c and d,
+// (2 / g) v(i - 1) + 4 (1 / g + 1 / h) v(i) + (2 / h) v(i + 1) = 6 c / g^2 + 6 d / h^2. The system is tridiagonal
+// and diagonally dominant, so it's solved by the Thomas algorithm, eliminating once for all the joints.
+std::vector<double> cubicVelocities(const AngleSets& waypoints, const std::vector<double>& times) {
+  const auto n = waypoints.size(), joints = waypoints[0].size();
+  std::vector<double> velocities(n * joints, 0);
+
+  // The diagonal after elimination, and the multiple of the row before subtracted from each row
+  std::vector<double> diagonal(n, 0), multiples(n, 0);
+  for(std::size_t i = 1; i + 1 < n; ++i) {
+    const auto g = times[i] - times[i - 1], h = times[i + 1] - times[i];
+    diagonal[i] = 4 * (1 / g + 1 / h);
+    if(i > 1) {
+      multiples[i] = (2 / g) / diagonal[i - 1];
+      diagonal[i] -= multiples[i] * (2 / g);
+    }
+  }
+
+  std::vector<double> right(n, 0);
+  for(std::size_t j = 0; j < joints; ++j) {
+    for(std::size_t i = 1; i + 1 < n; ++i) {
+      const auto g = times[i] - times[i - 1], h = times[i + 1] - times[i];
+      const auto c = double(waypoints[i][j]) - waypoints[i - 1][j], d = double(waypoints[i + 1][j]) - waypoints[i][j];
+      right[i] = 6 * c / (g * g) + 6 * d / (h * h) - multiples[i] * right[i - 1];
+    }
+    for(auto i = n - 2; i > 0; --i) {
+      const auto h = times[i + 1] - times[i];
+      velocities[i * joints + j] = (right[i] - (2 / h) * velocities[(i + 1) * joints + j]) / diagonal[i];
+    }
+  }
+
+  return velocities;
+}
+
+// The accelerations (waypoint-major) of the cubic spline with the velocities: at the start of each piece, and at the
+// end of the last.
+std::vector<double> cubicAccelerations(
+  const AngleSets& waypoints,
+  const std::vector<double>& velocities,
+  const std::vector<double>& times
+) {
+  const auto n = waypoints.size(), joints = waypoints[0].size();
+  std::vector<double> accelerations(n * joints);
+
+  for(std::size_t i = 0; i + 1 < n; ++i) {
+    const auto h = times[i + 1] - times[i];
+    for(std::size_t j = 0; j < joints; ++j) {
+      const auto d = double(waypoints[i + 1][j]) - waypoints[i][j];
+      const auto v0 = velocities[i * joints + j], v1 = velocities[(i + 1) * joints + j];
+      accelerations[i * joints + j] = 6 * d / (h * h) - (4 * v0 + 2 * v1) / h;
+      if(i + 2 == n) accelerations[(i + 1) * joints + j] = -6 * d / (h * h) + (2 * v0 + 4 * v1) / h;
+    }
+  }
+
+  return accelerations;
+}
+
+// A 2 x 2 matrix [[a, b], [c, d]], or with a 2 vector (x, y), for the quintic spline's block tridiagonal system.
+struct Block {
+  double a, b, c, d;
+};
+struct Pair {
+  double x, y;
+};
+
+Block product(const Block& p, const Block& q) {
+  return Block{ p.a * q.a + p.b * q.c, p.a * q.b + p.b * q.d, p.c * q.a + p.d * q.c, p.c * q.b + p.d * q.d };
+}
+
+Pair product(const Block& p, const Pair& v) {
+  return Pair{ p.a * v.x + p.b * v.y, p.c * v.x + p.d * v.y };
+}
+
+Block inverse(const Block& p) {
+  const auto determinant = p.a * p.d - p.b * p.c;
+  return Block{ p.d / determinant, -p.b / determinant, -p.c / determinant, p.a / determinant };
+}
+
+// How the jerk (first row) and its rate (second) differ across waypoint i of the quintic spline with the velocity and
+// acceleration at the waypoint before (before), at it (at) and after (after), for pieces of g and h either side.
+// From the quintic Hermite polynomials of the pieces; the difference is zero where they're continuous.
+Block before(double g) {
+  return Block{ -24 / (g * g), -3 / g, -168 / (g * g * g), -24 / (g * g) };
+}
+
+Block at(double g, double h) {
+  return Block{ 36 / (h * h) - 36 / (g * g), 9 / g + 9 / h, -192 / (g * g * g) - 192 / (h * h * h),
+    36 / (g * g) - 36 / (h * h) };
+}
+
+Block after(double h) {
+  return Block{ 24 / (h * h), -3 / h, -168 / (h * h * h), 24 / (h * h) };
+}
+
+// The velocities and accelerations (waypoint-major) of the quintic spline: at rest with no acceleration at the ends,
+// and with continuous jerks and rates of jerk at the waypoints between. The system is block tridiagonal, so it's
+// solved by the block Thomas algorithm, eliminating once for all the joints.
+void quinticRates(
+  const AngleSets& waypoints,
+  const std::vector<double>& times,
+  std::vector<double>& velocities,
+  std::vector<double>& accelerations
+) {
+  const auto n = waypoints.size(), joints = waypoints[0].size();
+  velocities.assign(n * joints, 0);
+  accelerations.assign(n * joints, 0);
+
+  // The inverse of the diagonal block after elimination, and the multiple of the row before subtracted from each row
+  std::vector<Block> diagonals(n), multiples(n);
+  for(std::size_t i = 1; i + 1 < n; ++i) {
+    const auto g = times[i] - times[i - 1], h = times[i + 1] - times[i];
+    auto diagonal = at(g, h);
+    if(i > 1) {
+      multiples[i] = product(before(g), diagonals[i - 1]);
+      const auto eliminated = product(multiples[i], after(g));
+      diagonal = Block{ diagonal.a - eliminated.a, diagonal.b - eliminated.b, diagonal.c - eliminated.c,
+        diagonal.d - eliminated.d };
+    }
+    diagonals[i] = inverse(diagonal);
+  }
+
+  std::vector<Pair> right(n, Pair{ 0, 0 });
+  for(std::size_t j = 0; j < joints; ++j) {
+    for(std::size_t i = 1; i + 1 < n; ++i) {
+      const auto g = times[i] - times[i - 1], h = times[i + 1] - times[i];
+      const auto c = double(waypoints[i][j]) - waypoints[i - 1][j], d = double(waypoints[i + 1][j]) - waypoints[i][j];
+      const auto eliminated = product(multiples[i], right[i - 1]);
+      right[i] = Pair{ 60 * d / (h * h * h) - 60 * c / (g * g * g) - eliminated.x,
+        -360 * c / (g * g * g * g) - 360 * d / (h * h * h * h) - eliminated.y };
+    }
+    for(auto i = n - 2; i > 0; --i) {
+      const auto h = times[i + 1] - times[i];
+      const auto k = (i + 1) * joints + j;
+      const auto next = product(after(h), Pair{ velocities[k], accelerations[k] });
+      const auto rates = product(diagonals[i], Pair{ right[i].x - next.x, right[i].y - next.y });
+      velocities[i * joints + j] = rates.x;
+      accelerations[i * joints + j] = rates.y;
+    }
+  }
+}
+
+std::vector<double> seconds(const std::vector<Real>& times) {
+  return std::vector<double>(times.begin(), times.end());
+}
+
+// The piece of the spline at a time, trying the piece of the time before (and the one after it) first.
+std::size_t piece(const std::vector<Real>& knots, Real time, std::size_t hint) {
+  const auto last = knots.size() - 2;
+  for(auto i = hint; i <= std::min(hint + 1, last); ++i) {
+    if(knots[i] <= time && (i == last || time < knots[i + 1])) return i;
+  }
+  return std::size_t(std::upper_bound(knots.begin() + 1, knots.end() - 1, time) - (knots.begin() + 1));
+}
+
+// Samples found along the pieces (by locate) and where the kernels write the states of the joints at them
+// (skipping null outputs).
+struct Samples {
+  // The first coefficient of each sample's piece, and the time into it
+  const std::size_t* offsets;
+  const Real* times;
+  std::size_t count;
+  Real* positions;
+  Real* velocities;
+  Real* accelerations;
+};
+
+// Samples evaluated together: the kernels' loops stay free of the searches (and, for AVX, of calls to code
+// without it).
+const std::size_t CHUNK = 64;
+
+// Set the offsets and times of Samples for count times, searching from the piece at hint. Returns the piece of the
+// last time.
+std::size_t locate(
+  const std::vector<Real>& knots,
+  std::size_t lanes,
+  const Real* times,
+  std::size_t count,
+  std::size_t hint,
+  std::size_t* offsets,
+  Real* into
+) {
+  for(std::size_t i = 0; i < count; ++i) {
+    hint = piece(knots, times[i], hint);
+    offsets[i] = hint * JointSpline::ORDER * lanes;
+    into[i] = std::min(std::max(times[i], knots.front()), knots.back()) - knots[hint];
+  }
+  return hint;
+}
+
+void kernel(const Real* coefficients, std::size_t joints, std::size_t lanes, const Samples& samples) {
+  for(std::size_t i = 0; i < samples.count; ++i) {
+    const auto t = samples.times[i];
+    const auto c = coefficients + samples.offsets[i];
+
+    for(std::size_t j = 0; j < joints; ++j) {
+      const auto c0 = c[j], c1 = c[lanes + j], c2 = c[2 * lanes + j];
+      const auto c3 = c[3 * lanes + j], c4 = c[4 * lanes + j], c5 = c[5 * lanes + j];
+
+      if(samples.positions) {
+        samples.positions[i * joints + j] = c0 + t * (c1 + t * (c2 + t * (c3 + t * (c4 + t * c5))));
+      }
+      if(samples.velocities) {
+        samples.velocities[i * joints + j] = c1 + t * (2 * c2 + t * (3 * c3 + t * (4 * c4 + t * (5 * c5))));
+      }
+      if(samples.accelerations) {
+        samples.accelerations[i * joints + j] = 2 * c2 + t * (6 * c3 + t * (12 * c4 + t * (20 * c5)));
+      }
+    }
+  }
+}
+
+#ifdef RBT_AVX_KERNEL
+
+static_assert(std::is_same<Real, float>::value, "The AVX kernel evaluates 8 single precision joints at a time");
+
+// Store the lanes of value for the joints from out on: all of them unless the joints end within them.
+__attribute__((target("avx"))) void store(Real* out, __m256 value, std::size_t joints) {
+  if(joints >= LANES) return _mm256_storeu_ps(out, value);
+
+  const auto mask = _mm256_cmp_ps(_mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_ps(Real(joints)), _CMP_LT_OQ);
+  _mm256_maskstore_ps(out, _mm256_castps_si256(mask), value);
+}
+
+// As kernel, 8 joints at a time.
+__attribute__((target("avx"))) void avxKernel(
+  const Real* coefficients,
+  std::size_t joints,
+  std::size_t lanes,
+  const Samples& samples
+) {
+  const auto two = _mm256_set1_ps(2), three = _mm256_set1_ps(3), four = _mm256_set1_ps(4);
+  const auto five = _mm256_set1_ps(5), six = _mm256_set1_ps(6), twelve = _mm256_set1_ps(12);
+  const auto twenty = _mm256_set1_ps(20);
+
+  for(std::size_t i = 0; i < samples.count; ++i) {
+    const auto t = _mm256_set1_ps(samples.times[i]);
+    const auto c = coefficients + samples.offsets[i];
+
+    for(std::size_t j = 0; j < lanes; j += LANES) {
+      const auto left = joints - j;
+      const auto c0 = _mm256_loadu_ps(c + j), c1 = _mm256_loadu_ps(c + lanes + j);
+      const auto c2 = _mm256_loadu_ps(c + 2 * lanes + j), c3 = _mm256_loadu_ps(c + 3 * lanes + j);
+      const auto c4 = _mm256_loadu_ps(c + 4 * lanes + j), c5 = _mm256_loadu_ps(c + 5 * lanes + j);
+
+      if(samples.positions) {
+        auto p = _mm256_add_ps(c4, _mm256_mul_ps(t, c5));
+        p = _mm256_add_ps(c3, _mm256_mul_ps(t, p));
+        p = _mm256_add_ps(c2, _mm256_mul_ps(t, p));
+        p = _mm256_add_ps(c1, _mm256_mul_ps(t, p));
+        p = _mm256_add_ps(c0, _mm256_mul_ps(t, p));
+        store(samples.positions + i * joints + j, p, left);
+      }
+      if(samples.velocities) {
+        auto v = _mm256_add_ps(_mm256_mul_ps(four, c4), _mm256_mul_ps(t, _mm256_mul_ps(five, c5)));
+        v = _mm256_add_ps(_mm256_mul_ps(three, c3), _mm256_mul_ps(t, v));
+        v = _mm256_add_ps(_mm256_mul_ps(two, c2), _mm256_mul_ps(t, v));
+        v = _mm256_add_ps(c1, _mm256_mul_ps(t, v));
+        store(samples.velocities + i * joints + j, v, left);
+      }
+      if(samples.accelerations) {
+        auto a = _mm256_add_ps(_mm256_mul_ps(twelve, c4), _mm256_mul_ps(t, _mm256_mul_ps(twenty, c5)));
+        a = _mm256_add_ps(_mm256_mul_ps(six, c3), _mm256_mul_ps(t, a));
+        a = _mm256_add_ps(_mm256_mul_ps(two, c2), _mm256_mul_ps(t, a));
+        store(samples.accelerations + i * joints + j, a, left);
+      }
+    }
+  }
+}
+
+#endif
+
+}
+
+JointSpline::JointSpline(
+  const AngleSets& waypoints,
+  const std::vector<double>& velocities,
+  const std::vector<double>& accelerations,
+  const std::vector<Real>& times
+) : count(waypoints[0].size()), lanes((waypoints[0].size() + LANES - 1) / LANES * LANES), knots(times),
+    coefficients((times.size() - 1) * ORDER * lanes, 0) {
+  for(std::size_t i = 0; i + 1 < waypoints.size(); ++i) {
+    const auto h = double(times[i + 1]) - times[i];
+    const auto c = &this->coefficients[i * ORDER * this->lanes];
+
+    for(std::size_t j = 0; j < this->count; ++j) {
+      const double p0 = waypoints[i][j], p1 = waypoints[i + 1][j];
+      const auto v0 = velocities[i * this->count + j], v1 = velocities[(i + 1) * this->count + j];
+      const auto a0 = accelerations[i * this->count + j], a1 = accelerations[(i + 1) * this->count + j];
+
+      // The quintic through p0 and p1 with these rates, in the fraction u of the piece: p0 + h v0 u + h^2 a0 u^2 / 2
+      // + e3 u^3 + e4 u^4 + e5 u^5, where the last three make up the differences at the end
+      const auto position = p1 - p0 - h * v0 - h * h * a0 / 2, velocity = h * (v1 - v0) - h * h * a0;
+      const auto acceleration = h * h * (a1 - a0);
+      c[j] = Real(p0);
+      c[this->lanes + j] = Real(v0);
+      c[2 * this->lanes + j] = Real(a0 / 2);
+      c[3 * this->lanes + j] = Real((10 * position - 4 * velocity + acceleration / 2) / (h * h * h));
+      c[4 * this->lanes + j] = Real((-15 * position + 7 * velocity - acceleration) / (h * h * h * h));
+      c[5 * this->lanes + j] = Real((6 * position - 3 * velocity + acceleration / 2) / (h * h * h * h * h));
+    }
+  }
+}
+
+JointSpline JointSpline::cubic(const AngleSets& waypoints, const std::vector<Real>& times) {
+  check(waypoints, times);
+
+  const auto t = seconds(times);
+  const auto velocities = cubicVelocities(waypoints, t);
+  return JointSpline(waypoints, velocities, cubicAccelerations(waypoints, velocities, t), times);
+}
+
+JointSpline JointSpline::quintic(const AngleSets& waypoints, const std::vector<Real>& times) {
+  check(waypoints, times);
+
+  std::vector<double> velocities, accelerations;
+  quinticRates(waypoints, seconds(times), velocities, accelerations);
+  return JointSpline(waypoints, velocities, accelerations, times);
+}
+
+JointSpline JointSpline::hermite(
+  const AngleSets& waypoints,
+  const AngleSets& velocities,
+  const AngleSets& accelerations,
+  const std::vector<Real>& times
+) {
+  check(waypoints, times);
+  if(velocities.size() != waypoints.size() || accelerations.size() != waypoints.size()) {
+    throw std::invalid_argument("There must be a velocity and an acceleration for each waypoint");
+  }
+
+  const auto joints = waypoints[0].size();
+  return JointSpline(waypoints, flatten(velocities, joints), flatten(accelerations, joints), times);
+}
+
+Angles JointSpline::operator()(Real time) const {
+  std::size_t offset;
+  Real into;
+  locate(this->knots, this->lanes, &time, 1, 0, &offset, &into);
+
+  Angles angles(this->count);
+  kernel(this->coefficients.data(), this->count, this->lanes,
+    Samples{ &offset, &into, 1, angles.data(), nullptr, nullptr });
+  return angles;
+}
+
+void JointSpline::evaluate(const Real* times, std::size_t count, Real* positions, Real* velocities,
+  Real* accelerations) const {
+#ifdef RBT_AVX_KERNEL
+  const auto avx = simd::avx();
+#endif
+
+  std::size_t offsets[CHUNK];
+  Real into[CHUNK];
+  std::size_t hint = 0;
+  for(std::size_t begin = 0; begin < count; begin += CHUNK) {
+    const auto size = std::min(CHUNK, count - begin);
+    hint = locate(this->knots, this->lanes, times + begin, size, hint, offsets, into);
+
+    const auto at = begin * this->count;
+    const auto samples = Samples{ offsets, into, size, positions ? positions + at : nullptr,
+      velocities ? velocities + at : nullptr, accelerations ? accelerations + at : nullptr };
+
+#ifdef RBT_AVX_KERNEL
+    if(avx) {
+      avxKernel(this->coefficients.data(), this->count, this->lanes, samples);
+      continue;
+    }
+#endif
+
+    kernel(this->coefficients.data(), this->count, this->lanes, samples);
+  }
+}
+
+void JointSpline::evaluate(const std::vector<Real>& times, AngleSets& positions) const {
+  std::vector<Real> values(times.size() * this->count);
+  this->evaluate(times.data(), times.size(), values.data());
+
+  positions.resize(times.size());
+  for(std::size_t i = 0; i < times.size(); ++i) {
+    positions[i].assign(values.begin() + i * this->count, values.begin() + (i + 1) * this->count);
+  }
+}
+
+}
@@ -0,0 +1,170 @@
+#include "timing.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace rbt {
+
+namespace {
+
+// Below this rate of change along the path a joint is taken to be still.
+const double STILL = 1e-12;
+const double UNLIMITED = std::numeric_limits<double>::infinity();
+
+// The path is parameterized by s, one per waypoint, and timed by x = (ds/dt)^2 and u = d^2s/dt^2 at each waypoint.
+// With constant u between waypoints x(i + 1) = x(i) + 2 u(i). Each joint's limits at waypoint i bound u to a band
+// slope * x +- offset (from |q'(s) u + q''(s) x| <= a), and x by (v / |q'(s)|)^2.
+class Constraints {
+public:
+  Constraints(const AngleSets& path, const std::vector<MotionLimits>& limits);
+
+  // The fastest x at waypoint i (no faster than bound(i)) from which x(i + 1) <= next is reachable.
+  double fastest(std::size_t i, double next) const;
+  // The largest u at waypoint i at x.
+  double hardest(std::size_t i, double x) const;
+  // The fastest x allowed at waypoint i.
+  inline double bound(std::size_t i) const { return this->bounds[i]; };
+
+private:
+  std::size_t joints;
+  // Of each joint at each waypoint (waypoint-major); the offset is infinite where the joint doesn't constrain u
+  std::vector<double> slopes, offsets;
+  std::vector<double> bounds;
+};
+
+Constraints::Constraints(const AngleSets& path, const std::vector<MotionLimits>& limits)
+  : joints(limits.size()), slopes(path.size() * limits.size()), offsets(path.size() * limits.size()),
+    bounds(path.size(), UNLIMITED) {
+  const auto last = path.size() - 1;
+
+  for(std::size_t i = 0; i < path.size(); ++i) {
+    const auto& previous = path[(i == 0) ? 0 : i - 1];
+    const auto& next = path[std::min(i + 1, last)];
+
+    for(std::size_t j = 0; j < this->joints; ++j) {
+      // Central differences, and one-sided at the ends (where the path is taken to be straight)
+      const double first = (double(next[j]) - previous[j]) / ((i == 0 || i == last) ? 1 : 2);
+      const double second = (i == 0 || i == last) ? 0 : (double(next[j]) - 2.0 * path[i][j] + previous[j]);
+      const double velocity = limits[j].velocity, acceleration = limits[j].acceleration;
+
+      auto& slope = this->slopes[i * this->joints + j];
+      auto& offset = this->offsets[i * this->joints + j];
+      slope = 0;
+      offset = UNLIMITED;
+
+      if(std::abs(first) > STILL) {
+        this->bounds[i] = std::min(this->bounds[i], (velocity / first) * (velocity / first));
+        slope = -second / first;
+        offset = acceleration / std::abs(first);
+      } else if(std::abs(second) > STILL) {
+        // Still, but turning: only x makes it accelerate
+        this->bounds[i] = std::min(this->bounds[i], acceleration / std::abs(second));
+      }
+    }
+  }
+}
+
+double Constraints::fastest(std::size_t i, double next) const {
+  // Eliminate u: every lower line must lie below every upper line, including the lines (0 - x) / 2 <= u and
+  // u <= (next - x) / 2 of x(i + 1) in [0, next]. Lines of equal slope (a joint's own band) never cross.
+  auto x = this->bounds[i];
+  const auto* slopes = &this->slopes[i * this->joints];
+  const auto* offsets = &this->offsets[i * this->joints];
+
+  for(std::size_t lower = 0; lower <= this->joints; ++lower) {
+    const bool reaching = lower == this->joints;
+    if(!reaching && std::isinf(offsets[lower])) continue;
+    const auto lowerSlope = reaching ? -0.5 : slopes[lower];
+    const auto lowerOffset = reaching ? 0.0 : -offsets[lower];
+
+    for(std::size_t upper = 0; upper <= this->joints; ++upper) {
+      const bool reached = upper == this->joints;
+      if(reached ? std::isinf(next) : std::isinf(offsets[upper])) continue;
+      const auto upperSlope = reached ? -0.5 : slopes[upper];
+      const auto upperOffset = reached ? 0.5 * next : offsets[upper];
+
+      // (lowerSlope - upperSlope) x <= upperOffset - lowerOffset
+      const auto rate = lowerSlope - upperSlope;
+      if(rate > 0) x = std::min(x, (upperOffset - lowerOffset) / rate);
+    }
+  }
+
+  return std::max(x, 0.0);
+}
+
+double Constraints::hardest(std::size_t i, double x) const {
+  auto u = UNLIMITED;
+  for(std::size_t j = 0; j < this->joints; ++j) {
+    const auto offset = this->offsets[i * this->joints + j];
+    if(!std::isinf(offset)) u = std::min(u, this->slopes[i * this->joints + j] * x + offset);
+  }
+  return u;
+}
+
+// The time from waypoint i to the next when starting and ending at rest there, where the constant acceleration of
+// the forward pass would never move: accelerating as hard as the limits at either end allow over the first half
+// (or until the speed limit) and braking over the second.
+double restToRest(const Constraints& constraints, std::size_t i) {
+  const auto u = std::min(constraints.hardest(i, 0), constraints.hardest(i + 1, 0));
+  if(std::isinf(u)) return 0;
+
+  const auto peak = std::min({ u, constraints.bound(i), constraints.bound(i + 1) });
+  return 2 * std::sqrt(peak) / u + (1 - peak / u) / std::sqrt(peak);
+}
+
+}
+
+std::vector<Real> timeOptimal(const AngleSets& path, const std::vector<MotionLimits>& limits) {
+  for(const auto& limit : limits) {
+    if(!(limit.velocity > 0) || !(limit.acceleration > 0)) {
+      throw std::invalid_argument("Joint velocity and acceleration limits must be positive");
+    }
+  }
+  for(const auto& angles : path) {
+    if(angles.size() != limits.size()) {
+      throw std::invalid_argument("Each waypoint must have an angle for each joint");
+    }
+    for(const auto angle : angles) {
+      if(!std::isfinite(angle)) throw std::invalid_argument("Waypoint angles must be finite");
+    }
+  }
+
+  if(path.size() < 2) return std::vector<Real>(path.size(), 0);
+
+  const auto constraints = Constraints(path, limits);
+  const auto last = path.size() - 1;
+
+  // Backward: the fastest x at each waypoint from which the end can still be reached at rest
+  std::vector<double> fastest(path.size());
+  fastest[last] = 0;
+  for(auto i = last; i-- > 0;) {
+    fastest[i] = constraints.fastest(i, fastest[i + 1]);
+  }
+
+  // Forward: from rest, as hard as the limits allow without leaving the reachable speeds
+  std::vector<Real> times(path.size());
+  times[0] = 0;
+  double x = 0, t = 0;
+  for(std::size_t i = 0; i < last; ++i) {
+    double next = fastest[i + 1];
+    if(!std::isinf(x)) {
+      const auto u = std::min(constraints.hardest(i, x), 0.5 * (fastest[i + 1] - x));
+      next = std::clamp(x + 2 * u, 0.0, fastest[i + 1]);
+    }
+
+    // Passing from one waypoint to the next (one apart in s) with constant acceleration
+    t += (x + next > 0) ? 2 / (std::sqrt(x) + std::sqrt(next)) : restToRest(constraints, i);
+    times[i + 1] = Real(t);
+    x = next;
+  }
+
+  return times;
+}
+
+std::vector<Real> timeOptimal(const AngleSets& path, const Serial& robot) {
+  return timeOptimal(path, robot.motionLimits());
+}
+
+}
@@ -0,0 +1,444 @@
+#include "trajectory.hpp"
+#include "utilities.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace rbt {
+
+namespace {
+
+typedef std::array<double, OnlineTrajectory::SEGMENTS> Segments;
+
+// Newton steps of a search, which stops earlier once within TOLERANCE (radians) of the target or WIDTH of the root.
+const std::size_t NEWTON_STEPS = 8;
+const double TOLERANCE = 1e-9;
+const double WIDTH = 1e-12;
+
+// Within these of the target (radians, rad/s and rad/s^2) a joint has arrived: finer motions are lost to rounding, so
+// (e.g. with a target moving by rounded steps) replanning them could go on forever.
+const double SETTLED_POSITION = 1e-6, SETTLED_VELOCITY = 1e-5, SETTLED_ACCELERATION = 1e-3;
+
+// Relative difference of a target position from where it was expected to move that is taken for rounding.
+const double ROUNDING = 4 * double(std::numeric_limits<Real>::epsilon());
+
+// Position, velocity and acceleration (of a joint relative to its target).
+struct Motion {
+  double position, velocity, acceleration;
+};
+
+// The limits of a joint relative to its target: the velocities it may move at and its largest acceleration and jerk,
+// and the reciprocals of the last two (so planning multiplies rather than divides).
+struct Bounds {
+  double slowest, fastest, acceleration, jerk;
+  double perAcceleration, perJerk;
+};
+
+// A velocity change: its direction, the acceleration it peaks at (in that direction), and its duration and distance.
+struct Change {
+  double direction, peak, duration, distance;
+};
+
+// A plan changing to a cruising velocity and from it to rest, without cruising: where it takes the joint and how long
+// its changes take.
+struct Reach {
+  double position, time;
+  Change first, second;
+};
+
+// A function's value and slope.
+struct Evaluation {
+  double value, slope;
+};
+
+// An interval about a root of a function, and its values at the ends (NaN until evaluated).
+struct Bracket {
+  double low, high, atLow, atHigh;
+
+  // Narrow the interval to x, where the value is at.
+  inline void narrow(double x, double at) {
+    if(x == this->low) this->atLow = at;
+    if(x == this->high) this->atHigh = at;
+    if(at < 0) {
+      this->low = x;
+      this->atLow = at;
+    } else {
+      this->high = x;
+      this->atHigh = at;
+    }
+  }
+};
+
+inline void advance(Motion& motion, double time, double jerk) {
+  motion.position += time * (motion.velocity + time * (motion.acceleration / 2 + time * jerk / 6));
+  motion.velocity += time * (motion.acceleration + time * jerk / 2);
+  motion.acceleration += time * jerk;
+}
+
+// The velocity gained ramping the acceleration from start to the limit and back to 0.
+inline double ramps(double start, const Bounds& bounds) {
+  const auto peak = bounds.acceleration;
+  return ((peak >= start) ? 2 * peak * peak - start * start : start * start) * bounds.perJerk / 2;
+}
+
+// The velocity at which a change from velocity and acceleration turns around: the velocity passes it even just
+// ramping the acceleration down.
+inline double turn(double velocity, double acceleration, const Bounds& bounds) {
+  return velocity + acceleration * std::abs(acceleration) * bounds.perJerk / 2;
+}
+
+// The fastest change from velocity from and acceleration acceleration to velocity to at rest, as 3 segments: jerk
+// towards a peak acceleration (at most the limit), holding it and jerk back to 0.
+Change change(double from, double acceleration, double to, const Bounds& bounds, double* durations, double* jerks) {
+  // Speeding up unless, even just ramping the acceleration down, the velocity passes to
+  const auto jerk = bounds.jerk;
+  const double direction = (to >= turn(from, acceleration, bounds)) ? 1 : -1;
+
+  // As if speeding up
+  const auto gain = direction * (to - from);
+  const auto start = direction * acceleration;
+
+  auto peak = bounds.acceleration;
+  auto hold = 0.0;
+  const auto needed = ramps(start, bounds);
+  if(needed <= gain) {
+    hold = (gain - needed) * bounds.perAcceleration;
+  } else {
+    // Never reaching the limit: (2 peak^2 - start^2) / (2 jerk) = gain
+    peak = std::sqrt(std::max(0.0, jerk * gain + start * start / 2));
+  }
+
+  const auto first = std::abs(peak - start) * bounds.perJerk, last = peak * bounds.perJerk;
+  durations[0] = first;
+  jerks[0] = direction * ((peak >= start) ? jerk : -jerk);
+  durations[1] = hold;
+  jerks[1] = 0;
+  durations[2] = last;
+  jerks[2] = -direction * jerk;
+
+  // The distance at velocity to for the duration, less the moment of the acceleration about the start
+  const auto duration = first + hold + last;
+  const auto moment = (first * first * (start + 2 * peak) + peak * last * (3 * (first + hold) + last)) * (1.0 / 6) +
+    peak * hold * (first + hold / 2);
+  return Change{ direction, peak, duration, to * duration - direction * moment };
+}
+
+// Changing to velocity and from it to rest, without cruising: sets the segments. Cruising for a time t at velocity
+// then takes the joint t * velocity further.
+Reach shape(const Motion& start, double velocity, const Bounds& bounds, Segments& durations, Segments& jerks) {
+  const auto first = change(start.velocity, start.acceleration, velocity, bounds, &durations[0], &jerks[0]);
+  durations[3] = 0;
+  jerks[3] = 0;
+  const auto second = change(velocity, 0, 0, bounds, &durations[4], &jerks[4]);
+  return Reach{ start.position + first.distance + second.distance, first.duration + second.duration, first, second };
+}
+
+// The rate at which the position reached grows with the cruising velocity, but for the first change's
+// direction * velocity / peak, which is infinite where it only just starts (bending like a square root).
+inline double rest(const Reach& reach, double velocity, const Bounds& bounds) {
+  const auto& second = reach.second;
+  return (reach.first.peak + second.peak) * bounds.perJerk / 2 + ((second.peak > 0) ? std::abs(velocity) / second.peak : 0);
+}
+
+// The rate at which the position reached grows with the cruising velocity.
+inline double slope(const Reach& reach, double velocity, const Bounds& bounds) {
+  const auto& first = reach.first;
+  return first.direction * velocity / first.peak + rest(reach, velocity, bounds);
+}
+
+inline double total(const Segments& durations) {
+  double sum = 0;
+  for(const auto duration : durations) sum += duration;
+  return sum;
+}
+
+// The velocities at which the form of a plan changes: where its first change turns around, where either change
+// starts holding the acceleration limit, and 0. Between them, the position reached is smooth in the velocity.
+std::array<double, 6> breaks(const Motion& start, const Bounds& bounds) {
+  const auto limit = bounds.acceleration * bounds.acceleration * bounds.perJerk;
+  std::array<double, 6> points = {
+    turn(start.velocity, start.acceleration, bounds),
+    start.velocity + ramps(start.acceleration, bounds), start.velocity - ramps(-start.acceleration, bounds),
+    -limit, 0, limit
+  };
+  std::sort(points.begin(), points.end());
+  return points;
+}
+
+// A root of f between below, where it's negative, and above, where it's positive, by Newton's method from their
+// secant, bisecting instead where a step would leave them. Stops within TOLERANCE of the root, WIDTH of it or after
+// NEWTON_STEPS evaluations, returning the last point evaluated and leaving below and above about the root.
+template <typename F>
+double newton(const F& f, double& below, double& above, double atBelow, double atAbove) {
+  auto x = below - atBelow * (above - below) / (atAbove - atBelow);
+  for(std::size_t i = 1;; ++i) {
+    if(!(std::min(below, above) < x && x < std::max(below, above))) x = (below + above) / 2;
+    const auto at = f(x);
+    if(std::abs(at.value) <= TOLERANCE || std::abs(above - below) <= WIDTH || i == NEWTON_STEPS) return x;
+
+    ((at.value < 0) ? below : above) = x;
+    x -= at.value / at.slope;
+  }
+}
+
+// The fastest plan onto the target: changing to the velocity where the position comes out on the target, without
+// cruising (the faster the velocity, the further the joint gets), or if there's none cruising at a limit on the way.
+// Returns the cruising velocity.
+double fastest(const Motion& start, const Bounds& bounds, double guess, Segments& durations, Segments& jerks) {
+  const auto position = [&](double velocity) { return shape(start, velocity, bounds, durations, jerks).position; };
+  // Making up for what the plan falls short by cruising
+  const auto makeUp = [&](double velocity) {
+    const auto reached = position(velocity);
+    durations[3] = (velocity != 0) ? std::max(0.0, -reached / velocity) : 0;
+    return velocity;
+  };
+
+  // From the last plan's velocity first: after following that plan (up to rounding) it's usually still the one, and
+  // after following a slower one a Newton step from it usually finds the new one
+  auto bracket = Bracket{ bounds.slowest, bounds.fastest, NAN, NAN };
+  if(guess >= bracket.low && guess <= bracket.high) {
+    const auto reach = shape(start, guess, bounds, durations, jerks);
+    if(std::abs(reach.position) <= TOLERANCE) return guess;
+    bracket.narrow(guess, reach.position);
+
+    const auto next = guess - reach.position / slope(reach, guess, bounds);
+    if(bracket.low < next && next < bracket.high) {
+      const auto at = position(next);
+      if(std::abs(at) <= TOLERANCE) return next;
+      bracket.narrow(next, at);
+    }
+  }
+
+  // Too far to get there without cruising (as usually after doing so in the last plan)
+  if(std::isnan(bracket.atHigh)) bracket.atHigh = position(bracket.high);
+  if(bracket.atHigh <= 0) return makeUp(bracket.high);
+  if(std::isnan(bracket.atLow)) bracket.atLow = position(bracket.low);
+  if(bracket.atLow >= 0) return makeUp(bracket.low);
+
+  // Narrow down to the piece between breaks the root is in
+  const auto points = breaks(start, bounds);
+  auto first = std::upper_bound(points.begin(), points.end(), bracket.low) - points.begin();
+  auto last = std::lower_bound(points.begin(), points.end(), bracket.high) - points.begin();
+  while(first < last) {
+    const auto middle = (first + last) / 2;
+    const auto at = position(points[middle]);
+    if(std::abs(at) <= TOLERANCE) return points[middle];
+
+    bracket.narrow(points[middle], at);
+    if(at < 0) {
+      first = middle + 1;
+    } else {
+      last = middle;
+    }
+  }
+
+  // Where the first change doesn't reach the acceleration limit, search its peak acceleration instead: the position
+  // reached is smooth in that, where in the velocity it bends like a square root as the change only just starts
+  const auto jerk = bounds.jerk;
+  const double direction = (bracket.low >= turn(start.velocity, start.acceleration, bounds)) ? 1 : -1;
+  const auto acceleration = direction * start.acceleration;
+  const bool peaking = (direction > 0) ? bracket.high <= start.velocity + ramps(acceleration, bounds) :
+    bracket.low >= start.velocity - ramps(acceleration, bounds);
+  const auto velocityAt = [&](double peak) {
+    return start.velocity + direction * (2 * peak * peak - acceleration * acceleration) * bounds.perJerk / 2;
+  };
+
+  double reached = NAN;
+  auto below = bracket.low, above = bracket.high;
+  if(peaking) {
+    const auto peakAt = [&](double velocity) {
+      return std::sqrt(std::max(0.0, jerk * direction * (velocity - start.velocity) + acceleration * acceleration / 2));
+    };
+    below = peakAt(below);
+    above = peakAt(above);
+
+    // dV/dpeak = 2 direction peak / jerk, cancelling the first change's bend
+    const auto root = newton([&](double peak) {
+      const auto velocity = velocityAt(peak);
+      const auto reach = shape(start, velocity, bounds, durations, jerks);
+      reached = reach.position;
+      return Evaluation{ reached, 2 * (velocity + direction * peak * rest(reach, velocity, bounds)) * bounds.perJerk };
+    }, below, above, bracket.atLow, bracket.atHigh);
+    if(std::abs(reached) <= TOLERANCE) return velocityAt(root);
+
+    below = velocityAt(below);
+    above = velocityAt(above);
+  } else {
+    const auto root = newton([&](double velocity) {
+      const auto reach = shape(start, velocity, bounds, durations, jerks);
+      reached = reach.position;
+      return Evaluation{ reached, slope(reach, velocity, bounds) };
+    }, below, above, bracket.atLow, bracket.atHigh);
+    if(std::abs(reached) <= TOLERANCE) return root;
+  }
+
+  // Out of steps: from the velocity falling short of the target, cruise the rest of the way
+  return makeUp((bracket.low + bracket.high > 0) ? below : above);
+}
+
+// A plan taking duration, cruising between 0 and velocity (that of the fastest plan, which takes fastest). Returns the
+// cruising velocity, or NaN if there's no such plan.
+double stretch(const Motion& start, double velocity, double fastest, double duration, const Bounds& bounds, double guess,
+  Segments& durations, Segments& jerks) {
+  // Cruising for the rest of the duration. While there's time left to, the position reached grows with the cruising
+  // velocity at the time left plus the changes' peak accelerations over twice the jerk, free of the first change's bend.
+  const auto reached = [&](double cruise) {
+    const auto reach = shape(start, cruise, bounds, durations, jerks);
+    const auto left = duration - reach.time;
+    durations[3] = std::max(0.0, left);
+    const auto slope = (left > 0) ? left + (reach.first.peak + reach.second.peak) * bounds.perJerk / 2 :
+      rbt::slope(reach, cruise, bounds);
+    return Evaluation{ reach.position + cruise * durations[3], slope };
+  };
+
+  // Cruising at the fastest plan's velocity for longer than it does overshoots the target by that times the time
+  auto bracket = Bracket{ std::min(0.0, velocity), std::max(0.0, velocity), NAN, NAN };
+  ((velocity < 0) ? bracket.atLow : bracket.atHigh) = velocity * (duration - fastest);
+
+  // From the last plan's velocity first, as in fastest
+  if(guess >= bracket.low && guess <= bracket.high) {
+    const auto at = reached(guess).value;
+    if(std::abs(at) <= TOLERANCE) return guess;
+    bracket.narrow(guess, at);
+  }
+
+  if(std::isnan(bracket.atLow)) bracket.atLow = reached(bracket.low).value;
+  if(std::isnan(bracket.atHigh)) bracket.atHigh = reached(bracket.high).value;
+  if(bracket.atLow > 0 || bracket.atHigh < 0) return NAN;
+
+  return newton(reached, bracket.low, bracket.high, bracket.atLow, bracket.atHigh);
+}
+
+}
+
+OnlineTrajectory::OnlineTrajectory(const Serial& robot, Real cycle) : period(cycle) {
+  const auto motion = robot.motionLimits();
+  if(motion.size() != TRAJECTORY_JOINTS) {
+    throw std::invalid_argument("The online trajectory generator drives robots of 6 joints");
+  }
+  if(!(cycle > 0)) throw std::invalid_argument("The cycle of the trajectory generator must be positive");
+
+  for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+    const auto& limit = motion[j];
+    for(const auto value : { limit.velocity, limit.acceleration, limit.jerk }) {
+      if(!(value > 0) || std::isinf(value)) {
+        throw std::invalid_argument("Joint velocity, acceleration and jerk limits must be positive and finite");
+      }
+    }
+    this->limits[j] = limit;
+  }
+
+  for(auto& plan : this->plans) plan = Plan{ 0, 0, 0, {}, {}, 0, 0, 0 };
+}
+
+bool OnlineTrajectory::update(const JointState& current, const JointTarget& target, JointState& next) {
+  const bool continuing = current.position == this->next.position && current.velocity == this->next.velocity &&
+    current.acceleration == this->next.acceleration;
+  this->synchronized = 0;
+
+  std::array<Bounds, TRAJECTORY_JOINTS> bounds;
+  bool settled = true;
+  for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+    assert_msg(std::abs(target.velocity[j]) < this->limits[j].velocity, "Target velocities must be within the limits");
+
+    // A target moved on by its velocity, but rounded, keeps moving precisely
+    const double moved = this->goal[j] + double(this->target.velocity[j]) * this->period;
+    const bool following = target.velocity[j] == this->target.velocity[j] &&
+      std::abs(target.position[j] - moved) <= ROUNDING * std::max(1.0, std::abs(moved));
+    this->goal[j] = following ? moved : target.position[j];
+
+    auto& plan = this->plans[j];
+    plan.position = (continuing ? this->precise.position[j] : current.position[j]) - this->goal[j];
+    plan.velocity = (continuing ? this->precise.velocity[j] : current.velocity[j]) - target.velocity[j];
+    plan.acceleration = continuing ? this->precise.acceleration[j] : current.acceleration[j];
+    settled = settled && std::abs(plan.position) <= SETTLED_POSITION && std::abs(plan.velocity) <= SETTLED_VELOCITY &&
+      std::abs(plan.acceleration) <= SETTLED_ACCELERATION;
+
+    const double velocity = this->limits[j].velocity;
+    const double acceleration = this->limits[j].acceleration, jerk = this->limits[j].jerk;
+    bounds[j] = Bounds{ -velocity - target.velocity[j], velocity - target.velocity[j], acceleration, jerk,
+      1 / acceleration, 1 / jerk };
+
+    const auto start = Motion{ plan.position, plan.velocity, plan.acceleration };
+    plan.fastest = fastest(start, bounds[j], plan.fastest, plan.durations, plan.jerks);
+    plan.duration = total(plan.durations);
+    this->synchronized = std::max(this->synchronized, plan.duration);
+  }
+
+  if(settled) {
+    for(auto& plan : this->plans) plan.duration = 0;
+    this->synchronized = 0;
+  }
+
+  this->target = target;
+
+  // Slow the others down to arrive with the slowest
+  for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+    auto& plan = this->plans[j];
+    if(plan.duration >= this->synchronized) {
+      plan.cruise = plan.fastest;
+      continue;
+    }
+
+    const auto start = Motion{ plan.position, plan.velocity, plan.acceleration };
+    auto durations = plan.durations, jerks = plan.jerks;
+    const auto cruise = stretch(start, plan.fastest, plan.duration, this->synchronized, bounds[j], plan.cruise, durations, jerks);
+    if(!std::isnan(cruise)) {
+      plan.durations = durations;
+      plan.jerks = jerks;
+      plan.duration = total(durations);
+      plan.cruise = cruise;
+    }
+  }
+
+  this->precise = this->sample(this->period);
+  for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+    next.position[j] = Real(this->precise.position[j]);
+    next.velocity[j] = Real(this->precise.velocity[j]);
+    next.acceleration[j] = Real(this->precise.acceleration[j]);
+  }
+  this->next = next;
+  return this->synchronized <= this->period;
+}
+
+OnlineTrajectory::PreciseState OnlineTrajectory::sample(double time) const {
+  PreciseState state;
+
+  for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+    const auto& plan = this->plans[j];
+
+    // On the target once there, exactly
+    auto motion = Motion{ 0, 0, 0 };
+    if(time < plan.duration) {
+      motion = Motion{ plan.position, plan.velocity, plan.acceleration };
+      double left = time;
+      for(std::size_t i = 0; i < SEGMENTS && left > 0; ++i) {
+        const auto step = std::min(left, plan.durations[i]);
+        advance(motion, step, plan.jerks[i]);
+        left -= step;
+      }
+    }
+
+    state.position[j] = motion.position + this->goal[j] + double(this->target.velocity[j]) * time;
+    state.velocity[j] = motion.velocity + this->target.velocity[j];
+    state.acceleration[j] = motion.acceleration;
+  }
+
+  return state;
+}
+
+JointState OnlineTrajectory::at(Real time) const {
+  const auto precise = this->sample(time);
+
+  JointState state;
+  for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+    state.position[j] = Real(precise.position[j]);
+    state.velocity[j] = Real(precise.velocity[j]);
+    state.acceleration[j] = Real(precise.acceleration[j]);
+  }
+  return state;
+}
+
+}
@@ -0,0 +1,316 @@
+#include "utils/capture.hpp"
+#include "serial.hpp"
+#include "spatial/dual.hpp"
+#include "spatial/quaternion.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rbt::capture {
+
+namespace {
+
+const char MAGIC[4] = { 'R', 'B', 'T', 'W' };
+// Bytes a thread encodes before writing them to the file
+constexpr std::size_t BATCH = 1 << 16;
+
+static_assert(sizeof(Real) == 4, "Captures store angles and poses as 32 bit floats");
+
+// The requests a thread has encoded but not yet written. Each record's robot id is filled in when written, from the
+// key of its robot.
+struct Buffer {
+  std::mutex lock;
+  std::string bytes;
+  std::vector<std::pair<std::size_t, uint64_t>> robots;
+};
+
+struct Recorder {
+  std::atomic<bool> active{false};
+  // Guards the buffers. Taken before a buffer's lock, which is taken before the lock of the file and ids.
+  std::mutex registry;
+  std::vector<std::unique_ptr<Buffer>> buffers;
+  std::vector<Buffer*> unused;
+
+  std::mutex lock;
+  std::ofstream file;
+  std::map<uint64_t, uint16_t> ids;
+  std::map<uint16_t, uint64_t> robots;
+
+  // The id of the robot with the key, giving it the next free id if it has none. Must be called holding the lock.
+  uint16_t id(uint64_t key) {
+    const auto found = this->ids.find(key);
+    if(found != this->ids.end()) return found->second;
+
+    uint16_t next = 0;
+    while(this->robots.count(next) != 0) ++next;
+    this->ids[key] = next;
+    this->robots[next] = key;
+    return next;
+  }
+
+  // Write out the buffer, holding its lock.
+  void flush(Buffer& buffer) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if(this->file.is_open()) {
+      for(const auto& [offset, key] : buffer.robots) {
+        const auto id = this->id(key);
+        buffer.bytes[offset + 2] = static_cast<char>(id & 0xff);
+        buffer.bytes[offset + 3] = static_cast<char>(id >> 8);
+      }
+      this->file.write(buffer.bytes.data(), static_cast<std::streamsize>(buffer.bytes.size()));
+    }
+    buffer.bytes.clear();
+    buffer.robots.clear();
+  }
+
+  // Write out every thread's buffer, holding the registry lock.
+  void drain() {
+    for(const auto& buffer : this->buffers) {
+      std::lock_guard<std::mutex> guard(buffer->lock);
+      this->flush(*buffer);
+    }
+  }
+};
+
+Recorder& recorder() {
+  static Recorder instance;
+  return instance;
+}
+
+// The buffer of this thread, written out and given back for another thread when it exits.
+struct Local {
+  Buffer* buffer = nullptr;
+
+  ~Local() {
+    if(this->buffer == nullptr) return;
+    auto& capture = recorder();
+    {
+      std::lock_guard<std::mutex> guard(this->buffer->lock);
+      capture.flush(*this->buffer);
+    }
+    std::lock_guard<std::mutex> guard(capture.registry);
+    capture.unused.push_back(this->buffer);
+  }
+};
+
+thread_local Local local;
+thread_local std::size_t suppressed = 0;
+
+Buffer& buffer() {
+  if(local.buffer != nullptr) return *local.buffer;
+
+  auto& capture = recorder();
+  std::lock_guard<std::mutex> guard(capture.registry);
+  if(capture.unused.empty()) {
+    capture.buffers.push_back(std::make_unique<Buffer>());
+    local.buffer = capture.buffers.back().get();
+  } else {
+    local.buffer = capture.unused.back();
+    capture.unused.pop_back();
+  }
+  return *local.buffer;
+}
+
+// Robots are told apart by their parameters (so copies of a robot share its id), hashed with 64 bit FNV-1a
+uint64_t key(const Serial& robot) {
+  uint64_t hash = 14695981039346656037ull;
+  const auto mix = [&hash](Real value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for(int i = 0; i < 4; ++i) hash = (hash ^ ((bits >> (8 * i)) & 0xff)) * 1099511628211ull;
+  };
+
+  for(const auto& joint : robot.joints()) {
+    for(const auto value : { joint.alpha, joint.a, joint.theta, joint.d, joint.limits[0], joint.limits[1],
+      joint.motion.velocity, joint.motion.acceleration, joint.motion.jerk }) {
+      mix(value);
+    }
+  }
+  return hash;
+}
+
+// Values are stored little-endian, whatever the byte order of the host
+template <typename T>
+void put(std::string& bytes, T value) {
+  static_assert(std::is_unsigned<T>::value, "Captures store unsigned integers and floats");
+  for(std::size_t i = 0; i < sizeof(T); ++i) bytes.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+void put(std::string& bytes, Real value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  put(bytes, bits);
+}
+
+template <typename T>
+T get(std::istream& in) {
+  static_assert(std::is_unsigned<T>::value, "Captures store unsigned integers and floats");
+  unsigned char bytes[sizeof(T)];
+  if(!in.read(reinterpret_cast<char*>(bytes), sizeof(T))) throw std::runtime_error("Truncated capture");
+
+  T value = 0;
+  for(std::size_t i = 0; i < sizeof(T); ++i) value = static_cast<T>(value | (T(bytes[i]) << (8 * i)));
+  return value;
+}
+
+template <>
+Real get<Real>(std::istream& in) {
+  const auto bits = get<uint32_t>(in);
+  Real value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void encode(std::string& bytes, Request::Kind kind, uint16_t robot, const Frame& frame, const Angles& angles) {
+  if(angles.size() > UINT8_MAX) throw std::invalid_argument("Too many angles to capture");
+
+  put(bytes, static_cast<uint8_t>(kind));
+  put(bytes, static_cast<uint8_t>(angles.size()));
+  put(bytes, robot);
+
+  if(kind == Request::Kind::INVERSE) {
+    const auto pose = frame.pose();
+    for(const auto& q : { pose.r, pose.d }) {
+      put(bytes, q.r); put(bytes, q.x); put(bytes, q.y); put(bytes, q.z);
+    }
+  }
+
+  for(const auto angle : angles) put(bytes, angle);
+}
+
+void encode(std::string& bytes, const Request& request) {
+  encode(bytes, request.kind, request.robot, request.pose, request.angles);
+}
+
+void write_header(std::ostream& out) {
+  std::string bytes(MAGIC, sizeof(MAGIC));
+  put(bytes, VERSION);
+  out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+// Encode a request of the robot into this thread's buffer, writing the buffer out once it has a batch.
+void record(Request::Kind kind, const Serial& robot, const Frame& pose, const Angles& angles) {
+  auto& local = buffer();
+  std::lock_guard<std::mutex> guard(local.lock);
+  // Stopped since checked: its buffers may already be written out
+  if(!recording()) return;
+
+  local.robots.emplace_back(local.bytes.size(), key(robot));
+  encode(local.bytes, kind, 0, pose, angles);
+  if(local.bytes.size() >= BATCH) recorder().flush(local);
+}
+
+}
+
+void start(const std::string& file_path) {
+  auto& capture = recorder();
+  std::lock_guard<std::mutex> registry(capture.registry);
+  // Requests of a capture already running go to its file
+  capture.drain();
+
+  std::lock_guard<std::mutex> guard(capture.lock);
+  capture.file = std::ofstream(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!capture.file.is_open()) throw std::runtime_error("Couldn't create the capture " + file_path);
+
+  write_header(capture.file);
+  capture.active.store(true);
+}
+
+void stop() {
+  auto& capture = recorder();
+  std::lock_guard<std::mutex> registry(capture.registry);
+
+  capture.active.store(false);
+  capture.drain();
+
+  std::lock_guard<std::mutex> guard(capture.lock);
+  if(capture.file.is_open()) capture.file.close();
+}
+
+bool recording() {
+  return recorder().active.load(std::memory_order_relaxed);
+}
+
+void identify(const Serial& robot, uint16_t id) {
+  auto& capture = recorder();
+  std::lock_guard<std::mutex> guard(capture.lock);
+
+  const auto hash = key(robot);
+  const auto previous = capture.ids.find(hash);
+  if(previous != capture.ids.end()) capture.robots.erase(previous->second);
+
+  capture.ids[hash] = id;
+  capture.robots[id] = hash;
+}
+
+void record(const Frame& pose, const Serial& robot, const Angles& seed) {
+  if(!recording() || suppressed != 0) return;
+  record(Request::Kind::INVERSE, robot, pose, seed);
+}
+
+void record(const Angles& angles, const Serial& robot) {
+  if(!recording() || suppressed != 0) return;
+  record(Request::Kind::FORWARD, robot, Frame(), angles);
+}
+
+Suppress::Suppress() {
+  ++suppressed;
+}
+
+Suppress::~Suppress() {
+  --suppressed;
+}
+
+std::vector<Request> read(const std::string& file_path) {
+  auto file = std::ifstream(file_path, std::ios::in | std::ios::binary);
+  if(!file.is_open()) throw std::runtime_error("Couldn't open the capture " + file_path);
+
+  char magic[sizeof(MAGIC)];
+  if(!file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+    throw std::runtime_error(file_path + " isn't a capture");
+  }
+  if(get<uint32_t>(file) != VERSION) throw std::runtime_error(file_path + " is an unsupported capture version");
+
+  std::vector<Request> requests;
+  while(file.peek() != std::ifstream::traits_type::eof()) {
+    Request request;
+    const auto kind = get<uint8_t>(file);
+    if(kind > static_cast<uint8_t>(Request::Kind::FORWARD)) throw std::runtime_error("Unknown request in capture " + file_path);
+
+    request.kind = static_cast<Request::Kind>(kind);
+    request.angles.resize(get<uint8_t>(file));
+    request.robot = get<uint16_t>(file);
+
+    if(request.kind == Request::Kind::INVERSE) {
+      Real q[8];
+      for(auto& component : q) component = get<Real>(file);
+      request.pose = Frame(Dual<Quaternion>(Quaternion(q[0], q[1], q[2], q[3]), Quaternion(q[4], q[5], q[6], q[7])));
+    }
+
+    for(auto& angle : request.angles) angle = get<Real>(file);
+    requests.push_back(request);
+  }
+
+  return requests;
+}
+
+void write(const std::string& file_path, const std::vector<Request>& requests) {
+  auto file = std::ofstream(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!file.is_open()) throw std::runtime_error("Couldn't create the capture " + file_path);
+
+  std::string bytes;
+  for(const auto& request : requests) encode(bytes, request);
+
+  write_header(file);
+  file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  if(!file) throw std::runtime_error("Couldn't write the capture " + file_path);
+}
+
+}
@@ -1,22 +1,137 @@
 #include "utils/logger.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <streambuf>
+#include <thread>
+#include <vector>
 
 namespace rbt {
 
-Logger::Logger() {}
+static_assert(sizeof(Logger::Message) == Logger::MESSAGE_SIZE, "Messages should fill their slots exactly");
 
-Logger::~Logger() {
-  std::cout << os.rdbuf() << std::endl;
-}
+namespace {
+
+// A single producer (the logging thread), single consumer (whoever holds State::draining) ring of messages.
+struct Ring {
+  std::unique_ptr<Logger::Message[]> messages = std::make_unique<Logger::Message[]>(Logger::CAPACITY);
+  // Counters only ever increase, so the ring is full when tail - head == CAPACITY
+  alignas(64) std::atomic<std::size_t> head{0};
+  alignas(64) std::atomic<std::size_t> tail{0};
+  std::atomic<bool> closed{false};
+};
+
+
+struct State {
+  std::mutex lock;
+  std::vector<std::unique_ptr<Ring>> rings;
+  // Guarded by draining
+  std::ostream* sink = &std::cout;
+  std::atomic<std::size_t> dropped{0};
+
+  // Held while taking messages out of the rings (so there is only ever one consumer) and writing them to the sink
+  std::mutex draining;
+
+  std::mutex idle;
+  std::condition_variable wake;
+  bool running = true;
+  // Set by a producer whose ring is half full. Its wake-up may be missed, but only until the next LATENCY
+  std::atomic<bool> waiting{false};
+  std::thread worker;
+
+  State() : worker([this]() { this->run(); }) {}
+
+  ~State() {
+    {
+      std::lock_guard<std::mutex> guard(this->idle);
+      this->running = false;
+    }
+    this->wake.notify_one();
+    this->worker.join();
+    this->drain();
+  }
+
+  void run() {
+    std::unique_lock<std::mutex> guard(this->idle);
+    while(this->running) {
+      this->wake.wait_for(guard, std::chrono::milliseconds(Logger::LATENCY), [this]() {
+        return !this->running || this->waiting.load(std::memory_order_relaxed);
+      });
+      this->waiting.store(false, std::memory_order_relaxed);
 
-std::stringstream& Logger::out(const LEVEL& level) {
-  this->os << this->level_to_string(level);
-  return this->os;
+      guard.unlock();
+      this->drain();
+      guard.lock();
+    }
+  }
+
+  // Format and write every waiting message, returning how many there were.
+  std::size_t drain();
+};
+
+State& state() {
+  static State instance;
+  return instance;
 }
 
-std::string Logger::level_to_string(const LEVEL& level) {
+// The calling thread's ring, created on its first message. The ring is closed when the thread exits, and freed once
+// its last messages are written.
+class LocalRing {
+public:
+  Ring* ring = nullptr;
+
+  ~LocalRing() {
+    if(this->ring != nullptr) this->ring->closed.store(true, std::memory_order_release);
+  }
+
+  Ring& get() {
+    if(this->ring == nullptr) {
+      auto& shared = state();
+      std::lock_guard<std::mutex> guard(shared.lock);
+      shared.rings.push_back(std::make_unique<Ring>());
+      this->ring = shared.rings.back().get();
+    }
+    return *this->ring;
+  }
+};
+
+thread_local LocalRing local;
+
+// A stream buffer writing into the rest of a message, which drops what doesn't fit.
+class Text : public std::streambuf {
+public:
+  bool overflowed = false;
+
+  Text(char* begin, char* end) {
+    this->setp(begin, end);
+  }
+
+  std::size_t written() const {
+    return static_cast<std::size_t>(this->pptr() - this->pbase());
+  }
+
+protected:
+  int_type overflow(int_type c) override {
+    if(!traits_type::eq_int_type(c, traits_type::eof())) this->overflowed = true;
+    return traits_type::not_eof(c);
+  }
+
+  std::streamsize xsputn(const char* text, std::streamsize count) override {
+    const auto size = std::min(count, static_cast<std::streamsize>(this->epptr() - this->pptr()));
+    std::memcpy(this->pptr(), text, static_cast<std::size_t>(size));
+    this->pbump(static_cast<int>(size));
+    if(size < count) this->overflowed = true;
+    return count;
+  }
+};
+
+std::string level_to_string(const LEVEL& level) {
   switch(level) {
     case LEVEL::WARN:
       return {"\033[33m[WARN]\033[0m "};
@@ -27,4 +142,172 @@ std::string Logger::level_to_string(const LEVEL& level) {
   }
 }
 
+template <typename T>
+T get(const char* bytes) {
+  T value;
+  std::memcpy(&value, bytes, sizeof(T));
+  return value;
+}
+
+// Write the argument at position (advancing past it).
+void format_argument(std::ostringstream& out, const Logger::Message& message, std::size_t& position) {
+  const auto tag = message.arguments[position++];
+  switch(tag) {
+    case 'b':
+      out << (get<bool>(message.arguments + position) ? "true" : "false");
+      position += sizeof(bool);
+      break;
+    case 'i':
+      out << get<int64_t>(message.arguments + position);
+      position += sizeof(int64_t);
+      break;
+    case 'u':
+      out << get<uint64_t>(message.arguments + position);
+      position += sizeof(uint64_t);
+      break;
+    case 'f':
+      out << get<double>(message.arguments + position);
+      position += sizeof(double);
+      break;
+    case 'o': {
+      const auto writer = get<Logger::Writer>(message.arguments + position);
+      position += sizeof(Logger::Writer);
+      position += writer(out, message.arguments + position);
+      break;
+    }
+    default: {
+      const auto length = get<uint16_t>(message.arguments + position);
+      out.write(message.arguments + position + sizeof(uint16_t), length);
+      position += sizeof(uint16_t) + length;
+      if(tag == 'S') out << "...";
+    }
+  }
+}
+
+void format(std::ostringstream& out, const Logger::Message& message) {
+  out << level_to_string(message.level);
+
+  std::size_t position = 0;
+  for(auto c = message.format; *c != '\0'; ++c) {
+    if(c[0] == '{' && c[1] == '}' && position < message.size) {
+      format_argument(out, message, position);
+      ++c;
+    } else if(c[0] == '{' && c[1] == '}' && message.truncated) {
+      out << "...";
+      ++c;
+    } else {
+      out << *c;
+    }
+  }
+  out << '\n';
+}
+
+std::size_t State::drain() {
+  std::lock_guard<std::mutex> consumer(this->draining);
+
+  // Take the waiting messages of every ring, then write them in the order they were logged
+  std::vector<const Logger::Message*> batch;
+  std::vector<std::pair<Ring*, std::size_t>> taken;
+  {
+    std::lock_guard<std::mutex> guard(this->lock);
+    for(const auto& ring : this->rings) {
+      const auto head = ring->head.load(std::memory_order_relaxed);
+      const auto tail = ring->tail.load(std::memory_order_acquire);
+      for(auto i = head; i < tail; ++i) batch.push_back(&ring->messages[i % Logger::CAPACITY]);
+      taken.emplace_back(ring.get(), tail);
+    }
+  }
+
+  if(!batch.empty()) {
+    std::stable_sort(batch.begin(), batch.end(), [](const Logger::Message* a, const Logger::Message* b) {
+      return a->time < b->time;
+    });
+
+    std::ostringstream text;
+    for(const auto message : batch) format(text, *message);
+
+    *this->sink << text.str() << std::flush;
+  }
+
+  std::lock_guard<std::mutex> guard(this->lock);
+  // Only now give the slots back to their producers
+  for(const auto& [ring, tail] : taken) ring->head.store(tail, std::memory_order_release);
+
+  // Free the rings of exited threads once they're empty
+  this->rings.erase(std::remove_if(this->rings.begin(), this->rings.end(), [](const std::unique_ptr<Ring>& ring) {
+    return ring->closed.load(std::memory_order_acquire) &&
+      ring->head.load(std::memory_order_relaxed) == ring->tail.load(std::memory_order_acquire);
+  }), this->rings.end());
+
+  return batch.size();
+}
+
+}
+
+Logger::Message* Logger::claim() {
+  auto& ring = local.get();
+  const auto tail = ring.tail.load(std::memory_order_relaxed);
+  const auto waiting = tail - ring.head.load(std::memory_order_acquire);
+
+  if(waiting == Logger::CAPACITY) {
+    state().dropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  // Wake the background thread rather than wait up to LATENCY for it, so the ring doesn't fill
+  if(waiting == Logger::CAPACITY / 2) {
+    auto& shared = state();
+    shared.waiting.store(true, std::memory_order_relaxed);
+    shared.wake.notify_one();
+  }
+
+  auto message = &ring.messages[tail % Logger::CAPACITY];
+  message->time = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+  return message;
+}
+
+void Logger::publish() {
+  auto& ring = local.get();
+  ring.tail.store(ring.tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void Logger::put(Message& message, const char* text, std::size_t length) {
+  if(!Logger::fits(message, 1 + sizeof(uint16_t))) return;
+
+  const auto size = static_cast<uint16_t>(std::min(length, sizeof(message.arguments) - message.size - 1 - sizeof(uint16_t)));
+  message.arguments[message.size] = (size < length) ? 'S' : 's';
+  std::memcpy(message.arguments + message.size + 1, &size, sizeof(uint16_t));
+  std::memcpy(message.arguments + message.size + 1 + sizeof(uint16_t), text, size);
+  message.size = static_cast<uint16_t>(message.size + 1 + sizeof(uint16_t) + size);
+}
+
+void Logger::put(Message& message, void (*format)(std::ostream&, const void*), const void* value) {
+  if(!Logger::fits(message, 1 + sizeof(uint16_t))) return;
+
+  auto text = Text(message.arguments + message.size + 1 + sizeof(uint16_t), message.arguments + sizeof(message.arguments));
+  std::ostream out(&text);
+  format(out, value);
+
+  const auto size = static_cast<uint16_t>(text.written());
+  message.arguments[message.size] = text.overflowed ? 'S' : 's';
+  std::memcpy(message.arguments + message.size + 1, &size, sizeof(uint16_t));
+  message.size = static_cast<uint16_t>(message.size + 1 + sizeof(uint16_t) + size);
+}
+
+void Logger::flush() {
+  state().drain();
+}
+
+void Logger::set_sink(std::ostream& out) {
+  auto& shared = state();
+  shared.drain();
+
+  std::lock_guard<std::mutex> guard(shared.draining);
+  shared.sink = &out;
+}
+
+std::size_t Logger::dropped() {
+  return state().dropped.load(std::memory_order_relaxed);
+}
+
 }
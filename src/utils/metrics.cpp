@@ -0,0 +1,201 @@
+#include "utils/metrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace rbt::metrics {
+
+namespace {
+
+struct Registry {
+  std::mutex lock;
+  std::map<std::string, std::string> help;
+  std::map<std::string, std::unique_ptr<Counter>> counters;
+  std::map<std::string, std::unique_ptr<Gauge>> gauges;
+  std::map<std::string, std::unique_ptr<Histogram>> histograms;
+
+  bool taken(const std::string& name) const {
+    return this->counters.count(name) + this->gauges.count(name) + this->histograms.count(name) != 0;
+  }
+};
+
+Registry& registry() {
+  static Registry instance;
+  return instance;
+}
+
+template <typename T>
+T& find(std::map<std::string, std::unique_ptr<T>>& metrics, const std::string& name, const std::string& help) {
+  auto& all = registry();
+  std::lock_guard<std::mutex> guard(all.lock);
+
+  const auto found = metrics.find(name);
+  if(found != metrics.end()) return *found->second;
+
+  if(all.taken(name)) throw std::invalid_argument("The metric " + name + " already exists as another kind");
+  all.help.emplace(name, help);
+  return *metrics.emplace(name, std::make_unique<T>()).first->second;
+}
+
+uint64_t nanoseconds() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()
+  ).count());
+}
+
+void write_help(std::ostream& out, const std::string& name, const std::string& help, const char* type) {
+  out << "# HELP " << name << " " << help << "\n";
+  out << "# TYPE " << name << " " << type << "\n";
+}
+
+}
+
+std::size_t shard() {
+  static std::atomic<std::size_t> next{0};
+  thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+  return index;
+}
+
+uint64_t Counter::value() const {
+  uint64_t total = 0;
+  for(const auto& shard : this->shards) total += shard.value.load(std::memory_order_relaxed);
+  return total;
+}
+
+void Gauge::add(double amount) {
+  auto value = this->current.load(std::memory_order_relaxed);
+  while(!this->current.compare_exchange_weak(value, value + amount, std::memory_order_relaxed));
+}
+
+uint64_t Distribution::quantile(double q) const {
+  if(this->count == 0) return 0;
+
+  // The rank of the value at q, from 1
+  const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(this->count))));
+  uint64_t seen = 0;
+  for(std::size_t i = 0; i < this->buckets.size(); ++i) {
+    seen += this->buckets[i];
+    if(seen >= rank) return std::min(Histogram::highest(i), this->max);
+  }
+  return this->max;
+}
+
+std::size_t Histogram::bucket(uint64_t value) {
+  // Values below SUB_BUCKETS get a bucket each; above, each power of two is split into SUB_BUCKETS
+  if(value < SUB_BUCKETS) return static_cast<std::size_t>(value);
+
+  const auto exponent = static_cast<std::size_t>(63 - __builtin_clzll(value));
+  const auto mantissa = static_cast<std::size_t>(value >> (exponent - 4)) & (SUB_BUCKETS - 1);
+  return (exponent - 3) * SUB_BUCKETS + mantissa;
+}
+
+uint64_t Histogram::lowest(std::size_t bucket) {
+  if(bucket < SUB_BUCKETS) return bucket;
+
+  const auto exponent = bucket / SUB_BUCKETS + 3;
+  return (SUB_BUCKETS + bucket % SUB_BUCKETS) << (exponent - 4);
+}
+
+uint64_t Histogram::highest(std::size_t bucket) {
+  return (bucket + 1 < BUCKETS) ? Histogram::lowest(bucket + 1) - 1 : UINT64_MAX;
+}
+
+void Histogram::record(uint64_t value) {
+  auto& local = this->shards[shard()];
+  local.count.fetch_add(1, std::memory_order_relaxed);
+  local.sum.fetch_add(value, std::memory_order_relaxed);
+  local.buckets[Histogram::bucket(value)].fetch_add(1, std::memory_order_relaxed);
+
+  // Only this thread's shard, so the exchange rarely retries
+  auto max = local.max.load(std::memory_order_relaxed);
+  while(value > max && !local.max.compare_exchange_weak(max, value, std::memory_order_relaxed));
+}
+
+Distribution Histogram::distribution() const {
+  Distribution result;
+  result.buckets.assign(BUCKETS, 0);
+
+  for(const auto& shard : this->shards) {
+    result.sum += shard.sum.load(std::memory_order_relaxed);
+    result.max = std::max(result.max, shard.max.load(std::memory_order_relaxed));
+    for(std::size_t i = 0; i < BUCKETS; ++i) result.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+  }
+
+  // Count from the buckets so quantiles stay consistent with them while other threads record
+  for(const auto count : result.buckets) result.count += count;
+  return result;
+}
+
+Stopwatch::Stopwatch(Histogram& histogram) : histogram(histogram), begin(nanoseconds()) {}
+
+Stopwatch::~Stopwatch() {
+  this->histogram.record(nanoseconds() - this->begin);
+}
+
+Counter& counter(const std::string& name, const std::string& help) {
+  return find(registry().counters, name, help);
+}
+
+Gauge& gauge(const std::string& name, const std::string& help) {
+  return find(registry().gauges, name, help);
+}
+
+Histogram& histogram(const std::string& name, const std::string& help) {
+  return find(registry().histograms, name, help);
+}
+
+Snapshot snapshot() {
+  auto& all = registry();
+  std::lock_guard<std::mutex> guard(all.lock);
+
+  Snapshot result;
+  for(const auto& [name, metric] : all.counters) result.counters[name] = metric->value();
+  for(const auto& [name, metric] : all.gauges) result.gauges[name] = metric->value();
+  for(const auto& [name, metric] : all.histograms) result.histograms[name] = metric->distribution();
+  return result;
+}
+
+void write_prometheus(std::ostream& out) {
+  const auto values = snapshot();
+  std::map<std::string, std::string> help;
+  {
+    auto& all = registry();
+    std::lock_guard<std::mutex> guard(all.lock);
+    help = all.help;
+  }
+
+  for(const auto& [name, value] : values.counters) {
+    write_help(out, name, help[name], "counter");
+    out << name << " " << value << "\n";
+  }
+
+  for(const auto& [name, value] : values.gauges) {
+    write_help(out, name, help[name], "gauge");
+    out << name << " " << value << "\n";
+  }
+
+  for(const auto& [name, distribution] : values.histograms) {
+    write_help(out, name, help[name], "summary");
+    for(const auto q : { 0.5, 0.9, 0.99, 0.999 }) {
+      out << name << "{quantile=\"" << q << "\"} " << static_cast<double>(distribution.quantile(q)) * 1e-9 << "\n";
+    }
+    out << name << "_sum " << static_cast<double>(distribution.sum) * 1e-9 << "\n";
+    out << name << "_count " << distribution.count << "\n";
+  }
+  out.flush();
+}
+
+void write_prometheus(const std::string& file_path) {
+  auto file = std::ofstream(file_path, std::ios::out | std::ios::trunc);
+  if(!file.is_open()) throw std::runtime_error("Couldn't create the metrics file " + file_path);
+
+  write_prometheus(file);
+  if(!file) throw std::runtime_error("Couldn't write the metrics file " + file_path);
+}
+
+}
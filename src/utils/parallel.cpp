@@ -0,0 +1,114 @@
+#include "utils/parallel.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+namespace rbt {
+
+namespace {
+
+// Whether this thread is running chunks, so calls it makes from them don't wait on the pool they're part of.
+thread_local bool working = false;
+
+// Threads waiting for a job: the chunks of one parallel_chunks call.
+class Pool {
+public:
+  // Held by the call whose job the pool is running
+  std::mutex busy;
+
+  Pool() {
+    for(std::size_t i = 1; i < hardware_threads(); ++i) std::thread([this]() { this->serve(); }).detach();
+  }
+
+  // Run the chunks of the job on the pool and this thread, holding busy.
+  void run(std::size_t count, std::size_t size, void (*chunk)(const void*, std::size_t, std::size_t), const void* f) {
+    {
+      std::lock_guard<std::mutex> guard(this->lock);
+      this->job = Job{ count, size, chunk, f };
+      this->next.store(0, std::memory_order_relaxed);
+      this->failure = nullptr;
+      ++this->generation;
+    }
+    this->wake.notify_all();
+
+    this->work(this->job);
+
+    // Workers that took the job may still be running its chunks; none may start on the next job's with this one's
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->done.wait(guard, [this]() { return this->active == 0; });
+    this->job = Job{ 0, 0, nullptr, nullptr };
+
+    if(this->failure) std::rethrow_exception(this->failure);
+  }
+
+private:
+  struct Job {
+    std::size_t count, size;
+    void (*chunk)(const void*, std::size_t, std::size_t);
+    const void* f;
+  };
+
+  std::mutex lock;
+  std::condition_variable wake, done;
+  Job job = Job{ 0, 0, nullptr, nullptr };
+  std::atomic<std::size_t> next{0};
+  std::exception_ptr failure;
+  std::size_t generation = 0, active = 0;
+
+  // Take chunks of the job until there are none left.
+  void work(const Job& job) {
+    working = true;
+    for(auto begin = this->next.fetch_add(job.size); begin < job.count; begin = this->next.fetch_add(job.size)) {
+      try {
+        job.chunk(job.f, begin, std::min(begin + job.size, job.count));
+      } catch(...) {
+        std::lock_guard<std::mutex> guard(this->lock);
+        if(!this->failure) this->failure = std::current_exception();
+      }
+    }
+    working = false;
+  }
+
+  void serve() {
+    std::size_t seen = 0;
+    std::unique_lock<std::mutex> guard(this->lock);
+    while(true) {
+      this->wake.wait(guard, [&]() { return this->generation != seen; });
+      seen = this->generation;
+      if(this->job.chunk == nullptr) continue;
+
+      const auto job = this->job;
+      ++this->active;
+      guard.unlock();
+      this->work(job);
+      guard.lock();
+
+      if(--this->active == 0) this->done.notify_all();
+    }
+  }
+};
+
+// Never destroyed: its threads wait for jobs until the process exits, and as they never exit, their thread locals
+// (e.g. the buffers of the logger and profiler) aren't torn down after the statics they use.
+Pool& pool() {
+  static Pool* instance = new Pool();
+  return *instance;
+}
+
+}
+
+void parallel_chunks(std::size_t count, std::size_t size, void (*chunk)(const void*, std::size_t, std::size_t),
+  const void* f) {
+  auto& workers = pool();
+  if(working || hardware_threads() == 1 || !workers.busy.try_lock()) {
+    for(std::size_t begin = 0; begin < count; begin += size) chunk(f, begin, std::min(begin + size, count));
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(workers.busy, std::adopt_lock);
+  workers.run(count, size, chunk, f);
+}
+
+}
@@ -0,0 +1,364 @@
+#include "utils/profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace rbt::profiler {
+
+namespace {
+
+const uint32_t NONE = UINT32_MAX;
+
+// Durations are counted in buckets by their highest bit and the SUB_BUCKETS below it (the first SUB_BUCKETS exactly),
+// so a bucket spans at most a sixteenth of its values (as in metrics' histograms).
+const std::size_t SUB_BITS = 4, SUB_BUCKETS = 1 << SUB_BITS, BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+std::size_t bucket(uint64_t duration) {
+  if(duration < SUB_BUCKETS) return static_cast<std::size_t>(duration);
+  const auto high = static_cast<std::size_t>(63 - __builtin_clzll(duration));
+  const auto sub = static_cast<std::size_t>((duration >> (high - SUB_BITS)) & (SUB_BUCKETS - 1));
+  return (high - SUB_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+// The middle of the durations counted in a bucket.
+uint64_t middle(std::size_t index) {
+  if(index < SUB_BUCKETS) return index;
+  const auto shift = index / SUB_BUCKETS - 1;
+  const auto low = static_cast<uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+  return low + ((uint64_t(1) << shift) >> 1);
+}
+
+// The buffers are written only by their own thread and read while reporting, so they hold atomics, which the owner
+// updates with plain (relaxed) loads and stores rather than locked read-modify-writes.
+void add(std::atomic<uint64_t>& value, uint64_t amount) {
+  value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+// A zone path of one thread: a zone name under its parent zone, and the timings of its runs.
+struct Node {
+  // Set before the node is published (by Buffer::nodes), then fixed
+  const char* name;
+  uint32_t parent, depth;
+  // Used only by the owner, to find the children of a node
+  uint32_t child, sibling;
+
+  std::atomic<uint64_t> count, total, max;
+  std::array<std::atomic<uint64_t>, BUCKETS> histogram;
+
+  void reset() {
+    for(auto value : { &this->count, &this->total, &this->max }) value->store(0, std::memory_order_relaxed);
+    for(auto& value : this->histogram) value.store(0, std::memory_order_relaxed);
+  }
+};
+
+// A closed zone, for traces.
+struct Event {
+  std::atomic<const char*> name;
+  std::atomic<uint64_t> begin, end;
+};
+
+// The zones of one thread, in fixed storage: aggregated by path, and the last TRACE_EVENTS of them as a ring.
+// A thread takes a buffer with its first zone and gives it back when it exits, for the next new thread to take, so
+// there are only ever as many buffers as threads running zones at once, and the zones of exited threads are still
+// reported.
+struct Buffer {
+  std::size_t thread;
+  // The clear() this buffer was last reset for; a buffer from before the latest is empty
+  std::atomic<uint64_t> generation;
+
+  std::array<Node, MAX_ZONES> zones;
+  // Zones published (in the order they were first opened)
+  std::atomic<uint32_t> nodes;
+
+  // With a spare slot: the one being overwritten while the rest are read
+  std::array<Event, TRACE_EVENTS + 1> events;
+  // Events ever written: event i is at i % events.size() until overwritten
+  std::atomic<uint64_t> written;
+
+  // The zones open, outermost first (NONE where one wasn't recorded), and when they opened
+  std::array<uint32_t, MAX_DEPTH> open;
+  std::array<uint64_t, MAX_DEPTH> begins;
+  std::size_t depth;
+  // The root zones' first child
+  uint32_t roots;
+};
+
+struct Registry {
+  std::mutex lock;
+  std::vector<std::unique_ptr<Buffer>> buffers;
+  std::vector<Buffer*> free;
+  std::atomic<uint64_t> generation{0};
+};
+
+Registry& registry() {
+  static Registry instance;
+  return instance;
+}
+
+// Only reported (and its counts kept) if it has been reset for the latest clear().
+bool current(const Buffer& buffer) {
+  return buffer.generation.load(std::memory_order_acquire) == registry().generation.load(std::memory_order_acquire);
+}
+
+// Forget the buffer's zones, keeping the nodes of those still open so they can close.
+void reset(Buffer& buffer, uint64_t generation) {
+  const auto nodes = buffer.nodes.load(std::memory_order_relaxed);
+  for(uint32_t i = 0; i < nodes; ++i) buffer.zones[i].reset();
+  buffer.written.store(0, std::memory_order_relaxed);
+  buffer.generation.store(generation, std::memory_order_release);
+}
+
+// The calling thread's buffer, given back to the registry when the thread exits.
+struct Local {
+  Buffer* buffer = nullptr;
+
+  ~Local() {
+    if(this->buffer == nullptr) return;
+    auto& all = registry();
+    std::lock_guard<std::mutex> guard(all.lock);
+    all.free.push_back(this->buffer);
+  }
+};
+
+Buffer& buffer() {
+  thread_local Local local;
+  if(local.buffer == nullptr) {
+    auto& all = registry();
+    std::lock_guard<std::mutex> guard(all.lock);
+    if(all.free.empty()) {
+      all.buffers.push_back(std::make_unique<Buffer>());
+      auto& created = *all.buffers.back();
+      created.thread = all.buffers.size() - 1;
+      created.nodes.store(0, std::memory_order_relaxed);
+      created.roots = NONE;
+      reset(created, all.generation.load(std::memory_order_relaxed));
+      local.buffer = &created;
+    } else {
+      local.buffer = all.free.back();
+      all.free.pop_back();
+    }
+    local.buffer->depth = 0;
+  }
+  return *local.buffer;
+}
+
+// The node of the zone with the name under parent (NONE for the roots), added if it's new. NONE if there's no room.
+uint32_t find(Buffer& buffer, uint32_t parent, const char* name) {
+  auto& first = (parent == NONE) ? buffer.roots : buffer.zones[parent].child;
+  for(auto i = first; i != NONE; i = buffer.zones[i].sibling) {
+    const auto other = buffer.zones[i].name;
+    if(other == name || std::strcmp(other, name) == 0) return i;
+  }
+
+  const auto index = buffer.nodes.load(std::memory_order_relaxed);
+  if(index == MAX_ZONES) return NONE;
+
+  auto& node = buffer.zones[index];
+  node.name = name;
+  node.parent = parent;
+  node.depth = (parent == NONE) ? 0 : buffer.zones[parent].depth + 1;
+  node.child = NONE;
+  node.sibling = first;
+  node.reset();
+  first = index;
+  buffer.nodes.store(index + 1, std::memory_order_release);
+  return index;
+}
+
+std::string path(const Buffer& buffer, uint32_t node) {
+  const auto& zone = buffer.zones[node];
+  return (zone.parent == NONE) ? std::string(zone.name) : path(buffer, zone.parent) + "/" + zone.name;
+}
+
+// Call f(buffer) for each current buffer, holding the registry so none is added meanwhile.
+template <typename F>
+void visit(const F& f) {
+  auto& all = registry();
+  std::lock_guard<std::mutex> guard(all.lock);
+  for(const auto& buffer : all.buffers) {
+    if(current(*buffer)) f(*buffer);
+  }
+}
+
+void escape(std::ostream& out, const std::string& text) {
+  for(const auto c : text) {
+    if(c == '"' || c == '\\') out << '\\';
+    out << c;
+  }
+}
+
+}
+
+uint64_t now() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()
+  ).count());
+}
+
+Zone::Zone(const char* name) {
+  auto& local = buffer();
+  const auto depth = local.depth++;
+  if(depth >= MAX_DEPTH) return;
+
+  const auto parent = (depth == 0) ? NONE : local.open[depth - 1];
+  local.open[depth] = (depth > 0 && parent == NONE) ? NONE : find(local, parent, name);
+  // Read the clock last so the bookkeeping isn't counted
+  local.begins[depth] = now();
+}
+
+Zone::~Zone() {
+  const auto end = now();
+  auto& local = buffer();
+  const auto depth = --local.depth;
+  if(depth >= MAX_DEPTH || local.open[depth] == NONE) return;
+
+  const auto generation = registry().generation.load(std::memory_order_acquire);
+  if(local.generation.load(std::memory_order_relaxed) != generation) reset(local, generation);
+
+  auto& zone = local.zones[local.open[depth]];
+  const auto begin = local.begins[depth], duration = end - begin;
+  add(zone.count, 1);
+  add(zone.total, duration);
+  if(duration > zone.max.load(std::memory_order_relaxed)) zone.max.store(duration, std::memory_order_relaxed);
+  add(zone.histogram[bucket(duration)], 1);
+
+  const auto written = local.written.load(std::memory_order_relaxed);
+  auto& event = local.events[written % local.events.size()];
+  // Readers seeing any of the new event also see that the slot was being overwritten (as in a seqlock)
+  std::atomic_thread_fence(std::memory_order_release);
+  event.name.store(zone.name, std::memory_order_relaxed);
+  event.begin.store(begin, std::memory_order_relaxed);
+  event.end.store(end, std::memory_order_relaxed);
+  local.written.store(written + 1, std::memory_order_release);
+}
+
+std::vector<Statistics> statistics() {
+  struct Merged {
+    std::size_t depth, count = 0;
+    uint64_t total = 0, max = 0;
+    std::array<uint64_t, BUCKETS> histogram = {};
+  };
+
+  std::vector<std::string> order;
+  std::map<std::string, Merged> merged;
+
+  visit([&](const Buffer& buffer) {
+    const auto nodes = buffer.nodes.load(std::memory_order_acquire);
+    for(uint32_t i = 0; i < nodes; ++i) {
+      const auto& zone = buffer.zones[i];
+      const auto count = zone.count.load(std::memory_order_relaxed);
+      if(count == 0) continue;
+
+      const auto key = path(buffer, i);
+      auto found = merged.find(key);
+      if(found == merged.end()) {
+        order.push_back(key);
+        found = merged.emplace(key, Merged()).first;
+        found->second.depth = zone.depth;
+      }
+
+      auto& total = found->second;
+      total.count += count;
+      total.total += zone.total.load(std::memory_order_relaxed);
+      total.max = std::max(total.max, zone.max.load(std::memory_order_relaxed));
+      for(std::size_t b = 0; b < BUCKETS; ++b) total.histogram[b] += zone.histogram[b].load(std::memory_order_relaxed);
+    }
+  });
+
+  std::vector<Statistics> result;
+  for(const auto& key : order) {
+    const auto& zone = merged[key];
+
+    // The middle of the bucket holding the duration at each fraction of the sorted runs, as the nearest rank
+    const auto percentile = [&](double fraction) {
+      const auto rank = static_cast<uint64_t>(fraction * static_cast<double>(zone.count - 1) + 0.5);
+      uint64_t below = 0;
+      for(std::size_t b = 0; b < BUCKETS; ++b) {
+        below += zone.histogram[b];
+        if(below > rank) return std::min(middle(b), zone.max);
+      }
+      return zone.max;
+    };
+
+    const auto total = static_cast<double>(zone.total);
+    result.push_back(Statistics{
+      key, zone.depth, zone.count, total, total / static_cast<double>(zone.count),
+      percentile(0.5), percentile(0.99), zone.max
+    });
+  }
+  return result;
+}
+
+void print_report(std::ostream& out) {
+  const auto flags = out.flags();
+  out << std::fixed << std::setprecision(3);
+  out << std::left << std::setw(40) << "zone" << std::right << std::setw(10) << "count" << std::setw(14) << "mean [us]"
+    << std::setw(14) << "p50 [us]" << std::setw(14) << "p99 [us]" << std::setw(14) << "max [us]" << std::endl;
+
+  for(const auto& zone : statistics()) {
+    // Indent by depth, showing only the zone's own name
+    const auto slash = zone.path.rfind('/');
+    const auto name = std::string(2 * zone.depth, ' ') + zone.path.substr((slash == std::string::npos) ? 0 : slash + 1);
+
+    out << std::left << std::setw(40) << name << std::right << std::setw(10) << zone.count
+      << std::setw(14) << zone.mean / 1e3 << std::setw(14) << static_cast<double>(zone.p50) / 1e3
+      << std::setw(14) << static_cast<double>(zone.p99) / 1e3 << std::setw(14) << static_cast<double>(zone.max) / 1e3 << std::endl;
+  }
+  out.flags(flags);
+}
+
+void write_chrome_trace(std::ostream& out) {
+  const auto flags = out.flags();
+  out << std::fixed << std::setprecision(3);
+  out << "{\"traceEvents\":[";
+
+  bool first = true;
+  visit([&](const Buffer& buffer) {
+    const auto written = buffer.written.load(std::memory_order_acquire);
+    const auto oldest = (written > TRACE_EVENTS) ? written - TRACE_EVENTS : 0;
+
+    for(auto i = oldest; i < written; ++i) {
+      const auto& event = buffer.events[i % buffer.events.size()];
+      const auto name = event.name.load(std::memory_order_relaxed);
+      const auto begin = event.begin.load(std::memory_order_relaxed), end = event.end.load(std::memory_order_relaxed);
+      // Skip events the thread overwrote while they were read
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if(buffer.written.load(std::memory_order_acquire) >= i + buffer.events.size()) continue;
+
+      out << (first ? "\n" : ",\n") << "{\"name\":\"";
+      escape(out, name);
+      // Complete ("X") events in microseconds
+      out << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer.thread
+        << ",\"ts\":" << static_cast<double>(begin) / 1e3
+        << ",\"dur\":" << static_cast<double>(end - begin) / 1e3 << "}";
+      first = false;
+    }
+  });
+
+  out << "\n],\"displayTimeUnit\":\"ns\"}" << std::endl;
+  out.flags(flags);
+}
+
+void write_chrome_trace(const std::string& file_path) {
+  auto file = std::ofstream(file_path, std::ios::out | std::ios::trunc);
+  if(!file.is_open()) throw std::runtime_error("Couldn't create the trace " + file_path);
+
+  write_chrome_trace(file);
+  if(!file) throw std::runtime_error("Couldn't write the trace " + file_path);
+}
+
+void clear() {
+  // Each thread resets its own buffer when it next closes a zone; until then it's taken to be empty
+  registry().generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+}
@@ -1,7 +1,9 @@
 #include "visual/file_types/stl/stl_parser.hpp"
+#include "spatial/points.hpp"
 #include "spatial/triangle.hpp"
 #include "spatial/vector.hpp"
-#include "utils/timer.hpp"
+#include "utils/metrics.hpp"
+#include "utils/profiler.hpp"
 
 #include <iostream>
 
@@ -32,7 +34,18 @@ int STLParser::get_number_of_triangles() {
 }
 
 void STLParser::parse(const std::string& file_path, std::vector<Triangle>& triangles) {
-  Timer t("Parse STL");
+  Points normals;
+  this->parse(file_path, triangles, normals);
+}
+
+void STLParser::parse(const std::string& file_path, std::vector<Triangle>& triangles, Points& normals) {
+  PROFILE_ZONE("Parse STL");
+  static auto& parsed = metrics::counter("rbt_stl_parse_total", "STL files parsed");
+  static auto& read = metrics::counter("rbt_stl_triangles_total", "Triangles read from STL files");
+  static auto& latency = metrics::histogram("rbt_stl_parse_seconds", "STL parse latency");
+
+  const metrics::Stopwatch stopwatch(latency);
+  parsed.add();
 
   this->open_file(file_path);
 
@@ -47,14 +60,23 @@ void STLParser::parse(const std::string& file_path, std::vector<Triangle>& trian
   Facet* facets = new Facet[number_of_triangles];
   file.read(reinterpret_cast<char*>(facets), number_of_triangles * sizeof(Facet));
 
+  read.add(static_cast<uint64_t>(number_of_triangles));
   triangles.reserve(number_of_triangles);
+  const auto first = normals.size();
+  normals.resize(first + number_of_triangles);
   for(int i = 0; i < number_of_triangles; ++i) {
     triangles.push_back(Triangle({
       Vector3({ facets[i].a[0], facets[i].a[1], facets[i].a[2] }),
       Vector3({ facets[i].b[0], facets[i].b[1], facets[i].b[2] }),
       Vector3({ facets[i].c[0], facets[i].c[1], facets[i].c[2] }),
     }));
+
+    normals.x[first + i] = facets[i].normal[0];
+    normals.y[first + i] = facets[i].normal[1];
+    normals.z[first + i] = facets[i].normal[2];
   }
+
+  delete[] facets;
 }
 
 }
@@ -0,0 +1,95 @@
+#include "visual/file_types/stl/stl_writer.hpp"
+#include "spatial/points.hpp"
+#include "spatial/triangle.hpp"
+#include "utils/parallel.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace rbt::visual {
+
+namespace {
+
+const char HEADER[] = "Binary STL written by rbt::visual::STLWriter";
+
+// Call f(begin, end) over [0, count), in parallel if count is large enough.
+template <typename F>
+void run(std::size_t count, const F& f) {
+  if(count <= STLWriter::PARALLEL_THRESHOLD) {
+    f(0, count);
+  } else {
+    parallel_for(count, f);
+  }
+}
+
+}
+
+void STLWriter::start(std::size_t number_of_triangles) {
+  this->buffer.resize(STLWriter::STL_HEADER_SIZE_IN_BYTES + 4 + number_of_triangles * STLWriter::STL_FACET_SIZE_IN_BYTES);
+
+  // Binary STL files must not start with "solid", or readers take them for ASCII
+  std::memset(this->buffer.data(), ' ', STLWriter::STL_HEADER_SIZE_IN_BYTES);
+  std::memcpy(this->buffer.data(), HEADER, sizeof(HEADER) - 1);
+
+  const auto count = static_cast<uint32_t>(number_of_triangles);
+  std::memcpy(this->buffer.data() + STLWriter::STL_HEADER_SIZE_IN_BYTES, &count, sizeof(count));
+}
+
+void STLWriter::fill(const Points& vertices, const Points& normals, std::size_t first, std::size_t begin, std::size_t end) {
+  auto* out = this->buffer.data() + STLWriter::STL_HEADER_SIZE_IN_BYTES + 4 + (first + begin) * STLWriter::STL_FACET_SIZE_IN_BYTES;
+
+  for(auto i = begin; i < end; ++i) {
+    const float facet[12] = {
+      normals.x[i], normals.y[i], normals.z[i],
+      vertices.x[3 * i], vertices.y[3 * i], vertices.z[3 * i],
+      vertices.x[3 * i + 1], vertices.y[3 * i + 1], vertices.z[3 * i + 1],
+      vertices.x[3 * i + 2], vertices.y[3 * i + 2], vertices.z[3 * i + 2]
+    };
+    const uint16_t attribute = 0;
+
+    std::memcpy(out, facet, sizeof(facet));
+    std::memcpy(out + sizeof(facet), &attribute, sizeof(attribute));
+    out += STLWriter::STL_FACET_SIZE_IN_BYTES;
+  }
+}
+
+void STLWriter::flush(const std::string& file_path) {
+  auto file = std::ofstream(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!file.is_open()) throw std::runtime_error("Couldn't create the STL file " + file_path);
+
+  file.write(this->buffer.data(), static_cast<std::streamsize>(this->buffer.size()));
+  if(!file) throw std::runtime_error("Couldn't write the STL file " + file_path);
+}
+
+void STLWriter::write(const std::string& file_path, const std::vector<Triangle>& triangles) {
+  const auto vertices = rbt::vertices(triangles);
+  const auto normals = rbt::normals(triangles);
+
+  this->start(triangles.size());
+  run(triangles.size(), [&](std::size_t begin, std::size_t end) {
+    this->fill(vertices, normals, 0, begin, end);
+  });
+  this->flush(file_path);
+}
+
+void STLWriter::write(const std::string& file_path, const LinkMeshes& robot, const Angles& angles) {
+  // Posing transforms the links in parallel
+  robot.pose(angles, this->posed, this->scratch);
+
+  std::size_t number_of_triangles = 0;
+  for(const auto& link : this->posed) number_of_triangles += link.normals.size();
+  this->start(number_of_triangles);
+
+  std::size_t first = 0;
+  for(const auto& link : this->posed) {
+    run(link.normals.size(), [&](std::size_t begin, std::size_t end) {
+      this->fill(link.vertices, link.normals, first, begin, end);
+    });
+    first += link.normals.size();
+  }
+
+  this->flush(file_path);
+}
+
+}
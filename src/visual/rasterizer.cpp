@@ -0,0 +1,467 @@
+#include "visual/rasterizer.hpp"
+#include "utils/parallel.hpp"
+#include "utils/simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <type_traits>
+
+namespace rbt::visual {
+
+namespace {
+
+const std::size_t TILE = Rasterizer::TILE_SIZE;
+const std::size_t BLOCK = Rasterizer::BLOCK_SIZE;
+const std::size_t BLOCKS = TILE / BLOCK;
+
+static_assert(TILE % BLOCK == 0 && BLOCK == 8, "Rows of a block are rasterized 8 pixels at a time");
+
+// No triangle is this one, so pixels left with it saw nothing
+const uint32_t NOTHING = UINT32_MAX;
+
+// A vertex in the camera frame, and projected into the image with its inverse depth.
+struct Vertex {
+  Real x, y, z;
+  Real sx, sy, w;
+};
+
+// The depth buffer of a tile, as inverse depth (larger is nearer) so it can be interpolated linearly across the
+// image, with the triangle at each pixel and the farthest inverse depth of each block. The farthest depth of a block
+// stays the background's until every pixel of it is covered (a bit per pixel, row by row), so only then is it kept.
+struct alignas(32) Tile {
+  std::array<Real, TILE * TILE> w;
+  std::array<uint32_t, TILE * TILE> ids;
+  std::array<Real, BLOCKS * BLOCKS> farthest;
+  std::array<uint64_t, BLOCKS * BLOCKS> covered;
+};
+
+// Evaluate 8 pixels of a row starting at (x, y) (pixel centers are at half pixels), keeping those inside the triangle
+// and nearer than the buffer. Returns the pixels written.
+uint32_t rowScalar(const Real* a, const Real* b, const Real* c, const Real* plane, uint32_t id, Real x, Real y, Real* w, uint32_t* ids) {
+  uint32_t written = 0;
+  for(std::size_t lane = 0; lane < BLOCK; ++lane) {
+    const auto px = x + Real(0.5) + Real(lane), py = y + Real(0.5);
+    const auto e0 = a[0] * px + b[0] * py + c[0];
+    const auto e1 = a[1] * px + b[1] * py + c[1];
+    const auto e2 = a[2] * px + b[2] * py + c[2];
+    const auto depth = plane[0] * px + plane[1] * py + plane[2];
+
+    if(e0 >= 0 && e1 >= 0 && e2 >= 0 && depth > w[lane]) {
+      w[lane] = depth;
+      ids[lane] = id;
+      written |= 1u << lane;
+    }
+  }
+  return written;
+}
+
+// Evaluate rows [0, rows) of 8 pixels starting at (x, y), stored TILE apart from w and ids, as rowScalar. Returns the
+// pixels written, 8 bits per row.
+uint64_t blockScalar(const Real* a, const Real* b, const Real* c, const Real* plane, uint32_t id, Real x, Real y, std::size_t rows, Real* w, uint32_t* ids) {
+  uint64_t written = 0;
+  for(std::size_t row = 0; row < rows; ++row) {
+    const auto offset = row * TILE;
+    written |= uint64_t(rowScalar(a, b, c, plane, id, x, y + Real(row), w + offset, ids + offset)) << (BLOCK * row);
+  }
+  return written;
+}
+
+#ifdef RBT_AVX_KERNEL
+
+static_assert(std::is_same<Real, float>::value, "The AVX kernel rasterizes 8 single precision pixels at a time");
+
+// As blockScalar, a row of 8 pixels at a time. The terms along the row are the same for every row, so are only
+// evaluated once; the sums are in the same order, so the result is the same as blockScalar's.
+__attribute__((target("avx"))) uint64_t blockAVX(const Real* a, const Real* b, const Real* c, const Real* plane, uint32_t id, Real x, Real y, std::size_t rows, Real* w, uint32_t* ids) {
+  const auto px = _mm256_add_ps(_mm256_set1_ps(x + Real(0.5)), _mm256_set_ps(7, 6, 5, 4, 3, 2, 1, 0));
+  __m256 across[3];
+  for(std::size_t i = 0; i < 3; ++i) across[i] = _mm256_mul_ps(_mm256_set1_ps(a[i]), px);
+  const auto depthAcross = _mm256_mul_ps(_mm256_set1_ps(plane[0]), px);
+
+  const auto zero = _mm256_setzero_ps();
+  const auto triangle = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(id)));
+
+  uint64_t written = 0;
+  for(std::size_t row = 0; row < rows; ++row) {
+    const auto py = y + Real(row) + Real(0.5);
+
+    auto inside = _mm256_cmp_ps(_mm256_add_ps(_mm256_add_ps(across[0], _mm256_set1_ps(b[0] * py)), _mm256_set1_ps(c[0])), zero, _CMP_GE_OQ);
+    inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(_mm256_add_ps(across[1], _mm256_set1_ps(b[1] * py)), _mm256_set1_ps(c[1])), zero, _CMP_GE_OQ));
+    inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(_mm256_add_ps(across[2], _mm256_set1_ps(b[2] * py)), _mm256_set1_ps(c[2])), zero, _CMP_GE_OQ));
+    if(_mm256_movemask_ps(inside) == 0) continue;
+
+    auto* depths = w + row * TILE;
+    const auto depth = _mm256_add_ps(_mm256_add_ps(depthAcross, _mm256_set1_ps(plane[1] * py)), _mm256_set1_ps(plane[2]));
+    const auto stored = _mm256_load_ps(depths);
+    inside = _mm256_and_ps(inside, _mm256_cmp_ps(depth, stored, _CMP_GT_OQ));
+
+    const auto mask = static_cast<uint32_t>(_mm256_movemask_ps(inside));
+    if(mask == 0) continue;
+
+    _mm256_store_ps(depths, _mm256_blendv_ps(stored, depth, inside));
+    const auto indices = reinterpret_cast<float*>(ids + row * TILE);
+    _mm256_store_ps(indices, _mm256_blendv_ps(_mm256_load_ps(indices), triangle, inside));
+    written |= uint64_t(mask) << (BLOCK * row);
+  }
+  return written;
+}
+
+#endif
+
+typedef uint64_t (*Block)(const Real*, const Real*, const Real*, const Real*, uint32_t, Real, Real, std::size_t, Real*, uint32_t*);
+
+Block blockKernel() {
+#ifdef RBT_AVX_KERNEL
+  static const Block selected = simd::avx() ? blockAVX : blockScalar;
+#else
+  static const Block selected = blockScalar;
+#endif
+  return selected;
+}
+
+Vertex project(const Camera& camera, Real x, Real y, Real z) {
+  const auto w = 1 / z;
+  return Vertex{ x, y, z, camera.fx * x * w + camera.cx, camera.fy * y * w + camera.cy, w };
+}
+
+// Project the points [begin, end) (in the camera frame) into the image: x and y of the result are the image
+// coordinates and z the inverse depth. Only meaningful for points in front of the camera.
+void projectScalar(const Camera& camera, const Points& viewed, Points& projected, std::size_t begin, std::size_t end) {
+  for(auto i = begin; i < end; ++i) {
+    const auto w = 1 / viewed.z[i];
+    projected.x[i] = camera.fx * viewed.x[i] * w + camera.cx;
+    projected.y[i] = camera.fy * viewed.y[i] * w + camera.cy;
+    projected.z[i] = w;
+  }
+}
+
+#ifdef RBT_AVX_KERNEL
+
+// As projectScalar, 8 points at a time.
+__attribute__((target("avx"))) void projectAVX(const Camera& camera, const Points& viewed, Points& projected, std::size_t begin, std::size_t end) {
+  const auto fx = _mm256_set1_ps(camera.fx), fy = _mm256_set1_ps(camera.fy);
+  const auto cx = _mm256_set1_ps(camera.cx), cy = _mm256_set1_ps(camera.cy);
+  const auto one = _mm256_set1_ps(1);
+
+  auto i = begin;
+  for(; i + BLOCK <= end; i += BLOCK) {
+    const auto w = _mm256_div_ps(one, _mm256_loadu_ps(&viewed.z[i]));
+    _mm256_storeu_ps(&projected.x[i], _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(fx, _mm256_loadu_ps(&viewed.x[i])), w), cx));
+    _mm256_storeu_ps(&projected.y[i], _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(fy, _mm256_loadu_ps(&viewed.y[i])), w), cy));
+    _mm256_storeu_ps(&projected.z[i], w);
+  }
+
+  projectScalar(camera, viewed, projected, i, end);
+}
+
+#endif
+
+void project(const Camera& camera, const Points& viewed, Points& projected, std::size_t begin, std::size_t end) {
+#ifdef RBT_AVX_KERNEL
+  if(simd::avx()) {
+    projectAVX(camera, viewed, projected, begin, end);
+    return;
+  }
+#endif
+  projectScalar(camera, viewed, projected, begin, end);
+}
+
+// The first and last of count pixels whose centers lie within [low, high], clamped to the image: empty when first is
+// after last. The bounds are clamped before truncating (so far away or non-finite ones can't overflow) and rounded
+// without calling into the maths library, as most triangles are rejected here.
+void span(Real low, Real high, std::size_t count, int32_t& first, int32_t& last) {
+  const auto size = Real(count);
+  const auto a = std::min(size, std::max(Real(-1), low - Real(0.5)));
+  const auto b = std::min(size, std::max(Real(-1), high - Real(0.5)));
+
+  const auto ta = static_cast<int32_t>(a), tb = static_cast<int32_t>(b);
+  first = std::max<int32_t>(0, ta + (Real(ta) < a));
+  last = std::min<int32_t>(static_cast<int32_t>(count) - 1, tb - (Real(tb) > b));
+}
+
+// The part of the triangle in front of the near plane, as a fan of up to 4 vertices. Returns the vertex count.
+std::size_t clip(const Camera& camera, const std::array<Vertex, 3>& triangle, std::array<Vertex, 4>& result) {
+  std::size_t count = 0;
+  for(std::size_t i = 0; i < 3; ++i) {
+    const auto& p = triangle[i];
+    const auto& q = triangle[(i + 1) % 3];
+    const bool pIn = p.z >= camera.near, qIn = q.z >= camera.near;
+
+    if(pIn) result[count++] = p;
+    if(pIn != qIn) {
+      const auto s = (camera.near - p.z) / (q.z - p.z);
+      result[count++] = project(camera, p.x + s * (q.x - p.x), p.y + s * (q.y - p.y), camera.near);
+    }
+  }
+  return count;
+}
+
+}
+
+Camera Camera::with_field_of_view(std::size_t width, std::size_t height, Real fieldOfView, const RigidMatrix& pose, Real near, Real far) {
+  const auto focal = Real(width) / (2 * std::tan(fieldOfView / 2));
+  return Camera(width, height, focal, focal, Real(width) / 2, Real(height) / 2, pose, near, far);
+}
+
+RigidMatrix look_at(const Vector3& eye, const Vector3& target, const Vector3& up) {
+  const auto z = unit(target - eye);
+  const auto x = unit(cross(z, up));
+  const auto y = cross(z, x);
+
+  // The columns are the camera axes in the world
+  return RigidMatrix({
+    x[0], y[0], z[0], eye[0],
+    x[1], y[1], z[1], eye[1],
+    x[2], y[2], z[2], eye[2]
+  });
+}
+
+Rasterizer::Rasterizer(const Serial& robot, const std::vector<Mesh>& links) : robot(robot), meshes(robot, links) {
+  uint32_t total = 0;
+  for(std::size_t link = 0; link < links.size(); ++link) {
+    this->firsts.push_back(total);
+    total += static_cast<uint32_t>(links[link].size());
+    this->owners.resize(total, static_cast<uint8_t>(link));
+  }
+  this->placements.resize(links.size());
+  this->viewed.resize(links.size());
+  this->projected.resize(links.size());
+}
+
+void Rasterizer::render(const Camera& camera, const Angles& angles, DepthImage& image, bool normals) {
+  const auto& links = this->meshes.links();
+  this->robot.linkPoses(angles, this->frames);
+  const auto toCamera = inverse(camera.pose);
+
+  // Take every link into the camera frame
+  for(std::size_t link = 0; link < links.size(); ++link) {
+    this->placements[link] = RigidMatrix(this->frames[link]);
+    const auto& vertices = links[link].vertices;
+    this->viewed[link].resize(vertices.size());
+    this->projected[link].resize(vertices.size());
+
+    const auto placement = toCamera * this->placements[link];
+    parallel_for(vertices.size(), [&](std::size_t begin, std::size_t end) {
+      transform(placement, vertices, this->viewed[link], begin, end);
+      project(camera, this->viewed[link], this->projected[link], begin, end);
+    });
+  }
+
+  const auto tilesX = (camera.width + TILE - 1) / TILE, tilesY = (camera.height + TILE - 1) / TILE;
+  const auto tiles = tilesX * tilesY;
+  const auto total = this->owners.size();
+  const auto workers = hardware_threads();
+
+  this->setups.resize(workers);
+  this->bins.resize(workers);
+
+  // Set up triangles, each worker taking a range of them and sorting them into its own bins
+  parallel_for(workers, [&](std::size_t first, std::size_t last) {
+    for(auto worker = first; worker < last; ++worker) {
+      auto& setups = this->setups[worker];
+      auto& bins = this->bins[worker];
+      setups.clear();
+      bins.resize(tiles);
+      for(auto& bin : bins) bin.clear();
+
+      const auto begin = total * worker / workers, end = total * (worker + 1) / workers;
+      auto link = static_cast<std::size_t>(std::upper_bound(this->firsts.begin(), this->firsts.end(), begin) - this->firsts.begin()) - 1;
+
+      for(auto triangle = begin; triangle < end; ++triangle) {
+        while(link + 1 < this->firsts.size() && triangle >= this->firsts[link + 1]) ++link;
+        const auto& points = this->viewed[link], & screen = this->projected[link];
+        const auto index = 3 * (triangle - this->firsts[link]);
+        const auto* z = &points.z[index];
+        if(z[0] > camera.far && z[1] > camera.far && z[2] > camera.far) continue;
+
+        // Most triangles are wholly in front of the near plane, already projected and needing no clipping
+        std::array<Vertex, 4> polygon;
+        std::size_t count = 3;
+        if(z[0] >= camera.near && z[1] >= camera.near && z[2] >= camera.near) {
+          for(std::size_t i = 0; i < 3; ++i) {
+            // Only clipping uses x and y
+            polygon[i] = Vertex{ 0, 0, z[i], screen.x[index + i], screen.y[index + i], screen.z[index + i] };
+          }
+        } else {
+          if(z[0] < camera.near && z[1] < camera.near && z[2] < camera.near) continue;
+
+          std::array<Vertex, 3> corners;
+          for(std::size_t i = 0; i < 3; ++i) {
+            const auto x = points.x[index + i], y = points.y[index + i];
+            corners[i] = (z[i] >= camera.near) ? project(camera, x, y, z[i]) : Vertex{ x, y, z[i], 0, 0, 0 };
+          }
+          count = clip(camera, corners, polygon);
+        }
+
+        // Split the clipped polygon into a fan of triangles
+        for(std::size_t fan = 1; fan + 1 < count; ++fan) {
+          const auto& p0 = polygon[0], & p1 = polygon[fan], & p2 = polygon[fan + 1];
+
+          // The pixels whose centers the triangle's bounds cover; many small triangles cover none
+          int32_t minX, maxX, minY, maxY;
+          span(std::min({ p0.sx, p1.sx, p2.sx }), std::max({ p0.sx, p1.sx, p2.sx }), camera.width, minX, maxX);
+          if(minX > maxX) continue;
+          span(std::min({ p0.sy, p1.sy, p2.sy }), std::max({ p0.sy, p1.sy, p2.sy }), camera.height, minY, maxY);
+          if(minY > maxY) continue;
+
+          Setup setup;
+          // Edge i is opposite vertex i
+          const std::array<const Vertex*, 3> v = {{ &p0, &p1, &p2 }};
+          for(std::size_t i = 0; i < 3; ++i) {
+            const auto& a = *v[(i + 1) % 3], & b = *v[(i + 2) % 3];
+            setup.a[i] = a.sy - b.sy;
+            setup.b[i] = b.sx - a.sx;
+            setup.c[i] = a.sx * b.sy - a.sy * b.sx;
+          }
+
+          // Both sides are drawn, so orient the edges to be positive inside. Edge 0 at vertex 0 is twice the area.
+          const auto area = setup.a[0] * p0.sx + setup.b[0] * p0.sy + setup.c[0];
+          if(!(std::abs(area) > 0)) continue;
+          if(area < 0) {
+            for(std::size_t i = 0; i < 3; ++i) {
+              setup.a[i] = -setup.a[i];
+              setup.b[i] = -setup.b[i];
+              setup.c[i] = -setup.c[i];
+            }
+          }
+
+          // Barycentric weights are the edge functions over the area
+          const auto scale = 1 / std::abs(area);
+          setup.wa = (setup.a[0] * p0.w + setup.a[1] * p1.w + setup.a[2] * p2.w) * scale;
+          setup.wb = (setup.b[0] * p0.w + setup.b[1] * p1.w + setup.b[2] * p2.w) * scale;
+          setup.wc = (setup.c[0] * p0.w + setup.c[1] * p1.w + setup.c[2] * p2.w) * scale;
+          setup.nearest = std::max({ p0.w, p1.w, p2.w });
+
+          setup.minX = minX;
+          setup.minY = minY;
+          setup.maxX = maxX;
+          setup.maxY = maxY;
+          setup.triangle = static_cast<uint32_t>(triangle);
+
+          const auto id = static_cast<uint32_t>(setups.size());
+          setups.push_back(setup);
+          for(auto ty = std::size_t(setup.minY) / TILE; ty <= std::size_t(setup.maxY) / TILE; ++ty) {
+            for(auto tx = std::size_t(setup.minX) / TILE; tx <= std::size_t(setup.maxX) / TILE; ++tx) {
+              bins[ty * tilesX + tx].push_back(id);
+            }
+          }
+        }
+      }
+    }
+  });
+
+  image.width = camera.width;
+  image.height = camera.height;
+  image.depth.resize(camera.width * camera.height);
+  image.links.resize(camera.width * camera.height);
+  this->ids.resize(camera.width * camera.height);
+
+  const auto rasterize = blockKernel();
+  const auto background = (camera.far < INF) ? 1 / camera.far : 0;
+
+  parallel_for(tiles, [&](std::size_t first, std::size_t last) {
+    Tile tile;
+    for(auto t = first; t < last; ++t) {
+      const auto originX = (t % tilesX) * TILE, originY = (t / tilesX) * TILE;
+      const auto width = std::min(TILE, camera.width - originX), height = std::min(TILE, camera.height - originY);
+
+      // Most tiles of a robot seen whole are empty: fill their pixels in directly
+      bool empty = true;
+      for(std::size_t worker = 0; worker < workers; ++worker) empty = empty && this->bins[worker][t].empty();
+      if(empty) {
+        for(std::size_t y = 0; y < height; ++y) {
+          const auto pixel = (originY + y) * camera.width + originX;
+          std::fill_n(this->ids.begin() + pixel, width, NOTHING);
+          std::fill_n(image.depth.begin() + pixel, width, INF);
+          std::fill_n(image.links.begin() + pixel, width, DepthImage::NO_LINK);
+        }
+        continue;
+      }
+
+      tile.w.fill(background);
+      tile.ids.fill(NOTHING);
+      tile.farthest.fill(background);
+      tile.covered.fill(0);
+
+      // Workers' bins in turn, so the result does not depend on timing
+      for(std::size_t worker = 0; worker < workers; ++worker) {
+        for(const auto id : this->bins[worker][t]) {
+          const auto& setup = this->setups[worker][id];
+          const Real plane[3] = { setup.wa, setup.wb, setup.wc };
+
+          const auto x0 = std::max<int32_t>(setup.minX, int32_t(originX)) - int32_t(originX);
+          const auto x1 = std::min<int32_t>(setup.maxX, int32_t(originX + TILE - 1)) - int32_t(originX);
+          const auto y0 = std::max<int32_t>(setup.minY, int32_t(originY)) - int32_t(originY);
+          const auto y1 = std::min<int32_t>(setup.maxY, int32_t(originY + TILE - 1)) - int32_t(originY);
+
+          for(auto by = std::size_t(y0) / BLOCK; by <= std::size_t(y1) / BLOCK; ++by) {
+            for(auto bx = std::size_t(x0) / BLOCK; bx <= std::size_t(x1) / BLOCK; ++bx) {
+              // Skip blocks already covered by nearer surfaces than any of the triangle
+              auto& farthest = tile.farthest[by * BLOCKS + bx];
+              if(setup.nearest <= farthest) continue;
+
+              const auto rowBegin = std::max(by * BLOCK, std::size_t(y0)), rowEnd = std::min(by * BLOCK + BLOCK - 1, std::size_t(y1));
+              const auto offset = rowBegin * TILE + bx * BLOCK;
+              const auto written = rasterize(
+                setup.a, setup.b, setup.c, plane, setup.triangle,
+                Real(originX + bx * BLOCK), Real(originY + rowBegin), rowEnd - rowBegin + 1, &tile.w[offset], &tile.ids[offset]
+              ) << (BLOCK * (rowBegin - by * BLOCK));
+
+              auto& covered = tile.covered[by * BLOCKS + bx];
+              covered |= written;
+              if(written != 0 && covered == UINT64_MAX) {
+                auto block = INF;
+                for(std::size_t y = 0; y < BLOCK; ++y) {
+                  const auto* w = &tile.w[(by * BLOCK + y) * TILE + bx * BLOCK];
+                  for(std::size_t x = 0; x < BLOCK; ++x) block = std::min(block, w[x]);
+                }
+                farthest = block;
+              }
+            }
+          }
+        }
+      }
+
+      // Copy the tile's pixels within the image out
+      for(std::size_t y = 0; y < height; ++y) {
+        for(std::size_t x = 0; x < width; ++x) {
+          const auto pixel = (originY + y) * camera.width + originX + x;
+          const auto id = tile.ids[y * TILE + x];
+          this->ids[pixel] = id;
+          image.depth[pixel] = (id == NOTHING) ? INF : 1 / tile.w[y * TILE + x];
+          image.links[pixel] = (id == NOTHING) ? DepthImage::NO_LINK : this->owners[id];
+        }
+      }
+    }
+  });
+
+  if(!normals) {
+    image.normals.resize(0);
+    return;
+  }
+
+  image.normals.resize(image.depth.size());
+  const auto eye = camera.pose.translation();
+  parallel_for(image.depth.size(), [&](std::size_t begin, std::size_t end) {
+    std::fill(image.normals.x.begin() + begin, image.normals.x.begin() + end, Real(0));
+    std::fill(image.normals.y.begin() + begin, image.normals.y.begin() + end, Real(0));
+    std::fill(image.normals.z.begin() + begin, image.normals.z.begin() + end, Real(0));
+
+    for(auto pixel = begin; pixel < end; ++pixel) {
+      const auto id = this->ids[pixel];
+      if(id == NOTHING) continue;
+
+      const auto link = this->owners[id];
+      const auto triangle = id - this->firsts[link];
+      const auto& placement = this->placements[link];
+      auto normal = placement.rotate(links[link].normals[triangle]);
+
+      // Turn back faces towards the camera
+      if(normal * (placement(links[link].vertices[3 * triangle]) - eye) > 0) normal = Real(-1) * normal;
+      image.normals.set(pixel, normal);
+    }
+  });
+}
+
+}
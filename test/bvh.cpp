@@ -0,0 +1,176 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "meshes/box.hpp"
+
+#include "collision/bvh.hpp"
+#include "spatial/aabb.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/transform.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+
+#include <algorithm>
+#include <random>
+
+using rbt::AABB;
+using rbt::Real;
+using rbt::RigidMatrix;
+using rbt::Transform;
+using rbt::Triangle;
+using rbt::Vector3;
+using rbt::collision::BVH;
+
+namespace {
+
+// A "soup" of small random triangles inside a 100 unit cube.
+std::vector<Triangle> soup(std::size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<Real> position(0, 100);
+  std::uniform_real_distribution<Real> offset(-2, 2);
+
+  std::vector<Triangle> triangles;
+  for(std::size_t i = 0; i < count; ++i) {
+    const auto p = Vector3({ position(generator), position(generator), position(generator) });
+    triangles.push_back(Triangle({
+      p,
+      p + Vector3({ offset(generator), offset(generator), offset(generator) }),
+      p + Vector3({ offset(generator), offset(generator), offset(generator) })
+    }));
+  }
+
+  return triangles;
+}
+
+}
+
+TEST_CASE("BVH") {
+  const auto triangles = soup(5000, 42);
+  const auto bvh = BVH(triangles);
+
+  SECTION("nodes are 32 bytes") {
+    CHECK(sizeof(BVH::Node) == 32);
+  }
+
+  SECTION("references every triangle exactly once") {
+    std::vector<std::size_t> seen;
+    for(const auto& node : bvh.nodes()) {
+      if(!node.isLeaf()) continue;
+      CHECK(node.count <= BVH::MAX_LEAF_SIZE);
+      for(auto k = node.offset; k < node.offset + node.count; ++k) {
+        seen.push_back(bvh.originalIndex(k));
+      }
+    }
+
+    std::sort(seen.begin(), seen.end());
+    REQUIRE(seen.size() == triangles.size());
+    for(std::size_t i = 0; i < seen.size(); ++i) {
+      REQUIRE(seen[i] == i);
+    }
+  }
+
+  SECTION("overlap query matches brute force") {
+    const auto query = AABB(Vector3({20, 30, 40}), Vector3({45, 50, 60}));
+
+    auto result = bvh.overlapping(query);
+    std::sort(result.begin(), result.end());
+
+    std::vector<std::size_t> expected;
+    for(std::size_t i = 0; i < triangles.size(); ++i) {
+      if(overlaps(bounds(triangles[i]), query)) expected.push_back(i);
+    }
+
+    CHECK(result == expected);
+  }
+
+  SECTION("closest point matches brute force") {
+    for(const auto& p : { Vector3({50, 50, 50}), Vector3({-20, 10, 130}), Vector3({99, 1, 3}) }) {
+      const auto result = bvh.closest(p);
+
+      Real expected = rbt::INF;
+      for(const auto& triangle : triangles) {
+        expected = std::min(expected, length(closestPoint(triangle, p) - p));
+      }
+
+      CHECK(result.distance == Approx(expected));
+      CHECK(length(closestPoint(triangles[result.triangle], p) - p) == Approx(expected));
+    }
+  }
+
+  SECTION("closest point respects the maximum distance") {
+    const auto mesh = BVH(rbt::box(Vector3({0, 0, 0}), Vector3({1, 1, 1})));
+
+    CHECK(rbt::isInf(mesh.closest(Vector3({5, 0.5, 0.5}), 2).distance));
+    CHECK(mesh.closest(Vector3({5, 0.5, 0.5}), 5).distance == Approx(4));
+    CHECK_THAT(mesh.closest(Vector3({5, 0.5, 0.5})).point, ComponentsEqual(Vector3({1, 0.5, 0.5})));
+  }
+
+  SECTION("triangle intersection") {
+    const auto mesh = BVH(rbt::box(Vector3({0, 0, 0}), Vector3({1, 1, 1})));
+
+    const auto piercing = Triangle({ Vector3({0.5, 0.5, -1}), Vector3({0.6, 0.5, 2}), Vector3({0.5, 0.6, 2}) });
+    const auto inside = Triangle({ Vector3({0.2, 0.2, 0.5}), Vector3({0.8, 0.2, 0.5}), Vector3({0.2, 0.8, 0.5}) });
+
+    CHECK(mesh.intersects(piercing));
+    CHECK_FALSE(mesh.intersects(inside));
+  }
+
+  SECTION("refit follows moved vertices") {
+    const auto offset = Vector3({200, 0, 0});
+
+    std::vector<Triangle> moved;
+    for(const auto& triangle : triangles) {
+      moved.push_back(Triangle({ triangle[0] + offset, triangle[1] + offset, triangle[2] + offset }));
+    }
+
+    auto refitted = bvh;
+    refitted.refit(moved);
+
+    CHECK_THAT(refitted.bounds().min, ComponentsEqual(bvh.bounds().min + offset));
+    CHECK_THAT(refitted.bounds().max, ComponentsEqual(bvh.bounds().max + offset));
+
+    const auto p = Vector3({250, 50, 50});
+    CHECK(refitted.closest(p).distance == Approx(bvh.closest(p - offset).distance));
+  }
+
+  SECTION("parallel and serial builds agree") {
+    const auto large = soup(4 * BVH::PARALLEL_THRESHOLD, 7);
+    const auto tree = BVH(large);
+
+    const auto p = Vector3({10, 20, 30});
+    Real expected = rbt::INF;
+    for(const auto& triangle : large) {
+      expected = std::min(expected, length(closestPoint(triangle, p) - p));
+    }
+
+    CHECK(tree.closest(p).distance == Approx(expected));
+  }
+
+  SECTION("intersects another hierarchy") {
+    const auto unit = BVH(rbt::box(Vector3({0, 0, 0}), Vector3({1, 1, 1})));
+    const auto diagonal = rbt::unit(Vector3({1, 1, 1}));
+
+    const auto placement = [&](const Vector3& translation) {
+      return RigidMatrix(Transform(diagonal, rbt::toRadians(45), translation).dual);
+    };
+
+    CHECK(intersects(unit, unit, placement(Vector3({0.5, 0.5, 0.5}))));
+    CHECK_FALSE(intersects(unit, unit, placement(Vector3({3, 0, 0}))));
+
+    // Faces pass through each other even though no vertex of one box is inside the other
+    CHECK(intersects(unit, unit, RigidMatrix(Transform(Vector3({0, 0, 1}), rbt::toRadians(45), Vector3({0.5, -0.2, 0})).dual)));
+
+    // A small box wholly inside the other has no intersecting triangles
+    const auto small = BVH(rbt::box(Vector3({0.4, 0.4, 0.4}), Vector3({0.6, 0.6, 0.6})));
+    CHECK_FALSE(intersects(unit, small, RigidMatrix()));
+  }
+}
+
+TEST_CASE("Oriented box overlap") {
+  const auto a = AABB(Vector3({0, 0, 0}), Vector3({2, 2, 2}));
+  const auto b = AABB(Vector3({-1, -1, -1}), Vector3({1, 1, 1}));
+  const auto rotation = Vector3({0, 0, 1});
+
+  CHECK(overlaps(a, b, RigidMatrix(Transform(rotation, rbt::toRadians(45), Vector3({3.3, 1, 1})).dual)));
+  CHECK_FALSE(overlaps(a, b, RigidMatrix(Transform(rotation, rbt::toRadians(45), Vector3({3.5, 1, 1})).dual)));
+  CHECK_FALSE(overlaps(a, b, RigidMatrix(Transform(rotation, 0, Vector3({3.1, 1, 1})).dual)));
+}
@@ -0,0 +1,171 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "meshes/box.hpp"
+
+#include "joint.hpp"
+#include "serial.hpp"
+#include "collision/capsule.hpp"
+#include "collision/self_distance.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/vector.hpp"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using rbt::Joint;
+using rbt::Mesh;
+using rbt::Real;
+using rbt::Serial;
+using rbt::Vector3;
+using rbt::box;
+using rbt::toRadians;
+using rbt::collision::Capsule;
+using rbt::collision::CapsuleLanes;
+using rbt::collision::SelfDistance;
+using rbt::collision::fitCapsule;
+
+TEST_CASE("Capsule") {
+  SECTION("distance") {
+    const auto first = Capsule(Vector3({0, 0, 0}), Vector3({10, 0, 0}), 1);
+
+    SECTION("between crossing segments") {
+      const auto second = Capsule(Vector3({5, -5, 4}), Vector3({5, 5, 4}), 0.5);
+      CHECK(distance(first, second) == Approx(2.5));
+    }
+
+    SECTION("between parallel segments") {
+      const auto second = Capsule(Vector3({4, 3, 0}), Vector3({20, 3, 0}), 1);
+      CHECK(distance(first, second) == Approx(1));
+    }
+
+    SECTION("between endpoints") {
+      const auto second = Capsule(Vector3({13, 4, 0}), Vector3({20, 10, 0}), 1);
+      CHECK(distance(first, second) == Approx(3));
+    }
+
+    SECTION("to a sphere") {
+      const auto sphere = Capsule(Vector3({-3, 4, 0}), Vector3({-3, 4, 0}), 2);
+      CHECK(distance(first, sphere) == Approx(2));
+      CHECK(distance(sphere, first) == Approx(2));
+    }
+
+    SECTION("is negative when overlapping") {
+      const auto second = Capsule(Vector3({5, 0, 1}), Vector3({5, 0, 8}), 1);
+      CHECK(distance(first, second) == Approx(-1));
+    }
+
+    SECTION("batched lanes match single queries") {
+      CapsuleLanes p, q;
+      std::vector<Capsule> others;
+      for(std::size_t lane = 0; lane < CapsuleLanes::WIDTH; ++lane) {
+        const Real offset = static_cast<Real>(lane);
+        others.push_back(Capsule(Vector3({offset, 3, -offset}), Vector3({2 * offset, -4, 1}), 0.25));
+        p.set(lane, first);
+        q.set(lane, others.back());
+      }
+
+      std::array<Real, CapsuleLanes::WIDTH> result;
+      distances(p, q, result);
+
+      for(std::size_t lane = 0; lane < CapsuleLanes::WIDTH; ++lane) {
+        CHECK(result[lane] == Approx(distance(first, others[lane])));
+      }
+    }
+  }
+
+  SECTION("fitting") {
+    const auto mesh = box(Vector3({-95, -5, -5}), Vector3({-5, 5, 5}));
+    const auto capsule = fitCapsule(mesh);
+
+    SECTION("encloses every vertex") {
+      for(const auto& triangle : mesh) {
+        for(std::size_t i = 0; i < 3; ++i) {
+          const auto point = Capsule(triangle[i], triangle[i], 0);
+          CHECK(distance(capsule, point) <= 1e-4);
+        }
+      }
+    }
+
+    SECTION("is tight around a long box") {
+      CHECK(capsule.radius == Approx(5 * std::sqrt(2)));
+      CHECK(length(capsule.b - capsule.a) == Approx(90).margin(0.1));
+      CHECK(std::abs(capsule.a[0] + capsule.b[0]) == Approx(100));
+    }
+
+    SECTION("is no larger than the bounding sphere of a cube") {
+      const auto cube = fitCapsule(box(Vector3({0, 0, 0}), Vector3({2, 2, 2})));
+      const auto r = cube.radius;
+      const auto volume = rbt::PI * r * r * (length(cube.b - cube.a) + 4 * r / 3);
+
+      CHECK(volume <= Approx(4 * rbt::PI * std::pow(std::sqrt(3), 3) / 3).epsilon(0.001));
+    }
+  }
+}
+
+TEST_CASE("SelfDistance") {
+  const auto robot = Serial({
+    Joint(0, 100, 0, 0),
+    Joint(0, 100, 0, 0),
+    Joint(0, 100, 0, 0)
+  });
+
+  const auto link = box(Vector3({-95, -5, -5}), Vector3({-5, 5, 5}));
+  const auto meshes = std::vector<Mesh>({ Mesh(), link, link, link });
+  const auto proxies = SelfDistance(robot, meshes);
+
+  SECTION("checks non-adjacent links with geometry") {
+    CHECK(proxies.pairs().size() == 1);
+  }
+
+  SECTION("measures clearance of a straight arm") {
+    CHECK(proxies.distance({ 0, 0, 0 }) == Approx(110 - 10 * std::sqrt(2)).margin(0.1));
+  }
+
+  SECTION("is negative for a folded arm") {
+    CHECK(proxies.distance({ 0, toRadians(170), toRadians(170) }) < 0);
+  }
+
+  SECTION("places capsules at the link poses") {
+    const rbt::Angles angles = { toRadians(20), toRadians(-50), toRadians(80) };
+    const auto frames = robot.linkPoses(angles);
+    const auto posed = proxies.posed(angles);
+
+    REQUIRE(posed.size() == frames.size());
+    for(std::size_t link = 0; link < posed.size(); ++link) {
+      const auto expected = rbt::collision::transform(proxies.capsules()[link], rbt::RigidMatrix(frames[link]));
+      CHECK(rbt::length(posed[link].a - expected.a) < 1e-3);
+      CHECK(rbt::length(posed[link].b - expected.b) < 1e-3);
+    }
+  }
+
+  SECTION("answers queries from several threads at once") {
+    std::vector<rbt::Angles> configurations;
+    for(std::size_t i = 0; i < 64; ++i) {
+      const auto angle = toRadians(Real(i) * 5);
+      configurations.push_back({ angle, 2 * angle, -angle });
+    }
+
+    std::vector<Real> expected;
+    for(const auto& angles : configurations) expected.push_back(proxies.distance(angles));
+
+    std::vector<std::vector<Real>> results(4, std::vector<Real>(configurations.size()));
+    std::vector<std::thread> threads;
+    for(std::size_t t = 0; t < results.size(); ++t) {
+      threads.emplace_back([&, t]() {
+        SelfDistance::Scratch scratch;
+        for(std::size_t repeat = 0; repeat < 50; ++repeat) {
+          for(std::size_t i = 0; i < configurations.size(); ++i) results[t][i] = proxies.distance(configurations[i], scratch);
+        }
+      });
+    }
+    for(auto& thread : threads) thread.join();
+
+    for(const auto& result : results) CHECK(result == expected);
+  }
+
+  SECTION("is INF without anything to check") {
+    const auto empty = SelfDistance(robot, std::vector<Mesh>({ Mesh(), link, Mesh(), Mesh() }));
+    CHECK(rbt::isInf(empty.distance({ 0, 0, 0 })));
+  }
+}
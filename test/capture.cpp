@@ -0,0 +1,140 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "ik.hpp"
+#include "serial.hpp"
+#include "utilities.hpp"
+#include "utils/capture.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using rbt::Angles;
+using rbt::Frame;
+using rbt::toRadians;
+using rbt::capture::Request;
+
+TEST_CASE("Capture") {
+  const auto path = (std::filesystem::temp_directory_path() / "robot_capture_test.rbtw").string();
+  const auto& robot = rbt::ABB_IRB_120;
+  const auto angles = Angles({ toRadians(10), toRadians(20), toRadians(-30), toRadians(40), toRadians(50), toRadians(60) });
+  const auto pose = robot.pose(angles);
+
+  SECTION("records inverse and forward kinematics requests") {
+    rbt::capture::identify(robot, 7);
+    rbt::capture::start(path);
+    REQUIRE(rbt::capture::recording());
+
+    rbt::ik::angles(pose, robot);
+    robot.pose(angles);
+    rbt::capture::stop();
+    // Not recorded once stopped
+    robot.pose(angles);
+
+    const auto requests = rbt::capture::read(path);
+    // Not the forward kinematics ik::angles makes itself
+    REQUIRE(requests.size() == 2);
+
+    CHECK(requests[0].kind == Request::Kind::INVERSE);
+    CHECK(requests[0].robot == 7);
+    CHECK(requests[0].angles.empty());
+    CHECK_THAT(requests[0].pose.position(), ComponentsEqual(pose.position()));
+    CHECK(requests[0].pose.orientation() == pose.orientation());
+
+    CHECK(requests[1].kind == Request::Kind::FORWARD);
+    CHECK(requests[1].robot == 7);
+    CHECK(requests[1].angles == angles);
+  }
+
+  SECTION("tells robots apart by their parameters") {
+    rbt::capture::identify(robot, 7);
+    const auto copy = robot;
+    auto joints = robot.joints();
+    joints[0].d += 1;
+    const auto other = rbt::Serial(joints);
+
+    rbt::capture::start(path);
+    copy.pose(angles);
+    other.pose(angles);
+    rbt::capture::stop();
+
+    const auto requests = rbt::capture::read(path);
+    REQUIRE(requests.size() == 2);
+    CHECK(requests[0].robot == 7);
+    CHECK(requests[1].robot != 7);
+  }
+
+  SECTION("records the requests of every thread") {
+    const std::size_t count = 5000;
+    rbt::capture::start(path);
+    {
+      // Enough for each thread to write out batches along the way
+      std::vector<std::thread> threads;
+      for(int thread = 0; thread < 2; ++thread) {
+        threads.emplace_back([&]() { for(std::size_t i = 0; i < count; ++i) robot.pose(angles); });
+      }
+      for(auto& thread : threads) thread.join();
+    }
+    robot.pose(angles);
+    rbt::capture::stop();
+
+    const auto requests = rbt::capture::read(path);
+    REQUIRE(requests.size() == 2 * count + 1);
+    for(const auto& request : requests) REQUIRE(request.angles == angles);
+  }
+
+  SECTION("round trips requests") {
+    const auto requests = std::vector<Request>({
+      Request{ Request::Kind::INVERSE, 3, pose, Angles({ 1, 2 }) },
+      Request{ Request::Kind::FORWARD, 65535, Frame(), angles }
+    });
+    rbt::capture::write(path, requests);
+
+    const auto read = rbt::capture::read(path);
+    REQUIRE(read.size() == 2);
+    CHECK(read[0].robot == 3);
+    CHECK(read[0].angles == Angles({ 1, 2 }));
+    CHECK(read[0].pose.orientation() == pose.orientation());
+    CHECK(read[1].robot == 65535);
+    CHECK(read[1].angles == angles);
+
+    // Header, then a 4 byte record header, with 8 pose and 2 seed floats and 6 angle floats
+    std::ifstream file(path, std::ios::binary);
+    const auto bytes = std::vector<unsigned char>(std::istreambuf_iterator<char>(file), {});
+    REQUIRE(bytes.size() == 8 + (4 + 10 * 4) + (4 + 6 * 4));
+
+    // Little-endian: the version, the first record's header and its last seed angle (2.0f)
+    CHECK(std::vector<unsigned char>(bytes.begin() + 4, bytes.begin() + 12) ==
+      std::vector<unsigned char>({ 1, 0, 0, 0, 0, 2, 3, 0 }));
+    CHECK(std::vector<unsigned char>(bytes.begin() + 48, bytes.begin() + 52) ==
+      std::vector<unsigned char>({ 0x00, 0x00, 0x00, 0x40 }));
+    CHECK(bytes[52 + 2] == 0xff);
+    CHECK(bytes[52 + 3] == 0xff);
+  }
+
+  SECTION("rejects invalid files") {
+    {
+      std::ofstream file(path, std::ios::binary);
+      file << "not a capture";
+    }
+    CHECK_THROWS_AS(rbt::capture::read(path), std::runtime_error);
+
+    rbt::capture::write(path, { Request{ Request::Kind::FORWARD, 0, Frame(), angles } });
+    {
+      std::ofstream file(path, std::ios::binary | std::ios::app);
+      file.put(1);
+    }
+    CHECK_THROWS_AS(rbt::capture::read(path), std::runtime_error);
+
+    CHECK_THROWS_AS(rbt::capture::read("missing.rbtw"), std::runtime_error);
+  }
+
+  std::remove(path.c_str());
+}
@@ -0,0 +1,123 @@
+#include "third_party/catch.hpp"
+#include "meshes/box.hpp"
+
+#include "joint.hpp"
+#include "serial.hpp"
+#include "collision/continuous.hpp"
+#include "collision/self_distance.hpp"
+#include "spatial/vector.hpp"
+
+using rbt::Angles;
+using rbt::Joint;
+using rbt::Mesh;
+using rbt::Real;
+using rbt::Serial;
+using rbt::Vector3;
+using rbt::box;
+using rbt::toRadians;
+using rbt::collision::ContinuousSelfCollision;
+using rbt::collision::MotionBound;
+using rbt::collision::SelfDistance;
+
+namespace {
+
+const auto PLANAR = Serial({
+  Joint(0, 100, 0, 0),
+  Joint(0, 100, 0, 0),
+  Joint(0, 100, 0, 0)
+});
+
+Angles lerp(const Angles& a, const Angles& b, const Real& s) {
+  Angles result;
+  for(std::size_t j = 0; j < a.size(); ++j) {
+    result.push_back(a[j] + s * (b[j] - a[j]));
+  }
+  return result;
+}
+
+}
+
+TEST_CASE("MotionBound") {
+  const auto bound = MotionBound(PLANAR, { 0, 10, 20, 30 });
+
+  SECTION("sums the reach from each moving joint") {
+    CHECK(bound.displacement(3, { 0.1, 0, 0 }) == Approx(0.1 * 330));
+    CHECK(bound.displacement(3, { 0, 0, -0.1 }) == Approx(0.1 * 130));
+    CHECK(bound.displacement(2, { 0.1, 0.2, 0.3 }) == Approx(0.1 * 220 + 0.2 * 120));
+  }
+
+  SECTION("ignores joints that move both links rigidly") {
+    CHECK(bound.displacement(3, { 0.1, 0.2, 0.3 }, 2) == Approx(0.3 * 130));
+    CHECK(bound.displacement(3, { 0.1, 0.2, 0.3 }, 0) == bound.displacement(3, { 0.1, 0.2, 0.3 }));
+  }
+
+  SECTION("the base never moves") {
+    CHECK(bound.displacement(0, { 1, 1, 1 }) == 0);
+  }
+}
+
+TEST_CASE("ContinuousSelfCollision") {
+  const auto link = box(Vector3({-95, -5, -5}), Vector3({-5, 5, 5}));
+  const auto proxies = SelfDistance(PLANAR, std::vector<Mesh>({ Mesh(), link, link, link }));
+  const auto checker = ContinuousSelfCollision(proxies);
+
+  SECTION("passes a collision free motion") {
+    const auto result = checker.check({ 0, 0, 0 }, { toRadians(90), toRadians(-30), toRadians(30) });
+
+    CHECK_FALSE(result.collides);
+    CHECK(result.time == 1);
+  }
+
+  SECTION("finds a collision between collision free endpoints") {
+    const Angles start = { 0, toRadians(170), toRadians(10) };
+    const Angles end = { 0, toRadians(170), toRadians(300) };
+
+    REQUIRE(proxies.distance(start) > 0);
+    REQUIRE(proxies.distance(end) > 0);
+
+    SECTION("by bisection") {
+      const auto result = checker.check(start, end);
+
+      CHECK(result.collides);
+      CHECK(proxies.distance(lerp(start, end, result.time)) <= 0.01);
+    }
+
+    SECTION("by conservative advancement, stopping at the first contact") {
+      const auto result = checker.firstContact(start, end);
+
+      CHECK(result.collides);
+      CHECK(proxies.distance(lerp(start, end, result.time)) <= 0.01);
+
+      for(Real s = 0; s < result.time; s += result.time / 50) {
+        CHECK(proxies.distance(lerp(start, end, s)) > 0);
+      }
+    }
+  }
+
+  SECTION("finds a brief contact that sampling the endpoints and midpoint misses") {
+    // Only the tip of the last link has geometry, which grazes the end of the first link as it swings past
+    const auto tip = box(Vector3({-15, -5, -5}), Vector3({-5, 5, 5}));
+    const auto grazing = SelfDistance(PLANAR, std::vector<Mesh>({ Mesh(), link, link, tip }));
+
+    const Angles start = { 0, toRadians(90), toRadians(150) };
+    const Angles end = { 0, toRadians(90), toRadians(350) };
+
+    REQUIRE(grazing.distance(start) > 0);
+    REQUIRE(grazing.distance(lerp(start, end, 0.5)) > 0);
+    REQUIRE(grazing.distance(end) > 0);
+
+    const auto result = ContinuousSelfCollision(grazing).check(start, end);
+    CHECK(result.collides);
+    CHECK(result.time < 0.5);
+    CHECK(ContinuousSelfCollision(grazing).firstContact(start, end).collides);
+  }
+
+  SECTION("takes few steps far from contact") {
+    const Angles start = { 0, 0, 0 };
+    const Angles end = { 0, toRadians(10), 0 };
+
+    CHECK(checker.firstContact(start, end).steps == 1);
+    CHECK(checker.check(start, end).steps == 2);
+    CHECK_FALSE(checker.check(start, end).collides);
+  }
+}
@@ -0,0 +1,120 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "meshes/box.hpp"
+
+#include "collision/convex_hull.hpp"
+#include "spatial/vector.hpp"
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+using rbt::Real;
+using rbt::Vector3;
+using rbt::collision::ConvexHull;
+
+namespace {
+
+std::vector<Vector3> randomPoints(std::size_t count, unsigned int seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<Real> position(-100, 100);
+
+  std::vector<Vector3> points;
+  while(points.size() < count) {
+    const auto p = Vector3({ position(generator), position(generator), position(generator) });
+    if(rbt::length(p) <= 100) points.push_back(p);
+  }
+  return points;
+}
+
+// Every point is inside, every vertex is one of the points, and the faces close up into a sphere-like surface.
+void checkHull(const ConvexHull& hull, const std::vector<Vector3>& points) {
+  for(const auto& point : points) {
+    REQUIRE(hull.contains(point, 1e-3));
+  }
+
+  for(const auto& vertex : hull.vertices()) {
+    REQUIRE(std::find(points.begin(), points.end(), vertex) != points.end());
+  }
+
+  // Each edge is shared by exactly two faces, in opposite directions
+  std::map<std::pair<uint32_t, uint32_t>, int> edges;
+  for(const auto& face : hull.faces()) {
+    for(std::size_t e = 0; e < 3; ++e) {
+      ++edges[{ face[e], face[(e + 1) % 3] }];
+    }
+  }
+  for(const auto& edge : edges) {
+    REQUIRE(edge.second == 1);
+    REQUIRE(edges.count({ edge.first.second, edge.first.first }) == 1);
+  }
+
+  const auto vertices = static_cast<int>(hull.vertices().size());
+  const auto faces = static_cast<int>(hull.faces().size());
+  CHECK(vertices - static_cast<int>(edges.size()) / 2 + faces == 2);
+
+  for(const auto& direction : { Vector3({1, 0, 0}), Vector3({0.3, -0.5, 0.8}), Vector3({-1, -1, -1}) }) {
+    Real best = -rbt::INF;
+    for(const auto& point : points) {
+      best = std::max(best, point * direction);
+    }
+    CHECK(hull.support(direction) * direction == Approx(best));
+  }
+}
+
+}
+
+TEST_CASE("ConvexHull") {
+  SECTION("of a box mesh") {
+    const auto mesh = rbt::box(Vector3({0, 0, 0}), Vector3({1, 2, 3}));
+    const auto hull = ConvexHull(mesh);
+
+    CHECK(hull.vertices().size() == 8);
+    CHECK(hull.faces().size() == 12);
+    CHECK(hull.planes().size() == 6);
+    CHECK(hull.contains(Vector3({0.5, 1, 1.5})));
+    CHECK_FALSE(hull.contains(Vector3({0.5, 1, 3.1})));
+
+    for(const auto& plane : hull.planes()) {
+      CHECK(rbt::length(plane.normal) == Approx(1));
+    }
+  }
+
+  SECTION("ignores points on the faces") {
+    std::vector<Vector3> grid;
+    for(int i = 0; i <= 4; ++i) {
+      for(int j = 0; j <= 4; ++j) {
+        for(int k = 0; k <= 4; ++k) {
+          grid.push_back(Vector3({ Real(i), Real(j), Real(k) }));
+        }
+      }
+    }
+
+    const auto hull = ConvexHull(grid);
+    CHECK(hull.vertices().size() == 8);
+    CHECK(hull.planes().size() == 6);
+    checkHull(hull, grid);
+  }
+
+  SECTION("of random points") {
+    const auto points = randomPoints(2000, 1);
+    checkHull(ConvexHull(points), points);
+  }
+
+  SECTION("of many points") {
+    const auto points = randomPoints(ConvexHull::PARALLEL_THRESHOLD + 5000, 2);
+    checkHull(ConvexHull(points), points);
+  }
+
+  SECTION("of flat points") {
+    const std::vector<Vector3> square = {
+      Vector3({0, 0, 0}), Vector3({1, 0, 0}), Vector3({0, 1, 0}), Vector3({1, 1, 0}), Vector3({0, 0, 0})
+    };
+    const auto hull = ConvexHull(square);
+
+    CHECK(hull.vertices().size() == 4);
+    CHECK(hull.faces().empty());
+    CHECK_FALSE(hull.contains(Vector3({0.5, 0.5, 0})));
+    CHECK_THAT(hull.support(Vector3({1, 1, 0})), ComponentsEqual(Vector3({1, 1, 0})));
+  }
+}
@@ -0,0 +1,131 @@
+#include "third_party/catch.hpp"
+#include "meshes/box.hpp"
+#include "meshes/sphere.hpp"
+
+#include "mesh/decimation.hpp"
+#include "mesh/indexed_mesh.hpp"
+#include "spatial/vector.hpp"
+
+#include <algorithm>
+#include <map>
+
+using rbt::Real;
+using rbt::Vector3;
+using rbt::mesh::IndexedMesh;
+using rbt::mesh::boundaryEdges;
+using rbt::mesh::decimate;
+using rbt::mesh::weld;
+
+namespace {
+
+// A square in z = 0 split into cells x cells pairs of triangles, facing +z.
+IndexedMesh grid(int cells) {
+  IndexedMesh result;
+  for(int j = 0; j <= cells; ++j) {
+    for(int i = 0; i <= cells; ++i) result.vertices.push_back(Vector3({ Real(i), Real(j), 0 }));
+  }
+
+  const auto index = [cells](int i, int j) { return static_cast<uint32_t>(j * (cells + 1) + i); };
+  for(int j = 0; j < cells; ++j) {
+    for(int i = 0; i < cells; ++i) {
+      result.triangles.push_back({{ index(i, j), index(i + 1, j), index(i + 1, j + 1) }});
+      result.triangles.push_back({{ index(i, j), index(i + 1, j + 1), index(i, j + 1) }});
+    }
+  }
+  return result;
+}
+
+// True if every edge is shared by exactly two triangles, once in each direction.
+bool closed(const IndexedMesh& mesh) {
+  std::map<std::pair<uint32_t, uint32_t>, int> edges;
+  for(const auto& triangle : mesh.triangles) {
+    for(std::size_t e = 0; e < 3; ++e) ++edges[{ triangle[e], triangle[(e + 1) % 3] }];
+  }
+  return std::all_of(edges.begin(), edges.end(), [&edges](const auto& edge) {
+    const auto reverse = edges.find({ edge.first.second, edge.first.first });
+    return edge.second == 1 && reverse != edges.end() && reverse->second == 1;
+  });
+}
+
+}
+
+TEST_CASE("Decimation") {
+  SECTION("reduces a sphere to the target while keeping it closed") {
+    const auto sphere = weld(rbt::sphere(Vector3({1, 2, 3}), 10, 24, 48));
+    const auto target = sphere.triangles.size() / 8;
+    const auto result = decimate(sphere, target);
+
+    CHECK(result.triangles.size() <= target);
+    CHECK(result.triangles.size() >= target - 2);
+    CHECK(closed(result));
+    for(const auto& v : result.vertices) CHECK(rbt::length(v - Vector3({1, 2, 3})) == Approx(10).margin(0.5));
+  }
+
+  SECTION("collapses flat faces exactly") {
+    // A box whose faces are finely split: only the corners matter
+    IndexedMesh box;
+    for(int axis = 0; axis < 3; ++axis) {
+      for(const Real side : { Real(-1), Real(1) }) {
+        auto face = grid(6);
+        const auto offset = static_cast<uint32_t>(box.vertices.size());
+        for(const auto& v : face.vertices) {
+          // Map the grid onto the face, keeping it outward facing
+          Vector3 p;
+          p[axis] = side;
+          p[(axis + 1) % 3] = v[side > 0 ? 0 : 1] / 3 - 1;
+          p[(axis + 2) % 3] = v[side > 0 ? 1 : 0] / 3 - 1;
+          box.vertices.push_back(p);
+        }
+        for(const auto& triangle : face.triangles) box.triangles.push_back({{ offset + triangle[0], offset + triangle[1], offset + triangle[2] }});
+      }
+    }
+    box = weld(rbt::mesh::triangles(box));
+    REQUIRE(closed(box));
+
+    const auto result = decimate(box, 12, 1e-3);
+    CHECK(result.triangles.size() == 12);
+    CHECK(result.vertices.size() == 8);
+    for(const auto& v : result.vertices) {
+      for(std::size_t i = 0; i < 3; ++i) CHECK(std::abs(v[i]) == Approx(1));
+    }
+  }
+
+  SECTION("stops at the error bound") {
+    const auto sphere = weld(rbt::sphere(Vector3({0, 0, 0}), 10, 24, 48));
+    const auto coarse = decimate(sphere, 0, 0.5);
+    const auto fine = decimate(sphere, 0, 0.05);
+
+    CHECK(coarse.triangles.size() < fine.triangles.size());
+    CHECK(fine.triangles.size() < sphere.triangles.size());
+    for(const auto& v : fine.vertices) CHECK(rbt::length(v) == Approx(10).margin(0.1));
+  }
+
+  SECTION("keeps boundaries in place") {
+    const auto square = grid(10);
+    const auto result = decimate(square, 0);
+
+    const auto boundary = [](const Vector3& v) { return v[0] == 0 || v[0] == 10 || v[1] == 0 || v[1] == 10; };
+    CHECK(result.triangles.size() < square.triangles.size() / 4);
+    CHECK(static_cast<std::size_t>(std::count_if(result.vertices.begin(), result.vertices.end(), boundary)) == 40);
+    CHECK(boundaryEdges(result).size() == 40);
+    for(const auto& v : result.vertices) CHECK(v[2] == Approx(0));
+
+    // Every triangle still faces +z
+    for(const auto& triangle : result.triangles) {
+      const auto n = rbt::cross(result.vertices[triangle[1]] - result.vertices[triangle[0]], result.vertices[triangle[2]] - result.vertices[triangle[0]]);
+      CHECK(n[2] > 0);
+    }
+  }
+
+  SECTION("builds levels of detail") {
+    const auto sphere = weld(rbt::sphere(Vector3({0, 0, 0}), 1, 16, 32));
+    const auto levels = rbt::mesh::levelsOfDetail(sphere, 4, 0.25);
+
+    REQUIRE(levels.size() == 4);
+    CHECK(levels[0].triangles.size() == sphere.triangles.size());
+    for(std::size_t i = 1; i < levels.size(); ++i) {
+      CHECK(levels[i].triangles.size() <= levels[i - 1].triangles.size() / 4);
+      CHECK(closed(levels[i]));
+    }
+  }
+}
@@ -0,0 +1,139 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "meshes/box.hpp"
+
+#include "collision/bvh.hpp"
+#include "collision/distance_field.hpp"
+#include "spatial/vector.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+using rbt::Real;
+using rbt::Vector3;
+using rbt::collision::BVH;
+using rbt::collision::DistanceField;
+
+namespace {
+
+// Signed distance to the box [0, 10]^3.
+Real boxDistance(const Vector3& p) {
+  Real outside = 0;
+  Real inside = -rbt::INF;
+  for(std::size_t axis = 0; axis < 3; ++axis) {
+    const auto d = std::max(-p[axis], p[axis] - 10);
+    outside += std::max(d, Real(0)) * std::max(d, Real(0));
+    inside = std::max(inside, d);
+  }
+  return (inside > 0) ? std::sqrt(outside) : inside;
+}
+
+}
+
+TEST_CASE("DistanceField") {
+  const auto mesh = rbt::box(Vector3({0, 0, 0}), Vector3({10, 10, 10}));
+  const Real voxel = 1;
+  const auto field = DistanceField(mesh, voxel, 3);
+
+  SECTION("covers the padded mesh bounds in whole bricks") {
+    for(std::size_t axis = 0; axis < 3; ++axis) {
+      CHECK(field.samples()[axis] % DistanceField::BRICK_SIZE == 0);
+      CHECK(field.bounds().min[axis] <= -3);
+      CHECK(field.bounds().max[axis] >= 13);
+    }
+    CHECK(field.denseBricks() == field.bricks());
+  }
+
+  SECTION("samples are the exact signed distance") {
+    for(std::size_t k = 0; k < 17; ++k) {
+      for(std::size_t j = 0; j < 17; ++j) {
+        for(std::size_t i = 0; i < 17; ++i) {
+          const auto p = field.origin() + Vector3({ Real(i), Real(j), Real(k) }) * voxel;
+          REQUIRE(field.at(i, j, k) == Approx(boxDistance(p)).margin(1e-4));
+        }
+      }
+    }
+  }
+
+  SECTION("interpolates between samples") {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<Real> position(-2.5, 12.5);
+
+    const auto bvh = BVH(mesh);
+    for(int n = 0; n < 200; ++n) {
+      const auto p = Vector3({ position(generator), position(generator), position(generator) });
+      const auto d = field.distance(p);
+
+      CHECK(d == Approx(boxDistance(p)).margin(voxel));
+      CHECK(std::abs(d) == Approx(bvh.closest(p).distance).margin(voxel));
+    }
+  }
+
+  SECTION("gradients point away from the surface") {
+    CHECK_THAT(field.gradient(Vector3({ 12.2, 5.3, 5.4 })), ComponentsEqual(Vector3({ 1, 0, 0 })));
+    CHECK_THAT(field.gradient(Vector3({ 5.3, -1.6, 5.4 })), ComponentsEqual(Vector3({ 0, -1, 0 })));
+    CHECK_THAT(field.gradient(Vector3({ 5.3, 4.4, 1.6 })), ComponentsEqual(Vector3({ 0, 0, -1 })));
+  }
+
+  SECTION("continues past the grid") {
+    const auto p = Vector3({ 5, 5, 40 });
+    CHECK(field.distance(p) == Approx(30).margin(1e-3));
+    CHECK_THAT(field.gradient(p), ComponentsEqual(Vector3({ 0, 0, 1 })));
+  }
+
+  SECTION("collapses bricks beyond the band") {
+    const Real coarse = 2;
+    const auto sparse = DistanceField(rbt::box(Vector3({0, 0, 0}), Vector3({40, 40, 40})), coarse, 3, 4);
+    CHECK(sparse.denseBricks() < sparse.bricks());
+
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<Real> position(-2.5, 42.5);
+
+    for(int n = 0; n < 200; ++n) {
+      const auto p = Vector3({ position(generator), position(generator), position(generator) });
+      const auto d = sparse.distance(p);
+      const auto exact = boxDistance(p / Real(4)) * 4;
+
+      // Near the surface nothing changes; farther away the clearance is never overstated
+      if(std::abs(exact) < 2) CHECK(d == Approx(exact).margin(coarse));
+      CHECK((d < 0) == (exact < 0));
+      CHECK(std::abs(d) <= std::abs(exact) + coarse);
+    }
+  }
+
+  SECTION("saves and maps files") {
+    const auto path = (std::filesystem::temp_directory_path() / "robot_distance_field_test.sdf").string();
+    DistanceField(mesh, voxel, 3, 2).save(path);
+
+    const auto loaded = DistanceField::load(path);
+    const auto original = DistanceField(mesh, voxel, 3, 2);
+
+    CHECK(loaded.samples() == original.samples());
+    CHECK(loaded.denseBricks() == original.denseBricks());
+    CHECK(loaded.voxelSize() == original.voxelSize());
+    CHECK_THAT(loaded.origin(), ComponentsEqual(original.origin()));
+
+    for(std::size_t k = 0; k < loaded.samples()[2]; ++k) {
+      for(std::size_t j = 0; j < loaded.samples()[1]; ++j) {
+        for(std::size_t i = 0; i < loaded.samples()[0]; ++i) {
+          REQUIRE(loaded.at(i, j, k) == original.at(i, j, k));
+        }
+      }
+    }
+
+    std::remove(path.c_str());
+  }
+
+  SECTION("rejects other files") {
+    const auto path = (std::filesystem::temp_directory_path() / "robot_distance_field_test.txt").string();
+    std::ofstream(path) << std::string(100, 'x');
+
+    CHECK_THROWS_AS(DistanceField::load(path), std::runtime_error);
+    CHECK_THROWS_AS(DistanceField::load(path + ".missing"), std::runtime_error);
+
+    std::remove(path.c_str());
+  }
+}
@@ -0,0 +1,135 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "meshes/box.hpp"
+
+#include "frame.hpp"
+#include "collision/capsule.hpp"
+#include "collision/convex_hull.hpp"
+#include "collision/gjk.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/transform.hpp"
+#include "spatial/vector.hpp"
+
+#include <random>
+
+using rbt::Real;
+using rbt::RigidMatrix;
+using rbt::Transform;
+using rbt::Vector3;
+using rbt::toRadians;
+using rbt::collision::Box;
+using rbt::collision::Capsule;
+using rbt::collision::ConvexHull;
+using rbt::collision::ConvexShape;
+using rbt::collision::Simplex;
+using rbt::collision::separation;
+
+namespace {
+
+RigidMatrix at(const Vector3& translation, const Vector3& axis = Vector3({0, 0, 1}), Real degrees = 0) {
+  return RigidMatrix(Transform(rbt::unit(axis), toRadians(degrees), translation));
+}
+
+}
+
+TEST_CASE("GJK") {
+  const auto cube = Box(Vector3({1, 1, 1}));
+
+  SECTION("measures the gap between separated boxes") {
+    const auto result = separation(ConvexShape(cube, at(Vector3({0, 0, 0}))), ConvexShape(cube, at(Vector3({5, 0.5, 0}))));
+
+    CHECK(result.distance == Approx(3));
+    CHECK_THAT(result.normal, ComponentsEqual(Vector3({1, 0, 0})));
+    CHECK(result.pointA[0] == Approx(1));
+    CHECK(result.pointB[0] == Approx(4));
+    CHECK(rbt::length(result.pointB - result.pointA) == Approx(3));
+  }
+
+  SECTION("measures the depth of overlapping boxes") {
+    const auto result = separation(ConvexShape(cube, at(Vector3({0, 0, 0}))), ConvexShape(cube, at(Vector3({0.2, 1.5, 0.1}))));
+
+    CHECK(result.distance == Approx(-0.5).margin(1e-4));
+    CHECK_THAT(result.normal, ComponentsEqual(Vector3({0, 1, 0})));
+  }
+
+  SECTION("places shapes by frames and transforms") {
+    const auto placement = Transform(rbt::unit(Vector3({1, 2, 3})), toRadians(30), Vector3({10, -4, 2}));
+
+    auto byTransform = ConvexShape(cube);
+    byTransform.place(placement);
+    auto byFrame = ConvexShape(cube);
+    byFrame.place(rbt::Frame(placement.dual));
+
+    const auto direction = Vector3({0.3, -0.2, 0.9});
+    CHECK_THAT(byTransform.support(direction), ComponentsEqual(ConvexShape(cube, RigidMatrix(placement)).support(direction)));
+    CHECK_THAT(byFrame.support(direction), ComponentsEqual(byTransform.support(direction)));
+  }
+
+  SECTION("agrees with the capsule distance") {
+    std::mt19937 generator(5);
+    std::uniform_real_distribution<Real> position(-10, 10);
+    std::uniform_real_distribution<Real> radius(0.5, 3);
+
+    const auto random = [&]() {
+      return Capsule(
+        Vector3({ position(generator), position(generator), position(generator) }),
+        Vector3({ position(generator), position(generator), position(generator) }),
+        radius(generator)
+      );
+    };
+
+    for(int i = 0; i < 200; ++i) {
+      const auto first = random();
+      const auto second = random();
+      const auto result = separation(ConvexShape(first), ConvexShape(second));
+
+      REQUIRE(result.distance == Approx(rbt::collision::distance(first, second)).margin(1e-3));
+    }
+  }
+
+  SECTION("finds the closest points of hulls") {
+    const auto hull = ConvexHull(rbt::box(Vector3({-1, -2, -3}), Vector3({1, 2, 3})));
+    const auto a = ConvexShape(hull, at(Vector3({0, 0, 0}), Vector3({1, 1, 0}), 45));
+    const auto b = ConvexShape(cube, at(Vector3({0, 0, 20}), Vector3({0, 1, 1}), 20));
+    const auto result = separation(a, b);
+
+    REQUIRE(result.distance > 0);
+    CHECK(rbt::length(result.pointB - result.pointA) == Approx(result.distance));
+    CHECK(hull.contains(inverse(a.placement())(result.pointA), 1e-3));
+
+    // No vertex of either shape is closer along the normal than the witness points
+    CHECK(a.support(result.normal) * result.normal == Approx(result.pointA * result.normal).margin(1e-3));
+    CHECK(b.support(Real(-1) * result.normal) * result.normal == Approx(result.pointB * result.normal).margin(1e-3));
+  }
+
+  SECTION("measures the depth of capsules whose segments cross") {
+    const auto first = Capsule(Vector3({-5, 0, 0}), Vector3({5, 0, 0}), 1);
+    const auto second = Capsule(Vector3({0, -5, 0}), Vector3({0, 5, 0}), 0.5);
+
+    CHECK(separation(ConvexShape(first), ConvexShape(second)).distance == Approx(-1.5));
+  }
+
+  SECTION("warm starts from the previous simplex") {
+    const auto hull = ConvexHull(rbt::box(Vector3({-1, -2, -3}), Vector3({1, 2, 3})));
+    auto a = ConvexShape(hull);
+    auto b = ConvexShape(cube);
+
+    Simplex simplex;
+    std::size_t cold = 0, warm = 0;
+    for(int step = 0; step < 20; ++step) {
+      const auto placement = at(Vector3({ Real(6 + 0.01 * step), 1, 0.5 }), Vector3({1, 1, 1}), Real(10 + 0.1 * step));
+      b.place(placement);
+
+      const auto coldResult = separation(a, b);
+      const auto warmResult = separation(a, b, simplex);
+      CHECK(warmResult.distance == Approx(coldResult.distance).margin(1e-4));
+
+      if(step > 0) {
+        cold += coldResult.iterations;
+        warm += warmResult.iterations;
+      }
+    }
+
+    CHECK(warm < cold);
+  }
+}
@@ -0,0 +1,50 @@
+#include "third_party/catch.hpp"
+#include "meshes/box.hpp"
+#include "meshes/sphere.hpp"
+
+#include "mesh/indexed_mesh.hpp"
+#include "spatial/vector.hpp"
+
+using rbt::Vector3;
+using rbt::mesh::boundaryEdges;
+using rbt::mesh::weld;
+
+TEST_CASE("Indexed mesh") {
+  SECTION("welds the corners of a box") {
+    const auto box = rbt::box(Vector3({-1, -2, -3}), Vector3({1, 2, 3}));
+    const auto welded = weld(box);
+
+    CHECK(welded.vertices.size() == 8);
+    CHECK(welded.triangles.size() == 12);
+    CHECK(boundaryEdges(welded).empty());
+
+    const auto unwelded = rbt::mesh::triangles(welded);
+    REQUIRE(unwelded.size() == box.size());
+    for(std::size_t t = 0; t < box.size(); ++t) {
+      for(std::size_t i = 0; i < 3; ++i) CHECK(unwelded[t][i] == box[t][i]);
+    }
+  }
+
+  SECTION("welds nearby vertices within the tolerance") {
+    auto box = rbt::box(Vector3({-1, -1, -1}), Vector3({1, 1, 1}));
+    const auto shifted = rbt::box(Vector3({-1, -1, -1}), Vector3({1.0001, 1, 1}));
+    box.erase(box.begin() + 10, box.end());
+    box.insert(box.end(), shifted.begin() + 10, shifted.end());
+
+    CHECK(weld(box).vertices.size() == 12);
+    CHECK(weld(box, 1e-3).vertices.size() == 8);
+  }
+
+  SECTION("drops triangles collapsed by welding") {
+    const auto sphere = rbt::sphere(Vector3({0, 0, 0}), 1, 8, 16);
+    CHECK(weld(sphere).triangles.size() == sphere.size());
+    CHECK(weld(sphere, 10).triangles.empty());
+  }
+
+  SECTION("finds open edges") {
+    auto box = rbt::box(Vector3({-1, -1, -1}), Vector3({1, 1, 1}));
+    box.pop_back();
+
+    CHECK(boundaryEdges(weld(box)).size() == 3);
+  }
+}
@@ -0,0 +1,83 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "meshes/box.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "link_meshes.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/vector.hpp"
+
+using rbt::Angles;
+using rbt::LinkMeshes;
+using rbt::Mesh;
+using rbt::RigidMatrix;
+using rbt::Vector3;
+using rbt::toRadians;
+
+namespace {
+
+// Copies of a box filling out each link of the IRB 120, enough to take the parallel path.
+std::vector<Mesh> links(std::size_t copies) {
+  std::vector<Mesh> result;
+  for(std::size_t link = 0; link <= rbt::ABB_IRB_120.joints().size(); ++link) {
+    Mesh mesh;
+    for(std::size_t i = 0; i < copies; ++i) {
+      const auto offset = static_cast<rbt::Real>(i + link);
+      for(const auto& triangle : rbt::box(Vector3({offset, 0, 0}), Vector3({offset + 10, 20, 30}))) {
+        mesh.push_back(triangle);
+      }
+    }
+    result.push_back(mesh);
+  }
+  return result;
+}
+
+void checkPosed(const std::vector<Mesh>& meshes, const Angles& angles) {
+  const auto robot = rbt::ABB_IRB_120;
+  const auto linkMeshes = LinkMeshes(robot, meshes);
+  const auto frames = robot.linkPoses(angles);
+  const auto posed = linkMeshes.pose(angles);
+
+  REQUIRE(posed.size() == meshes.size());
+  for(std::size_t link = 0; link < meshes.size(); ++link) {
+    const auto placement = RigidMatrix(frames[link]);
+    const auto& geometry = linkMeshes.links()[link];
+
+    REQUIRE(posed[link].vertices.size() == 3 * meshes[link].size());
+    for(std::size_t i = 0; i < geometry.vertices.size(); ++i) {
+      REQUIRE_THAT(posed[link].vertices[i], ComponentsEqual(placement(geometry.vertices[i])));
+    }
+    for(std::size_t i = 0; i < geometry.normals.size(); ++i) {
+      REQUIRE_THAT(posed[link].normals[i], ComponentsEqual(placement.rotate(geometry.normals[i])));
+    }
+  }
+}
+
+}
+
+TEST_CASE("LinkMeshes") {
+  const Angles angles = { toRadians(10), toRadians(-20), toRadians(30), toRadians(40), toRadians(50), toRadians(60) };
+
+  SECTION("places each link mesh at its link pose") {
+    checkPosed(links(1), angles);
+  }
+
+  SECTION("places large meshes in parallel") {
+    checkPosed(links(300), angles);
+  }
+
+  SECTION("reuses the result and scratch between configurations") {
+    const auto linkMeshes = LinkMeshes(rbt::ABB_IRB_120, links(1));
+
+    std::vector<LinkMeshes::Geometry> posed;
+    LinkMeshes::Scratch scratch;
+    linkMeshes.pose(angles, posed, scratch);
+    const auto data = posed[3].vertices.x.data();
+    const auto placements = scratch.placements.data();
+
+    linkMeshes.pose(Angles(6, 0), posed, scratch);
+    CHECK(posed[3].vertices.x.data() == data);
+    CHECK(scratch.placements.data() == placements);
+    CHECK_THAT(posed[0].vertices[0], ComponentsEqual(linkMeshes.links()[0].vertices[0]));
+  }
+}
@@ -0,0 +1,109 @@
+#include "third_party/catch.hpp"
+
+// Compile out INFO messages in this file
+#define RBT_LOG_LEVEL 1
+#include "utils/logger.hpp"
+#include "utils/parallel.hpp"
+#include "spatial/vector.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using rbt::Logger;
+using rbt::Vector3;
+
+namespace {
+
+// Streamable, but not trivially copyable, so formatted on the logging thread
+struct Named {
+  std::string name;
+};
+
+std::ostream& operator<<(std::ostream& out, const Named& named) {
+  return out << "<" << named.name << ">";
+}
+
+std::size_t count(const std::string& text, const std::string& part) {
+  std::size_t found = 0;
+  for(auto at = text.find(part); at != std::string::npos; at = text.find(part, at + 1)) ++found;
+  return found;
+}
+
+}
+
+TEST_CASE("Logger") {
+  std::stringstream out;
+  Logger::set_sink(out);
+
+  SECTION("formats arguments into the message") {
+    LOG(WARN, "joint {} is {} past its limit ({}, {})", 3, 0.5, std::string("clamped"), true);
+    LOG(ERROR, "{} at {}", "collision", Vector3({1, 2, 3}));
+    Logger::flush();
+
+    CHECK(out.str() ==
+      "\033[33m[WARN]\033[0m joint 3 is 0.5 past its limit (clamped, true)\n"
+      "\033[31m[ERROR]\033[0m collision at 1 2 3 \n"
+    );
+  }
+
+  SECTION("formats other streamable arguments") {
+    LOG(WARN, "{} and {}", Named{"first"}, Named{std::string(10 * Logger::MESSAGE_SIZE, 'x')});
+    Logger::flush();
+
+    CHECK(out.str().find("<first> and <xxx") != std::string::npos);
+    CHECK(out.str().find("x...\n") != std::string::npos);
+  }
+
+  SECTION("leaves unmatched placeholders") {
+    LOG(WARN, "{} and {}", 1);
+    Logger::flush();
+
+    CHECK(out.str() == "\033[33m[WARN]\033[0m 1 and {}\n");
+  }
+
+  SECTION("truncates long strings") {
+    LOG(WARN, "{}", std::string(10 * Logger::MESSAGE_SIZE, 'x'));
+    Logger::flush();
+
+    CHECK(count(out.str(), "x") < Logger::MESSAGE_SIZE);
+    CHECK(count(out.str(), "x") > Logger::MESSAGE_SIZE / 2);
+    CHECK(out.str().find("x...\n") != std::string::npos);
+  }
+
+  SECTION("marks arguments left out") {
+    LOG(WARN, "{} {} {}", std::string(Logger::MESSAGE_SIZE, 'x'), 1, Vector3({1, 2, 3}));
+    Logger::flush();
+
+    CHECK(out.str().find("x... ... ...\n") != std::string::npos);
+  }
+
+  SECTION("compiles out disabled levels") {
+    int evaluated = 0;
+    LOG(INFO, "{}", ++evaluated);
+    Logger::flush();
+
+    CHECK(evaluated == 0);
+    CHECK(out.str().empty());
+  }
+
+  SECTION("drops rather than blocks when a ring is full") {
+    const auto dropped = Logger::dropped();
+    const std::size_t messages = 4 * Logger::CAPACITY;
+    for(std::size_t i = 0; i < messages; ++i) LOG(WARN, "{}", i);
+    Logger::flush();
+
+    CHECK(count(out.str(), "\n") + (Logger::dropped() - dropped) == messages);
+  }
+
+  SECTION("collects messages from every thread") {
+    rbt::parallel_for(1000, [](std::size_t begin, std::size_t end) {
+      for(auto i = begin; i < end; ++i) LOG(ERROR, "task {}", i);
+    });
+    Logger::flush();
+
+    CHECK(count(out.str(), "task ") == 1000);
+  }
+
+  Logger::set_sink(std::cout);
+}
@@ -0,0 +1,41 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+
+#include "frame.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/transform.hpp"
+#include "spatial/vector.hpp"
+
+using rbt::Frame;
+using rbt::RigidMatrix;
+using rbt::Transform;
+using rbt::Vector3;
+using rbt::toRadians;
+
+TEST_CASE("RigidMatrix") {
+  const auto a = Transform(rbt::unit(Vector3({1, 2, 3})), toRadians(70), Vector3({4, -2, 6}));
+  const auto b = Transform(Vector3({0, 1, 0}), toRadians(-120), Vector3({-1, 5, 2}));
+  const auto point = Vector3({3, 4, 5});
+
+  SECTION("matches the transform it was converted from") {
+    CHECK_THAT(RigidMatrix(a.dual)(point), ComponentsEqual(a(point)));
+    CHECK_THAT(RigidMatrix(b.dual)(point), ComponentsEqual(b(point)));
+    CHECK_THAT(RigidMatrix(a)(point), ComponentsEqual(a(point)));
+    CHECK_THAT(RigidMatrix(Frame(b.dual))(point), ComponentsEqual(b(point)));
+  }
+
+  SECTION("rotates directions without translating") {
+    const auto m = RigidMatrix(a.dual);
+    CHECK_THAT(m.rotate(point), ComponentsEqual(m(point) - m(Vector3())));
+  }
+
+  SECTION("composes like transforms") {
+    const auto result = RigidMatrix(a.dual) * RigidMatrix(b.dual);
+    CHECK_THAT(result(point), ComponentsEqual((a * b)(point)));
+  }
+
+  SECTION("inverts") {
+    const auto m = RigidMatrix(a.dual);
+    CHECK_THAT(inverse(m)(m(point)), ComponentsEqual(point));
+  }
+}
@@ -0,0 +1,32 @@
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+
+#include <vector>
+
+namespace rbt {
+
+// A closed, outward-facing box mesh spanning [min, max].
+inline std::vector<Triangle> box(const Vector3& min, const Vector3& max) {
+  const auto corner = [&min, &max](int i) {
+    return Vector3({ (i & 1) ? max[0] : min[0], (i & 2) ? max[1] : min[1], (i & 4) ? max[2] : min[2] });
+  };
+
+  // Two counter-clockwise triangles (viewed from outside) per face, as corner indices
+  const int faces[12][3] = {
+    {0, 2, 3}, {0, 3, 1}, // -Z
+    {4, 5, 7}, {4, 7, 6}, // +Z
+    {0, 1, 5}, {0, 5, 4}, // -Y
+    {2, 6, 7}, {2, 7, 3}, // +Y
+    {0, 4, 6}, {0, 6, 2}, // -X
+    {1, 3, 7}, {1, 7, 5}  // +X
+  };
+
+  std::vector<Triangle> triangles;
+  for(const auto& face : faces) {
+    triangles.push_back(Triangle({ corner(face[0]), corner(face[1]), corner(face[2]) }));
+  }
+
+  return triangles;
+}
+
+}
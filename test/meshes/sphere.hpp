@@ -0,0 +1,35 @@
+#include "utilities.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace rbt {
+
+// A closed, outward-facing sphere mesh of the given radius about the center, with rings of latitude and segments
+// of longitude.
+inline std::vector<Triangle> sphere(const Vector3& center, Real radius, int rings = 16, int segments = 32) {
+  const auto point = [&](int ring, int segment) {
+    const auto polar = PI * Real(ring) / Real(rings);
+    const auto azimuth = 2 * PI * Real(segment % segments) / Real(segments);
+    // Exactly the same poles for every segment, so they weld
+    if(ring == 0) return center + Vector3({ 0, 0, radius });
+    if(ring == rings) return center + Vector3({ 0, 0, -radius });
+    return center + radius * Vector3({ std::sin(polar) * std::cos(azimuth), std::sin(polar) * std::sin(azimuth), std::cos(polar) });
+  };
+
+  std::vector<Triangle> triangles;
+  for(int ring = 0; ring < rings; ++ring) {
+    for(int segment = 0; segment < segments; ++segment) {
+      const auto a = point(ring, segment), b = point(ring + 1, segment);
+      const auto c = point(ring + 1, segment + 1), d = point(ring, segment + 1);
+      if(ring != 0) triangles.push_back(Triangle({ a, b, d }));
+      if(ring != rings - 1) triangles.push_back(Triangle({ b, c, d }));
+    }
+  }
+
+  return triangles;
+}
+
+}
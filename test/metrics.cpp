@@ -0,0 +1,98 @@
+#include "third_party/catch.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "ik.hpp"
+#include "utilities.hpp"
+#include "utils/metrics.hpp"
+#include "utils/parallel.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using rbt::metrics::Histogram;
+
+TEST_CASE("Metrics") {
+  SECTION("counts across threads") {
+    auto& counter = rbt::metrics::counter("test_counter_total", "A test counter");
+    const auto before = counter.value();
+
+    rbt::parallel_for(1000, [&counter](std::size_t begin, std::size_t end) {
+      for(auto i = begin; i < end; ++i) counter.add(2);
+    });
+
+    CHECK(counter.value() - before == 2000);
+    CHECK(&rbt::metrics::counter("test_counter_total", "") == &counter);
+  }
+
+  SECTION("sets and adjusts gauges") {
+    auto& gauge = rbt::metrics::gauge("test_gauge", "A test gauge");
+    gauge.set(5);
+    gauge.add(-1.5);
+
+    CHECK(gauge.value() == Approx(3.5));
+  }
+
+  SECTION("rejects a name reused for another kind of metric") {
+    rbt::metrics::counter("test_kind_total", "A test counter");
+    CHECK_THROWS_AS(rbt::metrics::gauge("test_kind_total", "A test gauge"), std::invalid_argument);
+  }
+
+  SECTION("buckets values with bounded relative error") {
+    for(const uint64_t value : std::vector<uint64_t>({ 0, 1, 15, 16, 17, 1000, 123456789, UINT64_MAX })) {
+      const auto bucket = Histogram::bucket(value);
+      REQUIRE(bucket < Histogram::BUCKETS);
+      CHECK(Histogram::lowest(bucket) <= value);
+      CHECK(Histogram::highest(bucket) >= value);
+      CHECK(static_cast<double>(Histogram::highest(bucket) - Histogram::lowest(bucket)) <= static_cast<double>(value) / 16);
+    }
+
+    for(std::size_t bucket = 1; bucket < Histogram::BUCKETS; ++bucket) {
+      REQUIRE(Histogram::lowest(bucket) == Histogram::highest(bucket - 1) + 1);
+    }
+  }
+
+  SECTION("finds quantiles") {
+    auto& histogram = rbt::metrics::histogram("test_quantiles_seconds", "A test histogram");
+    for(uint64_t value = 1; value <= 10000; ++value) histogram.record(value);
+
+    const auto distribution = histogram.distribution();
+    CHECK(distribution.count == 10000);
+    CHECK(distribution.max == 10000);
+    CHECK(distribution.mean() == Approx(5000.5));
+    CHECK(distribution.quantile(0.5) == Approx(5000).epsilon(1.0 / 16));
+    CHECK(distribution.quantile(0.99) == Approx(9900).epsilon(1.0 / 16));
+    CHECK(distribution.quantile(1) == 10000);
+  }
+
+  SECTION("instruments inverse kinematics") {
+    const auto angle = rbt::toRadians(30);
+    const auto pose = rbt::ABB_IRB_120.pose({ angle, angle, angle, angle, angle, angle });
+    // The metrics are created by their first use
+    rbt::ik::angles(pose, rbt::ABB_IRB_120);
+
+    const auto before = rbt::metrics::snapshot();
+    rbt::ik::angles(pose, rbt::ABB_IRB_120);
+    const auto after = rbt::metrics::snapshot();
+
+    CHECK(after.counters.at("rbt_ik_calls_total") == before.counters.at("rbt_ik_calls_total") + 1);
+    CHECK(after.counters.at("rbt_ik_solutions_total") > before.counters.at("rbt_ik_solutions_total"));
+    CHECK(after.counters.at("rbt_serial_pose_total") > before.counters.at("rbt_serial_pose_total"));
+    CHECK(after.histograms.at("rbt_ik_seconds").count == before.histograms.at("rbt_ik_seconds").count + 1);
+  }
+
+  SECTION("exports the Prometheus text format") {
+    rbt::metrics::counter("test_export_total", "An exported counter").add(3);
+    rbt::metrics::histogram("test_export_seconds", "An exported histogram").record(2000000000);
+
+    std::stringstream out;
+    rbt::metrics::write_prometheus(out);
+    const auto text = out.str();
+
+    CHECK(text.find("# HELP test_export_total An exported counter\n# TYPE test_export_total counter\ntest_export_total 3\n") != std::string::npos);
+    CHECK(text.find("# TYPE test_export_seconds summary\n") != std::string::npos);
+    CHECK(text.find("test_export_seconds{quantile=\"0.5\"} 2") != std::string::npos);
+    CHECK(text.find("test_export_seconds_count 1\n") != std::string::npos);
+  }
+}
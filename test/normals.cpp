@@ -0,0 +1,59 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "meshes/box.hpp"
+#include "meshes/sphere.hpp"
+
+#include "mesh/indexed_mesh.hpp"
+#include "mesh/normals.hpp"
+#include "spatial/vector.hpp"
+
+#include <cmath>
+
+using rbt::Real;
+using rbt::Vector3;
+using rbt::mesh::IndexedMesh;
+using rbt::mesh::faceNormals;
+using rbt::mesh::vertexNormals;
+using rbt::mesh::weld;
+
+TEST_CASE("Mesh normals") {
+  SECTION("points box corners along their diagonals") {
+    const auto box = weld(rbt::box(Vector3({-1, -2, -3}), Vector3({1, 2, 3})));
+    const auto normals = vertexNormals(box);
+
+    REQUIRE(normals.size() == box.vertices.size());
+    for(std::size_t v = 0; v < box.vertices.size(); ++v) {
+      // Each corner meets three faces at right angles however the faces are split, so the normal is the diagonal
+      const auto& p = box.vertices[v];
+      const auto expected = rbt::unit(Vector3({ std::copysign(Real(1), p[0]), std::copysign(Real(1), p[1]), std::copysign(Real(1), p[2]) }));
+      CHECK_THAT(normals[v], ComponentsEqual(expected));
+    }
+  }
+
+  SECTION("follows the surface of a sphere") {
+    const auto sphere = weld(rbt::sphere(Vector3({1, 2, 3}), 5, 128, 256));
+    // Enough triangles for the parallel path
+    REQUIRE(sphere.vertices.size() > rbt::mesh::NORMALS_PARALLEL_THRESHOLD);
+
+    const auto normals = vertexNormals(sphere);
+    for(std::size_t v = 0; v < sphere.vertices.size(); ++v) {
+      const auto radial = rbt::unit(sphere.vertices[v] - Vector3({1, 2, 3}));
+      REQUIRE(normals[v] * radial > Real(0.999));
+    }
+  }
+
+  SECTION("gives face normals") {
+    const auto mesh = IndexedMesh(
+      { Vector3({0, 0, 0}), Vector3({2, 0, 0}), Vector3({0, 2, 0}), Vector3({5, 5, 5}) },
+      { {{ 0, 1, 2 }}, {{ 0, 2, 1 }}, {{ 0, 0, 1 }} }
+    );
+
+    const auto faces = faceNormals(mesh);
+    CHECK_THAT(faces[0], ComponentsEqual(Vector3({0, 0, 1})));
+    CHECK_THAT(faces[1], ComponentsEqual(Vector3({0, 0, -1})));
+    CHECK_THAT(faces[2], ComponentsEqual(Vector3({0, 0, 0})));
+
+    // The unused vertex has no normal
+    CHECK_THAT(vertexNormals(mesh)[3], ComponentsEqual(Vector3({0, 0, 0})));
+  }
+}
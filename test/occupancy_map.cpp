@@ -0,0 +1,137 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "collision/capsule.hpp"
+#include "collision/occupancy_map.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/points.hpp"
+#include "spatial/vector.hpp"
+
+#include <limits>
+#include <random>
+
+using rbt::Angles;
+using rbt::Points;
+using rbt::Real;
+using rbt::RigidMatrix;
+using rbt::Vector3;
+using rbt::collision::Capsule;
+using rbt::collision::OccupancyMap;
+
+TEST_CASE("Occupancy map") {
+  SECTION("marks the voxels holding points") {
+    auto map = OccupancyMap(10, Vector3({5, 5, 5}));
+    map.insert(Points({ Vector3({0, 0, 0}), Vector3({1, 2, 3}), Vector3({-3, -2, -1}), Vector3({100, -200, 300}) }));
+
+    // The first three share the voxel [-5, 5)
+    CHECK(map.count() == 2);
+    CHECK(map.occupied(Vector3({4, 4, 4})));
+    CHECK(!map.occupied(Vector3({6, 4, 4})));
+    CHECK(map.occupied(Vector3({101, -201, 301})));
+
+    const auto voxels = map.voxels();
+    REQUIRE(voxels.size() == 2);
+    CHECK_THAT(voxels[0], ComponentsEqual(Vector3({0, 0, 0})));
+
+    // Inserting again adds nothing new
+    map.insert(Points({ Vector3({0, 0, 0}), Vector3({102, -202, 302}) }));
+    CHECK(map.count() == 2);
+
+    map.clear();
+    CHECK(map.empty());
+    CHECK(!map.occupied(Vector3({0, 0, 0})));
+  }
+
+  SECTION("answers at coarser levels") {
+    auto map = OccupancyMap(1);
+    map.insert(Points({ Vector3({5.5, 0.5, 0.5}) }));
+
+    CHECK(!map.occupied(Vector3({0.5, 0.5, 0.5}), 0));
+    CHECK(!map.occupied(Vector3({0.5, 0.5, 0.5}), 2));
+    CHECK(map.occupied(Vector3({0.5, 0.5, 0.5}), 3));
+    CHECK(map.occupied(Vector3({-100, 0, 0}), OccupancyMap::LEVELS));
+
+    const auto cell = map.cell(Vector3({5.5, 0.5, 0.5}), 2);
+    REQUIRE(cell);
+    CHECK_THAT(cell->min, ComponentsEqual(Vector3({4, 0, 0})));
+    CHECK_THAT(cell->max, ComponentsEqual(Vector3({8, 4, 4})));
+
+    // Points outside the span of the map have no cell, as insert drops them
+    CHECK(!map.cell(Vector3({1e7, 0, 0})));
+    CHECK(!map.cell(Vector3({0, -1e7, 0}), OccupancyMap::LEVELS));
+    CHECK(!map.cell(Vector3({0, 0, std::numeric_limits<Real>::quiet_NaN()})));
+  }
+
+  SECTION("collides capsules with voxels") {
+    auto map = OccupancyMap(1);
+    map.insert(Points({ Vector3({10.5, 0.5, 0.5}) }));
+
+    const auto half = std::sqrt(Real(3)) / 2;
+    CHECK(map.collides(Capsule(Vector3({0, 0.5, 0.5}), Vector3({5, 0.5, 0.5}), Real(5.5) - half + Real(0.01))));
+    CHECK(!map.collides(Capsule(Vector3({0, 0.5, 0.5}), Vector3({5, 0.5, 0.5}), Real(5.5) - half - Real(0.01))));
+
+    // A coarser level is more conservative
+    const auto near = Capsule(Vector3({0, 0.5, 0.5}), Vector3({5, 0.5, 0.5}), 3);
+    CHECK(!map.collides(near));
+    CHECK(map.collides(near, 4));
+  }
+
+  SECTION("agrees with testing every voxel") {
+    std::mt19937 generator(9);
+    std::uniform_real_distribution<Real> coordinate(-500, 500);
+
+    auto map = OccupancyMap(7, Vector3({1, 2, 3}));
+    Points cloud;
+    for(std::size_t i = 0; i < OccupancyMap::PARALLEL_THRESHOLD + 1000; ++i) {
+      cloud.push_back(Vector3({ coordinate(generator), coordinate(generator), Real(0.05) * coordinate(generator) }));
+    }
+    map.insert(cloud);
+    const auto voxels = map.voxels();
+
+    for(std::size_t i = 0; i < cloud.size(); i += 97) CHECK(map.occupied(cloud[i]));
+
+    std::uniform_real_distribution<Real> radius(1, 20);
+    std::size_t collisions = 0;
+    for(int i = 0; i < 30; ++i) {
+      const auto capsule = Capsule(
+        Vector3({ coordinate(generator), coordinate(generator), coordinate(generator) }),
+        Vector3({ coordinate(generator), coordinate(generator), coordinate(generator) }),
+        radius(generator)
+      );
+
+      bool expected = false;
+      for(std::size_t v = 0; v < voxels.size() && !expected; ++v) {
+        expected = rbt::collision::distance(capsule, Capsule(voxels[v], voxels[v], Real(7 * 0.8660254))) <= 0;
+      }
+
+      REQUIRE(map.collides(capsule) == expected);
+      collisions += expected;
+    }
+    CHECK(collisions > 3);
+    CHECK(collisions < 27);
+  }
+
+  SECTION("checks posed robot links") {
+    const auto robot = rbt::ABB_IRB_120;
+    std::vector<Capsule> proxies(1, Capsule(Vector3({0, 0, 0}), Vector3({0, 0, 200}), 80));
+    for(std::size_t link = 1; link <= robot.joints().size(); ++link) {
+      proxies.push_back(Capsule(Vector3({-30, 0, 0}), Vector3({30, 0, 0}), 40));
+    }
+
+    const Angles angles = { 0.2, -0.3, 0.4, 0.5, 0.6, 0.7 };
+    const auto frames = robot.linkPoses(angles);
+    const auto tool = RigidMatrix(frames[6])(Vector3({0, 0, 0}));
+
+    auto map = OccupancyMap(5);
+    map.insert(Points({ Vector3({1000, 1000, 1000}) }));
+    CHECK(!map.inCollision(robot, proxies, angles));
+
+    map.insert(Points({ tool }));
+    CHECK(map.inCollision(robot, proxies, angles));
+
+    const auto links = map.collisions(robot, proxies, angles);
+    CHECK(std::find(links.begin(), links.end(), 6) != links.end());
+    CHECK(std::find(links.begin(), links.end(), 0) == links.end());
+  }
+}
@@ -0,0 +1,49 @@
+#include "third_party/catch.hpp"
+
+#include "utils/parallel.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Parallel for") {
+  SECTION("calls every index once") {
+    for(const std::size_t count : { 0, 1, 7, 1000, 100003 }) {
+      std::vector<std::atomic<int>> calls(count);
+      rbt::parallel_for(count, [&calls](std::size_t begin, std::size_t end) {
+        for(auto i = begin; i < end; ++i) ++calls[i];
+      });
+      for(const auto& called : calls) REQUIRE(called == 1);
+    }
+  }
+
+  SECTION("runs calls made from chunks and from other threads") {
+    std::atomic<std::size_t> total{0};
+    const auto nested = [&total]() {
+      rbt::parallel_for(100, [&total](std::size_t begin, std::size_t end) {
+        rbt::parallel_for(end - begin, [&total](std::size_t first, std::size_t last) { total += last - first; });
+      });
+    };
+
+    std::vector<std::thread> threads;
+    for(int thread = 0; thread < 4; ++thread) threads.emplace_back([&nested]() {
+      for(int i = 0; i < 50; ++i) nested();
+    });
+    for(auto& thread : threads) thread.join();
+
+    CHECK(total == 4 * 50 * 100);
+  }
+
+  SECTION("rethrows what a chunk throws") {
+    const auto fail = [](std::size_t begin, std::size_t end) {
+      if(begin <= 500 && 500 < end) throw std::runtime_error("Chunk failed");
+    };
+    CHECK_THROWS_AS(rbt::parallel_for(1000, fail), std::runtime_error);
+
+    // And still runs the next call
+    std::atomic<std::size_t> total{0};
+    rbt::parallel_for(1000, [&total](std::size_t begin, std::size_t end) { total += end - begin; });
+    CHECK(total == 1000);
+  }
+}
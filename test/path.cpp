@@ -0,0 +1,165 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "frame.hpp"
+#include "path.hpp"
+#include "utilities.hpp"
+#include "spatial/dual.hpp"
+#include "spatial/quaternion.hpp"
+#include "spatial/transform.hpp"
+#include "spatial/vector.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using rbt::Angles;
+using rbt::CartesianPath;
+using rbt::Frame;
+using rbt::Quaternion;
+using rbt::Real;
+using rbt::Transform;
+using rbt::Vector3;
+using rbt::toRadians;
+
+namespace {
+
+Frame pose(const Vector3& axis, Real degrees, const Vector3& position) {
+  return Frame(Transform(rbt::unit(axis), toRadians(degrees), position).dual);
+}
+
+// The angle between two orientations.
+Real angleBetween(const Frame& a, const Frame& b) {
+  const auto relative = conjugate(a.orientation()) * b.orientation();
+  const auto sine = std::sqrt(relative.x * relative.x + relative.y * relative.y + relative.z * relative.z);
+  return 2 * std::atan2(sine, std::abs(relative.r));
+}
+
+void requireSame(const Frame& a, const Frame& b, Real tolerance = 1e-2) {
+  REQUIRE(rbt::length(a.position() - b.position()) < tolerance);
+  REQUIRE(angleBetween(a, b) < 1e-3);
+}
+
+}
+
+TEST_CASE("Cartesian paths") {
+  const auto from = pose(Vector3({ 1, 2, 3 }), 20, Vector3({ 300, -100, 400 }));
+  const auto to = pose(Vector3({ -1, 0, 2 }), 75, Vector3({ 250, 200, 500 }));
+
+  SECTION("screw-linearly interpolates between poses") {
+    requireSame(rbt::sclerp(from.pose(), to.pose(), 0), from);
+    requireSame(rbt::sclerp(from.pose(), to.pose(), 1), to);
+
+    // A turn about a vertical axis through (100, 0, 0) moves around a circle
+    const auto a = pose(Vector3({ 0, 0, 1 }), 0, Vector3({ 200, 0, 0 }));
+    const auto b = pose(Vector3({ 0, 0, 1 }), 90, Vector3({ 100, 100, 0 }));
+    const auto middle = Frame(rbt::sclerp(a.pose(), b.pose(), 0.5));
+    const auto expected = Vector3({ 100 + 100 * std::cos(toRadians(45)), 100 * std::sin(toRadians(45)), 0 });
+
+    CHECK_THAT(middle.position(), ComponentsEqual(expected));
+    CHECK(angleBetween(middle, a) == Approx(toRadians(45)));
+  }
+
+  SECTION("moves along a screw at a constant rate") {
+    const auto frames = CartesianPath::screw(from, to).frames(5);
+    REQUIRE(frames.size() > 10);
+
+    // Each step is the same motion
+    const auto first = frames[0].pose();
+    const auto step = frames[1].pose() * rbt::Dual<Quaternion>(conjugate(first.r), conjugate(first.d));
+    for(std::size_t i = 1; i + 1 < frames.size(); ++i) {
+      requireSame(Frame(step * frames[i].pose()), frames[i + 1]);
+    }
+    requireSame(frames.back(), to);
+  }
+
+  SECTION("moves along a line") {
+    const auto path = CartesianPath::linear(from, to);
+    CHECK(path.length() == Approx(rbt::length(to.position() - from.position())));
+
+    const auto frames = path.frames(1, toRadians(0.5));
+    for(std::size_t i = 0; i < frames.size(); ++i) {
+      const auto s = Real(i) / Real(frames.size() - 1);
+      const auto expected = from.position() + s * (to.position() - from.position());
+      REQUIRE(rbt::length(frames[i].position() - expected) < 1e-2);
+      REQUIRE(angleBetween(frames[i], from) == Approx(s * path.angle()).margin(1e-3));
+    }
+    requireSame(frames.back(), to);
+  }
+
+  SECTION("moves along an arc through the via point") {
+    const auto via = pose(Vector3({ 0, 0, 1 }), 0, Vector3({ 500, 100, 300 }));
+    const auto path = CartesianPath::circular(from, via, to);
+    const auto frames = path.frames(1);
+
+    const auto b = via.position();
+    Real closest = rbt::INF;
+    Real travelled = 0;
+    for(std::size_t i = 0; i < frames.size(); ++i) {
+      closest = std::min(closest, rbt::length(frames[i].position() - b));
+      if(i > 0) {
+        const auto step = rbt::length(frames[i].position() - frames[i - 1].position());
+        REQUIRE(step <= 1.01);
+        travelled += step;
+      }
+    }
+
+    CHECK(closest < 1);
+    CHECK(travelled == Approx(path.length()).epsilon(1e-3));
+    requireSame(frames.front(), from);
+    requireSame(frames.back(), to);
+
+    CHECK_THROWS_AS(CartesianPath::circular(from, Frame(Transform(Real(0.5) * (from.position() + to.position())).dual), to), std::invalid_argument);
+  }
+
+  SECTION("samples at the resolutions") {
+    const auto path = CartesianPath::screw(from, to);
+    const auto fine = path.samples(1, toRadians(90));
+    const auto turning = path.samples(1000, toRadians(1));
+
+    CHECK(fine.front() == 0);
+    CHECK(fine.back() == 1);
+    CHECK(Real(fine.size() - 1) == Approx(std::ceil(path.length())));
+    CHECK(Real(turning.size() - 1) == Approx(std::ceil(path.angle() / toRadians(1))));
+  }
+
+  SECTION("evaluates batches like single poses") {
+    const auto path = CartesianPath::circular(from, pose(Vector3({ 0, 0, 1 }), 0, Vector3({ 500, 100, 300 })), to);
+    const auto s = path.samples(6);
+    REQUIRE(s.size() % 8 != 0);
+
+    std::vector<Frame> frames;
+    path.evaluate(s, frames);
+    REQUIRE(frames.size() == s.size());
+    for(std::size_t i = 0; i < s.size(); ++i) requireSame(frames[i], path(s[i]), 1e-3);
+  }
+
+  SECTION("solves paths for joint angles") {
+    const auto start = Angles({ toRadians(10), toRadians(20), toRadians(-10), toRadians(30), toRadians(40), toRadians(-20) });
+    const auto end = Angles({ toRadians(-30), toRadians(10), toRadians(5), toRadians(-20), toRadians(60), toRadians(10) });
+    const auto path = CartesianPath::linear(rbt::ABB_IRB_120.pose(start), rbt::ABB_IRB_120.pose(end));
+
+    const auto joints = rbt::jointPath(path, rbt::ABB_IRB_120, start, 1);
+    const auto frames = path.frames(1);
+    REQUIRE(frames.size() > rbt::PATH_CHUNK);
+    REQUIRE(joints.size() == frames.size());
+
+    for(std::size_t i = 0; i < joints.size(); ++i) {
+      requireSame(rbt::ABB_IRB_120.pose(joints[i]), frames[i], 0.1);
+
+      const auto& previous = (i == 0) ? start : joints[i - 1];
+      for(std::size_t j = 0; j < 6; ++j) REQUIRE(std::abs(joints[i][j] - previous[j]) < toRadians(5));
+    }
+  }
+
+  SECTION("stops at unreachable poses") {
+    const auto start = Angles({ 0, 0, 0, 0, toRadians(30), 0 });
+    const auto far = pose(Vector3({ 0, 0, 1 }), 0, Vector3({ 2000, 0, 500 }));
+    const auto path = CartesianPath::linear(rbt::ABB_IRB_120.pose(start), far);
+
+    const auto joints = rbt::jointPath(path, rbt::ABB_IRB_120, start, 5);
+    CHECK(!joints.empty());
+    CHECK(joints.size() < path.samples(5).size());
+  }
+}
@@ -0,0 +1,89 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "meshes/box.hpp"
+
+#include "spatial/matrix.hpp"
+#include "spatial/points.hpp"
+#include "spatial/transform.hpp"
+#include "spatial/vector.hpp"
+
+#include <random>
+
+using rbt::Points;
+using rbt::Real;
+using rbt::RigidMatrix;
+using rbt::Transform;
+using rbt::Vector3;
+
+TEST_CASE("Points") {
+  const auto placement = RigidMatrix(Transform(rbt::unit(Vector3({1, -2, 3})), rbt::toRadians(50), Vector3({4, 5, -6})));
+
+  // Not a multiple of the batch width, so the remainder is covered too
+  std::mt19937 generator(3);
+  std::uniform_real_distribution<Real> position(-100, 100);
+  Points points;
+  for(int i = 0; i < 21; ++i) {
+    points.push_back(Vector3({ position(generator), position(generator), position(generator) }));
+  }
+
+  SECTION("transforms every point") {
+    Points result(points.size());
+    transform(placement, points, result);
+
+    for(std::size_t i = 0; i < points.size(); ++i) {
+      CHECK_THAT(result[i], ComponentsEqual(placement(points[i])));
+    }
+  }
+
+  SECTION("rotates every direction") {
+    Points result(points.size());
+    rotate(placement, points, result);
+
+    for(std::size_t i = 0; i < points.size(); ++i) {
+      CHECK_THAT(result[i], ComponentsEqual(placement.rotate(points[i])));
+    }
+  }
+
+  SECTION("transforms only the given range") {
+    Points result(points.size());
+    transform(placement, points, result, 3, 14);
+
+    for(std::size_t i = 0; i < points.size(); ++i) {
+      const auto expected = (i >= 3 && i < 14) ? placement(points[i]) : Vector3();
+      CHECK_THAT(result[i], ComponentsEqual(expected));
+    }
+  }
+
+  SECTION("finds the point furthest along a direction") {
+    for(const auto& direction : { Vector3({1, 0, 0}), Vector3({-0.3, 0.5, 0.8}), Vector3({0, 0, -1}) }) {
+      std::size_t expected = 0;
+      for(std::size_t i = 1; i < points.size(); ++i) {
+        if(points[i] * direction > points[expected] * direction) expected = i;
+      }
+      CHECK(rbt::farthest(points, direction) == expected);
+    }
+
+    // Ties go to the first point
+    CHECK(rbt::farthest(Points(std::vector<Vector3>(20, Vector3({1, 2, 3}))), Vector3({1, 1, 1})) == 0);
+  }
+
+  SECTION("lays out meshes three vertices per triangle") {
+    const auto mesh = rbt::box(Vector3({0, 0, 0}), Vector3({1, 2, 3}));
+    const auto vertices = rbt::vertices(mesh);
+    const auto normals = rbt::normals(mesh);
+
+    REQUIRE(vertices.size() == 3 * mesh.size());
+    REQUIRE(normals.size() == mesh.size());
+
+    const auto triangles = rbt::triangles(vertices);
+    REQUIRE(triangles.size() == mesh.size());
+    for(std::size_t t = 0; t < mesh.size(); ++t) {
+      for(std::size_t corner = 0; corner < 3; ++corner) {
+        CHECK_THAT(triangles[t][corner], ComponentsEqual(mesh[t][corner]));
+      }
+      CHECK(rbt::length(normals[t]) == Approx(1));
+    }
+
+    CHECK_THAT(normals[0], ComponentsEqual(Vector3({0, 0, -1})));
+  }
+}
@@ -0,0 +1,143 @@
+#include "third_party/catch.hpp"
+
+#include "utils/parallel.hpp"
+#include "utils/profiler.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using rbt::profiler::Statistics;
+using rbt::profiler::Zone;
+
+namespace {
+
+const Statistics* find(const std::vector<Statistics>& statistics, const std::string& path) {
+  const auto found = std::find_if(statistics.begin(), statistics.end(), [&](const Statistics& zone) {
+    return zone.path == path;
+  });
+  return (found == statistics.end()) ? nullptr : &*found;
+}
+
+}
+
+TEST_CASE("Profiler") {
+  rbt::profiler::clear();
+
+  SECTION("aggregates nested zones by path") {
+    for(int i = 0; i < 10; ++i) {
+      const Zone outer("outer");
+      for(int j = 0; j < 3; ++j) {
+        const Zone inner("inner");
+      }
+    }
+
+    const auto statistics = rbt::profiler::statistics();
+    const auto outer = find(statistics, "outer");
+    const auto inner = find(statistics, "outer/inner");
+    REQUIRE(outer != nullptr);
+    REQUIRE(inner != nullptr);
+
+    CHECK(outer->count == 10);
+    CHECK(outer->depth == 0);
+    CHECK(inner->count == 30);
+    CHECK(inner->depth == 1);
+
+    CHECK(inner->p50 <= inner->p99);
+    CHECK(inner->p99 <= inner->max);
+    CHECK(inner->mean <= static_cast<double>(inner->max));
+    // Each outer zone contains its inner zones
+    CHECK(outer->total >= inner->total);
+  }
+
+  SECTION("records zones on every thread") {
+    rbt::parallel_for(64, [](std::size_t begin, std::size_t end) {
+      for(auto i = begin; i < end; ++i) {
+        const Zone zone("task");
+      }
+    });
+
+    const auto statistics = rbt::profiler::statistics();
+    REQUIRE(find(statistics, "task") != nullptr);
+    CHECK(find(statistics, "task")->count == 64);
+  }
+
+  SECTION("keeps the last trace events in bounded buffers") {
+    // Threads come and go, giving their buffers to the next
+    for(int call = 0; call < 20; ++call) {
+      rbt::parallel_for(8, [](std::size_t begin, std::size_t end) {
+        for(auto i = begin; i < end; ++i) {
+          const Zone zone("task");
+        }
+      });
+    }
+
+    const auto runs = 3 * rbt::profiler::TRACE_EVENTS;
+    for(std::size_t i = 0; i < runs; ++i) {
+      const Zone zone("often");
+    }
+
+    const auto statistics = rbt::profiler::statistics();
+    REQUIRE(find(statistics, "often") != nullptr);
+    CHECK(find(statistics, "often")->count == runs);
+    CHECK(find(statistics, "task")->count == 160);
+
+    std::stringstream trace;
+    rbt::profiler::write_chrome_trace(trace);
+    const auto json = trace.str();
+
+    std::size_t events = 0, threads = 0;
+    const auto often = std::string("\"name\":\"often\"");
+    for(auto at = json.find(often); at != std::string::npos; at = json.find(often, at + 1)) ++events;
+    for(auto at = json.find("\"tid\":"); at != std::string::npos; at = json.find("\"tid\":", at + 1)) {
+      threads = std::max(threads, std::size_t(std::stoul(json.substr(at + 6))) + 1);
+    }
+    CHECK(events == rbt::profiler::TRACE_EVENTS);
+    CHECK(threads <= rbt::hardware_threads() + 2);
+  }
+
+  SECTION("exports Chrome trace events") {
+    {
+      const Zone outer("outer \"quoted\"");
+      const Zone inner("inner");
+    }
+
+    std::stringstream trace;
+    rbt::profiler::write_chrome_trace(trace);
+    const auto json = trace.str();
+
+    CHECK(json.rfind("{\"traceEvents\":[", 0) == 0);
+    CHECK(json.find("\"name\":\"outer \\\"quoted\\\"\"") != std::string::npos);
+    CHECK(json.find("\"name\":\"inner\",\"ph\":\"X\"") != std::string::npos);
+  }
+
+  SECTION("keeps open zones when cleared") {
+    {
+      const Zone outer("outer");
+      { const Zone before("before"); }
+      rbt::profiler::clear();
+      { const Zone after("after"); }
+    }
+
+    const auto statistics = rbt::profiler::statistics();
+    CHECK(find(statistics, "outer/before") == nullptr);
+    REQUIRE(find(statistics, "outer/after") != nullptr);
+    REQUIRE(find(statistics, "outer") != nullptr);
+    CHECK(find(statistics, "outer")->count == 1);
+  }
+
+#ifdef RBT_PROFILE
+  SECTION("profiles scopes by macro") {
+    {
+      PROFILE_ZONE("macro");
+      PROFILE_ZONE("nested");
+    }
+
+    CHECK(find(rbt::profiler::statistics(), "macro/nested") != nullptr);
+  }
+#endif
+
+  rbt::profiler::clear();
+}
@@ -0,0 +1,117 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "meshes/box.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "collision/raycast.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/points.hpp"
+#include "spatial/vector.hpp"
+#include "visual/rasterizer.hpp"
+
+using rbt::Angles;
+using rbt::Mesh;
+using rbt::Real;
+using rbt::Vector3;
+using rbt::toRadians;
+using rbt::visual::Camera;
+using rbt::visual::DepthImage;
+using rbt::visual::Rasterizer;
+using rbt::visual::look_at;
+
+namespace {
+
+// A box around the origin of every link, with the base and end effector left empty.
+std::vector<Mesh> links(Real size) {
+  std::vector<Mesh> result(1);
+  for(std::size_t link = 1; link < rbt::ABB_IRB_120.joints().size(); ++link) {
+    result.push_back(rbt::box(Vector3({-size, -size, -size}), Vector3({size, size, size})));
+  }
+  result.push_back(Mesh());
+  return result;
+}
+
+}
+
+TEST_CASE("Rasterizer") {
+  const auto robot = rbt::ABB_IRB_120;
+  const Angles home = { 0, 0, 0, 0, 0, 0 };
+
+  SECTION("renders the depth of a face seen head on") {
+    // Link 1 sits 290 up at the top of the first joint
+    auto rasterizer = Rasterizer(robot, links(50));
+    const auto camera = Camera::with_field_of_view(64, 48, toRadians(60), look_at(Vector3({1000, 0, 290}), Vector3({0, 0, 290})));
+
+    DepthImage image;
+    rasterizer.render(camera, home, image, true);
+
+    REQUIRE(image.width == 64);
+    REQUIRE(image.height == 48);
+    CHECK(image.at(32, 24) == Approx(950));
+    CHECK(image.links[24 * 64 + 32] == 1);
+    CHECK_THAT(image.normals[24 * 64 + 32], ComponentsEqual(Vector3({1, 0, 0})));
+
+    CHECK(image.at(0, 0) == rbt::INF);
+    CHECK(image.links[0] == DepthImage::NO_LINK);
+    CHECK_THAT(image.normals[0], ComponentsEqual(Vector3({0, 0, 0})));
+  }
+
+  SECTION("agrees with ray casting") {
+    const auto meshes = links(60);
+    auto rasterizer = Rasterizer(robot, meshes);
+    auto scene = rbt::collision::RayScene(meshes);
+
+    const Angles angles = { toRadians(20), toRadians(-30), toRadians(40), toRadians(10), toRadians(60), 0 };
+    scene.place(robot.linkPoses(angles));
+
+    const auto camera = Camera::with_field_of_view(
+      100, 75, toRadians(70), look_at(Vector3({300, -300, 600}), Vector3({250, 0, 400})), 1, 2000
+    );
+    DepthImage image;
+    rasterizer.render(camera, angles, image);
+
+    std::size_t seen = 0, disagree = 0;
+    for(std::size_t y = 0; y < image.height; ++y) {
+      for(std::size_t x = 0; x < image.width; ++x) {
+        // A direction with unit z in the camera frame, so its ray distance is the depth
+        const auto direction = camera.pose.rotate(Vector3({
+          (Real(x) + Real(0.5) - camera.cx) / camera.fx, (Real(y) + Real(0.5) - camera.cy) / camera.fy, 1
+        }));
+        const auto hit = scene.raycast(camera.pose.translation(), direction);
+        const auto expected = (hit.distance <= camera.far) ? hit.distance : rbt::INF;
+
+        if(expected != rbt::INF) ++seen;
+        // Pixels right on an outline may fall either way
+        const auto depth = image.at(x, y);
+        if((depth == rbt::INF) != (expected == rbt::INF) || (depth != rbt::INF && std::abs(depth - expected) > 0.1)) ++disagree;
+      }
+    }
+
+    CHECK(seen > image.depth.size() / 10);
+    CHECK(disagree < image.depth.size() / 100);
+  }
+
+  SECTION("clips triangles crossing the near plane") {
+    // The camera sits inside a box, so every triangle it sees crosses the near plane or is behind it
+    auto meshes = std::vector<Mesh>(robot.joints().size() + 1);
+    meshes[0] = rbt::box(Vector3({-100, -100, -100}), Vector3({100, 100, 100}));
+    auto rasterizer = Rasterizer(robot, meshes);
+
+    const auto camera = Camera::with_field_of_view(32, 32, toRadians(90), look_at(Vector3({0, 0, 0}), Vector3({1, 0, 0})), 10);
+    DepthImage image;
+    rasterizer.render(camera, home, image);
+
+    for(const auto depth : image.depth) CHECK(depth == Approx(100));
+  }
+
+  SECTION("leaves out surfaces beyond the far plane") {
+    auto meshes = std::vector<Mesh>(robot.joints().size() + 1);
+    meshes[1] = rbt::box(Vector3({-50, -50, -50}), Vector3({50, 50, 50}));
+    auto rasterizer = Rasterizer(robot, meshes);
+    const auto camera = Camera::with_field_of_view(32, 24, toRadians(60), look_at(Vector3({1000, 0, 290}), Vector3({0, 0, 290})), 1, 900);
+
+    DepthImage image;
+    rasterizer.render(camera, home, image);
+    for(const auto depth : image.depth) CHECK(depth == rbt::INF);
+  }
+}
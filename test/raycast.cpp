@@ -0,0 +1,171 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "meshes/box.hpp"
+#include "meshes/sphere.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "collision/bvh.hpp"
+#include "collision/raycast.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/points.hpp"
+#include "spatial/vector.hpp"
+
+#include <random>
+
+using rbt::Mesh;
+using rbt::Points;
+using rbt::Real;
+using rbt::RigidMatrix;
+using rbt::Vector3;
+using rbt::collision::BVH;
+using rbt::collision::RayHit;
+using rbt::collision::RayScene;
+using rbt::collision::raycast;
+
+namespace {
+
+// The nearest hit by testing every triangle, or INF.
+Real bruteForce(const Mesh& mesh, const Vector3& origin, const Vector3& direction) {
+  Real best = rbt::INF;
+  for(const auto& t : mesh) {
+    const auto e1 = t[1] - t[0], e2 = t[2] - t[0];
+    const auto p = rbt::cross(direction, e2);
+    const auto det = e1 * p;
+    if(det == 0) continue;
+
+    const auto s = origin - t[0];
+    const auto u = (s * p) / det;
+    const auto q = rbt::cross(s, e1);
+    const auto v = (direction * q) / det;
+    const auto distance = (e2 * q) / det;
+    if(u >= 0 && v >= 0 && u + v <= 1 && distance >= 0) best = std::min(best, distance);
+  }
+  return best;
+}
+
+Points randomPoints(std::mt19937& generator, std::size_t count, Real extent) {
+  std::uniform_real_distribution<Real> coordinate(-extent, extent);
+  Points result;
+  for(std::size_t i = 0; i < count; ++i) result.push_back(Vector3({ coordinate(generator), coordinate(generator), coordinate(generator) }));
+  return result;
+}
+
+}
+
+TEST_CASE("Ray casting") {
+  const auto box = rbt::box(Vector3({-1, -2, -3}), Vector3({1, 2, 3}));
+
+  SECTION("finds the first hit") {
+    const auto bvh = BVH(box);
+    const auto origin = Vector3({-5, 0.5, 1}), direction = Vector3({2, 0, 0});
+    const auto hit = raycast(bvh, origin, direction);
+
+    REQUIRE(hit.hit());
+    CHECK(hit.distance == Approx(2));
+
+    // The barycentric coordinates give back the hit point on the triangle hit
+    const auto& t = box[hit.triangle];
+    const auto point = (1 - hit.u - hit.v) * t[0] + hit.u * t[1] + hit.v * t[2];
+    CHECK_THAT(point, ComponentsEqual(origin + hit.distance * direction));
+    CHECK(point[0] == Approx(-1));
+  }
+
+  SECTION("respects the maximum distance") {
+    const auto bvh = BVH(box);
+    CHECK(raycast(bvh, Vector3({-5, 0, 0}), Vector3({1, 0, 0}), 3.9).distance == rbt::INF);
+    CHECK(raycast(bvh, Vector3({-5, 0, 0}), Vector3({1, 0, 0}), 4.1).distance == Approx(4));
+    CHECK(!raycast(bvh, Vector3({-5, 0, 0}), Vector3({-1, 0, 0})).hit());
+  }
+
+  SECTION("agrees with testing every triangle") {
+    const auto sphere = rbt::sphere(Vector3({1, 2, 3}), 10, 12, 24);
+    const auto bvh = BVH(sphere);
+
+    std::mt19937 generator(3);
+    // Not a whole number of packets
+    const auto origins = randomPoints(generator, 301, 20);
+    const auto directions = randomPoints(generator, 301, 1);
+
+    std::vector<RayHit> hits;
+    raycast(bvh, origins, directions, hits);
+    std::vector<uint8_t> occluded;
+    rbt::collision::occluded(bvh, origins, directions, occluded);
+
+    REQUIRE(hits.size() == origins.size());
+    REQUIRE(occluded.size() == origins.size());
+    std::size_t hit = 0;
+    for(std::size_t i = 0; i < origins.size(); ++i) {
+      const auto expected = bruteForce(sphere, origins[i], directions[i]);
+      if(expected == rbt::INF) {
+        CHECK(!hits[i].hit());
+      } else {
+        CHECK(hits[i].distance == Approx(expected).epsilon(1e-3));
+        ++hit;
+      }
+      CHECK(static_cast<bool>(occluded[i]) == hits[i].hit());
+    }
+    // Plenty of both
+    CHECK(hit > 30);
+    CHECK(hit < 250);
+  }
+
+  SECTION("casts against placed objects") {
+    auto scene = RayScene({ box, rbt::box(Vector3({-1, -1, -1}), Vector3({1, 1, 1})) });
+    scene.place(0, RigidMatrix(rbt::Transform(Vector3({0, 0, 1}), rbt::toRadians(90), Vector3({10, 0, 0}))));
+    scene.place(1, RigidMatrix(rbt::Transform(Vector3({0, 0, 1}), 0, Vector3({20, 0, 0}))));
+
+    // The first box is turned so its 4 wide side faces along x
+    const auto first = scene.raycast(Vector3({0, 0, 0}), Vector3({1, 0, 0}));
+    CHECK(first.object == 0);
+    CHECK(first.distance == Approx(8));
+
+    const auto second = scene.raycast(Vector3({0, 0, 2.5}), Vector3({1, 0, 0}));
+    CHECK(second.object == 0);
+    const auto third = scene.raycast(Vector3({30, 0, 0}), Vector3({-1, 0, 0}));
+    CHECK(third.object == 1);
+    CHECK(third.distance == Approx(9));
+
+    scene.place(1, RigidMatrix(rbt::Transform(Vector3({0, 0, 1}), 0, Vector3({20, 0, 5}))));
+    CHECK(scene.raycast(Vector3({30, 0, 0}), Vector3({-1, 0, 0})).object == 0);
+  }
+
+  SECTION("casts against posed robot links") {
+    const auto robot = rbt::ABB_IRB_120;
+    std::vector<Mesh> links;
+    for(std::size_t link = 0; link <= robot.joints().size(); ++link) {
+      links.push_back(rbt::sphere(Vector3({0, 0, 0}), Real(40 - 4 * Real(link)), 6, 12));
+    }
+    auto scene = RayScene(links);
+
+    std::mt19937 generator(7);
+    for(int pose = 0; pose < 3; ++pose) {
+      const rbt::Angles angles = { Real(0.3 * pose), Real(-0.2 * pose), Real(0.5 * pose), 0.1, Real(0.4 * pose), 0 };
+      const auto frames = robot.linkPoses(angles);
+      scene.place(frames);
+
+      Mesh world;
+      for(std::size_t link = 0; link < links.size(); ++link) {
+        const auto placement = RigidMatrix(frames[link]);
+        for(const auto& t : links[link]) world.push_back(rbt::Triangle({ placement(t[0]), placement(t[1]), placement(t[2]) }));
+      }
+
+      const auto origins = randomPoints(generator, 200, 600);
+      auto directions = randomPoints(generator, 200, 1);
+      // Aim roughly at the robot
+      for(std::size_t i = 0; i < origins.size(); ++i) {
+        directions.set(i, Vector3({300, 0, 500}) - origins[i] + Real(300) * directions[i]);
+      }
+
+      std::vector<RayHit> hits;
+      scene.raycast(origins, directions, hits);
+      for(std::size_t i = 0; i < origins.size(); ++i) {
+        const auto expected = bruteForce(world, origins[i], directions[i]);
+        if(expected == rbt::INF) {
+          CHECK(!hits[i].hit());
+        } else {
+          CHECK(hits[i].distance == Approx(expected).epsilon(1e-3));
+        }
+      }
+    }
+  }
+}
@@ -5,13 +5,20 @@
 
 namespace rbt {
 
+// Speeds from the data sheet; accelerations and jerks are nominal
 const auto ABB_IRB_120 = Serial({
-  Joint(toRadians( -90),    0, toRadians(   0),  290, Vector2({ toRadians(-165), toRadians(165) })),
-  Joint(toRadians(   0),  270, toRadians( -90),    0, Vector2({ toRadians(-110), toRadians(110) })),
-  Joint(toRadians( -90),   70, toRadians(   0),    0, Vector2({ toRadians(-110), toRadians(70)  })),
-  Joint(toRadians(  90),    0, toRadians(   0),  302, Vector2({ toRadians(-160), toRadians(160) })),
-  Joint(toRadians( -90),    0, toRadians(   0),    0, Vector2({ toRadians(-120), toRadians(120) })),
-  Joint(toRadians(   0),    0, toRadians( 180),   72, Vector2({ toRadians(-400), toRadians(400) }))
+  Joint(toRadians( -90),    0, toRadians(   0),  290, Vector2({ toRadians(-165), toRadians(165) }),
+    MotionLimits{ toRadians(250), toRadians(1200), toRadians(12000) }),
+  Joint(toRadians(   0),  270, toRadians( -90),    0, Vector2({ toRadians(-110), toRadians(110) }),
+    MotionLimits{ toRadians(250), toRadians(1000), toRadians(10000) }),
+  Joint(toRadians( -90),   70, toRadians(   0),    0, Vector2({ toRadians(-110), toRadians(70)  }),
+    MotionLimits{ toRadians(250), toRadians(1200), toRadians(12000) }),
+  Joint(toRadians(  90),    0, toRadians(   0),  302, Vector2({ toRadians(-160), toRadians(160) }),
+    MotionLimits{ toRadians(320), toRadians(2000), toRadians(20000) }),
+  Joint(toRadians( -90),    0, toRadians(   0),    0, Vector2({ toRadians(-120), toRadians(120) }),
+    MotionLimits{ toRadians(320), toRadians(2000), toRadians(20000) }),
+  Joint(toRadians(   0),    0, toRadians( 180),   72, Vector2({ toRadians(-400), toRadians(400) }),
+    MotionLimits{ toRadians(420), toRadians(3000), toRadians(30000) })
 });
 
 }
@@ -0,0 +1,113 @@
+#include "third_party/catch.hpp"
+#include "meshes/box.hpp"
+
+#include "ik.hpp"
+#include "joint.hpp"
+#include "serial.hpp"
+#include "collision/self_collision.hpp"
+#include "spatial/vector.hpp"
+
+using rbt::AngleSets;
+using rbt::Angles;
+using rbt::Joint;
+using rbt::Mesh;
+using rbt::Serial;
+using rbt::Vector3;
+using rbt::box;
+using rbt::toRadians;
+using rbt::collision::AllowedCollisionMatrix;
+using rbt::collision::LinkPair;
+using rbt::collision::SelfCollision;
+
+namespace {
+
+// A planar arm of three 100 unit links rotating about Z
+const auto PLANAR = Serial({
+  Joint(0, 100, 0, 0),
+  Joint(0, 100, 0, 0),
+  Joint(0, 100, 0, 0)
+});
+
+// Each link frame sits at the far end of its link, so link geometry spans [-100, 0] along X
+std::vector<Mesh> planarMeshes() {
+  const auto link = box(Vector3({-95, -5, -5}), Vector3({-5, 5, 5}));
+  return {
+    box(Vector3({-100, -10, -10}), Vector3({-60, 10, 10})),
+    link,
+    link,
+    link
+  };
+}
+
+}
+
+TEST_CASE("AllowedCollisionMatrix") {
+  auto acm = AllowedCollisionMatrix(4);
+
+  SECTION("allows adjacent links by default") {
+    CHECK(acm.allowed(0, 1));
+    CHECK(acm.allowed(2, 1));
+    CHECK_FALSE(acm.allowed(0, 2));
+  }
+
+  SECTION("is symmetric") {
+    acm.allow(3, 0);
+    CHECK(acm.allowed(0, 3));
+
+    acm.allow(1, 0, false);
+    CHECK_FALSE(acm.allowed(0, 1));
+  }
+}
+
+TEST_CASE("SelfCollision") {
+  const auto checker = SelfCollision(PLANAR, planarMeshes());
+
+  SECTION("a straight arm is collision free") {
+    CHECK_FALSE(checker.inCollision({ 0, 0, 0 }));
+  }
+
+  SECTION("a folded arm is collision free when links pass each other") {
+    CHECK_FALSE(checker.inCollision({ 0, toRadians(90), toRadians(90) }));
+  }
+
+  SECTION("a folded arm hits itself") {
+    const Angles folded = { 0, toRadians(170), toRadians(170) };
+
+    CHECK(checker.inCollision(folded));
+    CHECK(checker.collisions(folded) == std::vector<LinkPair>({ { 1, 3 } }));
+  }
+
+  SECTION("reuses scratch space across queries") {
+    SelfCollision::Scratch scratch;
+    std::vector<LinkPair> pairs = { { 0, 2 } };
+
+    CHECK(checker.inCollision({ 0, toRadians(170), toRadians(170) }, scratch));
+    CHECK_FALSE(checker.inCollision({ 0, 0, 0 }, scratch));
+    checker.collisions({ 0, toRadians(170), toRadians(170) }, pairs, scratch);
+    CHECK(pairs == std::vector<LinkPair>({ { 1, 3 } }));
+    checker.collisions({ 0, 0, 0 }, pairs, scratch);
+    CHECK(pairs.empty());
+  }
+
+  SECTION("respects the allowed collision matrix") {
+    const Angles intoBase = { toRadians(180), 0, 0 };
+    CHECK_FALSE(checker.inCollision(intoBase));
+
+    auto acm = AllowedCollisionMatrix(4);
+    acm.allow(0, 1, false);
+    CHECK(SelfCollision(PLANAR, planarMeshes(), acm).inCollision(intoBase));
+  }
+
+  SECTION("filters inverse kinematics solutions") {
+    auto sets = AngleSets({
+      { 0, 0, 0 },
+      { 0, toRadians(170), toRadians(170) },
+      { rbt::ik::SINGULAR, toRadians(170), toRadians(170) }
+    });
+
+    rbt::ik::removeIfSelfColliding(sets, checker);
+
+    CHECK(sets.size() == 2);
+    CHECK(sets[0] == Angles({ 0, 0, 0 }));
+  }
+}
@@ -0,0 +1,123 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "meshes/box.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "collision/capsule.hpp"
+#include "collision/self_filter.hpp"
+#include "spatial/matrix.hpp"
+#include "spatial/points.hpp"
+#include "spatial/vector.hpp"
+
+#include <random>
+
+using rbt::Angles;
+using rbt::Mesh;
+using rbt::Points;
+using rbt::Real;
+using rbt::RigidMatrix;
+using rbt::Vector3;
+using rbt::toRadians;
+using rbt::collision::Capsule;
+using rbt::collision::SelfFilter;
+
+namespace {
+
+// A capsule along the x axis of every moving link, and none for the base.
+std::vector<Capsule> proxies() {
+  std::vector<Capsule> result(1, Capsule());
+  for(std::size_t link = 1; link <= rbt::ABB_IRB_120.joints().size(); ++link) {
+    result.push_back(Capsule(Vector3({0, 0, 0}), Vector3({100, 0, 0}), 30));
+  }
+  return result;
+}
+
+// Whether the point is within any padded proxy, one capsule at a time.
+bool inside(const SelfFilter& filter, const std::vector<rbt::Frame>& frames, const Vector3& point) {
+  for(std::size_t link = 0; link < frames.size(); ++link) {
+    const auto& proxy = filter.proxies()[link];
+    if(proxy.radius <= 0) continue;
+
+    const auto capsule = rbt::collision::transform(proxy, RigidMatrix(frames[link]));
+    if(rbt::collision::distance(capsule, Capsule(point, point, 0)) <= 0) return true;
+  }
+  return false;
+}
+
+}
+
+TEST_CASE("Self filter") {
+  const auto robot = rbt::ABB_IRB_120;
+  const Angles angles = { toRadians(30), toRadians(-20), toRadians(10), toRadians(45), toRadians(60), toRadians(90) };
+  const auto frames = robot.linkPoses(angles);
+
+  SECTION("grows the proxies by the padding") {
+    // Only link 3, so no other link covers the points
+    std::vector<Capsule> single(robot.joints().size() + 1, Capsule());
+    single[3] = Capsule(Vector3({0, 0, 0}), Vector3({100, 0, 0}), 30);
+    const auto filter = SelfFilter(robot, single, 5);
+    const auto placement = RigidMatrix(frames[3]);
+
+    Points points;
+    points.push_back(placement(Vector3({50, 0, 34})));
+    points.push_back(placement(Vector3({50, 0, 36})));
+    points.push_back(placement(Vector3({-34, 0, 0})));
+    points.push_back(placement(Vector3({-36, 0, 0})));
+
+    std::vector<uint8_t> result;
+    filter.inside(angles, points, result);
+    CHECK(result == std::vector<uint8_t>({ 1, 0, 1, 0 }));
+
+    // But not the placeholders of links without geometry
+    CHECK(filter.proxies()[0].radius == 0);
+    CHECK(filter.proxies()[3].radius == 35);
+  }
+
+  SECTION("fits proxies to link meshes") {
+    std::vector<Mesh> links(robot.joints().size() + 1);
+    links[2] = rbt::box(Vector3({0, -10, -10}), Vector3({200, 10, 10}));
+    const auto filter = SelfFilter(robot, links, 2);
+
+    CHECK(filter.proxies()[0].radius == 0);
+    CHECK(filter.proxies()[2].radius >= Real(std::sqrt(200) + 2 - 1e-3));
+
+    // The whole box is covered
+    std::vector<uint8_t> result;
+    Points corners;
+    for(const auto& triangle : links[2]) {
+      for(std::size_t i = 0; i < 3; ++i) corners.push_back(RigidMatrix(frames[2])(triangle[i]));
+    }
+    filter.inside(angles, corners, result);
+    CHECK(std::all_of(result.begin(), result.end(), [](uint8_t i) { return i == 1; }));
+  }
+
+  SECTION("agrees with testing every capsule") {
+    const auto filter = SelfFilter(robot, proxies(), 10);
+
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<Real> coordinate(-300, 800);
+    Points cloud;
+    // Enough for the parallel path, and not a whole number of blocks
+    for(std::size_t i = 0; i < SelfFilter::PARALLEL_THRESHOLD + 13; ++i) {
+      cloud.push_back(Vector3({ coordinate(generator), coordinate(generator), coordinate(generator) }));
+    }
+
+    std::vector<uint8_t> result;
+    filter.inside(angles, cloud, result);
+    REQUIRE(result.size() == cloud.size());
+
+    std::size_t count = 0;
+    for(std::size_t i = 0; i < cloud.size(); ++i) {
+      REQUIRE(static_cast<bool>(result[i]) == inside(filter, frames, cloud[i]));
+      count += result[i];
+    }
+    CHECK(count > 100);
+
+    auto kept = cloud;
+    CHECK(filter.remove(angles, kept) == count);
+    REQUIRE(kept.size() == cloud.size() - count);
+    for(std::size_t i = 0, k = 0; i < cloud.size(); ++i) {
+      if(!result[i]) REQUIRE_THAT(kept[k++], ComponentsEqual(cloud[i]));
+    }
+  }
+}
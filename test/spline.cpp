@@ -0,0 +1,207 @@
+#include "third_party/catch.hpp"
+
+#include "spline.hpp"
+#include "utilities.hpp"
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using rbt::AngleSets;
+using rbt::Angles;
+using rbt::JointSpline;
+using rbt::Real;
+
+namespace {
+
+// A move of one joint from 0 to 1 (and of another from 1 to -1) over duration, at times (fractions of it) and the
+// state of the first at a fraction, in a shape p of the fraction with its first two derivatives.
+struct Move {
+  Real duration;
+  std::vector<Real> fractions;
+  Real (*p)(Real), (*dp)(Real), (*ddp)(Real);
+
+  AngleSets waypoints() const {
+    AngleSets waypoints;
+    for(const auto u : this->fractions) waypoints.push_back({ this->p(u), 1 - 2 * this->p(u) });
+    return waypoints;
+  }
+
+  std::vector<Real> times() const {
+    std::vector<Real> times;
+    for(const auto u : this->fractions) times.push_back(u * this->duration);
+    return times;
+  }
+
+  // Samples of the spline throughout, against the move.
+  void check(const JointSpline& spline) const {
+    for(int i = 0; i <= 200; ++i) {
+      const auto u = Real(i) / 200, time = u * this->duration;
+      Real positions[2], velocities[2], accelerations[2];
+      spline.evaluate(&time, 1, positions, velocities, accelerations);
+
+      REQUIRE(positions[0] == Approx(this->p(u)).margin(1e-5));
+      REQUIRE(positions[1] == Approx(1 - 2 * this->p(u)).margin(1e-5));
+      REQUIRE(velocities[0] == Approx(this->dp(u) / this->duration).margin(1e-4));
+      REQUIRE(accelerations[0] == Approx(this->ddp(u) / (this->duration * this->duration)).margin(1e-3));
+      REQUIRE(accelerations[1] == Approx(-2 * this->ddp(u) / (this->duration * this->duration)).margin(1e-3));
+    }
+  }
+};
+
+// Whether values just before and after a time (and further before and after) change no more across it than either
+// side of it, give or take a tolerance.
+bool continuous(Real before, Real after, Real further, Real later, Real tolerance) {
+  return std::abs(after - before) <= Real(1.5) * (std::abs(before - further) + std::abs(later - after)) + tolerance;
+}
+
+AngleSets random(std::mt19937& generator, std::size_t count, std::size_t joints) {
+  std::uniform_real_distribution<Real> angle(-3, 3);
+  AngleSets sets(count, Angles(joints));
+  for(auto& set : sets) for(auto& value : set) value = angle(generator);
+  return sets;
+}
+
+std::vector<Real> increasing(std::mt19937& generator, std::size_t count) {
+  std::uniform_real_distribution<Real> step(0.1f, 0.5f);
+  std::vector<Real> times({ 1 });
+  while(times.size() < count) times.push_back(times.back() + step(generator));
+  return times;
+}
+
+}
+
+TEST_CASE("Joint splines") {
+  std::mt19937 generator(7);
+  const auto fractions = std::vector<Real>({ 0, 0.1f, 0.35f, 0.5f, 0.8f, 1 });
+
+  SECTION("reproduce a cubic starting and ending at rest") {
+    const auto move = Move{ 2, fractions,
+      [](Real u) { return 3 * u * u - 2 * u * u * u; },
+      [](Real u) { return 6 * u - 6 * u * u; },
+      [](Real u) { return 6 - 12 * u; } };
+
+    move.check(JointSpline::cubic(move.waypoints(), move.times()));
+  }
+
+  SECTION("reproduce a minimum jerk move") {
+    const auto move = Move{ 1.5f, fractions,
+      [](Real u) { return u * u * u * (10 + u * (-15 + 6 * u)); },
+      [](Real u) { return 30 * u * u * (1 + u * (-2 + u)); },
+      [](Real u) { return 60 * u * (1 + u * (-3 + 2 * u)); } };
+
+    move.check(JointSpline::quintic(move.waypoints(), move.times()));
+  }
+
+  SECTION("pass smoothly through the waypoints") {
+    const auto waypoints = random(generator, 12, 6);
+    const auto times = increasing(generator, 12);
+
+    for(const auto& spline : { JointSpline::cubic(waypoints, times), JointSpline::quintic(waypoints, times) }) {
+      REQUIRE(spline.joints() == 6);
+      CHECK(spline.start() == times.front());
+      CHECK(spline.end() == times.back());
+
+      for(std::size_t i = 0; i < times.size(); ++i) {
+        const auto angles = spline(times[i]);
+        for(std::size_t j = 0; j < 6; ++j) REQUIRE(angles[j] == Approx(waypoints[i][j]).margin(1e-4));
+      }
+
+      // Velocities and accelerations are continuous across the waypoints: they change no more across each one than
+      // either side of it
+      const Real step = 1e-4f;
+      for(std::size_t i = 1; i + 1 < times.size(); ++i) {
+        const Real around[4] = { times[i] - 2 * step, times[i] - step, times[i] + step, times[i] + 2 * step };
+        Real velocities[24], accelerations[24];
+        spline.evaluate(around, 4, nullptr, velocities, accelerations);
+
+        for(std::size_t j = 0; j < 6; ++j) {
+          REQUIRE(continuous(velocities[6 + j], velocities[12 + j], velocities[j], velocities[18 + j], 1e-3f));
+          REQUIRE(continuous(accelerations[6 + j], accelerations[12 + j], accelerations[j], accelerations[18 + j],
+            0.02f));
+        }
+      }
+
+      // At rest at the ends
+      const Real ends[2] = { times.front(), times.back() };
+      Real velocities[12];
+      spline.evaluate(ends, 2, nullptr, velocities);
+      for(const auto velocity : velocities) CHECK(velocity == Approx(0).margin(1e-4));
+    }
+
+    // The quintic spline also starts and ends without acceleration
+    const auto quintic = JointSpline::quintic(waypoints, times);
+    const Real ends[2] = { times.front(), times.back() };
+    Real accelerations[12];
+    quintic.evaluate(ends, 2, nullptr, nullptr, accelerations);
+    for(const auto acceleration : accelerations) CHECK(acceleration == Approx(0).margin(1e-3));
+  }
+
+  SECTION("take the velocities and accelerations they're given") {
+    const auto waypoints = random(generator, 5, 3);
+    const auto velocities = random(generator, 5, 3);
+    const auto accelerations = random(generator, 5, 3);
+    const auto times = increasing(generator, 5);
+    const auto spline = JointSpline::hermite(waypoints, velocities, accelerations, times);
+
+    for(std::size_t i = 0; i < times.size(); ++i) {
+      Real position[3], velocity[3], acceleration[3];
+      spline.evaluate(&times[i], 1, position, velocity, acceleration);
+
+      for(std::size_t j = 0; j < 3; ++j) {
+        REQUIRE(position[j] == Approx(waypoints[i][j]).margin(1e-4));
+        REQUIRE(velocity[j] == Approx(velocities[i][j]).margin(1e-3));
+        REQUIRE(acceleration[j] == Approx(accelerations[i][j]).margin(1e-2));
+      }
+    }
+  }
+
+  SECTION("evaluate in batches as one time at a time") {
+    // More joints than a register holds, with times out of order and beyond the ends
+    const std::size_t joints = 11, count = 300;
+    const auto times = increasing(generator, 20);
+    const auto spline = JointSpline::quintic(random(generator, 20, joints), times);
+
+    std::uniform_real_distribution<Real> time(times.front() - 1, times.back() + 1);
+    std::vector<Real> samples(count);
+    for(auto& sample : samples) sample = time(generator);
+
+    // With one more sample's worth to see nothing is written past the end
+    std::vector<Real> positions((count + 1) * joints, -100), velocities((count + 1) * joints, -100);
+    spline.evaluate(samples.data(), count, positions.data(), velocities.data());
+
+    for(std::size_t i = 0; i < count; ++i) {
+      const auto angles = spline(samples[i]);
+      for(std::size_t j = 0; j < joints; ++j) REQUIRE(positions[i * joints + j] == Approx(angles[j]).margin(1e-5));
+    }
+    for(std::size_t j = 0; j < joints; ++j) {
+      CHECK(positions[count * joints + j] == -100);
+      CHECK(velocities[count * joints + j] == -100);
+    }
+
+    AngleSets sets;
+    spline.evaluate(samples, sets);
+    REQUIRE(sets.size() == count);
+    CHECK(sets[7] == spline(samples[7]));
+  }
+
+  SECTION("hold the ends outside their times") {
+    const auto waypoints = random(generator, 4, 2);
+    const auto times = increasing(generator, 4);
+    const auto spline = JointSpline::cubic(waypoints, times);
+
+    CHECK(spline(times.front() - 10) == spline(times.front()));
+    CHECK(spline(times.back() + 10) == spline(times.back()));
+  }
+
+  SECTION("reject bad waypoints and times") {
+    const auto waypoints = AngleSets({ { 0, 1 }, { 1, 2 }, { 2, 3 } });
+    CHECK_THROWS_AS(JointSpline::cubic({ { 0, 1 } }, { 0 }), std::invalid_argument);
+    CHECK_THROWS_AS(JointSpline::cubic(waypoints, { 0, 1 }), std::invalid_argument);
+    CHECK_THROWS_AS(JointSpline::quintic(waypoints, { 0, 1, 1 }), std::invalid_argument);
+    CHECK_THROWS_AS(JointSpline::quintic({ { 0, 1 }, { 1 }, { 2, 3 } }, { 0, 1, 2 }), std::invalid_argument);
+    CHECK_THROWS_AS(JointSpline::cubic({ { 0, 1 }, { rbt::INF, 2 } }, { 0, 1 }), std::invalid_argument);
+    CHECK_THROWS_AS(JointSpline::hermite(waypoints, waypoints, { { 0, 0 } }, { 0, 1, 2 }), std::invalid_argument);
+  }
+}
@@ -0,0 +1,51 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+
+#include "spatial/points.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+#include "visual/file_types/stl/stl_parser.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using rbt::Points;
+using rbt::Real;
+using rbt::Triangle;
+using rbt::Vector3;
+using rbt::visual::STLParser;
+
+TEST_CASE("STL parser") {
+  SECTION("reads triangles and their facet normals") {
+    const auto path = (std::filesystem::temp_directory_path() / "robot_stl_parser_test.stl").string();
+    {
+      std::ofstream file(path, std::ios::binary);
+      file << std::string(80, ' ');
+      const uint32_t count = 2;
+      file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+      const float facets[2][12] = {
+        { 0, 0, 1,   0, 0, 0,   1, 0, 0,   0, 1, 0 },
+        { 0, 0, -1,  0, 0, 5,   0, 1, 5,   1, 0, 5 }
+      };
+      const uint16_t attribute = 0;
+      for(const auto& facet : facets) {
+        file.write(reinterpret_cast<const char*>(facet), sizeof(facet));
+        file.write(reinterpret_cast<const char*>(&attribute), sizeof(attribute));
+      }
+    }
+
+    std::vector<Triangle> triangles;
+    Points normals;
+    CHECK_NOTHROW(STLParser().parse(path, triangles, normals));
+    std::remove(path.c_str());
+
+    REQUIRE(triangles.size() == 2);
+    REQUIRE(normals.size() == 2);
+    CHECK_THAT(triangles[1][1], ComponentsEqual(Vector3({0, 1, 5})));
+    CHECK_THAT(normals[0], ComponentsEqual(Vector3({0, 0, 1})));
+    CHECK_THAT(normals[1], ComponentsEqual(Vector3({0, 0, -1})));
+  }
+}
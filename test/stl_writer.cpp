@@ -0,0 +1,93 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+#include "meshes/box.hpp"
+#include "meshes/sphere.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "link_meshes.hpp"
+#include "spatial/points.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+#include "visual/file_types/stl/stl_parser.hpp"
+#include "visual/file_types/stl/stl_writer.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using rbt::Angles;
+using rbt::LinkMeshes;
+using rbt::Mesh;
+using rbt::Points;
+using rbt::Real;
+using rbt::Triangle;
+using rbt::Vector3;
+using rbt::toRadians;
+using rbt::visual::STLParser;
+using rbt::visual::STLWriter;
+
+TEST_CASE("STL writer") {
+  const auto path = (std::filesystem::temp_directory_path() / "robot_stl_writer_test.stl").string();
+
+  SECTION("writes triangles back as they were read") {
+    const auto box = rbt::box(Vector3({-1, -2, -3}), Vector3({1, 2, 3}));
+    STLWriter().write(path, box);
+
+    std::vector<Triangle> triangles;
+    Points normals;
+    STLParser().parse(path, triangles, normals);
+
+    REQUIRE(triangles.size() == box.size());
+    const auto expected = rbt::normals(box);
+    for(std::size_t t = 0; t < box.size(); ++t) {
+      for(std::size_t i = 0; i < 3; ++i) CHECK(triangles[t][i] == box[t][i]);
+      CHECK_THAT(normals[t], ComponentsEqual(expected[t]));
+    }
+
+    // 80 byte header, facet count, then 50 bytes per facet
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    CHECK(static_cast<std::size_t>(file.tellg()) == 84 + 50 * box.size());
+  }
+
+  SECTION("writes every link of a posed robot") {
+    const auto robot = rbt::ABB_IRB_120;
+    std::vector<Mesh> links;
+    for(std::size_t link = 0; link <= robot.joints().size(); ++link) {
+      // Enough facets in one link for the parallel path
+      links.push_back((link == 2)
+        ? rbt::sphere(Vector3({100, 0, 0}), 40, 96, 96)
+        : rbt::box(Vector3({0, 0, 0}), Vector3({Real(10 + link), 20, 30})));
+    }
+    REQUIRE(links[2].size() > STLWriter::PARALLEL_THRESHOLD);
+
+    const auto meshes = LinkMeshes(robot, links);
+    const Angles angles = { toRadians(10), toRadians(-20), toRadians(30), toRadians(40), toRadians(50), toRadians(60) };
+
+    auto writer = STLWriter();
+    // Writing twice reuses the buffers
+    writer.write(path, meshes, { 0, 0, 0, 0, 0, 0 });
+    writer.write(path, meshes, angles);
+
+    std::vector<Triangle> triangles;
+    Points normals;
+    STLParser().parse(path, triangles, normals);
+
+    const auto posed = meshes.pose(angles);
+    std::size_t facet = 0;
+    for(const auto& link : posed) {
+      for(std::size_t t = 0; t < link.normals.size(); ++t, ++facet) {
+        REQUIRE(facet < triangles.size());
+        for(std::size_t i = 0; i < 3; ++i) REQUIRE(triangles[facet][i] == link.vertices[3 * t + i]);
+        REQUIRE(normals[facet] == link.normals[t]);
+      }
+    }
+    CHECK(facet == triangles.size());
+  }
+
+  std::remove(path.c_str());
+
+  SECTION("fails to write where it can't") {
+    CHECK_THROWS_AS(STLWriter().write("no/such/directory/robot.stl", rbt::box(Vector3(), Vector3({1, 1, 1}))), std::runtime_error);
+  }
+}
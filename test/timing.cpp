@@ -0,0 +1,131 @@
+#include "third_party/catch.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "frame.hpp"
+#include "joint.hpp"
+#include "path.hpp"
+#include "timing.hpp"
+#include "utilities.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+using rbt::ABB_IRB_120;
+using rbt::AngleSets;
+using rbt::Angles;
+using rbt::CartesianPath;
+using rbt::MotionLimits;
+using rbt::Real;
+using rbt::timeOptimal;
+using rbt::toRadians;
+
+namespace {
+
+// count waypoints evenly spaced along a line from one set of angles to another.
+AngleSets line(const Angles& from, const Angles& to, std::size_t count) {
+  AngleSets path;
+  for(std::size_t i = 0; i < count; ++i) {
+    const auto s = Real(i) / Real(count - 1);
+    Angles angles;
+    for(std::size_t j = 0; j < from.size(); ++j) angles.push_back(from[j] + s * (to[j] - from[j]));
+    path.push_back(angles);
+  }
+  return path;
+}
+
+}
+
+TEST_CASE("Time optimal path parameterization") {
+  SECTION("joints are unlimited by default") {
+    const auto joint = rbt::Joint(0, 0, 0, 0);
+    CHECK(std::isinf(joint.motion.velocity));
+    CHECK(std::isinf(joint.motion.acceleration));
+    CHECK(std::isinf(joint.motion.jerk));
+    CHECK(ABB_IRB_120.motionLimits().size() == 6);
+  }
+
+  SECTION("accelerates, cruises and brakes along a line") {
+    // 1 rad at up to 1 rad/s and 2 rad/s^2: 0.5 s to reach full speed over 0.25 rad, 0.5 s cruising, 0.5 s braking
+    const auto times = timeOptimal(line({ 0 }, { 1 }, 2001), { MotionLimits{ 1, 2, 10 } });
+
+    REQUIRE(times.size() == 2001);
+    CHECK(times.front() == 0);
+    CHECK(times.back() == Approx(1.5).epsilon(0.01));
+    CHECK(times[1000] == Approx(0.75).epsilon(0.01));
+  }
+
+  SECTION("never reaches full speed on a short move") {
+    // 0.25 rad at 2 rad/s^2: accelerating over half of it for sqrt(0.125) s, peaking at 0.71 rad/s, then braking
+    const auto times = timeOptimal(line({ 0 }, { 0.25 }, 1001), { MotionLimits{ 1, 2, 10 } });
+    CHECK(times.back() == Approx(2 * std::sqrt(0.125)).epsilon(0.01));
+  }
+
+  SECTION("times a move of two waypoints") {
+    // 0.25 rad at 2 rad/s^2: sqrt(0.125) s accelerating and as long braking, as over many waypoints
+    const auto limits = std::vector<MotionLimits>(2, MotionLimits{ 1, 2, 10 });
+    const auto times = timeOptimal(line({ 0, 0 }, { 0.25, 0.1f }, 2), limits);
+
+    REQUIRE(times.size() == 2);
+    CHECK(times.front() == 0);
+    CHECK(times.back() == Approx(2 * std::sqrt(0.125)));
+
+    // Reaching full speed: 0.5 s each way over 0.25 rad, cruising over the other 0.5 rad
+    CHECK(timeOptimal(line({ 0 }, { 1 }, 2), { MotionLimits{ 1, 2, 10 } }).back() == Approx(1.5));
+    CHECK(timeOptimal(line({ 1 }, { 1 }, 2), { MotionLimits{ 1, 2, 10 } }).back() == 0);
+  }
+
+  SECTION("is limited by the slowest joint") {
+    const auto limits = std::vector<MotionLimits>({ MotionLimits{ 1, 2, 10 }, MotionLimits{ 0.5, 2, 10 } });
+    const auto times = timeOptimal(line({ 0, 0 }, { 1, 1 }, 2001), limits);
+
+    // 0.25 s to reach 0.5 rad/s over 0.0625 rad each way, cruising for the other 0.875 rad
+    CHECK(times.back() == Approx(0.25 + 1.75 + 0.25).epsilon(0.01));
+  }
+
+  SECTION("keeps the joints of an IK path within their limits") {
+    const auto start = Angles({ toRadians(10), toRadians(20), toRadians(-10), toRadians(30), toRadians(40), toRadians(-20) });
+    const auto via = Angles({ toRadians(-10), toRadians(30), toRadians(0), toRadians(0), toRadians(50), toRadians(0) });
+    const auto end = Angles({ toRadians(-30), toRadians(10), toRadians(5), toRadians(-20), toRadians(60), toRadians(10) });
+    const auto path = CartesianPath::circular(ABB_IRB_120.pose(start), ABB_IRB_120.pose(via), ABB_IRB_120.pose(end));
+    const auto joints = rbt::jointPath(path, ABB_IRB_120, start, 1);
+    REQUIRE(joints.size() > 100);
+
+    const auto times = timeOptimal(joints, ABB_IRB_120);
+    const auto limits = ABB_IRB_120.motionLimits();
+
+    REQUIRE(times.size() == joints.size());
+    for(std::size_t i = 1; i < joints.size(); ++i) REQUIRE(times[i] > times[i - 1]);
+
+    // By finite differences, over a few waypoints to smooth out the noise of the IK solutions
+    const std::size_t span = 4;
+    const auto velocity = [&](std::size_t i, std::size_t j) {
+      return (joints[i + span][j] - joints[i][j]) / (times[i + span] - times[i]);
+    };
+
+    Real fastest = 0, hardest = 0;
+    for(std::size_t i = 0; i + 2 * span < joints.size(); ++i) {
+      for(std::size_t j = 0; j < 6; ++j) {
+        const auto acceleration = (velocity(i + span, j) - velocity(i, j)) / (0.5f * (times[i + 2 * span] - times[i]));
+        fastest = std::max(fastest, std::abs(velocity(i, j)) / limits[j].velocity);
+        hardest = std::max(hardest, std::abs(acceleration) / limits[j].acceleration);
+      }
+    }
+
+    CHECK(fastest <= 1.05);
+    CHECK(hardest <= 1.05);
+    // Time optimal, so some joint is at full speed or acceleration somewhere
+    CHECK(std::max(fastest, hardest) >= 0.95);
+  }
+
+  SECTION("takes no time without moving") {
+    const auto times = timeOptimal(line({ 1, 2 }, { 1, 2 }, 10), std::vector<MotionLimits>(2, MotionLimits{ 1, 1, 1 }));
+    CHECK(times.back() == 0);
+    CHECK(timeOptimal(AngleSets(), ABB_IRB_120).empty());
+  }
+
+  SECTION("rejects mismatched waypoints and limits") {
+    CHECK_THROWS_AS(timeOptimal(line({ 0, 0 }, { 1, 1 }, 10), ABB_IRB_120), std::invalid_argument);
+    CHECK_THROWS_AS(timeOptimal(line({ 0 }, { 1 }, 10), { MotionLimits{ 0, 1, 1 } }), std::invalid_argument);
+    CHECK_THROWS_AS(timeOptimal({ { rbt::INF } }, { MotionLimits() }), std::invalid_argument);
+  }
+}
@@ -0,0 +1,176 @@
+#include "third_party/catch.hpp"
+#include "robots/abb_irb_120.hpp"
+
+#include "joint.hpp"
+#include "serial.hpp"
+#include "trajectory.hpp"
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+using rbt::ABB_IRB_120;
+using rbt::JointState;
+using rbt::JointTarget;
+using rbt::OnlineTrajectory;
+using rbt::Real;
+using rbt::TRAJECTORY_JOINTS;
+using rbt::toRadians;
+
+namespace {
+
+// Follow the generator from state until it reports the target reached, checking the limits on the way and moving
+// the target along. Returns the cycles taken.
+std::size_t follow(OnlineTrajectory& generator, JointState& state, JointTarget& target, std::size_t cycles = 10000) {
+  const auto limits = ABB_IRB_120.motionLimits();
+  const auto cycle = generator.cycle();
+
+  for(std::size_t i = 1; i <= cycles; ++i) {
+    JointState next;
+    const auto reached = generator.update(state, target, next);
+
+    for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+      REQUIRE(std::abs(next.velocity[j]) <= limits[j].velocity * 1.001);
+      REQUIRE(std::abs(next.acceleration[j]) <= limits[j].acceleration * 1.001);
+      REQUIRE(std::abs(next.acceleration[j] - state.acceleration[j]) <= limits[j].jerk * cycle * 1.001);
+    }
+
+    state = next;
+    for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) target.position[j] += target.velocity[j] * cycle;
+    if(reached) return i;
+  }
+
+  FAIL("The target wasn't reached");
+  return cycles;
+}
+
+}
+
+TEST_CASE("Online trajectory generation") {
+  auto generator = OnlineTrajectory(ABB_IRB_120, 0.001);
+  const auto limits = ABB_IRB_120.motionLimits();
+
+  SECTION("moves one joint as fast as its limits allow") {
+    JointState state, next;
+    JointTarget target;
+    target.position[0] = 2;
+    generator.update(state, target, next);
+
+    // Ramping the acceleration up and down at each end and cruising the rest of the way
+    const Real velocity = limits[0].velocity, acceleration = limits[0].acceleration, jerk = limits[0].jerk;
+    CHECK(generator.duration() == Approx(2 / velocity + velocity / acceleration + acceleration / jerk).epsilon(1e-4));
+    CHECK(next.acceleration[0] == Approx(jerk * 0.001).epsilon(1e-3));
+  }
+
+  SECTION("reaches the target at rest within the limits") {
+    JointState state;
+    JointTarget target;
+    target.position = { 1, -0.5, 0.3, 2, -1, 3 };
+
+    const auto cycles = follow(generator, state, target);
+    CHECK(cycles > 100);
+    for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+      CHECK(state.position[j] == Approx(target.position[j]));
+      CHECK(state.velocity[j] == 0);
+      CHECK(state.acceleration[j] == 0);
+    }
+  }
+
+  SECTION("synchronizes the joints") {
+    JointState state, next;
+    JointTarget target;
+    target.position = { 1, -0.5, 0.3, 2, -1, 3 };
+    generator.update(state, target, next);
+
+    // Still moving just before the end, and there at the end
+    const auto before = generator.at(generator.duration() - 0.01f);
+    const auto after = generator.at(generator.duration());
+    for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+      CHECK(std::abs(before.velocity[j]) > 0.001);
+      CHECK(std::abs(before.position[j] - target.position[j]) > 1e-6);
+      CHECK(after.position[j] == Approx(target.position[j]));
+    }
+  }
+
+  SECTION("starts from motion") {
+    JointState state;
+    state.velocity = { 2, -2, 1, 3, -3, 4 };
+    state.acceleration = { 10, 10, -10, 0, 20, -20 };
+    JointTarget target;
+    target.position = { 0.1, 0, 0, -0.2, 0, 0 };
+
+    follow(generator, state, target);
+    for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+      CHECK(state.position[j] == Approx(target.position[j]).margin(1e-5));
+      CHECK(state.velocity[j] == 0);
+    }
+  }
+
+  SECTION("catches up with a moving target") {
+    JointState state;
+    JointTarget target;
+    target.position = { 0.5, 0, 0, 0, 0.5, 0 };
+    target.velocity = { 0.5, -0.5, 0, 1, 0, -1 };
+
+    const auto start = target.position;
+    const auto cycles = follow(generator, state, target);
+    for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+      CHECK(target.position[j] == Approx(start[j] + target.velocity[j] * Real(0.001 * cycles)).margin(1e-3));
+      CHECK(state.position[j] == Approx(target.position[j]).margin(1e-5));
+      CHECK(state.velocity[j] == Approx(target.velocity[j]));
+      CHECK(state.acceleration[j] == 0);
+    }
+  }
+
+  SECTION("follows a target that changes on the way") {
+    JointState state;
+    JointTarget target;
+    target.position = { 1, 1, 1, 1, 1, 1 };
+
+    for(int i = 0; i < 200; ++i) {
+      JointState next;
+      generator.update(state, target, next);
+      state = next;
+    }
+
+    target.position = { -1, 0, 0.5, -2, 0, 1 };
+    follow(generator, state, target);
+    for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+      CHECK(state.position[j] == Approx(target.position[j]).margin(1e-5));
+    }
+  }
+
+  SECTION("reaches random targets from random states") {
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<Real> fraction(-0.9, 0.9);
+    auto slower = OnlineTrajectory(ABB_IRB_120, 0.004);
+
+    for(int i = 0; i < 50; ++i) {
+      JointState state;
+      JointTarget target;
+      for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+        state.position[j] = 3 * fraction(generator);
+        // Slow enough to ramp the acceleration down within the velocity limit
+        state.velocity[j] = limits[j].velocity * fraction(generator) / 2;
+        state.acceleration[j] = limits[j].acceleration * fraction(generator);
+        target.position[j] = 3 * fraction(generator);
+        target.velocity[j] = (i % 2) ? limits[j].velocity * fraction(generator) / 2 : 0;
+      }
+
+      follow(slower, state, target);
+      for(std::size_t j = 0; j < TRAJECTORY_JOINTS; ++j) {
+        REQUIRE(state.position[j] == Approx(target.position[j]).margin(1e-5));
+        REQUIRE(state.velocity[j] == Approx(target.velocity[j]));
+      }
+    }
+  }
+
+  SECTION("needs the motion limits of 6 joints") {
+    CHECK_THROWS_AS(OnlineTrajectory(rbt::Serial({ rbt::Joint(0, 0, 0, 0) }), 0.001), std::invalid_argument);
+
+    auto joints = ABB_IRB_120.joints();
+    joints[2].motion.jerk = rbt::INF;
+    CHECK_THROWS_AS(OnlineTrajectory(rbt::Serial(joints), 0.001), std::invalid_argument);
+    CHECK_THROWS_AS(OnlineTrajectory(ABB_IRB_120, 0), std::invalid_argument);
+  }
+}
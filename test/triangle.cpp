@@ -0,0 +1,69 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+
+#include "spatial/aabb.hpp"
+#include "spatial/triangle.hpp"
+#include "spatial/vector.hpp"
+
+using rbt::AABB;
+using rbt::Triangle;
+using rbt::Vector3;
+
+TEST_CASE("Triangle") {
+  const auto t = Triangle({ Vector3({0, 0, 0}), Vector3({2, 0, 0}), Vector3({0, 2, 0}) });
+
+  SECTION("normal follows the winding") {
+    CHECK_THAT(normal(t), ComponentsEqual(Vector3({0, 0, 4})));
+  }
+
+  SECTION("closest point") {
+    SECTION("above the face") {
+      CHECK_THAT(closestPoint(t, Vector3({0.5, 0.5, 3})), ComponentsEqual(Vector3({0.5, 0.5, 0})));
+    }
+
+    SECTION("beyond a vertex") {
+      CHECK_THAT(closestPoint(t, Vector3({-1, -1, 1})), ComponentsEqual(Vector3({0, 0, 0})));
+      CHECK_THAT(closestPoint(t, Vector3({5, -1, 0})), ComponentsEqual(Vector3({2, 0, 0})));
+    }
+
+    SECTION("beyond an edge") {
+      CHECK_THAT(closestPoint(t, Vector3({1, -3, 2})), ComponentsEqual(Vector3({1, 0, 0})));
+      CHECK_THAT(closestPoint(t, Vector3({2, 2, 0})), ComponentsEqual(Vector3({1, 1, 0})));
+    }
+  }
+
+  SECTION("intersection") {
+    SECTION("crossing triangles") {
+      const auto other = Triangle({ Vector3({0.5, 0.5, -1}), Vector3({0.5, 0.5, 1}), Vector3({3, 3, 0}) });
+      CHECK(intersects(t, other));
+    }
+
+    SECTION("parallel triangles") {
+      const auto other = Triangle({ Vector3({0, 0, 1}), Vector3({2, 0, 1}), Vector3({0, 2, 1}) });
+      CHECK_FALSE(intersects(t, other));
+    }
+
+    SECTION("coplanar triangles") {
+      const auto overlapping = Triangle({ Vector3({1, 0.5, 0}), Vector3({3, 0.5, 0}), Vector3({1, 3, 0}) });
+      const auto separate = Triangle({ Vector3({2, 2, 0}), Vector3({4, 2, 0}), Vector3({2, 4, 0}) });
+
+      CHECK(intersects(t, overlapping));
+      CHECK_FALSE(intersects(t, separate));
+    }
+
+    SECTION("triangles separated by an edge-edge axis") {
+      const auto other = Triangle({ Vector3({1.5, 1.5, -1}), Vector3({1.5, 1.5, 1}), Vector3({3, 3, 0}) });
+      CHECK_FALSE(intersects(t, other));
+    }
+  }
+
+  SECTION("bounds") {
+    const auto box = bounds(t);
+
+    CHECK_THAT(box.min, ComponentsEqual(Vector3({0, 0, 0})));
+    CHECK_THAT(box.max, ComponentsEqual(Vector3({2, 2, 0})));
+    CHECK(box.surfaceArea() == Approx(8));
+    CHECK(distanceSq(box, Vector3({3, 1, 0})) == Approx(1));
+    CHECK(distanceSq(box, Vector3({1, 1, 0})) == Approx(0));
+  }
+}
@@ -0,0 +1,130 @@
+#include "third_party/catch.hpp"
+#include "matchers/vector.hpp"
+
+#include "frame.hpp"
+#include "spatial/dual.hpp"
+#include "spatial/quaternion.hpp"
+#include "spatial/transform.hpp"
+#include "spatial/twist.hpp"
+#include "spatial/vector.hpp"
+
+#include <random>
+
+using rbt::Dual;
+using rbt::Frame;
+using rbt::Poses;
+using rbt::Quaternion;
+using rbt::Real;
+using rbt::Transform;
+using rbt::Twist;
+using rbt::Twists;
+using rbt::Vector3;
+using rbt::toRadians;
+
+namespace {
+
+Dual<Quaternion> pose(const Vector3& axis, Real degrees, const Vector3& translation) {
+  return Transform(rbt::unit(axis), toRadians(degrees), translation).dual;
+}
+
+void requireClose(const Vector3& a, const Vector3& b, Real margin = 1e-4) {
+  for(std::size_t c = 0; c < 3; ++c) {
+    REQUIRE(a[c] == Approx(b[c]).margin(margin));
+  }
+}
+
+// Poses are equal when their components are, up to the sign of the whole dual quaternion.
+void requireSamePose(const Dual<Quaternion>& a, const Dual<Quaternion>& b, Real margin = 1e-4) {
+  const Real sign = (a.r.r * b.r.r + a.r.x * b.r.x + a.r.y * b.r.y + a.r.z * b.r.z < 0) ? -1 : 1;
+  const Real first[8] = { a.r.r, a.r.x, a.r.y, a.r.z, a.d.r, a.d.x, a.d.y, a.d.z };
+  const Real second[8] = { b.r.r, b.r.x, b.r.y, b.r.z, b.d.r, b.d.x, b.d.y, b.d.z };
+  for(int c = 0; c < 8; ++c) {
+    REQUIRE(first[c] == Approx(sign * second[c]).margin(margin));
+  }
+}
+
+}
+
+TEST_CASE("Twist") {
+  const auto a = pose(Vector3({1, 2, 3}), 40, Vector3({0.3, -0.2, 0.5}));
+  const auto b = pose(Vector3({-1, 0, 2}), 130, Vector3({-0.4, 0.1, 0.2}));
+
+  SECTION("exp undoes log") {
+    requireSamePose(rbt::exp(rbt::log(a)), a);
+    requireSamePose(rbt::exp(rbt::log(b)), b);
+  }
+
+  SECTION("log turns the shorter way around") {
+    const auto l = rbt::log(Real(-1) * a);
+    requireSamePose(rbt::exp(l), a);
+    CHECK(rbt::log(a).r.x == Approx(l.r.x));
+  }
+
+  SECTION("log of a pure translation is half the translation") {
+    const auto l = rbt::log(pose(Vector3({0, 0, 1}), 0, Vector3({2, -4, 6})));
+
+    CHECK(l.r.x == Approx(0).margin(1e-6));
+    CHECK_THAT(Vector3({ l.d.x, l.d.y, l.d.z }), ComponentsEqual(Vector3({1, -2, 3})));
+  }
+
+  SECTION("keeps its precision for tiny turns") {
+    for(const auto degrees : { Real(1e-5), Real(1e-3), Real(0.5), Real(10) }) {
+      const auto small = pose(Vector3({0, 1, 1}), degrees, Vector3({0.1, 0.2, 0.3}));
+      const auto motion = rbt::twist(Dual<Quaternion>(), small);
+
+      CHECK(rbt::length(motion.angular) == Approx(toRadians(degrees)).epsilon(1e-3));
+      requireSamePose(rbt::displacement(motion), small, 1e-6);
+    }
+  }
+
+  SECTION("pow takes fractions of the screw motion") {
+    const auto half = rbt::pow(b, 0.5);
+    requireSamePose(half * half, b);
+    requireSamePose(rbt::pow(b, 0), Dual<Quaternion>());
+    requireSamePose(rbt::pow(b, 1), b);
+  }
+
+  SECTION("displacement by the twist between poses moves one onto the other") {
+    requireSamePose(rbt::displacement(rbt::twist(a, b)) * a, b);
+
+    const auto error = rbt::twist(a, a);
+    requireClose(error.angular, Vector3({0, 0, 0}));
+    requireClose(error.linear, Vector3({0, 0, 0}));
+  }
+
+  SECTION("batches agree with single poses") {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<Real> component(-1, 1);
+    std::uniform_real_distribution<Real> angle(-180, 180);
+
+    // Not a multiple of 8, to cover the remainder; a few nearly equal to a, to cover the small angle branches
+    Poses from, to;
+    for(int i = 0; i < 29; ++i) {
+      const auto axis = Vector3({ component(generator), component(generator), component(generator) });
+      const auto translation = Vector3({ component(generator), component(generator), component(generator) });
+      from.push_back(pose(axis, angle(generator), translation));
+      to.push_back((i % 5 == 0) ? pose(axis, Real(0.01 * i), translation) * a : pose(axis, angle(generator), translation));
+    }
+
+    Twists fromOne, fromEach;
+    rbt::twists(a, to, fromOne);
+    rbt::twists(from, to, fromEach);
+    REQUIRE(fromOne.size() == to.size());
+
+    Poses moved;
+    rbt::displacements(fromEach, moved);
+    REQUIRE(moved.size() == to.size());
+
+    for(std::size_t i = 0; i < to.size(); ++i) {
+      const auto one = rbt::twist(a, to[i]);
+      const auto each = rbt::twist(from[i], to[i]);
+
+      requireClose(fromOne[i].angular, one.angular);
+      requireClose(fromOne[i].linear, one.linear);
+      requireClose(fromEach[i].angular, each.angular);
+      requireClose(fromEach[i].linear, each.linear);
+      requireSamePose(moved[i], rbt::displacement(each));
+      requireSamePose(moved[i] * from[i], to[i], 1e-3);
+    }
+  }
+}
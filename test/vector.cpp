@@ -4,6 +4,7 @@
 
 using rbt::Real;
 using rbt::Vector3;
+using rbt::cross;
 using rbt::length;
 using rbt::lengthSq;
 using rbt::toRadians;
@@ -35,6 +36,19 @@ TEST_CASE("Vector") {
     REQUIRE(v2 / s == Vector3({-0.5, 1, -1.5}));
   }
 
+  SECTION("vector addition") {
+    const auto result = v2 + v3;
+    const auto expected = Vector3({ 1, -3, 0 });
+
+    REQUIRE(result == expected);
+  }
+
+  SECTION("cross product") {
+    REQUIRE(cross(Vector3({ 1, 0, 0 }), Vector3({ 0, 1, 0 })) == Vector3({ 0, 0, 1 }));
+    REQUIRE(cross(v2, v3) * v2 == 0);
+    REQUIRE(cross(v2, v3) * v3 == 0);
+  }
+
   SECTION("vector subtraction") {
     const auto result = v1 - v2;
     const auto expected = Vector3({ 1, -2, 3 });